@@ -72,6 +72,17 @@ typedef struct gsupplicant_create_interface_params {
     const char* config_file;
 } GSupplicantCreateInterfaceParams;
 
+typedef struct gsupplicant_scan_policy {
+    guint flags;
+
+#define GSUPPLICANT_SCAN_POLICY_MERGE   (0x01) /* Merge identical requests */
+
+    guint max_active;       /* Concurrent scans, 0 for no limit */
+    guint stagger_ms;       /* Minimum interval between scan starts */
+    guint retry_count;      /* Retries of rejected scan requests */
+    guint retry_delay_ms;   /* Doubles after each retry */
+} GSupplicantScanPolicy;    /* Since 1.0.31 */
+
 typedef
 void
 (*GSupplicantFunc)(
@@ -102,10 +113,48 @@ void
     const char* result,
     void* data);
 
+/*
+ * Objects are bound to the thread-default main context at the time they
+ * are created (see g_main_context_push_thread_default). That's where the
+ * D-Bus signals get delivered and where all the callbacks are invoked.
+ * To run the library on a worker thread, push the worker's context and
+ * keep it pushed while the objects are being created and used. Each
+ * context has its own set of instances, i.e. gsupplicant_new() and
+ * other *_new() functions called on different contexts return different
+ * objects. An object must only be used on the thread running its context.
+ */
 GSupplicant*
 gsupplicant_new(
     void);
 
+GMainContext*
+gsupplicant_get_context(
+    GSupplicant* supplicant); /* Since 1.0.31 */
+
+/*
+ * With non-zero timeout, the objects keep their state when wpa_supplicant
+ * restarts. If it comes back within the timeout, the state is re-read
+ * and only the actual changes get signalled, otherwise everything becomes
+ * invalid as usual. Zero (the default) disables the resync.
+ */
+void
+gsupplicant_set_resync_timeout(
+    GSupplicant* supplicant,
+    guint ms); /* Since 1.0.31 */
+
+/*
+ * With a policy set, scan requests from all interfaces bound to the same
+ * context are queued and started according to the policy. Requests which
+ * get rejected by wpa_supplicant (ScanError) are retried with backoff.
+ * Only one scan per interface runs at a time. NULL disables coordination
+ * (the default), the requests which are still queued get started as soon
+ * as possible.
+ */
+void
+gsupplicant_set_scan_policy(
+    GSupplicant* supplicant,
+    const GSupplicantScanPolicy* policy); /* Since 1.0.31 */
+
 GSupplicant*
 gsupplicant_ref(
     GSupplicant* supplicant);
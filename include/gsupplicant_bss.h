@@ -94,6 +94,7 @@ typedef enum gsupplicant_bss_property {
     GSUPPLICANT_BSS_PROPERTY_RATES,
     GSUPPLICANT_BSS_PROPERTY_MAXRATE,
     GSUPPLICANT_BSS_PROPERTY_SIGNAL,
+    GSUPPLICANT_BSS_PROPERTY_AGE,           /* Since 1.0.31 */
     GSUPPLICANT_BSS_PROPERTY_COUNT
 } GSUPPLICANT_BSS_PROPERTY;
 
@@ -125,6 +126,8 @@ struct gsupplicant_bss {
     const GSupplicantUIntArray* rates;
     guint maxrate;
     gint signal;
+    guint age;              /* Since 1.0.31 (seconds) */
+    gint64 last_seen;       /* Since 1.0.31 (monotonic time, may lag) */
 };
 
 typedef
@@ -142,6 +145,15 @@ void
     const char* result,
     void* data);
 
+typedef
+void
+(*GSupplicantBSSRoamFunc)(
+    GSupplicantBSS* bss,
+    GCancellable* cancel,
+    const GError* error,
+    gint64 gap,     /* Microseconds from disassociation to COMPLETED */
+    void* data); /* Since: 1.0.31 */
+
 typedef
 void
 (*GSupplicantBSSPropertyFunc)(
@@ -206,6 +218,32 @@ gsupplicant_bss_connect(
     GSupplicantBSSStringResultFunc fn,
     void* data);
 
+/*
+ * Moves the association to this BSS without reconfiguring the network.
+ * Fails right away (returns NULL) unless the interface is associated with
+ * another BSS of the same SSID and security. The callback is invoked once
+ * the interface reaches COMPLETED state with this BSS.
+ */
+GCancellable*
+gsupplicant_bss_roam(
+    GSupplicantBSS* bss,
+    GSupplicantBSSRoamFunc fn,
+    void* data); /* Since: 1.0.31 */
+
+/*
+ * Allocation-free access to BSSID and SSID. The returned pointer remains
+ * valid until the corresponding property changes.
+ */
+const guint8*
+gsupplicant_bss_bssid_data(
+    GSupplicantBSS* bss,
+    gsize* size); /* Since: 1.0.31 */
+
+const guint8*
+gsupplicant_bss_ssid_data(
+    GSupplicantBSS* bss,
+    gsize* size); /* Since: 1.0.31 */
+
 #define gsupplicant_bss_remove_all_handlers(bss, ids) \
     gsupplicant_bss_remove_handlers(bss, ids, G_N_ELEMENTS(ids))
 
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GSUPPLICANT_CATALOG_H
+#define GSUPPLICANT_CATALOG_H
+
+#include <gsupplicant_types.h>
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Catalog of the networks configured on the interface. Keeps the
+ * parsed (typed) values of the most frequently used network properties
+ * and indexes the networks by SSID and key management. It's updated
+ * incrementally as networks come and go and their properties change.
+ *
+ * Since 1.0.31
+ */
+
+typedef struct gsupplicant_catalog_priv GSupplicantCatalogPriv;
+
+struct gsupplicant_catalog {
+    GObject object;
+    GSupplicantCatalogPriv* priv;
+    GSupplicantInterface* iface;
+    guint count;
+};
+
+typedef struct gsupplicant_catalog_entry {
+    GSupplicantNetwork* network;
+    const char* path;
+    GBytes* ssid;                   /* NULL if not known yet */
+    GSUPPLICANT_KEYMGMT keymgmt;
+    GSUPPLICANT_EAP_METHOD eap;
+    gint priority;
+    gboolean disabled;
+} GSupplicantCatalogEntry;
+
+typedef
+void
+(*GSupplicantCatalogFunc)(
+    GSupplicantCatalog* catalog,
+    void* data);
+
+GSupplicantCatalog*
+gsupplicant_catalog_new(
+    GSupplicantInterface* iface);
+
+GSupplicantCatalog*
+gsupplicant_catalog_ref(
+    GSupplicantCatalog* catalog);
+
+void
+gsupplicant_catalog_unref(
+    GSupplicantCatalog* catalog);
+
+gulong
+gsupplicant_catalog_add_changed_handler(
+    GSupplicantCatalog* catalog,
+    GSupplicantCatalogFunc fn,
+    void* data);
+
+void
+gsupplicant_catalog_remove_handler(
+    GSupplicantCatalog* catalog,
+    gulong id);
+
+const GSupplicantCatalogEntry*
+gsupplicant_catalog_get(
+    GSupplicantCatalog* catalog,
+    const char* path);
+
+/* Arrays of const GSupplicantCatalogEntry*, NULL if nothing matches */
+const GPtrArray*
+gsupplicant_catalog_find_ssid(
+    GSupplicantCatalog* catalog,
+    GBytes* ssid);
+
+const GPtrArray*
+gsupplicant_catalog_find_keymgmt(
+    GSupplicantCatalog* catalog,
+    GSUPPLICANT_KEYMGMT keymgmt);   /* Exactly one bit */
+
+/* First entry for this SSID supporting any of the keymgmt bits */
+const GSupplicantCatalogEntry*
+gsupplicant_catalog_lookup(
+    GSupplicantCatalog* catalog,
+    GBytes* ssid,
+    GSUPPLICANT_KEYMGMT keymgmt);
+
+G_END_DECLS
+
+#endif /* GSUPPLICANT_CATALOG_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GSUPPLICANT_EMBED_H
+#define GSUPPLICANT_EMBED_H
+
+#include <gsupplicant_types.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Drives the main context which GSupplicant objects are bound to from
+ * an external event loop (epoll, libevent and such), without running
+ * GMainLoop. Each iteration goes like this:
+ *
+ *   1. gsupplicant_embed_prepare() returns the timeout and the file
+ *      descriptors to wait for (in practice, it's normally just the
+ *      context's wakeup fd, so the set rarely changes)
+ *   2. The external loop waits until any of those becomes ready or
+ *      the timeout expires
+ *   3. gsupplicant_embed_dispatch() invokes whatever is ready, without
+ *      blocking
+ *
+ * The embed object must be used on the thread where it was created.
+ * It owns (acquires) the context while it exists. Passing NULL as the
+ * context means the thread-default one. Objects created while the same
+ * context is thread-default are bound to it (see gsupplicant_new).
+ *
+ * Since 1.0.31
+ */
+
+typedef struct gsupplicant_embed GSupplicantEmbed;
+
+GSupplicantEmbed*
+gsupplicant_embed_new(
+    GMainContext* context); /* NULL if the context is owned elsewhere */
+
+void
+gsupplicant_embed_free(
+    GSupplicantEmbed* embed);
+
+GMainContext*
+gsupplicant_embed_context(
+    GSupplicantEmbed* embed);
+
+/* Returns the timeout in milliseconds, -1 if there's none */
+int
+gsupplicant_embed_prepare(
+    GSupplicantEmbed* embed,
+    const GPollFD** fds,
+    guint* n_fds);
+
+/* Returns TRUE if anything has been dispatched */
+gboolean
+gsupplicant_embed_dispatch(
+    GSupplicantEmbed* embed);
+
+G_END_DECLS
+
+#endif /* GSUPPLICANT_EMBED_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -52,7 +52,8 @@ GQuark gsupplicant_error_quark(void);
     e(BLOB_EXISTS,          "BlobExists")        \
     e(NO_SUBSCRIPTION,      "NoSubscription")    \
     e(SUBSCRIPTION_IN_USE,  "SubscriptionInUse") \
-    e(SUBSCRIPTION_NOT_YOU, "SubscriptionNotYou")
+    e(SUBSCRIPTION_NOT_YOU, "SubscriptionNotYou") \
+    e(SCAN_ERROR,           "Interface.ScanError")
 
 typedef enum gsupplicant_error_code {
 #define GSUPPLICANT_ERROR_ENUM_(E,e) GSUPPLICANT_ERROR_##E,
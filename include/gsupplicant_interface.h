@@ -163,8 +163,51 @@ typedef struct gsupplicant_scan_params {
     gboolean allow_roam;
 } GSupplicantScanParams;
 
+typedef struct gsupplicant_directed_scan_ssid {
+    GBytes* ssid;
+    gint priority;              /* Higher priority SSIDs go first */
+} GSupplicantDirectedScanSSID;  /* Since: 1.0.31 */
+
+typedef struct gsupplicant_scan_times {
+    guint scans;
+    guint retries;
+    gint64 last_wait;           /* Microseconds in the queue */
+    gint64 last_run;            /* Microseconds of scanning */
+    gint64 total_wait;
+    gint64 total_run;
+} GSupplicantScanTimes;         /* Since: 1.0.31 */
+
+typedef struct gsupplicant_filter_policy {
+    guint flags;                /* Reserved, must be zero */
+    guint dense_count;          /* More BSSs raise the threshold */
+    guint sparse_count;         /* Fewer BSSs lower the threshold */
+    gint min_rssi;              /* Lowest threshold (dBm) */
+    gint max_rssi;              /* Highest threshold (dBm) */
+    guint step;                 /* Adjustment step (dB) */
+} GSupplicantFilterPolicy;      /* Since: 1.0.31 */
+
+typedef struct gsupplicant_bss_expiry {
+    guint flags;                /* Reserved, must be zero */
+    guint max_age;              /* BSSExpireAge (seconds) */
+    guint max_count;            /* BSSExpireCount (scans) */
+    guint flush_interval;       /* Seconds, zero disables flushing */
+} GSupplicantBSSExpiry;         /* Since: 1.0.31 */
+
+typedef struct gsupplicant_scan_source_stats {
+    guint host_scans;           /* Requested by this library */
+    guint host_results;         /* New BSSs found by those */
+    guint offloaded_scans;      /* Completed while sched scans enabled */
+    guint offloaded_results;    /* New BSSs found by those */
+    guint other_scans;          /* All other completed scans */
+    guint other_results;        /* New BSSs found by those */
+} GSupplicantScanSourceStats;   /* Since: 1.0.31 */
+
 typedef struct gsupplicant_network_params {
-    guint flags;  /* Should be zero */
+    guint flags;  /* Zero or these: */
+
+/* Adds FT variants of the enabled suites selected by keymgmt */
+#define GSUPPLICANT_NETWORK_PARAM_FT    (0x01) /* Since 1.0.31 */
+
     GSUPPLICANT_AUTH_FLAGS auth_flags;
     GBytes* ssid;
     GSUPPLICANT_OP_MODE mode;
@@ -216,6 +259,13 @@ typedef struct gsupplicant_wps_credentials {
     guint key_index;
 } GSupplicantWPSCredentials;
 
+/* AP mode station, stays at the same address while it's authorized */
+typedef struct gsupplicant_station {
+    const char* address;
+    gint64 connected;           /* Monotonic time (microseconds) */
+    gint64 connected_real;      /* Real time (microseconds) */
+} GSupplicantStation; /* Since: 1.0.31 */
+
 typedef struct gsupplicant_interface_priv GSupplicantInterfacePriv;
 
 struct gsupplicant_interface {
@@ -290,6 +340,13 @@ void
     GSUPPLICANT_INTERFACE_EAP_EVENT status,
     void* data);
 
+typedef
+void
+(*GSupplicantInterfaceStationFunc)(
+    GSupplicantInterface* iface,
+    const GSupplicantStation* station,
+    void* data); /* Since: 1.0.31 */
+
 GSupplicantInterface*
 gsupplicant_interface_new(
     const char* path);
@@ -361,6 +418,14 @@ gsupplicant_interface_reattach(
     GSupplicantInterfaceResultFunc fn,
     void* data);
 
+/* Same ESS transition, see also gsupplicant_bss_roam() */
+GCancellable*
+gsupplicant_interface_roam(
+    GSupplicantInterface* iface,
+    const char* bssid,
+    GSupplicantInterfaceResultFunc fn,
+    void* data); /* Since: 1.0.31 */
+
 GCancellable*
 gsupplicant_interface_add_blob(
     GSupplicantInterface* self,
@@ -509,6 +574,191 @@ void gsupplicant_interface_set_sae_check_mfp(GSupplicantInterface *iface,
 void gsupplicant_interface_set_sae_pwe(GSupplicantInterface* iface,
     GSUPPLICANT_SAE_PWE_OPTION option); /* Since: 1.0.29 */
 
+/*
+ * BSS lookups. Only the GSupplicantBSS objects which currently exist
+ * (i.e. have been created with gsupplicant_bss_new() and haven't been
+ * destroyed yet) are indexed. No references are added to the returned
+ * objects. The frequency lookup returns NULL if there are no known BSSs
+ * on the specified frequency.
+ */
+GSupplicantBSS*
+gsupplicant_interface_find_bss(
+    GSupplicantInterface* iface,
+    GBytes* bssid); /* Since: 1.0.31 */
+
+const GPtrArray*
+gsupplicant_interface_find_bsss_on_frequency(
+    GSupplicantInterface* iface,
+    guint frequency); /* Since: 1.0.31 */
+
+/*
+ * AP mode stations are indexed by address. Added and removed handlers
+ * are invoked for each station (the STATIONS change follows). The
+ * station record passed to the removed handler is freed right after.
+ */
+const GSupplicantStation*
+gsupplicant_interface_find_station(
+    GSupplicantInterface* iface,
+    const char* address); /* Since: 1.0.31 */
+
+gulong
+gsupplicant_interface_add_station_added_handler(
+    GSupplicantInterface* iface,
+    GSupplicantInterfaceStationFunc fn,
+    void* data); /* Since: 1.0.31 */
+
+gulong
+gsupplicant_interface_add_station_removed_handler(
+    GSupplicantInterface* iface,
+    GSupplicantInterfaceStationFunc fn,
+    void* data); /* Since: 1.0.31 */
+
+/*
+ * Directed (active) scan for any number of SSIDs. The SSIDs are sorted
+ * by priority and split into batches of at most caps.max_scan_ssid.
+ * Each batch is submitted as soon as the previous scan is finished.
+ * The other scan parameters (except for the type and SSIDs which are
+ * ignored) apply to every batch. The callback is invoked once, when
+ * the last batch is done or after the first failure. A batch which
+ * doesn't complete in 30 seconds fails with G_IO_ERROR_TIMED_OUT.
+ * NULL SSIDs are skipped, NULL is returned if there are none left.
+ */
+GCancellable*
+gsupplicant_interface_directed_scan(
+    GSupplicantInterface* iface,
+    const GSupplicantScanParams* params,
+    const GSupplicantDirectedScanSSID* ssids,
+    guint count,
+    GSupplicantInterfaceResultFunc fn,
+    void* data); /* Since: 1.0.31 */
+
+GCancellable*
+gsupplicant_interface_directed_scan_full(
+    GSupplicantInterface* iface,
+    GCancellable* cancel,
+    const GSupplicantScanParams* params,
+    const GSupplicantDirectedScanSSID* ssids,
+    guint count,
+    GSupplicantInterfaceResultFunc fn,
+    GDestroyNotify destroy,
+    void* data); /* Since: 1.0.31 */
+
+/* Only the scans which went through gsupplicant_set_scan_policy() */
+const GSupplicantScanTimes*
+gsupplicant_interface_get_scan_times(
+    GSupplicantInterface* iface); /* Since: 1.0.31 */
+
+/*
+ * Supplicant-side scan result filtering. The results which don't pass
+ * the filters never become BSS objects. FilterSsids drops the BSSs whose
+ * SSID doesn't match any configured network, FilterRssi drops the ones
+ * weaker than the threshold (zero disables the filter) and BssMaxCount
+ * limits the size of the BSS table.
+ */
+gboolean
+gsupplicant_interface_set_filter_ssids(
+    GSupplicantInterface* iface,
+    gboolean enable); /* Since: 1.0.31 */
+
+gboolean
+gsupplicant_interface_set_filter_rssi(
+    GSupplicantInterface* iface,
+    gint rssi); /* Since: 1.0.31 */
+
+gint
+gsupplicant_interface_get_filter_rssi(
+    GSupplicantInterface* iface); /* Since: 1.0.31 */
+
+gboolean
+gsupplicant_interface_set_bss_max_count(
+    GSupplicantInterface* iface,
+    guint count); /* Since: 1.0.31 */
+
+/*
+ * Adaptive FilterRssi. After each scan, the threshold is raised by one
+ * step if the interface has more than dense_count BSSs and lowered if
+ * it has fewer than sparse_count, staying within [min_rssi, max_rssi].
+ * NULL policy stops the adjustments, leaving the threshold as is.
+ */
+gboolean
+gsupplicant_interface_set_filter_policy(
+    GSupplicantInterface* iface,
+    const GSupplicantFilterPolicy* policy); /* Since: 1.0.31 */
+
+gboolean
+gsupplicant_interface_set_bss_expire_age(
+    GSupplicantInterface* iface,
+    guint seconds); /* Since: 1.0.31 */
+
+gboolean
+gsupplicant_interface_set_bss_expire_count(
+    GSupplicantInterface* iface,
+    guint count); /* Since: 1.0.31 */
+
+/*
+ * Configures BSSExpireAge and BSSExpireCount and, if flush_interval is
+ * non-zero, periodically flushes the BSSs which haven't been seen for
+ * longer than max_age, without waiting for the next scan to expire
+ * them. Zero max_age and max_count leave the respective setting alone.
+ * NULL stops the flushing.
+ */
+gboolean
+gsupplicant_interface_set_bss_expiry(
+    GSupplicantInterface* iface,
+    const GSupplicantBSSExpiry* expiry); /* Since: 1.0.31 */
+
+/*
+ * Scheduled (firmware offloaded) scans. See also gsupplicant_sched_scan.h
+ * for a plan builder which validates the plans and can revert them.
+ */
+gboolean
+gsupplicant_interface_set_sched_scan_interval(
+    GSupplicantInterface* iface,
+    guint seconds); /* Since: 1.0.31 */
+
+gboolean
+gsupplicant_interface_set_sched_scan_plans(
+    GSupplicantInterface* iface,
+    const char* plans); /* Since: 1.0.31 */
+
+gboolean
+gsupplicant_interface_set_scan_offload(
+    GSupplicantInterface* iface,
+    gboolean enable); /* Since: 1.0.31 */
+
+/*
+ * Scans (ScanDone signals) are counted as host scans if they follow a
+ * successful scan request made by this library. The rest are counted
+ * as offloaded if scheduled scans are enabled (SchedScanPlans or
+ * SchedScanInterval is set and DisableScanOffload is not), otherwise
+ * as other scans (initiated by wpa_supplicant or by another client).
+ * Offloaded scans may still include some of those.
+ */
+const GSupplicantScanSourceStats*
+gsupplicant_interface_get_scan_source_stats(
+    GSupplicantInterface* iface); /* Since: 1.0.31 */
+
+/* Roaming related settings, see also gsupplicant_roam_profile.h */
+gboolean
+gsupplicant_interface_set_okc(
+    GSupplicantInterface* iface,
+    gboolean enable); /* Since: 1.0.31 */
+
+gboolean
+gsupplicant_interface_set_pmf(
+    GSupplicantInterface* iface,
+    GSUPPLICANT_MFP_OPTIONS pmf); /* Since: 1.0.31 */
+
+gboolean
+gsupplicant_interface_set_fast_reauth(
+    GSupplicantInterface* iface,
+    gboolean enable); /* Since: 1.0.31 */
+
+gboolean
+gsupplicant_interface_set_bgscan(
+    GSupplicantInterface* iface,
+    const char* bgscan); /* Since: 1.0.31 */
+
 #define gsupplicant_interface_remove_all_handlers(iface, ids) \
     gsupplicant_interface_remove_handlers(iface, ids, G_N_ELEMENTS(ids))
 
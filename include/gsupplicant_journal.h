@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GSUPPLICANT_JOURNAL_H
+#define GSUPPLICANT_JOURNAL_H
+
+#include <gsupplicant_types.h>
+
+G_BEGIN_DECLS
+
+/*
+ * D-Bus traffic journal. While recording is active, method calls made
+ * to wpa_supplicant, their replies and the signals emitted by it are
+ * written to a binary file, each message timestamped. The journal can
+ * then be replayed offline (see test/replay).
+ *
+ * The file must not exist, it gets created readable only by the owner.
+ * Secrets (keys, passwords, PINs and blobs) passed to wpa_supplicant are
+ * replaced with placeholders before being written.
+ *
+ * Recording can also be started by setting GSUPPLICANT_JOURNAL
+ * environment variable to the file name before the first GSupplicant
+ * instance is created. In that case, recording starts as soon as
+ * GSupplicant gets connected to the bus.
+ *
+ * Since 1.0.31
+ */
+
+gboolean
+gsupplicant_journal_start(
+    const char* file,
+    GError** error);
+
+void
+gsupplicant_journal_stop(
+    void);
+
+G_END_DECLS
+
+#endif /* GSUPPLICANT_JOURNAL_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GSUPPLICANT_LINK_PREDICTOR_H
+#define GSUPPLICANT_LINK_PREDICTOR_H
+
+#include <gsupplicant_types.h>
+#include <gsupplicant_interface.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Link predictor watches the signal of the current association and
+ * tries to guess when the link is about to collapse. The samples come
+ * from gsupplicant_interface_signal_poll() (RSSI and link speed) and
+ * from the Signal updates of the current BSS. RSSI is extrapolated
+ * horizon milliseconds ahead using the least squares fit over the last
+ * few samples.
+ *
+ * When the link is predicted to go below rssi_threshold (or the link
+ * speed falls below linkspeed_threshold while the signal is dropping),
+ * at_risk becomes TRUE and a directed scan for the current SSID is
+ * started on the channels where BSSs of the same ESS have been seen,
+ * so that the roam candidates are fresh by the time the connection
+ * actually drops. Only the BSSs which are known to the interface's BSS
+ * index are considered, see gsupplicant_interface_find_bsss_on_frequency.
+ * If there are none, all channels are scanned.
+ *
+ * Since 1.0.31
+ */
+
+typedef struct gsupplicant_link_predictor_priv GSupplicantLinkPredictorPriv;
+
+struct gsupplicant_link_predictor {
+    GObject object;
+    GSupplicantLinkPredictorPriv* priv;
+    GSupplicantInterface* iface;
+    gboolean at_risk;
+};
+
+typedef struct gsupplicant_link_predictor_policy {
+    guint flags;
+
+#define GSUPPLICANT_LINK_PREDICTOR_NO_SCAN  (0x01)  /* Only predict */
+
+    guint poll_interval;        /* Milliseconds, 0 to disable polling */
+    guint horizon;              /* Milliseconds */
+    gint rssi_threshold;        /* dBm */
+    gint linkspeed_threshold;   /* Mbps, 0 to ignore link speed */
+    guint min_scan_interval;    /* Seconds between the pre-scans */
+} GSupplicantLinkPredictorPolicy;
+
+typedef struct gsupplicant_link_predictor_stats {
+    guint samples;
+    guint predictions;          /* at_risk went TRUE */
+    guint scans;                /* Pre-scans started */
+    guint channels;             /* Total channels pre-scanned */
+    guint drops;                /* Associations lost */
+    guint predicted_drops;      /* Drops which happened while at_risk */
+} GSupplicantLinkPredictorStats;
+
+typedef
+void
+(*GSupplicantLinkPredictorFunc)(
+    GSupplicantLinkPredictor* predictor,
+    void* data);
+
+GSupplicantLinkPredictor*
+gsupplicant_link_predictor_new(
+    GSupplicantInterface* iface);
+
+GSupplicantLinkPredictor*
+gsupplicant_link_predictor_ref(
+    GSupplicantLinkPredictor* predictor);
+
+void
+gsupplicant_link_predictor_unref(
+    GSupplicantLinkPredictor* predictor);
+
+/* NULL policy restores the default one */
+void
+gsupplicant_link_predictor_set_policy(
+    GSupplicantLinkPredictor* predictor,
+    const GSupplicantLinkPredictorPolicy* policy);
+
+const GSupplicantLinkPredictorPolicy*
+gsupplicant_link_predictor_get_policy(
+    GSupplicantLinkPredictor* predictor);
+
+const GSupplicantLinkPredictorStats*
+gsupplicant_link_predictor_get_stats(
+    GSupplicantLinkPredictor* predictor);
+
+/* Extrapolated RSSI, FALSE if there's not enough samples */
+gboolean
+gsupplicant_link_predictor_predict(
+    GSupplicantLinkPredictor* predictor,
+    gint* rssi);
+
+gulong
+gsupplicant_link_predictor_add_at_risk_handler(
+    GSupplicantLinkPredictor* predictor,
+    GSupplicantLinkPredictorFunc fn,
+    void* data);
+
+void
+gsupplicant_link_predictor_remove_handler(
+    GSupplicantLinkPredictor* predictor,
+    gulong id);
+
+G_END_DECLS
+
+#endif /* GSUPPLICANT_LINK_PREDICTOR_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
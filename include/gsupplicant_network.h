@@ -60,6 +60,16 @@ struct gsupplicant_network {
     gboolean enabled;
 };
 
+/*
+ * Entry of the sorted view of network properties. The view (as well
+ * as the properties hashtable) stays valid until the next PROPERTIES
+ * change.
+ */
+typedef struct gsupplicant_network_key_value {
+    const char* key;
+    const char* value;
+} GSupplicantNetworkKeyValue; /* Since: 1.0.31 */
+
 typedef
 void
 (*GSupplicantNetworkFunc)(
@@ -73,6 +83,13 @@ void
     GSUPPLICANT_NETWORK_PROPERTY property,
     void* data);
 
+typedef
+void
+(*GSupplicantNetworkKeyFunc)(
+    GSupplicantNetwork* network,
+    const char* key,
+    void* data); /* Since: 1.0.31 */
+
 GSupplicantNetwork*
 gsupplicant_network_new(
     const char* path);
@@ -99,6 +116,13 @@ gsupplicant_network_add_property_changed_handler(
     GSupplicantNetworkPropertyFunc fn,
     void* data);
 
+gulong
+gsupplicant_network_add_properties_key_handler(
+    GSupplicantNetwork* network,
+    const char* key,           /* NULL for any key */
+    GSupplicantNetworkKeyFunc fn,
+    void* data); /* Since: 1.0.31 */
+
 void
 gsupplicant_network_remove_handler(
     GSupplicantNetwork* network,
@@ -115,6 +139,16 @@ gsupplicant_network_set_enabled(
     GSupplicantNetwork* network,
     gboolean enabled);
 
+const GSupplicantNetworkKeyValue*
+gsupplicant_network_properties(
+    GSupplicantNetwork* network,
+    guint* count); /* Since: 1.0.31 */
+
+const char*
+gsupplicant_network_property(
+    GSupplicantNetwork* network,
+    const char* key); /* Since: 1.0.31 */
+
 #define gsupplicant_network_remove_all_handlers(network, ids) \
     gsupplicant_network_remove_handlers(network, ids, G_N_ELEMENTS(ids))
 
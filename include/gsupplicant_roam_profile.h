@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GSUPPLICANT_ROAM_PROFILE_H
+#define GSUPPLICANT_ROAM_PROFILE_H
+
+#include <gsupplicant_types.h>
+#include <gsupplicant_interface.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Roaming profile ties together the settings which affect roaming
+ * latency: opportunistic key caching (OKC), fast BSS transition (FT),
+ * EAP fast re-authentication, management frame protection and bgscan.
+ *
+ * gsupplicant_roam_profile_check() tells which of the requested features
+ * can't work with the interface capabilities and (optionally) the RSN
+ * key management of the target BSS. gsupplicant_roam_profile_apply()
+ * configures the requested interface-wide settings in one go and leaves
+ * the rest alone, except for those it has changed before, which get
+ * their original values back. FT is a per-network key management
+ * setting, so it's only enabled for the networks whose parameters went
+ * through gsupplicant_roam_profile_network_params().
+ *
+ * The profile also watches the interface for roams, i.e. transitions
+ * from one completed association to another with a different BSS, and
+ * measures how long the connection was down in between.
+ *
+ * Since 1.0.31
+ */
+
+typedef struct gsupplicant_roam_profile_priv GSupplicantRoamProfilePriv;
+
+struct gsupplicant_roam_profile {
+    GObject object;
+    GSupplicantRoamProfilePriv* priv;
+    GSupplicantInterface* iface;
+};
+
+typedef enum gsupplicant_roam_feature {
+    GSUPPLICANT_ROAM_NONE           = (0x00),
+    GSUPPLICANT_ROAM_OKC            = (0x01),
+    GSUPPLICANT_ROAM_FT             = (0x02),
+    GSUPPLICANT_ROAM_FAST_REAUTH    = (0x04),
+    GSUPPLICANT_ROAM_PMF            = (0x08),
+    GSUPPLICANT_ROAM_BGSCAN         = (0x10)
+} GSUPPLICANT_ROAM_FEATURE;
+
+typedef struct gsupplicant_roam_profile_config {
+    GSUPPLICANT_ROAM_FEATURE features;
+    GSUPPLICANT_MFP_OPTIONS pmf;    /* With GSUPPLICANT_ROAM_PMF */
+    const char* bgscan;             /* With GSUPPLICANT_ROAM_BGSCAN */
+} GSupplicantRoamProfileConfig;
+
+typedef struct gsupplicant_roam_event {
+    const char* from;       /* BSS path */
+    const char* to;         /* BSS path */
+    gint64 gap;             /* Microseconds without association */
+} GSupplicantRoamEvent;
+
+typedef struct gsupplicant_roam_stats {
+    guint roams;
+    gint64 last_gap;        /* Microseconds */
+    gint64 max_gap;         /* Microseconds */
+    gint64 total_gap;       /* Microseconds */
+} GSupplicantRoamStats;
+
+typedef
+void
+(*GSupplicantRoamProfileEventFunc)(
+    GSupplicantRoamProfile* profile,
+    const GSupplicantRoamEvent* event,
+    void* data);
+
+GSupplicantRoamProfile*
+gsupplicant_roam_profile_new(
+    GSupplicantInterface* iface);
+
+GSupplicantRoamProfile*
+gsupplicant_roam_profile_ref(
+    GSupplicantRoamProfile* profile);
+
+void
+gsupplicant_roam_profile_unref(
+    GSupplicantRoamProfile* profile);
+
+/* Returns the requested features which are not going to work */
+GSUPPLICANT_ROAM_FEATURE
+gsupplicant_roam_profile_check(
+    GSupplicantRoamProfile* profile,
+    const GSupplicantRoamProfileConfig* config,
+    GSupplicantBSS* target);
+
+/* Also remembers the config for gsupplicant_roam_profile_network_params */
+gboolean
+gsupplicant_roam_profile_apply(
+    GSupplicantRoamProfile* profile,
+    const GSupplicantRoamProfileConfig* config);
+
+/* Adds FT key management (GSUPPLICANT_NETWORK_PARAM_FT) and bgscan */
+void
+gsupplicant_roam_profile_network_params(
+    GSupplicantRoamProfile* profile,
+    GSupplicantNetworkParams* params);
+
+const GSupplicantRoamStats*
+gsupplicant_roam_profile_get_stats(
+    GSupplicantRoamProfile* profile);
+
+gulong
+gsupplicant_roam_profile_add_roam_handler(
+    GSupplicantRoamProfile* profile,
+    GSupplicantRoamProfileEventFunc fn,
+    void* data);
+
+void
+gsupplicant_roam_profile_remove_handler(
+    GSupplicantRoamProfile* profile,
+    gulong id);
+
+G_END_DECLS
+
+#endif /* GSUPPLICANT_ROAM_PROFILE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GSUPPLICANT_SCAN_PLANNER_H
+#define GSUPPLICANT_SCAN_PLANNER_H
+
+#include <gsupplicant_types.h>
+#include <gsupplicant_interface.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Scan planner remembers on which channels the configured (saved)
+ * networks have been seen and scans those channels first. Only if
+ * none of the saved networks shows up there, it falls back to the
+ * full scan. Every max_partial consecutive partial scans are followed
+ * by a full one anyway, to pick up networks which have moved.
+ *
+ * Channel history is learned from the frequencies of the BSSs which
+ * carry the saved SSIDs. Channels which haven't been seen for more than
+ * max_age seconds are forgotten.
+ *
+ * Only one planned scan can be in progress at a time. The completion
+ * callback is invoked when the whole sequence (including the fallback
+ * full scan, if necessary) is finished, or with G_IO_ERROR_TIMED_OUT
+ * if it takes longer than the timeout.
+ *
+ * Since 1.0.31
+ */
+
+typedef struct gsupplicant_scan_planner_priv GSupplicantScanPlannerPriv;
+
+struct gsupplicant_scan_planner {
+    GObject object;
+    GSupplicantScanPlannerPriv* priv;
+    GSupplicantInterface* iface;
+    gboolean busy;
+};
+
+typedef struct gsupplicant_scan_planner_policy {
+    guint flags;
+
+#define GSUPPLICANT_SCAN_PLANNER_NO_FALLBACK    (0x01)
+
+    GSUPPLICANT_SCAN_TYPE type;
+    guint max_channels;     /* Per partial scan, 0 for no limit */
+    guint max_age;          /* Seconds, 0 to never forget */
+    guint max_partial;      /* In a row, 0 for no limit */
+    guint timeout;          /* Whole pass, milliseconds, 0 for no limit */
+} GSupplicantScanPlannerPolicy;
+
+typedef struct gsupplicant_scan_planner_stats {
+    guint partial_scans;
+    guint full_scans;
+    guint fallbacks;        /* Partial scans which found nothing */
+    guint channels;         /* Total channels scanned by partial scans */
+    guint64 partial_time;   /* Microseconds */
+    guint64 full_time;      /* Microseconds */
+    guint64 time_saved;     /* Microseconds, estimated */
+} GSupplicantScanPlannerStats;
+
+typedef
+void
+(*GSupplicantScanPlannerFunc)(
+    GSupplicantScanPlanner* planner,
+    const GError* error,
+    gboolean full,          /* The last scan was a full one */
+    void* data);
+
+GSupplicantScanPlanner*
+gsupplicant_scan_planner_new(
+    GSupplicantInterface* iface);
+
+GSupplicantScanPlanner*
+gsupplicant_scan_planner_ref(
+    GSupplicantScanPlanner* planner);
+
+void
+gsupplicant_scan_planner_unref(
+    GSupplicantScanPlanner* planner);
+
+/* NULL policy restores the default one */
+void
+gsupplicant_scan_planner_set_policy(
+    GSupplicantScanPlanner* planner,
+    const GSupplicantScanPlannerPolicy* policy);
+
+const GSupplicantScanPlannerPolicy*
+gsupplicant_scan_planner_get_policy(
+    GSupplicantScanPlanner* planner);
+
+const GSupplicantScanPlannerStats*
+gsupplicant_scan_planner_get_stats(
+    GSupplicantScanPlanner* planner);
+
+/* Returns FALSE if the interface isn't valid or a scan is in progress */
+gboolean
+gsupplicant_scan_planner_scan(
+    GSupplicantScanPlanner* planner,
+    GSupplicantScanPlannerFunc fn,
+    void* data);
+
+/* The completion callback isn't invoked for the cancelled scan */
+void
+gsupplicant_scan_planner_cancel(
+    GSupplicantScanPlanner* planner);
+
+/* Forgets the channel history */
+void
+gsupplicant_scan_planner_reset(
+    GSupplicantScanPlanner* planner);
+
+/* Number of channels the next partial scan would cover */
+guint
+gsupplicant_scan_planner_channel_count(
+    GSupplicantScanPlanner* planner);
+
+G_END_DECLS
+
+#endif /* GSUPPLICANT_SCAN_PLANNER_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
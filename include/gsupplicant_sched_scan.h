@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GSUPPLICANT_SCHED_SCAN_H
+#define GSUPPLICANT_SCHED_SCAN_H
+
+#include <gsupplicant_types.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Scheduled scan plan, i.e. a sequence of (interval x iterations) steps
+ * which wpa_supplicant hands over to the firmware, if the driver supports
+ * scheduled scans. The last step repeats forever and is added with zero
+ * iterations. Nothing can be added after that.
+ *
+ * The frequencies, if any, are applied as FreqList which restricts all
+ * scans (not only the scheduled ones) while the plan is applied. The
+ * SSIDs to look for are taken from the configured networks, like for
+ * any other scheduled scan.
+ *
+ * Applying the plan remembers the previous configuration of the
+ * interface, reverting the plan restores it. Freeing the plan doesn't
+ * revert it.
+ *
+ * Since 1.0.31
+ */
+
+GSupplicantSchedScanPlan*
+gsupplicant_sched_scan_plan_new(
+    void);
+
+void
+gsupplicant_sched_scan_plan_free(
+    GSupplicantSchedScanPlan* plan);
+
+gboolean
+gsupplicant_sched_scan_plan_add_step(
+    GSupplicantSchedScanPlan* plan,
+    guint interval,         /* Seconds */
+    guint iterations);      /* Zero for the last step */
+
+gboolean
+gsupplicant_sched_scan_plan_add_frequency(
+    GSupplicantSchedScanPlan* plan,
+    guint frequency);       /* MHz */
+
+/* Offloading is enabled by default */
+void
+gsupplicant_sched_scan_plan_set_offload(
+    GSupplicantSchedScanPlan* plan,
+    gboolean enable);
+
+/* The plan is complete, i.e. ends with the step which repeats forever */
+gboolean
+gsupplicant_sched_scan_plan_is_valid(
+    const GSupplicantSchedScanPlan* plan);
+
+/* In SchedScanPlans format, NULL if the plan is not valid */
+char*
+gsupplicant_sched_scan_plan_to_string(
+    const GSupplicantSchedScanPlan* plan);
+
+gboolean
+gsupplicant_sched_scan_plan_apply(
+    GSupplicantSchedScanPlan* plan,
+    GSupplicantInterface* iface);
+
+gboolean
+gsupplicant_sched_scan_plan_revert(
+    GSupplicantSchedScanPlan* plan);
+
+G_END_DECLS
+
+#endif /* GSUPPLICANT_SCHED_SCAN_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GSUPPLICANT_SNAPSHOT_H
+#define GSUPPLICANT_SNAPSHOT_H
+
+#include <gsupplicant_types.h>
+#include <gsupplicant_bss.h>
+#include <gsupplicant_interface.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Immutable snapshots of the interface state and its set of BSSs.
+ * A new snapshot is published after each batch of property change
+ * signals emitted by the interface or by one of its BSSs. Snapshots
+ * are reference counted, never change once published and may be read
+ * and released on any thread. BSS snapshots which haven't changed are
+ * shared by consecutive interface snapshots.
+ *
+ * Only the BSSs for which GSupplicantBSS objects exist are included,
+ * in no particular order.
+ *
+ * Since 1.0.31
+ */
+
+typedef struct gsupplicant_bss_snapshot {
+    const char* path;
+    GBytes* bssid;
+    GBytes* ssid;
+    const char* ssid_str;
+    GSUPPLICANT_BSS_MODE mode;
+    GSUPPLICANT_KEYMGMT keymgmt;
+    gboolean privacy;
+    guint frequency;
+    guint maxrate;
+    gint signal;
+} GSupplicantBSSSnapshot;
+
+typedef struct gsupplicant_interface_snapshot {
+    const char* path;
+    guint serial;
+    gboolean valid;
+    gboolean present;
+    GSUPPLICANT_INTERFACE_STATE state;
+    gboolean scanning;
+    const char* current_bss;
+    const char* current_network;
+    const GSupplicantBSSSnapshot* current;  /* NULL if not known */
+    guint bss_count;
+    const GSupplicantBSSSnapshot* const* bss;
+} GSupplicantInterfaceSnapshot;
+
+/*
+ * Returns a new reference to the latest snapshot. May be called on any
+ * thread as long as the interface object is alive. Changes are collected
+ * and published from an idle callback on the context the interface is
+ * bound to, so the snapshot may briefly lag behind the object.
+ */
+const GSupplicantInterfaceSnapshot*
+gsupplicant_interface_get_snapshot(
+    GSupplicantInterface* iface);
+
+const GSupplicantInterfaceSnapshot*
+gsupplicant_interface_snapshot_ref(
+    const GSupplicantInterfaceSnapshot* snapshot);
+
+void
+gsupplicant_interface_snapshot_unref(
+    const GSupplicantInterfaceSnapshot* snapshot);
+
+const GSupplicantBSSSnapshot*
+gsupplicant_bss_snapshot_ref(
+    const GSupplicantBSSSnapshot* snapshot);
+
+void
+gsupplicant_bss_snapshot_unref(
+    const GSupplicantBSSSnapshot* snapshot);
+
+G_END_DECLS
+
+#endif /* GSUPPLICANT_SNAPSHOT_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -44,6 +44,11 @@ typedef struct gsupplicant              GSupplicant;
 typedef struct gsupplicant_bss          GSupplicantBSS;
 typedef struct gsupplicant_network      GSupplicantNetwork;
 typedef struct gsupplicant_interface    GSupplicantInterface;
+typedef struct gsupplicant_catalog      GSupplicantCatalog; /* Since 1.0.31 */
+typedef struct gsupplicant_scan_planner GSupplicantScanPlanner;
+typedef struct gsupplicant_sched_scan_plan GSupplicantSchedScanPlan;
+typedef struct gsupplicant_roam_profile GSupplicantRoamProfile;
+typedef struct gsupplicant_link_predictor GSupplicantLinkPredictor;
 
 typedef enum gsupplicant_cipher {
     GSUPPLICANT_CIPHER_INVALID          = (0x00000000),
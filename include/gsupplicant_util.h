@@ -46,6 +46,29 @@ char*
 gsupplicant_utf8_from_bytes(
     GBytes* bytes);
 
+/*
+ * Structured log sink for the messages carrying binary payload (SSIDs,
+ * BSSIDs, IEs and such). The payload is passed as is, without being
+ * formatted, and the message text doesn't include it. The sink is
+ * invoked regardless of the log level, on the thread which generated
+ * the message. Should be set before any GSupplicant objects are created.
+ *
+ * Since 1.0.31
+ */
+typedef
+void
+(*GSupplicantLogBytesFunc)(
+    const char* module,
+    int level,
+    const char* message,
+    GBytes* bytes,
+    void* data);
+
+void
+gsupplicant_log_set_bytes_func(
+    GSupplicantLogBytesFunc fn,
+    void* data); /* Since 1.0.31 */
+
 G_END_DECLS
 
 #endif /* GSUPPLICANT_UTIL_H */
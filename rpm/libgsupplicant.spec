@@ -9,10 +9,16 @@ Source: %{name}-%{version}.tar.bz2
 
 %define libglibutil_version 1.0.52
 
+# Static tracepoints, enabled with --with sdt
+%bcond_with sdt
+
 BuildRequires: pkgconfig
 BuildRequires: pkgconfig(glib-2.0)
 BuildRequires: pkgconfig(gio-2.0)
 BuildRequires: pkgconfig(libglibutil) >= %{libglibutil_version}
+%if %{with sdt}
+BuildRequires: systemtap-sdt-devel
+%endif
 
 # license macro requires rpm >= 4.11
 BuildRequires: pkgconfig(rpm)
@@ -36,14 +42,15 @@ This package contains the development library for %{name}.
 %setup -q
 
 %build
-make %{_smp_mflags} LIBDIR=%{_libdir} KEEP_SYMBOLS=1 release pkgconfig
+make %{_smp_mflags} LIBDIR=%{_libdir} KEEP_SYMBOLS=1 %{?with_sdt:SDT=1} \
+  release pkgconfig
 
 %install
 rm -rf %{buildroot}
 make LIBDIR=%{_libdir} DESTDIR=%{buildroot} install-dev
 
 %check
-make -C test test
+make -C test %{?with_sdt:SDT=1} test
 
 %post -p /sbin/ldconfig
 
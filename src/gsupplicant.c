@@ -33,14 +33,20 @@
 #define GLIB_DISABLE_DEPRECATION_WARNINGS /* G_ADD_PRIVATE */
 
 #include "gsupplicant.h"
+#include "gsupplicant_p.h"
+#include "gsupplicant_scan_coordinator_p.h"
 #include "gsupplicant_dbus.h"
 #include "gsupplicant_util_p.h"
 #include "gsupplicant_error.h"
+#include "gsupplicant_journal_p.h"
 #include "gsupplicant_log.h"
+#include "gsupplicant_trace.h"
 
 #include <gutil_strv.h>
 #include <gutil_misc.h>
 
+#include <stdlib.h>
+
 /* Generated headers */
 #include "fi.w1.wpa_supplicant1.h"
 
@@ -51,19 +57,36 @@ GLOG_MODULE_DEFINE("gsupplicant");
 enum gsupplicant_proxy_handler_id {
     PROXY_INTERFACE_ADDED,
     PROXY_INTERFACE_REMOVED,
-    PROXY_NOTIFY_NAME_OWNER,
     PROXY_NOTIFY_CAPABILITIES,
     PROXY_NOTIFY_EAP_METHODS,
     PROXY_NOTIFY_INTERFACES,
+#if GSUPPLICANT_TRACE_ENABLED
+    PROXY_TRACE_PROPERTIES_CHANGED,
+    PROXY_TRACE_PROPERTIES_CHANGED_DONE,
+#endif
     PROXY_HANDLER_COUNT
 };
 
+/* These are never blocked */
+enum gsupplicant_resync_handler_id {
+    RESYNC_PROPERTIES_CHANGED,
+    RESYNC_NOTIFY_NAME_OWNER,
+    RESYNC_HANDLER_COUNT
+};
+
 struct gsupplicant_priv {
+    GMainContext* context;
+    const char* path;       /* Interned, the registry key */
     GDBusConnection* bus;
     FiW1Wpa_supplicant1* proxy;
     guint32 pending_signals;
-    GStrV* interfaces;
+    GStrV* interfaces;      /* Interned */
     gulong proxy_handler_id[PROXY_HANDLER_COUNT];
+    gulong resync_handler_id[RESYNC_HANDLER_COUNT];
+    guint resync_timeout_ms;
+    GSource* resync_timer;  /* Non-NULL while resyncing */
+    GSupplicantScanCoordinator* scan_coordinator;
+    gboolean scan_coordinated;
 };
 
 typedef GObjectClass GSupplicantClass;
@@ -200,10 +223,58 @@ static const GSupNameIntPair gsupplicant_keymgmt_suites [] = {
     { "ft-sae-ext-key", GSUPPLICANT_KEYMGMT_FT_SAE_EXT_KEY }
 };
 
+/* key_mgmt values as they appear in the network configuration */
+static const GSupNameIntPair gsupplicant_keymgmt_names [] = {
+    { "NONE",           GSUPPLICANT_KEYMGMT_NONE },
+    { "WPA-PSK",        GSUPPLICANT_KEYMGMT_WPA_PSK },
+    { "FT-PSK",         GSUPPLICANT_KEYMGMT_WPA_FT_PSK },
+    { "WPA-PSK-SHA256", GSUPPLICANT_KEYMGMT_WPA_PSK_SHA256 },
+    { "WPA-EAP",        GSUPPLICANT_KEYMGMT_WPA_EAP },
+    { "FT-EAP",         GSUPPLICANT_KEYMGMT_WPA_FT_EAP },
+    { "WPA-EAP-SHA256", GSUPPLICANT_KEYMGMT_WPA_EAP_SHA256 },
+    { "IEEE8021X",      GSUPPLICANT_KEYMGMT_IEEE8021X },
+    { "WPA-NONE",       GSUPPLICANT_KEYMGMT_WPA_NONE },
+    { "WPS",            GSUPPLICANT_KEYMGMT_WPS },
+    { "SAE",            GSUPPLICANT_KEYMGMT_SAE },
+    { "SAE-EXT-KEY",    GSUPPLICANT_KEYMGMT_SAE_EXT_KEY },
+    { "FT-SAE",         GSUPPLICANT_KEYMGMT_FT_SAE },
+    { "FT-SAE-EXT-KEY", GSUPPLICANT_KEYMGMT_FT_SAE_EXT_KEY }
+};
+
 /*==========================================================================*
  * Implementation
  *==========================================================================*/
 
+static
+guint
+gsupplicant_parse_names(
+    const char* names,
+    const GSupNameIntPair* list,
+    gsize count)
+{
+    guint mask = 0;
+    if (names) {
+        const char* ptr = names;
+        while (*ptr) {
+            const char* end;
+            while (*ptr == ' ') ptr++;
+            for (end = ptr; *end && *end != ' '; end++);
+            if (end > ptr) {
+                /* All known names are short */
+                char buf[32];
+                const gsize len = end - ptr;
+                if (len < sizeof(buf)) {
+                    memcpy(buf, ptr, len);
+                    buf[len] = 0;
+                    gsupplicant_name_int_set_bits(&mask, buf, list, count);
+                }
+            }
+            ptr = end;
+        }
+    }
+    return mask;
+}
+
 static
 void
 gsupplicant_call_cancelled(
@@ -225,6 +296,8 @@ gsupplicant_call_finished(
     gpointer data)
 {
     GSupplicantCall* call = data;
+    GSUPPLICANT_TRACE4(call_done, "supplicant", GSUPPLICANT_PATH, call,
+        g_cancellable_is_cancelled(call->cancel));
     g_signal_handler_disconnect(call->cancel, call->cancel_id);
     if (!g_cancellable_is_cancelled(call->cancel)) {
         GASSERT(call->supplicant);
@@ -259,6 +332,7 @@ gsupplicant_call_new(
     call->finish = finish;
     call->fn.cb = cb;
     call->data = data;
+    GSUPPLICANT_TRACE3(call_start, "supplicant", GSUPPLICANT_PATH, call);
     return call;
 }
 
@@ -386,6 +460,8 @@ gsupplicant_emit_pending_signals(
 
     /* Handlers could drop their references to us */
     gsupplicant_ref(self);
+    GSUPPLICANT_TRACE3(emit_pending_signals, "supplicant", GSUPPLICANT_PATH,
+        priv->pending_signals);
 
     /* VALID is the last one to be emitted if we BECOME valid */
     if ((priv->pending_signals & SIGNAL_BIT(VALID)) && self->valid) {
@@ -412,6 +488,9 @@ gsupplicant_emit_pending_signals(
             SIGNAL_VALID_CHANGED, GSUPPLICANT_PROPERTY_VALID);
     }
 
+    GSUPPLICANT_TRACE2(emit_pending_signals_done, "supplicant",
+        GSUPPLICANT_PATH);
+
     /* And release the temporary reference */
     gsupplicant_unref(self);
 }
@@ -483,22 +562,13 @@ gsupplicant_update_interfaces(
      * returns shallow copy, i.e. the return result should be released
      * with g_free(), but the individual strings must not be modified. */
     if (!gutil_strv_equal((const GStrV*)interfaces, priv->interfaces)) {
-#if STRV_GETTERS_RETURN_SHALLOW_COPY
-        GStrV* ptr;
-        for (ptr = interfaces; *ptr; ptr++) {
-            *ptr = g_strdup(*ptr);
-        }
-#else
-        interfaces = g_strdupv(interfaces);
-#endif
-        g_strfreev(priv->interfaces);
-        self->interfaces = priv->interfaces = interfaces;
+        GStrV* iinterfaces = gsupplicant_intern_strv((const GStrV*)interfaces);
+        gsupplicant_intern_strv_free(priv->interfaces);
+        self->interfaces = priv->interfaces = iinterfaces;
         priv->pending_signals |= SIGNAL_BIT(INTERFACES);
     }
 #if STRV_GETTERS_RETURN_SHALLOW_COPY
-    else {
-        g_free(interfaces);
-    }
+    g_free(interfaces);
 #endif
 }
 
@@ -526,6 +596,77 @@ gsupplicant_update_eap_methods(
     }
 }
 
+static
+void
+gsupplicant_update_all(
+    GSupplicant* self)
+{
+    gsupplicant_update_name_owner(self);
+    gsupplicant_update_capabilities(self);
+    gsupplicant_update_eap_methods(self);
+    gsupplicant_update_interfaces(self);
+}
+
+/*
+ * Resync. When wpa_supplicant goes away and resync is enabled, the last
+ * known state is kept (and the proxy handlers are blocked) until either
+ * wpa_supplicant comes back or the resync timeout expires. Then the
+ * whole state gets re-read and only the actual changes are signalled.
+ * Interfaces, BSSs and networks do the same with their own proxies.
+ */
+static
+void
+gsupplicant_resync_finish(
+    GSupplicant* self)
+{
+    GSupplicantPriv* priv = self->priv;
+
+    g_source_destroy(priv->resync_timer);
+    g_source_unref(priv->resync_timer);
+    priv->resync_timer = NULL;
+    gsupplicant_unblock_handlers(priv->proxy, priv->proxy_handler_id,
+        G_N_ELEMENTS(priv->proxy_handler_id));
+    gsupplicant_update_all(self);
+    gsupplicant_emit_pending_signals(self);
+}
+
+static
+gboolean
+gsupplicant_resync_timeout(
+    gpointer data)
+{
+    GSupplicant* self = GSUPPLICANT(data);
+
+    GWARN("wpa_supplicant didn't come back in %u ms",
+        self->priv->resync_timeout_ms);
+    gsupplicant_resync_finish(self);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+gsupplicant_resync_properties_changed(
+    GDBusProxy* proxy,
+    GVariant* changed,
+    GStrv invalidated,
+    gpointer data)
+{
+    GSupplicant* self = GSUPPLICANT(data);
+    GSupplicantPriv* priv = self->priv;
+
+    /* This runs before the notify:: signals get emitted */
+    if (self->valid && priv->resync_timeout_ms && !priv->resync_timer &&
+        !gsupplicant_proxy_has_owner(proxy)) {
+        GDEBUG("wpa_supplicant is gone, resyncing");
+        gsupplicant_block_handlers(priv->proxy, priv->proxy_handler_id,
+            G_N_ELEMENTS(priv->proxy_handler_id));
+        priv->resync_timer = g_timeout_source_new(priv->resync_timeout_ms);
+        g_source_set_callback(priv->resync_timer, gsupplicant_resync_timeout,
+            self, NULL);
+        g_source_attach(priv->resync_timer, priv->context);
+    }
+}
+
 static
 void
 gsupplicant_notify_name_owner(
@@ -534,8 +675,15 @@ gsupplicant_notify_name_owner(
     gpointer data)
 {
     GSupplicant* self = GSUPPLICANT(data);
-    gsupplicant_update_name_owner(self);
-    gsupplicant_emit_pending_signals(self);
+    GSupplicantPriv* priv = self->priv;
+
+    if (!priv->resync_timer) {
+        gsupplicant_update_name_owner(self);
+        gsupplicant_emit_pending_signals(self);
+    } else if (gsupplicant_proxy_has_owner(G_DBUS_PROXY(proxy))) {
+        GDEBUG("wpa_supplicant is back");
+        gsupplicant_resync_finish(self);
+    }
 }
 
 static
@@ -584,13 +732,15 @@ gsupplicant_proxy_interface_added(
 {
     GSupplicant* self = GSUPPLICANT(data);
     GSupplicantPriv* priv = self->priv;
+    const char* ipath = gsupplicant_intern(path);
     GDEBUG("Interface added: %s", path);
-    if (!gutil_strv_contains(priv->interfaces, path)) {
+    if (!gsupplicant_intern_strv_contains(priv->interfaces, ipath)) {
         self->interfaces = priv->interfaces =
-            gutil_strv_add(priv->interfaces, path);
+            gsupplicant_intern_strv_add(priv->interfaces, ipath);
         priv->pending_signals |= SIGNAL_BIT(INTERFACES);
         gsupplicant_emit_pending_signals(self);
     }
+    gsupplicant_intern_unref(ipath);
 }
 
 static
@@ -602,16 +752,47 @@ gsupplicant_proxy_interface_removed(
 {
     GSupplicant* self = GSUPPLICANT(data);
     GSupplicantPriv* priv = self->priv;
-    const int pos = gutil_strv_find(priv->interfaces, path);
+    const int pos = gsupplicant_intern_strv_find(priv->interfaces,
+        gsupplicant_intern_find(path));
     GDEBUG("Interface removed: %s", path);
     if (pos >= 0) {
         self->interfaces = priv->interfaces =
-            gutil_strv_remove_at(priv->interfaces, pos, TRUE);
+            gsupplicant_intern_strv_remove_at(priv->interfaces, pos);
         priv->pending_signals |= SIGNAL_BIT(INTERFACES);
         gsupplicant_emit_pending_signals(self);
     }
 }
 
+#if GSUPPLICANT_TRACE_ENABLED
+/*
+ * The notify:: signals are emitted by the default handler of
+ * g-properties-changed, these two bracket the whole dispatch.
+ */
+static
+void
+gsupplicant_trace_properties_changed(
+    GDBusProxy* proxy,
+    GVariant* changed,
+    GStrv invalidated,
+    gpointer data)
+{
+    GSUPPLICANT_TRACE4(properties_changed, "supplicant", GSUPPLICANT_PATH,
+        changed, invalidated);
+}
+
+static
+void
+gsupplicant_trace_properties_changed_done(
+    GDBusProxy* proxy,
+    GVariant* changed,
+    GStrv invalidated,
+    gpointer data)
+{
+    GSUPPLICANT_TRACE2(properties_changed_done, "supplicant",
+        GSUPPLICANT_PATH);
+}
+#endif
+
 static
 void
 gsupplicant_proxy_created(
@@ -624,11 +805,19 @@ gsupplicant_proxy_created(
     GError* error = NULL;
     FiW1Wpa_supplicant1* proxy = fi_w1_wpa_supplicant1_proxy_new_finish(
         result, &error);
+    GSUPPLICANT_TRACE3(proxy_ready, "supplicant", GSUPPLICANT_PATH,
+        proxy != NULL);
     if (proxy) {
         GASSERT(!priv->proxy);
         GASSERT(!self->valid);
 
         priv->proxy = proxy;
+        priv->resync_handler_id[RESYNC_PROPERTIES_CHANGED] =
+            g_signal_connect(proxy, "g-properties-changed",
+            G_CALLBACK(gsupplicant_resync_properties_changed), self);
+        priv->resync_handler_id[RESYNC_NOTIFY_NAME_OWNER] =
+            g_signal_connect(proxy, "notify::g-name-owner",
+            G_CALLBACK(gsupplicant_notify_name_owner), self);
         priv->proxy_handler_id[PROXY_INTERFACE_ADDED] =
             g_signal_connect(proxy, "interface-added",
             G_CALLBACK(gsupplicant_proxy_interface_added), self);
@@ -636,9 +825,6 @@ gsupplicant_proxy_created(
             g_signal_connect(proxy, "interface-removed",
             G_CALLBACK(gsupplicant_proxy_interface_removed), self);
 
-        priv->proxy_handler_id[PROXY_NOTIFY_NAME_OWNER] =
-            g_signal_connect(priv->proxy, "notify::g-name-owner",
-            G_CALLBACK(gsupplicant_notify_name_owner), self);
         priv->proxy_handler_id[PROXY_NOTIFY_CAPABILITIES] =
             g_signal_connect(priv->proxy, "notify::capabilities",
             G_CALLBACK(gsupplicant_notify_capabilities), self);
@@ -648,11 +834,16 @@ gsupplicant_proxy_created(
         priv->proxy_handler_id[PROXY_NOTIFY_INTERFACES] =
             g_signal_connect(priv->proxy, "notify::interfaces",
             G_CALLBACK(gsupplicant_notify_interfaces), self);
+#if GSUPPLICANT_TRACE_ENABLED
+        priv->proxy_handler_id[PROXY_TRACE_PROPERTIES_CHANGED] =
+            g_signal_connect(priv->proxy, "g-properties-changed",
+            G_CALLBACK(gsupplicant_trace_properties_changed), self);
+        priv->proxy_handler_id[PROXY_TRACE_PROPERTIES_CHANGED_DONE] =
+            g_signal_connect_after(priv->proxy, "g-properties-changed",
+            G_CALLBACK(gsupplicant_trace_properties_changed_done), self);
+#endif
 
-        gsupplicant_update_name_owner(self);
-        gsupplicant_update_capabilities(self);
-        gsupplicant_update_eap_methods(self);
-        gsupplicant_update_interfaces(self);
+        gsupplicant_update_all(self);
         gsupplicant_emit_pending_signals(self);
     } else {
         GERR("%s", GERRMSG(error));
@@ -673,8 +864,20 @@ gsupplicant_bus_get_finished(
     GError* error = NULL;
     priv->bus = g_bus_get_finish(result, &error);
     if (priv->bus) {
+        static gsize gsupplicant_journal_checked = 0;
+
         GDEBUG("Bus connected");
+        if (g_once_init_enter(&gsupplicant_journal_checked)) {
+            const char* journal = getenv("GSUPPLICANT_JOURNAL");
+
+            if (journal && journal[0]) {
+                /* Errors are logged by gsupplicant_journal_start_on_bus */
+                gsupplicant_journal_start_on_bus(journal, priv->bus, NULL);
+            }
+            g_once_init_leave(&gsupplicant_journal_checked, 1);
+        }
         /* Start the initialization sequence */
+        GSUPPLICANT_TRACE2(proxy_new, "supplicant", GSUPPLICANT_PATH);
         fi_w1_wpa_supplicant1_proxy_new(priv->bus, G_DBUS_PROXY_FLAGS_NONE,
             GSUPPLICANT_SERVICE, GSUPPLICANT_PATH, NULL,
             gsupplicant_proxy_created, gsupplicant_ref(self));
@@ -692,18 +895,76 @@ gsupplicant_bus_get_finished(
 GSupplicant*
 gsupplicant_new()
 {
-    /* Weak reference to the single instance of GSupplicant */
-    static GSupplicant* gsupplicant_instance = NULL;
-    if (gsupplicant_instance) {
-        gsupplicant_ref(gsupplicant_instance);
-    } else {
-        gsupplicant_instance = g_object_new(GSUPPLICANT_TYPE, NULL);
+    /* Weak references to the instances of GSupplicant, one per context */
+    static GSupplicantRegistry gsupplicant_registry;
+    GSupplicant* self = gsupplicant_registry_get(&gsupplicant_registry,
+        GSUPPLICANT_PATH);
+
+    if (!self) {
+        GSupplicantPriv* priv;
+
+        self = g_object_new(GSUPPLICANT_TYPE, NULL);
+        priv = self->priv;
+        priv->context = g_main_context_ref_thread_default();
+        priv->path = gsupplicant_intern(GSUPPLICANT_PATH);
         g_bus_get(GSUPPLICANT_BUS_TYPE, NULL, gsupplicant_bus_get_finished,
-            gsupplicant_ref(gsupplicant_instance));
-        g_object_add_weak_pointer(G_OBJECT(gsupplicant_instance),
-            (gpointer*)(&gsupplicant_instance));
+            gsupplicant_ref(self));
+        gsupplicant_registry_add(&gsupplicant_registry, priv->path, self);
+    }
+    return self;
+}
+
+GMainContext*
+gsupplicant_get_context(
+    GSupplicant* self) /* Since 1.0.31 */
+{
+    return G_LIKELY(self) ? self->priv->context : NULL;
+}
+
+void
+gsupplicant_set_resync_timeout(
+    GSupplicant* self,
+    guint ms) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        self->priv->resync_timeout_ms = ms;
+    }
+}
+
+gboolean
+gsupplicant_resync_enabled(
+    GSupplicant* self)
+{
+    return G_LIKELY(self) && self->priv->resync_timeout_ms;
+}
+
+void
+gsupplicant_set_scan_policy(
+    GSupplicant* self,
+    const GSupplicantScanPolicy* policy) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        GSupplicantPriv* priv = self->priv;
+
+        /* Once created, it stays until the end to drain the queue */
+        if (!priv->scan_coordinator && policy) {
+            priv->scan_coordinator =
+                gsupplicant_scan_coordinator_new(priv->context);
+        }
+        if (priv->scan_coordinator) {
+            priv->scan_coordinated = (policy != NULL);
+            gsupplicant_scan_coordinator_set_policy(priv->scan_coordinator,
+                policy);
+        }
     }
-    return gsupplicant_instance;
+}
+
+GSupplicantScanCoordinator*
+gsupplicant_scan_coordinator(
+    GSupplicant* self)
+{
+    return (G_LIKELY(self) && self->priv->scan_coordinated) ?
+        self->priv->scan_coordinator : NULL;
 }
 
 GSupplicant*
@@ -937,6 +1198,22 @@ gsupplicant_parse_keymgmt_list(
         gsupplicant_keymgmt_suites, G_N_ELEMENTS(gsupplicant_keymgmt_suites));
 }
 
+GSUPPLICANT_KEYMGMT
+gsupplicant_parse_keymgmt_names(
+    const char* names)
+{
+    return gsupplicant_parse_names(names, gsupplicant_keymgmt_names,
+        G_N_ELEMENTS(gsupplicant_keymgmt_names));
+}
+
+GSUPPLICANT_EAP_METHOD
+gsupplicant_parse_eap_method_names(
+    const char* names)
+{
+    return gsupplicant_parse_names(names, gsupplicant_eap_methods,
+        G_N_ELEMENTS(gsupplicant_eap_methods));
+}
+
 /*==========================================================================*
  * Internals
  *==========================================================================*/
@@ -965,16 +1242,25 @@ gsupplicant_finalize(
     GSupplicant* self = GSUPPLICANT(object);
     GSupplicantPriv* priv = self->priv;
     GVERBOSE_("");
+    if (priv->resync_timer) {
+        g_source_destroy(priv->resync_timer);
+        g_source_unref(priv->resync_timer);
+    }
     if (priv->proxy) {
         gutil_disconnect_handlers(priv->proxy, priv->proxy_handler_id,
             G_N_ELEMENTS(priv->proxy_handler_id));
+        gutil_disconnect_handlers(priv->proxy, priv->resync_handler_id,
+            G_N_ELEMENTS(priv->resync_handler_id));
         g_object_unref(priv->proxy);
     }
     if (priv->bus) {
         g_dbus_connection_flush_sync(priv->bus, NULL, NULL);
         g_object_unref(priv->bus);
     }
-    g_strfreev(priv->interfaces);
+    gsupplicant_scan_coordinator_free(priv->scan_coordinator);
+    gsupplicant_intern_strv_free(priv->interfaces);
+    gsupplicant_intern_unref(priv->path);
+    g_main_context_unref(priv->context);
     G_OBJECT_CLASS(gsupplicant_parent_class)->finalize(object);
 }
 
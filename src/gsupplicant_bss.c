@@ -33,14 +33,16 @@
 #define GLIB_DISABLE_DEPRECATION_WARNINGS /* G_ADD_PRIVATE */
 
 #include "gsupplicant_bss.h"
+#include "gsupplicant.h"
 #include "gsupplicant_interface.h"
+#include "gsupplicant_interface_p.h"
 #include "gsupplicant_p.h"
 #include "gsupplicant_util_p.h"
 #include "gsupplicant_dbus.h"
 #include "gsupplicant_log.h"
+#include "gsupplicant_trace.h"
 
 #include <gutil_misc.h>
-#include <gutil_strv.h>
 
 #include <ctype.h>
 
@@ -60,23 +62,69 @@ enum supplicant_iface_handler_id {
     INTERFACE_HANDLER_COUNT
 };
 
+/* These are never blocked */
+enum supplicant_bss_resync_handler_id {
+    RESYNC_PROPERTIES_CHANGED,
+    RESYNC_NOTIFY_NAME_OWNER,
+    RESYNC_HANDLER_COUNT
+};
+
 typedef struct gsupplicant_bss_connect_data {
     GSupplicantBSS* bss;
     GSupplicantBSSStringResultFunc fn;
     void* fn_data;
 } GSupplicantBSSConnectData;
 
+#define BSS_ROAM_TIMEOUT_SEC    (10)
+
+enum supplicant_bss_roam_iface_handler_id {
+    ROAM_INTERFACE_VALID_CHANGED,
+    ROAM_INTERFACE_STATE_CHANGED,
+    ROAM_INTERFACE_CURRENT_BSS_CHANGED,
+    ROAM_INTERFACE_HANDLER_COUNT
+};
+
+typedef struct gsupplicant_bss_roam_data {
+    GSupplicantBSS* bss;
+    GCancellable* cancel;
+    gulong cancel_id;
+    gulong iface_handler_id[ROAM_INTERFACE_HANDLER_COUNT];
+    GSource* timeout;
+    gboolean submitted;     /* Roam() call has completed */
+    gint64 lost;            /* When the interface has left COMPLETED state */
+    gint64 done;            /* When it has reached COMPLETED with this BSS */
+    GSupplicantBSSRoamFunc fn;
+    void* fn_data;
+} GSupplicantBSSRoamData;
+
+/*
+ * BSSID, SSID and (usually) rates are stored inline. SSID strings are
+ * interned, i.e. shared by all BSSs of the same network. SSIDs consisting
+ * of printable ASCII characters (which is the vast majority of them)
+ * don't need a temporary UTF-8 conversion buffer either.
+ */
+#define BSS_BSSID_LEN           (6)
+#define BSS_SSID_MAX_LEN        (32)
+#define BSS_INLINE_RATES        (16)
+
 struct gsupplicant_bss_priv {
     FiW1Wpa_supplicant1BSS* proxy;
     gulong proxy_handler_id[PROXY_HANDLER_COUNT];
     gulong iface_handler_id[INTERFACE_HANDLER_COUNT];
-    char* path;
-    char* ssid_str;
+    gulong resync_handler_id[RESYNC_HANDLER_COUNT];
+    gboolean resyncing;
+    const char* path;       /* Interned */
+    const char* ssid_str;   /* Interned */
     GSupplicantBSSWPA wpa;
     GSupplicantBSSRSN rsn;
     GSupplicantUIntArray rates;
     guint* rates_values;
     guint32 pending_signals;
+    guint8 bssid_len;
+    guint8 ssid_len;
+    guint8 bssid_data[BSS_BSSID_LEN];
+    guint8 ssid_data[BSS_SSID_MAX_LEN];
+    guint rates_buf[BSS_INLINE_RATES];
 };
 
 typedef enum wps_methods {
@@ -136,7 +184,8 @@ G_DEFINE_TYPE(GSupplicantBSS, gsupplicant_bss, G_TYPE_OBJECT)
     p(FREQUENCY,frequency) \
     p(RATES,rates) \
     p(MAXRATE,maxrate) \
-    p(SIGNAL,signal)
+    p(SIGNAL,signal) \
+    p(AGE,age)
 
 typedef enum gsupplicant_bss_signal {
 #define SIGNAL_ENUM_(P,p) SIGNAL_##P##_CHANGED,
@@ -185,9 +234,10 @@ G_STATIC_ASSERT(G_N_ELEMENTS(gsupplicant_bss_signame) == SIGNAL_COUNT);
 #define PROXY_PROPERTY_NAME_SIGNAL      "Signal"
 #define PROXY_PROPERTY_NAME_FREQUENCY   "Frequency"
 #define PROXY_PROPERTY_NAME_RATES       "Rates"
+#define PROXY_PROPERTY_NAME_AGE         "Age"
 
-/* Weak references to the instances of GSupplicantBSS */
-static GHashTable* gsupplicant_bss_table = NULL;
+/* Weak references to the instances of GSupplicantBSS (per main context) */
+static GSupplicantRegistry gsupplicant_bss_registry;
 
 /*==========================================================================*
  * Implementation
@@ -237,6 +287,168 @@ gsupplicant_bss_connect_done(
     cp->fn(cp->bss, cancel, error, result, cp->fn_data);
 }
 
+static
+void
+gsupplicant_bss_roam_data_free(
+    GSupplicantBSSRoamData* roam)
+{
+    gsupplicant_interface_remove_all_handlers(roam->bss->iface,
+        roam->iface_handler_id);
+    if (roam->timeout) {
+        g_source_destroy(roam->timeout);
+        g_source_unref(roam->timeout);
+    }
+    if (roam->cancel_id) {
+        g_signal_handler_disconnect(roam->cancel, roam->cancel_id);
+    }
+    if (!roam->submitted) {
+        /* Roam() call is still pending, drop its completion */
+        g_cancellable_cancel(roam->cancel);
+    }
+    g_object_unref(roam->cancel);
+    gsupplicant_bss_unref(roam->bss);
+    g_slice_free(GSupplicantBSSRoamData, roam);
+}
+
+static
+void
+gsupplicant_bss_roam_cancelled(
+    GCancellable* cancel,
+    gpointer roam)
+{
+    gsupplicant_bss_roam_data_free(roam);
+}
+
+static
+void
+gsupplicant_bss_roam_finish(
+    GSupplicantBSSRoamData* roam,
+    const GError* error)
+{
+    GSupplicantBSS* bss = roam->bss;
+    if (error) {
+        GDEBUG("[%s] Roam failed: %s", bss->path, GERRMSG(error));
+    } else {
+        GDEBUG("[%s] Roamed in %d ms", bss->path, roam->lost ?
+            (int)((roam->done - roam->lost) / 1000) : 0);
+    }
+    if (roam->fn) {
+        if (roam->cancel_id) {
+            /* In case if callback calls g_cancellable_cancel() */
+            g_signal_handler_disconnect(roam->cancel, roam->cancel_id);
+            roam->cancel_id = 0;
+        }
+        roam->fn(bss, roam->cancel, error, (!error && roam->lost) ?
+            (roam->done - roam->lost) : 0, roam->fn_data);
+    }
+    gsupplicant_bss_roam_data_free(roam);
+}
+
+static
+void
+gsupplicant_bss_roam_error(
+    GSupplicantBSSRoamData* roam,
+    GIOErrorEnum code,
+    const char* message)
+{
+    GError* error = g_error_new_literal(G_IO_ERROR, code, message);
+    gsupplicant_bss_roam_finish(roam, error);
+    g_error_free(error);
+}
+
+static
+void
+gsupplicant_bss_roam_iface_changed(
+    GSupplicantInterface* iface,
+    void* data)
+{
+    GSupplicantBSSRoamData* roam = data;
+    if (!iface->valid) {
+        gsupplicant_bss_roam_error(roam, G_IO_ERROR_FAILED,
+            "Interface is gone");
+    } else if (iface->state != GSUPPLICANT_INTERFACE_STATE_COMPLETED) {
+        if (!roam->lost) {
+            roam->lost = g_get_monotonic_time();
+        }
+    } else if (!g_strcmp0(iface->current_bss, roam->bss->path)) {
+        if (!roam->done) {
+            roam->done = g_get_monotonic_time();
+        }
+        if (roam->submitted) {
+            gsupplicant_bss_roam_finish(roam, NULL);
+        }
+    } else if (roam->lost) {
+        /* Back to COMPLETED but not with this BSS */
+        gsupplicant_bss_roam_error(roam, G_IO_ERROR_FAILED,
+            "Associated with another BSS");
+    }
+}
+
+static
+void
+gsupplicant_bss_roam_submitted(
+    GSupplicantInterface* iface,
+    GCancellable* cancel,
+    const GError* error,
+    void* data)
+{
+    GSupplicantBSSRoamData* roam = data;
+    roam->submitted = TRUE;
+    if (error) {
+        gsupplicant_bss_roam_finish(roam, error);
+    } else if (roam->done) {
+        /* State change arrived before the reply */
+        gsupplicant_bss_roam_finish(roam, NULL);
+    }
+}
+
+static
+gboolean
+gsupplicant_bss_roam_timeout(
+    gpointer data)
+{
+    GSupplicantBSSRoamData* roam = data;
+    g_source_unref(roam->timeout);
+    roam->timeout = NULL;
+    gsupplicant_bss_roam_error(roam, G_IO_ERROR_TIMED_OUT, "Roam timed out");
+    return G_SOURCE_REMOVE;
+}
+
+static
+gboolean
+gsupplicant_bss_can_roam(
+    GSupplicantBSS* self)
+{
+    GSupplicantInterface* iface = self->iface;
+    if (self->valid && self->bssid && iface->valid &&
+        iface->state == GSUPPLICANT_INTERFACE_STATE_COMPLETED &&
+        iface->current_bss) {
+        GSupplicantBSS* current;
+        gboolean ok = FALSE;
+        if (!strcmp(iface->current_bss, self->path)) {
+            GDEBUG("[%s] Already associated", self->path);
+            return FALSE;
+        }
+        current = gsupplicant_registry_get(&gsupplicant_bss_registry,
+            iface->current_bss);
+        if (!current || !current->valid) {
+            GDEBUG("[%s] Current BSS %s is unknown", self->path,
+                iface->current_bss);
+        } else if (!current->ssid || !self->ssid ||
+            !g_bytes_equal(current->ssid, self->ssid)) {
+            GDEBUG("[%s] SSID mismatch", self->path);
+        } else if (gsupplicant_bss_security(current) !=
+            gsupplicant_bss_security(self)) {
+            GDEBUG("[%s] Security mismatch", self->path);
+        } else {
+            ok = TRUE;
+        }
+        gsupplicant_bss_unref(current);
+        return ok;
+    }
+    return FALSE;
+}
+
 static
 void
 gsupplicant_bss_fill_network_params(
@@ -328,11 +540,14 @@ gsupplicant_bss_emit_pending_signals(
     GSupplicantBSS* self)
 {
     GSupplicantBSSPriv* priv = self->priv;
+    const guint32 pending = priv->pending_signals;
     GSUPPLICANT_BSS_SIGNAL sig;
     gboolean valid_changed;
 
     /* Handlers could drops their references to us */
     gsupplicant_bss_ref(self);
+    GSUPPLICANT_TRACE3(emit_pending_signals, "bss", self->path,
+        priv->pending_signals);
 
     /* VALID is the last one to be emitted if we BECOME valid */
     if ((priv->pending_signals & SIGNAL_BIT(VALID)) && self->valid) {
@@ -359,6 +574,13 @@ gsupplicant_bss_emit_pending_signals(
             GSUPPLICANT_BSS_PROPERTY_VALID);
     }
 
+    GSUPPLICANT_TRACE2(emit_pending_signals_done, "bss", self->path);
+
+    /* Update the interface snapshot */
+    if (pending) {
+        gsupplicant_interface_bss_changed(self->iface, self);
+    }
+
     /* And release the temporary reference */
     gsupplicant_bss_unref(self);
 }
@@ -395,6 +617,37 @@ gsupplicant_bss_get_bytes(
     return NULL;
 }
 
+/*
+ * Returns a reference to the cached bytestring property (to be released
+ * by the caller) and points data/size to its contents. Doesn't allocate
+ * any memory.
+ */
+static
+GVariant*
+gsupplicant_bss_get_bytestring(
+    GSupplicantBSS* self,
+    const char* name,
+    const guint8** data,
+    gsize* size)
+{
+    GSupplicantBSSPriv* priv = self->priv;
+    if (priv->proxy) {
+        GDBusProxy *proxy = G_DBUS_PROXY(priv->proxy);
+        GVariant* var = g_dbus_proxy_get_cached_property(proxy, name);
+        if (var) {
+            if (g_variant_is_of_type(var, G_VARIANT_TYPE_BYTESTRING)) {
+                *size = 0;
+                *data = g_variant_get_fixed_array(var, size, 1);
+                return var;
+            }
+            g_variant_unref(var);
+        }
+    }
+    *data = NULL;
+    *size = 0;
+    return NULL;
+}
+
 static
 void
 gsupplicant_bss_update_valid(
@@ -416,7 +669,7 @@ gsupplicant_bss_update_present(
 {
     GSupplicantBSSPriv* priv = self->priv;
     const gboolean present = priv->proxy && self->iface->valid &&
-        gutil_strv_contains(self->iface->bsss, priv->path);
+        gsupplicant_intern_strv_contains(self->iface->bsss, priv->path);
     if (self->present != present) {
         self->present = present;
         GDEBUG("BSS %s is %spresent", priv->path, present ? "" : "not ");
@@ -426,31 +679,105 @@ gsupplicant_bss_update_present(
 
 static
 void
-gsupplicant_bss_update_ssid(
+gsupplicant_bss_clear_ssid(
+    GSupplicantBSS* self)
+{
+    GSupplicantBSSPriv* priv = self->priv;
+    if (self->ssid) {
+        g_bytes_unref(self->ssid);
+        gsupplicant_intern_unref(priv->ssid_str);
+        self->ssid = NULL;
+        self->ssid_str = priv->ssid_str = NULL;
+        priv->ssid_len = 0;
+        priv->pending_signals |= SIGNAL_BIT(SSID);
+    }
+}
+
+static
+void
+gsupplicant_bss_update_ssid_str(
     GSupplicantBSS* self)
 {
     GSupplicantBSSPriv* priv = self->priv;
-    GBytes* ssid = gsupplicant_bss_get_bytes(self, PROXY_PROPERTY_NAME_SSID);
-    if (!gsupplicant_bss_bytes_equal(self->ssid, ssid)) {
-        if (self->ssid) {
-            g_bytes_unref(self->ssid);
+    const guint8* data = priv->ssid_data;
+    const guint len = priv->ssid_len;
+    const char* ssid_str;
+    guint i, nuls = 0;
+    gboolean ascii = TRUE;
+
+    /* Note that gsupplicant_utf8_from_bytes() turns all zeros into "" */
+    for (i = 0; i < len && ascii; i++) {
+        if (!data[i]) {
+            nuls++;
+        } else if (data[i] >= 0x80) {
+            ascii = FALSE;
         }
-        g_free(priv->ssid_str);
-        if (ssid) {
-            priv->ssid_str = gsupplicant_utf8_from_bytes(ssid);
-            GDEBUG("[%s] " PROXY_PROPERTY_NAME_SSID ": %s \"%s\"",
-                self->path, gsupplicant_format_bytes(ssid, FALSE),
-                priv->ssid_str);
-        } else {
-            priv->ssid_str = NULL;
-            GDEBUG("[%s] " PROXY_PROPERTY_NAME_SSID ": %s",
-                self->path, gsupplicant_format_bytes(ssid, FALSE));
+    }
+    if (ascii && (!nuls || nuls == len)) {
+        char buf[BSS_SSID_MAX_LEN + 1];
+        const guint n = nuls ? 0 : len;
+        memcpy(buf, data, n);
+        buf[n] = 0;
+        ssid_str = gsupplicant_intern(buf);
+    } else {
+        char* utf8 = gsupplicant_utf8_from_bytes(self->ssid);
+        ssid_str = gsupplicant_intern(utf8);
+        g_free(utf8);
+    }
+    gsupplicant_intern_unref(priv->ssid_str);
+    self->ssid_str = priv->ssid_str = ssid_str;
+}
+
+static
+void
+gsupplicant_bss_update_ssid(
+    GSupplicantBSS* self)
+{
+    GSupplicantBSSPriv* priv = self->priv;
+    const guint8* data;
+    gsize len;
+    GVariant* var = gsupplicant_bss_get_bytestring(self,
+        PROXY_PROPERTY_NAME_SSID, &data, &len);
+    if (var && len > sizeof(priv->ssid_data)) {
+        /* Not a valid 802.11 SSID, keep the old one */
+        GWARN("[%s] Rejecting " PROXY_PROPERTY_NAME_SSID " (%u bytes)",
+            self->path, (guint)len);
+        g_variant_unref(var);
+    } else if (var) {
+        if (!self->ssid || priv->ssid_len != len ||
+            memcmp(priv->ssid_data, data, len)) {
+            if (self->ssid) {
+                g_bytes_unref(self->ssid);
+            }
+            memcpy(priv->ssid_data, data, len);
+            priv->ssid_len = (guint8)len;
+            self->ssid = gsupplicant_variant_data_as_bytes(var);
+            gsupplicant_bss_update_ssid_str(self);
+            GDEBUG_BYTES(self->ssid, FALSE, "[%s] " PROXY_PROPERTY_NAME_SSID
+                " \"%s\":", self->path, self->ssid_str);
+            priv->pending_signals |= SIGNAL_BIT(SSID);
         }
-        self->ssid_str = priv->ssid_str;
-        self->ssid = ssid;
-        priv->pending_signals |= SIGNAL_BIT(SSID);
-    } else if (ssid) {
-        g_bytes_unref(ssid);
+        g_variant_unref(var);
+    } else if (self->ssid) {
+        gsupplicant_bss_clear_ssid(self);
+        GDEBUG("[%s] " PROXY_PROPERTY_NAME_SSID ": %s", self->path,
+            gsupplicant_format_bytes(NULL, FALSE));
+    }
+}
+
+static
+void
+gsupplicant_bss_clear_bssid(
+    GSupplicantBSS* self)
+{
+    GSupplicantBSSPriv* priv = self->priv;
+    GBytes* old_bssid = self->bssid;
+    if (old_bssid) {
+        self->bssid = NULL;
+        priv->bssid_len = 0;
+        gsupplicant_interface_bss_bssid_changed(self->iface, self, old_bssid);
+        g_bytes_unref(old_bssid);
+        priv->pending_signals |= SIGNAL_BIT(BSSID);
     }
 }
 
@@ -460,17 +787,36 @@ gsupplicant_bss_update_bssid(
     GSupplicantBSS* self)
 {
     GSupplicantBSSPriv* priv = self->priv;
-    GBytes* bssid = gsupplicant_bss_get_bytes(self, PROXY_PROPERTY_NAME_BSSID);
-    if (!gsupplicant_bss_bytes_equal(self->bssid, bssid)) {
-        if (self->bssid) {
-            g_bytes_unref(self->bssid);
+    const guint8* data;
+    gsize len;
+    GVariant* var = gsupplicant_bss_get_bytestring(self,
+        PROXY_PROPERTY_NAME_BSSID, &data, &len);
+    if (var && len > sizeof(priv->bssid_data)) {
+        /* Not a valid 802.11 BSSID, keep the old one */
+        GWARN("[%s] Rejecting " PROXY_PROPERTY_NAME_BSSID " (%u bytes)",
+            self->path, (guint)len);
+        g_variant_unref(var);
+    } else if (var) {
+        if (!self->bssid || priv->bssid_len != len ||
+            memcmp(priv->bssid_data, data, len)) {
+            GBytes* old_bssid = self->bssid;
+            memcpy(priv->bssid_data, data, len);
+            priv->bssid_len = (guint8)len;
+            self->bssid = gsupplicant_variant_data_as_bytes(var);
+            gsupplicant_interface_bss_bssid_changed(self->iface, self,
+                old_bssid);
+            if (old_bssid) {
+                g_bytes_unref(old_bssid);
+            }
+            GDEBUG_BYTES(self->bssid, FALSE, "[%s] "
+                PROXY_PROPERTY_NAME_BSSID ":", self->path);
+            priv->pending_signals |= SIGNAL_BIT(BSSID);
         }
-        self->bssid = bssid;
-        GDEBUG("[%s] " PROXY_PROPERTY_NAME_BSSID ": %s",
-            self->path, gsupplicant_format_bytes(bssid, FALSE));
-        priv->pending_signals |= SIGNAL_BIT(BSSID);
-    } else if (bssid) {
-        g_bytes_unref(bssid);
+        g_variant_unref(var);
+    } else if (self->bssid) {
+        gsupplicant_bss_clear_bssid(self);
+        GDEBUG("[%s] " PROXY_PROPERTY_NAME_BSSID ": %s", self->path,
+            gsupplicant_format_bytes(NULL, FALSE));
     }
 }
 
@@ -722,8 +1068,8 @@ gsupplicant_bss_update_ies(
             g_bytes_unref(self->ies);
         }
         self->ies = ies;
-        GVERBOSE("[%s] " PROXY_PROPERTY_NAME_IES ": %s",
-            self->path, gsupplicant_format_bytes(ies, FALSE));
+        GVERBOSE_BYTES(ies, FALSE, "[%s] " PROXY_PROPERTY_NAME_IES ":",
+            self->path);
         priv->pending_signals |= SIGNAL_BIT(IES);
         if (self->wps_caps != wps_caps) {
             self->wps_caps = wps_caps;
@@ -788,6 +1134,42 @@ gsupplicant_bss_update_signal(
     }
 }
 
+/*
+ * Age is the number of seconds since wpa_supplicant has last seen the
+ * BSS, at the time of the update. It gets converted into the monotonic
+ * last_seen timestamp. If wpa_supplicant doesn't provide Age, any
+ * update of the scan data counts as seeing the BSS.
+ *
+ * Note that wpa_supplicant doesn't signal Age changes on their own,
+ * only together with other BSS properties. If a scan sees the BSS
+ * without anything else having changed, last_seen stays where it was,
+ * i.e. it's the lower bound of the actual time.
+ */
+static
+void
+gsupplicant_bss_update_age(
+    GSupplicantBSS* self)
+{
+    GSupplicantBSSPriv* priv = self->priv;
+    const gint64 now = g_get_monotonic_time();
+    GVariant* var = g_dbus_proxy_get_cached_property(G_DBUS_PROXY
+        (priv->proxy), PROXY_PROPERTY_NAME_AGE);
+
+    if (var) {
+        const guint age = g_variant_get_uint32(var);
+
+        self->last_seen = now - age * G_TIME_SPAN_SECOND;
+        if (self->age != age) {
+            self->age = age;
+            GVERBOSE("[%s] %s: %u", self->path, PROXY_PROPERTY_NAME_AGE, age);
+            priv->pending_signals |= SIGNAL_BIT(AGE);
+        }
+        g_variant_unref(var);
+    } else {
+        self->last_seen = now;
+    }
+}
+
 static
 void
 gsupplicant_bss_update_frequency(
@@ -796,7 +1178,10 @@ gsupplicant_bss_update_frequency(
     GSupplicantBSSPriv* priv = self->priv;
     const guint f = fi_w1_wpa_supplicant1_bss_get_frequency(priv->proxy);
     if (self->frequency != f) {
+        const guint old_frequency = self->frequency;
         self->frequency = f;
+        gsupplicant_interface_bss_frequency_changed(self->iface, self,
+            old_frequency);
         GVERBOSE("[%s] %s: %u", self->path, PROXY_PROPERTY_NAME_FREQUENCY, f);
         priv->pending_signals |= SIGNAL_BIT(FREQUENCY);
     }
@@ -843,10 +1228,16 @@ gsupplicant_bss_update_rates(
                 memcmp(priv->rates.values, values, sizeof(guint)*n)) {
                 guint i, maxrate = 0;
 
-                /* Store the rates */
+                /* Store the rates (inline, if they fit) */
                 g_free(priv->rates_values);
-                priv->rates_values = gutil_memdup(values, sizeof(guint)*n);
-                priv->rates.values = priv->rates_values;
+                if (n <= G_N_ELEMENTS(priv->rates_buf)) {
+                    priv->rates_values = NULL;
+                    memcpy(priv->rates_buf, values, sizeof(guint)*n);
+                    priv->rates.values = priv->rates_buf;
+                } else {
+                    priv->rates_values = gutil_memdup(values, sizeof(guint)*n);
+                    priv->rates.values = priv->rates_values;
+                }
                 priv->rates.count = n;
                 self->rates = &priv->rates;
                 priv->pending_signals |= SIGNAL_BIT(RATES);
@@ -895,24 +1286,16 @@ gsupplicant_bss_proxy_gproperties_changed(
 {
     GSupplicantBSS* self = GSUPPLICANT_BSS(data);
     GSupplicantBSSPriv* priv = self->priv;
+    GSUPPLICANT_TRACE4(properties_changed, "bss", self->path, changed,
+        invalidated);
     if (invalidated) {
         char** ptr;
         for (ptr = invalidated; *ptr; ptr++) {
             const char* name = *ptr;
             if (!strcmp(name, PROXY_PROPERTY_NAME_SSID)) {
-                if (self->ssid) {
-                    g_bytes_unref(self->ssid);
-                    g_free(priv->ssid_str);
-                    self->ssid = NULL;
-                    self->ssid_str = priv->ssid_str = NULL;
-                    priv->pending_signals |= SIGNAL_BIT(SSID);
-                }
+                gsupplicant_bss_clear_ssid(self);
             } else if (!strcmp(name, PROXY_PROPERTY_NAME_BSSID)) {
-                if (self->bssid) {
-                    g_bytes_unref(self->bssid);
-                    self->bssid = NULL;
-                    priv->pending_signals |= SIGNAL_BIT(BSSID);
-                }
+                gsupplicant_bss_clear_bssid(self);
             } else if (!strcmp(name, PROXY_PROPERTY_NAME_WPA)) {
                 if (self->wpa) {
                     self->wpa = NULL;
@@ -946,15 +1329,18 @@ gsupplicant_bss_proxy_gproperties_changed(
                 }
             } else if (!strcmp(name, PROXY_PROPERTY_NAME_FREQUENCY)) {
                 if (self->frequency) {
+                    const guint old_frequency = self->frequency;
                     self->frequency = 0;
+                    gsupplicant_interface_bss_frequency_changed(self->iface,
+                        self, old_frequency);
                     priv->pending_signals |= SIGNAL_BIT(FREQUENCY);
                 }
             } else if (!strcmp(name, PROXY_PROPERTY_NAME_RATES)) {
                 gsupplicant_bss_clear_rates(self);
-            } else if (!strcmp(name, PROXY_PROPERTY_NAME_FREQUENCY)) {
-                if (self->frequency) {
-                    self->frequency = 0;
-                    priv->pending_signals |= SIGNAL_BIT(FREQUENCY);
+            } else if (!strcmp(name, PROXY_PROPERTY_NAME_AGE)) {
+                if (self->age) {
+                    self->age = 0;
+                    priv->pending_signals |= SIGNAL_BIT(AGE);
                 }
             }
         }
@@ -988,8 +1374,13 @@ gsupplicant_bss_proxy_gproperties_changed(
             }
             g_variant_unref(value);
         }
+        if (g_variant_n_children(changed)) {
+            /* Age may or may not be there */
+            gsupplicant_bss_update_age(self);
+        }
     }
     gsupplicant_bss_emit_pending_signals(self);
+    GSUPPLICANT_TRACE2(properties_changed_done, "bss", self->path);
 }
 
 static
@@ -1002,6 +1393,76 @@ gsupplicant_bss_proxy_properties_changed(
     gsupplicant_bss_proxy_gproperties_changed(proxy, change, NULL, data);
 }
 
+static
+void
+gsupplicant_bss_update_all(
+    GSupplicantBSS* self)
+{
+    gsupplicant_bss_update_valid(self);
+    gsupplicant_bss_update_present(self);
+    gsupplicant_bss_update_ssid(self);
+    gsupplicant_bss_update_bssid(self);
+    gsupplicant_bss_update_wpa(self);
+    gsupplicant_bss_update_rsn(self);
+    gsupplicant_bss_update_ies(self);
+    gsupplicant_bss_update_privacy(self);
+    gsupplicant_bss_update_mode(self);
+    gsupplicant_bss_update_frequency(self);
+    gsupplicant_bss_update_rates(self);
+    gsupplicant_bss_update_signal(self);
+    gsupplicant_bss_update_age(self);
+}
+
+/* See the resync comment in gsupplicant.c */
+static
+void
+gsupplicant_bss_resync_finish(
+    GSupplicantBSS* self)
+{
+    GSupplicantBSSPriv* priv = self->priv;
+
+    priv->resyncing = FALSE;
+    gsupplicant_unblock_handlers(priv->proxy, priv->proxy_handler_id,
+        G_N_ELEMENTS(priv->proxy_handler_id));
+    gsupplicant_bss_update_all(self);
+}
+
+static
+void
+gsupplicant_bss_resync_properties_changed(
+    GDBusProxy* proxy,
+    GVariant* changed,
+    GStrv invalidated,
+    gpointer data)
+{
+    GSupplicantBSS* self = GSUPPLICANT_BSS(data);
+    GSupplicantBSSPriv* priv = self->priv;
+
+    if (!priv->resyncing &&
+        gsupplicant_resync_enabled(self->iface->supplicant) &&
+        self->iface->valid && !gsupplicant_proxy_has_owner(proxy)) {
+        GDEBUG("[%s] Resyncing", self->path);
+        priv->resyncing = TRUE;
+        gsupplicant_block_handlers(priv->proxy, priv->proxy_handler_id,
+            G_N_ELEMENTS(priv->proxy_handler_id));
+    }
+}
+
+static
+void
+gsupplicant_bss_resync_notify_name_owner(
+    GDBusProxy* proxy,
+    GParamSpec* param,
+    gpointer data)
+{
+    GSupplicantBSS* self = GSUPPLICANT_BSS(data);
+
+    if (self->priv->resyncing && gsupplicant_proxy_has_owner(proxy)) {
+        gsupplicant_bss_resync_finish(self);
+        gsupplicant_bss_emit_pending_signals(self);
+    }
+}
+
 static
 void
 gsupplicant_bss_interface_valid_changed(
@@ -1010,8 +1471,13 @@ gsupplicant_bss_interface_valid_changed(
 {
     GSupplicantBSS* self = GSUPPLICANT_BSS(data);
     GASSERT(self->iface == iface);
-    gsupplicant_bss_update_valid(self);
-    gsupplicant_bss_update_present(self);
+    if (self->priv->resyncing) {
+        /* The interface has given up waiting */
+        gsupplicant_bss_resync_finish(self);
+    } else {
+        gsupplicant_bss_update_valid(self);
+        gsupplicant_bss_update_present(self);
+    }
     gsupplicant_bss_emit_pending_signals(self);
 }
 
@@ -1041,7 +1507,14 @@ gsupplicant_bss_proxy_created(
     GASSERT(!priv->proxy);
     priv->proxy = fi_w1_wpa_supplicant1_bss_proxy_new_for_bus_finish(result,
         &error);
+    GSUPPLICANT_TRACE3(proxy_ready, "bss", self->path, priv->proxy != NULL);
     if (priv->proxy) {
+        priv->resync_handler_id[RESYNC_PROPERTIES_CHANGED] =
+            g_signal_connect(priv->proxy, "g-properties-changed",
+            G_CALLBACK(gsupplicant_bss_resync_properties_changed), self);
+        priv->resync_handler_id[RESYNC_NOTIFY_NAME_OWNER] =
+            g_signal_connect(priv->proxy, "notify::g-name-owner",
+            G_CALLBACK(gsupplicant_bss_resync_notify_name_owner), self);
         priv->proxy_handler_id[PROXY_GPROPERTIES_CHANGED] =
             g_signal_connect(priv->proxy, "g-properties-changed",
             G_CALLBACK(gsupplicant_bss_proxy_gproperties_changed), self);
@@ -1058,19 +1531,7 @@ gsupplicant_bss_proxy_created(
                 GSUPPLICANT_INTERFACE_PROPERTY_BSSS,
                 gsupplicant_bss_interface_bsss_changed, self);
 
-        gsupplicant_bss_update_valid(self);
-        gsupplicant_bss_update_present(self);
-        gsupplicant_bss_update_ssid(self);
-        gsupplicant_bss_update_bssid(self);
-        gsupplicant_bss_update_wpa(self);
-        gsupplicant_bss_update_rsn(self);
-        gsupplicant_bss_update_ies(self);
-        gsupplicant_bss_update_privacy(self);
-        gsupplicant_bss_update_mode(self);
-        gsupplicant_bss_update_frequency(self);
-        gsupplicant_bss_update_rates(self);
-        gsupplicant_bss_update_signal(self);
-
+        gsupplicant_bss_update_all(self);
         gsupplicant_bss_emit_pending_signals(self);
     } else {
         GERR("%s", GERRMSG(error));
@@ -1079,24 +1540,6 @@ gsupplicant_bss_proxy_created(
     gsupplicant_bss_unref(self);
 }
 
-static
-void
-gsupplicant_bss_destroyed(
-    gpointer key,
-    GObject* dead)
-{
-    GVERBOSE_("%s", (char*)key);
-    GASSERT(gsupplicant_bss_table);
-    if (gsupplicant_bss_table) {
-        GASSERT(g_hash_table_lookup(gsupplicant_bss_table, key) == dead);
-        g_hash_table_remove(gsupplicant_bss_table, key);
-        if (g_hash_table_size(gsupplicant_bss_table) == 0) {
-            g_hash_table_unref(gsupplicant_bss_table);
-            gsupplicant_bss_table = NULL;
-        }
-    }
-}
-
 static
 GSupplicantBSS*
 gsupplicant_bss_create(
@@ -1122,25 +1565,21 @@ gsupplicant_bss_create(
     }
     if (ptr > path) {
         GSupplicantInterface* iface;
-        char* path2 = g_strdup(path);
-        /* Temporarily shorten the path to lookup the interface */
-        const gsize slash_index = ptr - path;
-        path2[slash_index] = 0;
+        char* path2 = g_strndup(path, ptr - path);
         GDEBUG_("%s -> %s", path, path2);
         iface = gsupplicant_interface_new(path2);
+        g_free(path2);
         if (iface) {
             GSupplicantBSS* self = g_object_new(GSUPPLICANT_BSS_TYPE,NULL);
             GSupplicantBSSPriv* priv = self->priv;
-            /* Path is already allocated (but truncated) */
-            path2[slash_index] = '/';
-            self->path = priv->path = path2;
+            self->path = priv->path = gsupplicant_intern(path);
             self->iface = iface;
+            GSUPPLICANT_TRACE2(proxy_new, "bss", self->path);
             fi_w1_wpa_supplicant1_bss_proxy_new_for_bus(GSUPPLICANT_BUS_TYPE,
                 G_DBUS_PROXY_FLAGS_NONE, GSUPPLICANT_SERVICE, self->path, NULL,
                 gsupplicant_bss_proxy_created, gsupplicant_bss_ref(self));
             return self;
         }
-        g_free(path2);
     }
     return NULL;
 }
@@ -1155,21 +1594,12 @@ gsupplicant_bss_new(
 {
     GSupplicantBSS* self = NULL;
     if (G_LIKELY(path)) {
-        self = gsupplicant_bss_table ?
-            gsupplicant_bss_ref(g_hash_table_lookup(gsupplicant_bss_table,
-            path)) : NULL;
+        self = gsupplicant_registry_get(&gsupplicant_bss_registry, path);
         if (!self) {
             self = gsupplicant_bss_create(path);
             if (self) {
-                gpointer key = g_strdup(path);
-                if (!gsupplicant_bss_table) {
-                    gsupplicant_bss_table =
-                        g_hash_table_new_full(g_str_hash, g_str_equal,
-                            g_free, NULL);
-                }
-                g_hash_table_replace(gsupplicant_bss_table, key, self);
-                g_object_weak_ref(G_OBJECT(self), gsupplicant_bss_destroyed,
-                    key);
+                gsupplicant_registry_add(&gsupplicant_bss_registry,
+                    self->path, self);
             }
         }
     }
@@ -1333,6 +1763,42 @@ gsupplicant_bss_pairwise(
     return pairwise;
 }
 
+const guint8*
+gsupplicant_bss_bssid_data(
+    GSupplicantBSS* self,
+    gsize* size) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && self->bssid) {
+        GSupplicantBSSPriv* priv = self->priv;
+        if (size) {
+            *size = priv->bssid_len;
+        }
+        return priv->bssid_data;
+    }
+    if (size) {
+        *size = 0;
+    }
+    return NULL;
+}
+
+const guint8*
+gsupplicant_bss_ssid_data(
+    GSupplicantBSS* self,
+    gsize* size) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && self->ssid) {
+        GSupplicantBSSPriv* priv = self->priv;
+        if (size) {
+            *size = priv->ssid_len;
+        }
+        return priv->ssid_data;
+    }
+    if (size) {
+        *size = 0;
+    }
+    return NULL;
+}
+
 GCancellable*
 gsupplicant_bss_connect(
     GSupplicantBSS* self,
@@ -1366,6 +1832,51 @@ gsupplicant_bss_connect(
     return NULL;
 }
 
+GCancellable*
+gsupplicant_bss_roam(
+    GSupplicantBSS* self,
+    GSupplicantBSSRoamFunc fn,
+    void* data) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && gsupplicant_bss_can_roam(self)) {
+        GSupplicantInterface* iface = self->iface;
+        GSupplicantBSSRoamData* roam = g_slice_new0(GSupplicantBSSRoamData);
+        GCancellable* cancel = gsupplicant_interface_roam(iface,
+            gsupplicant_format_bytes(self->bssid, FALSE),
+            gsupplicant_bss_roam_submitted, roam);
+
+        if (cancel) {
+            roam->bss = gsupplicant_bss_ref(self);
+            roam->cancel = g_object_ref(cancel);
+            roam->cancel_id = g_signal_connect(cancel, "cancelled",
+                G_CALLBACK(gsupplicant_bss_roam_cancelled), roam);
+            roam->fn = fn;
+            roam->fn_data = data;
+            roam->iface_handler_id[ROAM_INTERFACE_VALID_CHANGED] =
+                gsupplicant_interface_add_handler(iface,
+                    GSUPPLICANT_INTERFACE_PROPERTY_VALID,
+                    gsupplicant_bss_roam_iface_changed, roam);
+            roam->iface_handler_id[ROAM_INTERFACE_STATE_CHANGED] =
+                gsupplicant_interface_add_handler(iface,
+                    GSUPPLICANT_INTERFACE_PROPERTY_STATE,
+                    gsupplicant_bss_roam_iface_changed, roam);
+            roam->iface_handler_id[ROAM_INTERFACE_CURRENT_BSS_CHANGED] =
+                gsupplicant_interface_add_handler(iface,
+                    GSUPPLICANT_INTERFACE_PROPERTY_CURRENT_BSS,
+                    gsupplicant_bss_roam_iface_changed, roam);
+            roam->timeout = g_timeout_source_new_seconds
+                (BSS_ROAM_TIMEOUT_SEC);
+            g_source_set_callback(roam->timeout,
+                gsupplicant_bss_roam_timeout, roam, NULL);
+            g_source_attach(roam->timeout,
+                gsupplicant_get_context(iface->supplicant));
+            return cancel;
+        }
+        g_slice_free(GSupplicantBSSRoamData, roam);
+    }
+    return NULL;
+}
+
 /*==========================================================================*
  * Internals
  *==========================================================================*/
@@ -1394,6 +1905,8 @@ gsupplicant_bss_dispose(
     GSupplicantBSS* self = GSUPPLICANT_BSS(object);
     GSupplicantBSSPriv* priv = self->priv;
     if (priv->proxy) {
+        gutil_disconnect_handlers(priv->proxy, priv->resync_handler_id,
+            G_N_ELEMENTS(priv->resync_handler_id));
         gutil_disconnect_handlers(priv->proxy, priv->proxy_handler_id,
             G_N_ELEMENTS(priv->proxy_handler_id));
         g_object_unref(priv->proxy);
@@ -1401,6 +1914,7 @@ gsupplicant_bss_dispose(
     }
     gsupplicant_interface_remove_all_handlers(self->iface,
         priv->iface_handler_id);
+    gsupplicant_interface_bss_gone(self->iface, self);
     G_OBJECT_CLASS(SUPER_CLASS)->dispose(object);
 }
 
@@ -1424,9 +1938,9 @@ gsupplicant_bss_finalize(
     if (self->ies) {
         g_bytes_unref(self->ies);
     }
-    g_free(priv->ssid_str);
+    gsupplicant_intern_unref(priv->ssid_str);
     g_free(priv->rates_values);
-    g_free(priv->path);
+    gsupplicant_intern_unref(priv->path);
     gsupplicant_interface_unref(self->iface);
     G_OBJECT_CLASS(SUPER_CLASS)->finalize(object);
 }
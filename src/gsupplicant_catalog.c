@@ -0,0 +1,538 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define GLIB_DISABLE_DEPRECATION_WARNINGS /* G_ADD_PRIVATE */
+
+#include "gsupplicant_catalog.h"
+#include "gsupplicant_interface.h"
+#include "gsupplicant_network.h"
+#include "gsupplicant_p.h"
+#include "gsupplicant_util_p.h"
+#include "gsupplicant_log.h"
+
+#include <gutil_misc.h>
+
+#include <stdlib.h>
+
+/* Object definition */
+#define CATALOG_KEYMGMT_BITS (32)
+
+enum gsupplicant_catalog_iface_handler_id {
+    INTERFACE_VALID_CHANGED,
+    INTERFACE_NETWORKS_CHANGED,
+    INTERFACE_HANDLER_COUNT
+};
+
+typedef struct gsupplicant_catalog_item {
+    GSupplicantCatalogEntry entry;   /* Must be first */
+    GSupplicantCatalog* catalog;
+    gulong network_handler_id;
+    guint generation;
+} GSupplicantCatalogItem;
+
+struct gsupplicant_catalog_priv {
+    gulong iface_handler_id[INTERFACE_HANDLER_COUNT];
+    guint generation;
+    GHashTable* items;      /* Interned path => GSupplicantCatalogItem */
+    GHashTable* by_ssid;    /* GBytes => GPtrArray */
+    GPtrArray* by_keymgmt[CATALOG_KEYMGMT_BITS];
+};
+
+typedef GObjectClass GSupplicantCatalogClass;
+G_DEFINE_TYPE(GSupplicantCatalog, gsupplicant_catalog, G_TYPE_OBJECT)
+#define GSUPPLICANT_CATALOG_TYPE (gsupplicant_catalog_get_type())
+#define GSUPPLICANT_CATALOG(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), \
+        GSUPPLICANT_CATALOG_TYPE, GSupplicantCatalog))
+#define SUPER_CLASS gsupplicant_catalog_parent_class
+
+enum gsupplicant_catalog_signal {
+    SIGNAL_CHANGED,
+    SIGNAL_COUNT
+};
+
+#define SIGNAL_CHANGED_NAME "changed"
+
+static guint gsupplicant_catalog_signals[SIGNAL_COUNT];
+
+/* Network properties we are interested in */
+#define NETWORK_PROP_SSID       "ssid"
+#define NETWORK_PROP_KEY_MGMT   "key_mgmt"
+#define NETWORK_PROP_EAP        "eap"
+#define NETWORK_PROP_PRIORITY   "priority"
+#define NETWORK_PROP_DISABLED   "disabled"
+
+/*==========================================================================*
+ * Implementation
+ *==========================================================================*/
+
+/*
+ * SSID is either a quoted string or a hex dump, depending on whether
+ * it's printable or not.
+ */
+static
+GBytes*
+gsupplicant_catalog_parse_ssid(
+    const char* str)
+{
+    if (str) {
+        const gsize len = strlen(str);
+        if (len >= 2 && str[0] == '"' && str[len - 1] == '"') {
+            return g_bytes_new(str + 1, len - 2);
+        } else if (len) {
+            return gutil_hex2bytes(str, len);
+        }
+    }
+    return NULL;
+}
+
+static
+void
+gsupplicant_catalog_index_add(
+    GSupplicantCatalogPriv* priv,
+    GSupplicantCatalogItem* item)
+{
+    const GSupplicantCatalogEntry* entry = &item->entry;
+    guint keymgmt = entry->keymgmt;
+    if (entry->ssid) {
+        GPtrArray* list = g_hash_table_lookup(priv->by_ssid, entry->ssid);
+        if (!list) {
+            list = g_ptr_array_new();
+            g_hash_table_insert(priv->by_ssid, g_bytes_ref(entry->ssid),
+                list);
+        }
+        g_ptr_array_add(list, item);
+    }
+    while (keymgmt) {
+        const int bit = g_bit_nth_lsf(keymgmt, -1);
+        if (!priv->by_keymgmt[bit]) {
+            priv->by_keymgmt[bit] = g_ptr_array_new();
+        }
+        g_ptr_array_add(priv->by_keymgmt[bit], item);
+        keymgmt &= ~(1u << bit);
+    }
+}
+
+static
+void
+gsupplicant_catalog_index_remove(
+    GSupplicantCatalogPriv* priv,
+    GSupplicantCatalogItem* item)
+{
+    const GSupplicantCatalogEntry* entry = &item->entry;
+    guint keymgmt = entry->keymgmt;
+    if (entry->ssid) {
+        GPtrArray* list = g_hash_table_lookup(priv->by_ssid, entry->ssid);
+        if (list) {
+            g_ptr_array_remove(list, item);
+            if (!list->len) {
+                g_hash_table_remove(priv->by_ssid, entry->ssid);
+            }
+        }
+    }
+    while (keymgmt) {
+        const int bit = g_bit_nth_lsf(keymgmt, -1);
+        GPtrArray* list = priv->by_keymgmt[bit];
+        if (list) {
+            g_ptr_array_remove(list, item);
+            if (!list->len) {
+                g_ptr_array_free(list, TRUE);
+                priv->by_keymgmt[bit] = NULL;
+            }
+        }
+        keymgmt &= ~(1u << bit);
+    }
+}
+
+static
+gboolean
+gsupplicant_catalog_item_update(
+    GSupplicantCatalogItem* item)
+{
+    GSupplicantCatalogEntry* entry = &item->entry;
+    GSupplicantNetwork* network = entry->network;
+    GSupplicantCatalogPriv* priv = item->catalog->priv;
+    GBytes* ssid = gsupplicant_catalog_parse_ssid
+        (gsupplicant_network_property(network, NETWORK_PROP_SSID));
+    const GSUPPLICANT_KEYMGMT keymgmt = gsupplicant_parse_keymgmt_names
+        (gsupplicant_network_property(network, NETWORK_PROP_KEY_MGMT));
+    const GSUPPLICANT_EAP_METHOD eap = gsupplicant_parse_eap_method_names
+        (gsupplicant_network_property(network, NETWORK_PROP_EAP));
+    const char* priority_str =
+        gsupplicant_network_property(network, NETWORK_PROP_PRIORITY);
+    const char* disabled_str =
+        gsupplicant_network_property(network, NETWORK_PROP_DISABLED);
+    const gint priority = priority_str ? atoi(priority_str) : 0;
+    const gboolean disabled = disabled_str && atoi(disabled_str) != 0;
+    gboolean changed = FALSE;
+
+    if (entry->keymgmt != keymgmt || !gutil_bytes_equal(entry->ssid, ssid)) {
+        /* Only the indexed fields require re-indexing */
+        gsupplicant_catalog_index_remove(priv, item);
+        if (entry->ssid) {
+            g_bytes_unref(entry->ssid);
+        }
+        entry->ssid = ssid;
+        entry->keymgmt = keymgmt;
+        gsupplicant_catalog_index_add(priv, item);
+        changed = TRUE;
+        GDEBUG_BYTES(ssid, FALSE, "[%s] 0x%04x", entry->path, keymgmt);
+    } else if (ssid) {
+        g_bytes_unref(ssid);
+    }
+    if (entry->eap != eap) {
+        entry->eap = eap;
+        changed = TRUE;
+    }
+    if (entry->priority != priority) {
+        entry->priority = priority;
+        changed = TRUE;
+    }
+    if (entry->disabled != disabled) {
+        entry->disabled = disabled;
+        changed = TRUE;
+    }
+    return changed;
+}
+
+static
+void
+gsupplicant_catalog_emit_changed(
+    GSupplicantCatalog* self)
+{
+    self->count = g_hash_table_size(self->priv->items);
+    g_signal_emit(self, gsupplicant_catalog_signals[SIGNAL_CHANGED], 0);
+}
+
+static
+void
+gsupplicant_catalog_network_properties_changed(
+    GSupplicantNetwork* network,
+    void* data)
+{
+    GSupplicantCatalogItem* item = data;
+    if (gsupplicant_catalog_item_update(item)) {
+        gsupplicant_catalog_emit_changed(item->catalog);
+    }
+}
+
+static
+GSupplicantCatalogItem*
+gsupplicant_catalog_item_new(
+    GSupplicantCatalog* self,
+    const char* path)
+{
+    GSupplicantCatalogItem* item = g_slice_new0(GSupplicantCatalogItem);
+    GSupplicantCatalogEntry* entry = &item->entry;
+    entry->path = gsupplicant_intern_ref(path);
+    entry->network = gsupplicant_network_new(path);
+    item->catalog = self;
+    item->network_handler_id = gsupplicant_network_add_handler
+        (entry->network, GSUPPLICANT_NETWORK_PROPERTY_PROPERTIES,
+            gsupplicant_catalog_network_properties_changed, item);
+    gsupplicant_catalog_item_update(item);
+    return item;
+}
+
+static
+void
+gsupplicant_catalog_item_free(
+    GSupplicantCatalogItem* item)
+{
+    GSupplicantCatalogEntry* entry = &item->entry;
+    gsupplicant_network_remove_handler(entry->network,
+        item->network_handler_id);
+    gsupplicant_network_unref(entry->network);
+    gsupplicant_intern_unref(entry->path);
+    if (entry->ssid) {
+        g_bytes_unref(entry->ssid);
+    }
+    g_slice_free(GSupplicantCatalogItem, item);
+}
+
+static
+void
+gsupplicant_catalog_item_destroy(
+    gpointer data)
+{
+    gsupplicant_catalog_item_free(data);
+}
+
+/* Returns TRUE if anything has changed */
+static
+gboolean
+gsupplicant_catalog_sync(
+    GSupplicantCatalog* self)
+{
+    GSupplicantCatalogPriv* priv = self->priv;
+    const GStrV* networks = self->iface->valid ? self->iface->networks : NULL;
+    const guint gen = ++priv->generation;
+    guint n = 0;
+    gboolean changed = FALSE;
+
+    /* Add new networks and mark the existing ones */
+    if (networks) {
+        const GStrV* ptr;
+        for (ptr = networks; *ptr; ptr++) {
+            const char* path = *ptr; /* Interned */
+            GSupplicantCatalogItem* item =
+                g_hash_table_lookup(priv->items, path);
+            if (!item) {
+                item = gsupplicant_catalog_item_new(self, path);
+                g_hash_table_insert(priv->items, (gpointer)item->entry.path,
+                    item);
+                changed = TRUE;
+            }
+            item->generation = gen;
+            n++;
+        }
+    }
+
+    /* Drop whatever hasn't been marked */
+    if (g_hash_table_size(priv->items) > n) {
+        GHashTableIter it;
+        gpointer value;
+        g_hash_table_iter_init(&it, priv->items);
+        while (g_hash_table_iter_next(&it, NULL, &value)) {
+            GSupplicantCatalogItem* item = value;
+            if (item->generation != gen) {
+                gsupplicant_catalog_index_remove(priv, item);
+                g_hash_table_iter_remove(&it);
+                changed = TRUE;
+            }
+        }
+    }
+    return changed;
+}
+
+static
+void
+gsupplicant_catalog_interface_changed(
+    GSupplicantInterface* iface,
+    void* data)
+{
+    GSupplicantCatalog* self = GSUPPLICANT_CATALOG(data);
+    if (gsupplicant_catalog_sync(self)) {
+        gsupplicant_catalog_emit_changed(self);
+    }
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+GSupplicantCatalog*
+gsupplicant_catalog_new(
+    GSupplicantInterface* iface) /* Since 1.0.31 */
+{
+    if (G_LIKELY(iface)) {
+        GSupplicantCatalog* self = g_object_new(GSUPPLICANT_CATALOG_TYPE,
+            NULL);
+        GSupplicantCatalogPriv* priv = self->priv;
+        self->iface = gsupplicant_interface_ref(iface);
+        priv->iface_handler_id[INTERFACE_VALID_CHANGED] =
+            gsupplicant_interface_add_handler(iface,
+                GSUPPLICANT_INTERFACE_PROPERTY_VALID,
+                gsupplicant_catalog_interface_changed, self);
+        priv->iface_handler_id[INTERFACE_NETWORKS_CHANGED] =
+            gsupplicant_interface_add_handler(iface,
+                GSUPPLICANT_INTERFACE_PROPERTY_NETWORKS,
+                gsupplicant_catalog_interface_changed, self);
+        gsupplicant_catalog_sync(self);
+        self->count = g_hash_table_size(priv->items);
+        return self;
+    }
+    return NULL;
+}
+
+GSupplicantCatalog*
+gsupplicant_catalog_ref(
+    GSupplicantCatalog* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        g_object_ref(GSUPPLICANT_CATALOG(self));
+        return self;
+    } else {
+        return NULL;
+    }
+}
+
+void
+gsupplicant_catalog_unref(
+    GSupplicantCatalog* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        g_object_unref(GSUPPLICANT_CATALOG(self));
+    }
+}
+
+gulong
+gsupplicant_catalog_add_changed_handler(
+    GSupplicantCatalog* self,
+    GSupplicantCatalogFunc fn,
+    void* data) /* Since 1.0.31 */
+{
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+        SIGNAL_CHANGED_NAME, G_CALLBACK(fn), data) : 0;
+}
+
+void
+gsupplicant_catalog_remove_handler(
+    GSupplicantCatalog* self,
+    gulong id) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(id)) {
+        g_signal_handler_disconnect(self, id);
+    }
+}
+
+const GSupplicantCatalogEntry*
+gsupplicant_catalog_get(
+    GSupplicantCatalog* self,
+    const char* path) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(path)) {
+        const char* ipath = gsupplicant_intern_find(path);
+        if (ipath) {
+            return g_hash_table_lookup(self->priv->items, ipath);
+        }
+    }
+    return NULL;
+}
+
+const GPtrArray*
+gsupplicant_catalog_find_ssid(
+    GSupplicantCatalog* self,
+    GBytes* ssid) /* Since 1.0.31 */
+{
+    return (G_LIKELY(self) && G_LIKELY(ssid)) ?
+        g_hash_table_lookup(self->priv->by_ssid, ssid) : NULL;
+}
+
+const GPtrArray*
+gsupplicant_catalog_find_keymgmt(
+    GSupplicantCatalog* self,
+    GSUPPLICANT_KEYMGMT keymgmt) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && keymgmt && !(keymgmt & (keymgmt - 1))) {
+        return self->priv->by_keymgmt[g_bit_nth_lsf(keymgmt, -1)];
+    }
+    return NULL;
+}
+
+const GSupplicantCatalogEntry*
+gsupplicant_catalog_lookup(
+    GSupplicantCatalog* self,
+    GBytes* ssid,
+    GSUPPLICANT_KEYMGMT keymgmt) /* Since 1.0.31 */
+{
+    const GPtrArray* list = gsupplicant_catalog_find_ssid(self, ssid);
+    if (list) {
+        guint i;
+        for (i = 0; i < list->len; i++) {
+            const GSupplicantCatalogEntry* entry = list->pdata[i];
+            if (entry->keymgmt & keymgmt) {
+                return entry;
+            }
+        }
+    }
+    return NULL;
+}
+
+/*==========================================================================*
+ * Internals
+ *==========================================================================*/
+
+/**
+ * Per instance initializer
+ */
+static
+void
+gsupplicant_catalog_init(
+    GSupplicantCatalog* self)
+{
+    GSupplicantCatalogPriv* priv = G_TYPE_INSTANCE_GET_PRIVATE(self,
+        GSUPPLICANT_CATALOG_TYPE, GSupplicantCatalogPriv);
+    self->priv = priv;
+    priv->items = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+        NULL, gsupplicant_catalog_item_destroy);
+    priv->by_ssid = g_hash_table_new_full(g_bytes_hash, g_bytes_equal,
+        (GDestroyNotify)g_bytes_unref, (GDestroyNotify)g_ptr_array_unref);
+}
+
+/**
+ * Final stage of deinitialization
+ */
+static
+void
+gsupplicant_catalog_finalize(
+    GObject* object)
+{
+    GSupplicantCatalog* self = GSUPPLICANT_CATALOG(object);
+    GSupplicantCatalogPriv* priv = self->priv;
+    int i;
+    gsupplicant_interface_remove_all_handlers(self->iface,
+        priv->iface_handler_id);
+    g_hash_table_destroy(priv->items);
+    g_hash_table_destroy(priv->by_ssid);
+    for (i = 0; i < CATALOG_KEYMGMT_BITS; i++) {
+        if (priv->by_keymgmt[i]) {
+            g_ptr_array_free(priv->by_keymgmt[i], TRUE);
+        }
+    }
+    gsupplicant_interface_unref(self->iface);
+    G_OBJECT_CLASS(SUPER_CLASS)->finalize(object);
+}
+
+/**
+ * Per class initializer
+ */
+static
+void
+gsupplicant_catalog_class_init(
+    GSupplicantCatalogClass* klass)
+{
+    GObjectClass* object_class = G_OBJECT_CLASS(klass);
+    object_class->finalize = gsupplicant_catalog_finalize;
+    G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    g_type_class_add_private(klass, sizeof(GSupplicantCatalogPriv));
+    G_GNUC_END_IGNORE_DEPRECATIONS
+    gsupplicant_catalog_signals[SIGNAL_CHANGED] =
+        g_signal_new(SIGNAL_CHANGED_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE, 0);
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gsupplicant_embed.h"
+#include "gsupplicant_log.h"
+
+#define EMBED_MIN_FDS (4)
+
+struct gsupplicant_embed {
+    GMainContext* context;
+    GPollFD* fds;
+    guint n_fds;
+    guint fds_allocated;
+    gint max_priority;
+    gboolean prepared;
+};
+
+GSupplicantEmbed*
+gsupplicant_embed_new(
+    GMainContext* context) /* Since 1.0.31 */
+{
+    GMainContext* ctx = context ? g_main_context_ref(context) :
+        g_main_context_ref_thread_default();
+
+    if (g_main_context_acquire(ctx)) {
+        GSupplicantEmbed* self = g_slice_new0(GSupplicantEmbed);
+
+        self->context = ctx;
+        self->fds_allocated = EMBED_MIN_FDS;
+        self->fds = g_new(GPollFD, self->fds_allocated);
+        return self;
+    }
+    GWARN("Main context is owned by another thread");
+    g_main_context_unref(ctx);
+    return NULL;
+}
+
+void
+gsupplicant_embed_free(
+    GSupplicantEmbed* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        g_main_context_release(self->context);
+        g_main_context_unref(self->context);
+        g_free(self->fds);
+        g_slice_free(GSupplicantEmbed, self);
+    }
+}
+
+GMainContext*
+gsupplicant_embed_context(
+    GSupplicantEmbed* self) /* Since 1.0.31 */
+{
+    return G_LIKELY(self) ? self->context : NULL;
+}
+
+int
+gsupplicant_embed_prepare(
+    GSupplicantEmbed* self,
+    const GPollFD** fds,
+    guint* n_fds) /* Since 1.0.31 */
+{
+    int timeout = -1;
+    guint n = 0;
+
+    if (G_LIKELY(self)) {
+        gint count;
+
+        if (g_main_context_prepare(self->context, &self->max_priority)) {
+            /* Something is ready to be dispatched right away */
+            timeout = 0;
+        }
+        while ((count = g_main_context_query(self->context,
+            self->max_priority, &timeout, self->fds,
+            self->fds_allocated)) > (gint)self->fds_allocated) {
+            self->fds_allocated = count;
+            self->fds = g_renew(GPollFD, self->fds, self->fds_allocated);
+        }
+        self->n_fds = n = count;
+        self->prepared = TRUE;
+    }
+    if (fds) {
+        *fds = n ? self->fds : NULL;
+    }
+    if (n_fds) {
+        *n_fds = n;
+    }
+    return timeout;
+}
+
+gboolean
+gsupplicant_embed_dispatch(
+    GSupplicantEmbed* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        if (self->prepared) {
+            GPollFunc poll_func = g_main_context_get_poll_func(self->context);
+            gboolean ready;
+
+            /* Refresh revents without blocking */
+            self->prepared = FALSE;
+            if (self->n_fds) {
+                poll_func(self->fds, self->n_fds, 0);
+            }
+            ready = g_main_context_check(self->context, self->max_priority,
+                self->fds, self->n_fds);
+            if (ready) {
+                g_main_context_dispatch(self->context);
+            }
+            return ready;
+        } else {
+            return g_main_context_iteration(self->context, FALSE);
+        }
+    }
+    return FALSE;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -36,22 +36,30 @@
 #include "gsupplicant_network.h"
 #include "gsupplicant_bss.h"
 #include "gsupplicant.h"
+#include "gsupplicant_interface_p.h"
 #include "gsupplicant_p.h"
+#include "gsupplicant_scan_coordinator_p.h"
+#include "gsupplicant_snapshot_p.h"
 #include "gsupplicant_util_p.h"
 #include "gsupplicant_dbus.h"
 #include "gsupplicant_log.h"
+#include "gsupplicant_trace.h"
 #include "gsupplicant_error.h"
 
 #include <gutil_strv.h>
 #include <gutil_misc.h>
 #include <gutil_macros.h>
 
+#include <stdlib.h>
+
 /* Generated headers */
 #include "fi.w1.wpa_supplicant1.Interface.h"
 #include "fi.w1.wpa_supplicant1.Interface.WPS.h"
 
 /* Constants */
 #define WPS_DEFAULT_CONNECT_TIMEOUT_SEC (30)
+#define DIRECTED_SCAN_MAX_SSIDS (16) /* WPAS_MAX_SCAN_SSIDS */
+#define DIRECTED_SCAN_BATCH_TIMEOUT_SEC (30)
 
 /* Internal data structures */
 typedef union gsupplicant_interface_call_func_union {
@@ -124,13 +132,39 @@ typedef struct gsupplicant_interface_wps_connect {
     char* new_pin;
     GCancellable* cancel;
     gulong cancel_id;
-    guint timeout_id;
+    GSource* timeout;
     WPS_CONNECT_STATE state;
     GSupplicantInterfaceStringResultFunc fn;
     GDestroyNotify destroy;
     void* data;
 } GSupplicantInterfaceWPSConnect;
 
+enum gsupplicant_interface_directed_scan_handler_id {
+    DIRECTED_SCAN_VALID_CHANGED,
+    DIRECTED_SCAN_SCANNING_CHANGED,
+    DIRECTED_SCAN_HANDLER_COUNT
+};
+
+typedef struct gsupplicant_interface_directed_scan {
+    GSupplicantInterface* iface;
+    GCancellable* cancel;
+    GCancellable* batch_cancel; /* Scan call for the current batch */
+    gulong cancel_id;
+    gulong iface_handler_id[DIRECTED_SCAN_HANDLER_COUNT];
+    GSupplicantScanParams params;
+    GSupplicantScanFrequencies channels;
+    GBytes** ssids;         /* Sorted by priority */
+    guint count;
+    guint pos;
+    guint batch;
+    GSource* timeout;       /* For the current batch */
+    gboolean started;       /* Scan call has completed */
+    gboolean scanning;      /* Interface has been seen scanning */
+    GSupplicantInterfaceResultFunc fn;
+    GDestroyNotify destroy;
+    void* data;
+} GSupplicantInterfaceDirectedScan;
+
 /* Object definition */
 enum supplicant_interface_proxy_handler_id {
     PROXY_BSS_ADDED,
@@ -155,7 +189,13 @@ enum supplicant_interface_proxy_handler_id {
     PROXY_NOTIFY_NETWORKS,
     PROXY_NOTIFY_SAE_CHECK_MFP,
     PROXY_NOTIFY_SAE_PWE,
+    PROXY_NOTIFY_FILTER_RSSI,
     PROXY_EAP,
+    PROXY_SCAN_DONE,
+#if GSUPPLICANT_TRACE_ENABLED
+    PROXY_TRACE_PROPERTIES_CHANGED,
+    PROXY_TRACE_PROPERTIES_CHANGED_DONE,
+#endif
     PROXY_HANDLER_COUNT
 };
 
@@ -165,17 +205,28 @@ enum supplicant_handler_id {
     SUPPLICANT_HANDLER_COUNT
 };
 
+/* These are never blocked */
+enum supplicant_interface_resync_handler_id {
+    RESYNC_PROPERTIES_CHANGED,
+    RESYNC_NOTIFY_NAME_OWNER,
+    RESYNC_HANDLER_COUNT
+};
+
 struct gsupplicant_interface_priv {
+    GMainContext* context;
     GDBusConnection* bus;
     FiW1Wpa_supplicant1Interface* proxy;
     gulong proxy_handler_id[PROXY_HANDLER_COUNT];
     gulong supplicant_handler_id[SUPPLICANT_HANDLER_COUNT];
+    gulong resync_handler_id[RESYNC_HANDLER_COUNT];
+    gboolean resyncing;
     GSupplicantWPSCredentials wps_credentials;
     guint32 pending_signals;
-    GStrV* bsss;
-    GStrV* networks;
-    GStrV* stations;
-    char* path;
+    GStrV* bsss;            /* Interned */
+    GStrV* networks;        /* Interned */
+    GPtrArray* stations;    /* NULL terminated station addresses */
+    GHashTable* station_table;      /* Address => station record */
+    const char* path;       /* Interned */
     char* country;
     char* driver;
     char* ifname;
@@ -184,6 +235,22 @@ struct gsupplicant_interface_priv {
     char* current_network;
     gboolean sae_check_mfp;
     GSUPPLICANT_SAE_PWE_OPTION sae_pwe;
+    GHashTable* bss_by_bssid;       /* GBytes* => GSupplicantBSS* */
+    GHashTable* bss_by_frequency;   /* frequency => GPtrArray of BSSs */
+    GHashTable* bss_snapshots;      /* path => GSupplicantBSSSnapshot* */
+    GSupplicantSnapshotSlot snapshot;
+    guint snapshot_serial;
+    GSource* snapshot_idle;         /* Non-NULL while rebuild is pending */
+    GSupplicantScanTimes scan_times;
+    GSupplicantFilterPolicy filter_policy;
+    gboolean filter_adaptive;
+    gint filter_rssi;
+    GSupplicantBSSExpiry bss_expiry;
+    GSource* bss_flush_timer;
+    gboolean bss_flushing;
+    GSupplicantScanSourceStats scan_source_stats;
+    gboolean host_scan;     /* Scan requested since the last ScanDone */
+    guint new_bsss;         /* BSSs added since the last ScanDone */
 };
 
 typedef GObjectClass GSupplicantInterfaceClass;
@@ -221,6 +288,8 @@ typedef enum gsupplicant_interface_signal {
 #undef SIGNAL_ENUM_
     SIGNAL_PROPERTY_CHANGED,
     SIGNAL_EAP,
+    SIGNAL_STATION_ADDED,
+    SIGNAL_STATION_REMOVED,
     SIGNAL_COUNT
 } GSUPPLICANT_INTERFACE_SIGNAL;
 
@@ -239,6 +308,8 @@ G_STATIC_ASSERT((int)SIGNAL_PROPERTY_CHANGED ==
 
 #define SIGNAL_PROPERTY_CHANGED_NAME            "property-changed"
 #define SIGNAL_EAP_NAME                         "eap-event"
+#define SIGNAL_STATION_ADDED_NAME               "station-added"
+#define SIGNAL_STATION_REMOVED_NAME             "station-removed"
 #define SIGNAL_PROPERTY_CHANGED_DETAIL          "%x"
 #define SIGNAL_PROPERTY_CHANGED_DETAIL_MAX_LEN  (8)
 
@@ -249,7 +320,9 @@ static const char* gsupplicant_interface_signame[] = {
     GSUPPLICANT_INTERFACE_PROPERTIES_(SIGNAL_NAME_)
 #undef SIGNAL_NAME_
     SIGNAL_PROPERTY_CHANGED_NAME,
-    SIGNAL_EAP_NAME
+    SIGNAL_EAP_NAME,
+    SIGNAL_STATION_ADDED_NAME,
+    SIGNAL_STATION_REMOVED_NAME
 };
 
 G_STATIC_ASSERT(G_N_ELEMENTS(gsupplicant_interface_signame) == SIGNAL_COUNT);
@@ -278,9 +351,19 @@ G_STATIC_ASSERT(G_N_ELEMENTS(gsupplicant_interface_signame) == SIGNAL_COUNT);
 #define PROXY_PROPERTY_NAME_DISCONNECT_REASON   "DisconnectReason"
 #define PROXY_PROPERTY_NAME_SAE_CHECK_MFP       "SaeCheckMfp"
 #define PROXY_PROPERTY_NAME_SAE_PWE             "SaePwe"
-
-/* Weak references to the instances of GSupplicantInterface */
-static GHashTable* gsupplicant_interface_table = NULL;
+#define PROXY_PROPERTY_NAME_BSS_MAX_COUNT       "BssMaxCount"
+#define PROXY_PROPERTY_NAME_FILTER_SSIDS        "FilterSsids"
+#define PROXY_PROPERTY_NAME_FILTER_RSSI         "FilterRssi"
+#define PROXY_PROPERTY_NAME_DISABLE_SCAN_OFFLOAD "DisableScanOffload"
+#define PROXY_PROPERTY_NAME_FREQ_LIST           "FreqList"
+#define PROXY_PROPERTY_NAME_SCHED_SCAN_INTERVAL "SchedScanInterval"
+#define PROXY_PROPERTY_NAME_SCHED_SCAN_PLANS    "SchedScanPlans"
+#define PROXY_PROPERTY_NAME_BGSCAN              "Bgscan"
+#define PROXY_PROPERTY_NAME_OKC                 "Okc"
+#define PROXY_PROPERTY_NAME_PMF                 "Pmf"
+
+/* Weak references to GSupplicantInterface instances (per main context) */
+static GSupplicantRegistry gsupplicant_interface_registry;
 
 /* States */
 static const GSupNameIntPair gsupplicant_interface_states [] = {
@@ -346,17 +429,66 @@ gsupplicant_interface_signal_property_change(
         gsupplicant_interface_property_quarks[sig], prop);
 }
 
+static
+void
+gsupplicant_interface_build_snapshot(
+    GSupplicantInterface* self)
+{
+    GSupplicantInterfacePriv* priv = self->priv;
+
+    gsupplicant_snapshot_slot_publish(&priv->snapshot,
+        gsupplicant_interface_snapshot_new(self, priv->bss_snapshots,
+            ++(priv->snapshot_serial)));
+}
+
+static
+gboolean
+gsupplicant_interface_snapshot_idle(
+    gpointer data)
+{
+    GSupplicantInterface* self = GSUPPLICANT_INTERFACE(data);
+    GSupplicantInterfacePriv* priv = self->priv;
+
+    g_source_unref(priv->snapshot_idle);
+    priv->snapshot_idle = NULL;
+    gsupplicant_interface_build_snapshot(self);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+gsupplicant_interface_publish_snapshot(
+    GSupplicantInterface* self)
+{
+    GSupplicantInterfacePriv* priv = self->priv;
+
+    /*
+     * Building the snapshot is O(N) in the number of BSSs and a scan
+     * typically changes most of them, so the rebuild is deferred until
+     * the whole batch of updates has been processed.
+     */
+    if (!priv->snapshot_idle) {
+        priv->snapshot_idle = g_idle_source_new();
+        g_source_set_callback(priv->snapshot_idle,
+            gsupplicant_interface_snapshot_idle, self, NULL);
+        g_source_attach(priv->snapshot_idle, priv->context);
+    }
+}
+
 static
 void
 gsupplicant_interface_emit_pending_signals(
     GSupplicantInterface* self)
 {
     GSupplicantInterfacePriv* priv = self->priv;
+    const guint32 pending = priv->pending_signals;
     GSUPPLICANT_INTERFACE_SIGNAL sig;
     gboolean valid_changed;
 
     /* Handlers could drops their references to us */
     gsupplicant_interface_ref(self);
+    GSUPPLICANT_TRACE3(emit_pending_signals, "interface", self->path,
+        priv->pending_signals);
 
     /* VALID is the last one to be emitted if we BECOME valid */
     if ((priv->pending_signals & SIGNAL_BIT(VALID)) && self->valid) {
@@ -383,6 +515,13 @@ gsupplicant_interface_emit_pending_signals(
             SIGNAL_VALID_CHANGED, GSUPPLICANT_INTERFACE_PROPERTY_VALID);
     }
 
+    GSUPPLICANT_TRACE2(emit_pending_signals_done, "interface", self->path);
+
+    /* Publish the new state once the batch is done */
+    if (pending) {
+        gsupplicant_interface_publish_snapshot(self);
+    }
+
     /* And release the temporary reference */
     gsupplicant_interface_unref(self);
 }
@@ -637,6 +776,32 @@ gsupplicant_interface_add_network_args_security_proto(
     }
 }
 
+/* Adds the requested FT variants of the already enabled suites */
+static
+char*
+gsupplicant_interface_add_network_args_ft(
+    const char* key_mgmt,
+    GSUPPLICANT_KEYMGMT keymgmt)
+{
+    char** suites = g_strsplit(key_mgmt, " ", -1);
+    GString* buf = g_string_new(key_mgmt);
+
+    if ((keymgmt & GSUPPLICANT_KEYMGMT_WPA_FT_PSK) &&
+        gutil_strv_contains(suites, "WPA-PSK")) {
+        g_string_append(buf, " FT-PSK");
+    }
+    if ((keymgmt & GSUPPLICANT_KEYMGMT_WPA_FT_EAP) &&
+        gutil_strv_contains(suites, "WPA-EAP")) {
+        g_string_append(buf, " FT-EAP");
+    }
+    if ((keymgmt & GSUPPLICANT_KEYMGMT_FT_SAE) &&
+        gutil_strv_contains(suites, "SAE")) {
+        g_string_append(buf, " FT-SAE");
+    }
+    g_strfreev(suites);
+    return g_string_free(buf, FALSE);
+}
+
 static
 GVariant*
 gsupplicant_interface_add_network_args_new(
@@ -706,7 +871,17 @@ gsupplicant_interface_add_network_args_new(
         break;
     }
     gsupplicant_dict_add_string0(&builder, "auth_alg", auth_alg);
-    gsupplicant_dict_add_string0(&builder, "key_mgmt", key_mgmt);
+    if (key_mgmt && (np->flags & GSUPPLICANT_NETWORK_PARAM_FT) &&
+        (np->keymgmt & (GSUPPLICANT_KEYMGMT_WPA_FT_PSK |
+        GSUPPLICANT_KEYMGMT_WPA_FT_EAP | GSUPPLICANT_KEYMGMT_FT_SAE))) {
+        char* ft_key_mgmt = gsupplicant_interface_add_network_args_ft
+            (key_mgmt, np->keymgmt);
+
+        gsupplicant_dict_add_string(&builder, "key_mgmt", ft_key_mgmt);
+        g_free(ft_key_mgmt);
+    } else {
+        gsupplicant_dict_add_string0(&builder, "key_mgmt", key_mgmt);
+    }
     return g_variant_ref_sink(g_variant_builder_end(&builder));
 }
 
@@ -752,7 +927,7 @@ gsupplicant_interface_wps_parse_creds(
     if (!g_strcmp0(name, "BSSID")) {
         if (wps->bssid) g_bytes_unref(wps->bssid);
         wps->bssid = gsupplicant_variant_data_as_bytes(value);
-        GVERBOSE("  %s: %s", name, gsupplicant_format_bytes(wps->bssid, TRUE));
+        GVERBOSE_BYTES(wps->bssid, TRUE, "  %s:", name);
     } else if (!g_strcmp0(name, "SSID")) {
         if (g_variant_is_of_type(value, G_VARIANT_TYPE_STRING)) {
             gsize length = 0;
@@ -786,7 +961,7 @@ gsupplicant_interface_wps_parse_creds(
     } else if (!g_strcmp0(name, "Key")) {
         if (wps->key) g_bytes_unref(wps->key);
         wps->key = gsupplicant_variant_data_as_bytes(value);
-        GVERBOSE("  %s: %s", name, gsupplicant_format_bytes(wps->key, TRUE));
+        GVERBOSE_BYTES(wps->key, TRUE, "  %s:", name);
     } else if (!g_strcmp0(name, "KeyIndex")) {
         if (g_variant_is_of_type(value, G_VARIANT_TYPE_UINT32)) {
             wps->key_index = g_variant_get_uint32(value);
@@ -808,9 +983,10 @@ gsupplicant_interface_wps_connect_dispose(
         g_object_unref(connect->wps_proxy);
         connect->wps_proxy = NULL;
     }
-    if (connect->timeout_id) {
-        g_source_remove(connect->timeout_id);
-        connect->timeout_id = 0;
+    if (connect->timeout) {
+        g_source_destroy(connect->timeout);
+        g_source_unref(connect->timeout);
+        connect->timeout = NULL;
     }
 }
 
@@ -896,7 +1072,8 @@ gsupplicant_interface_wps_connect_timeout(
     GSupplicantInterfaceWPSConnect* connect = data;
     GDEBUG("WPS connect timed out");
     GASSERT(!g_cancellable_is_cancelled(connect->cancel));
-    connect->timeout_id = 0;
+    g_source_unref(connect->timeout);
+    connect->timeout = NULL;
     if (connect->fn) {
         GError* error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_TIMED_OUT,
             "WPS connect timed out");
@@ -939,8 +1116,11 @@ gsupplicant_interface_wps_connect_new(
     }
     if (!timeout_sec) timeout_sec = WPS_DEFAULT_CONNECT_TIMEOUT_SEC;
     if (timeout_sec > 0) {
-        connect->timeout_id = g_timeout_add_seconds(timeout_sec,
-            gsupplicant_interface_wps_connect_timeout, connect);
+        /* Attached to the context the interface is bound to */
+        connect->timeout = g_timeout_source_new_seconds(timeout_sec);
+        g_source_set_callback(connect->timeout,
+            gsupplicant_interface_wps_connect_timeout, connect, NULL);
+        g_source_attach(connect->timeout, iface->priv->context);
     }
     connect->fn = fn;
     connect->destroy = destroy;
@@ -1159,6 +1339,8 @@ gsupplicant_interface_call_finished(
     gpointer data)
 {
     GSupplicantInterfaceCall* call = data;
+    GSUPPLICANT_TRACE4(call_done, "interface", call->iface->path, call,
+        g_cancellable_is_cancelled(call->cancel));
     if (!g_cancellable_is_cancelled(call->cancel)) {
         call->finish(call, result);
     } else {
@@ -1194,6 +1376,7 @@ gsupplicant_interface_call_new(
     call->fn.cb = cb;
     call->destroy = destroy;
     call->data = data;
+    GSUPPLICANT_TRACE3(call_start, "interface", iface->path, call);
     return call;
 }
 
@@ -1221,6 +1404,8 @@ gsupplicant_interface_add_network_call_free(
     GSupplicantInterfaceAddNetworkCall* call)
 {
     GASSERT(!call->pending);
+    GSUPPLICANT_TRACE4(call_done, "interface", call->iface->path, call,
+        g_cancellable_is_cancelled(call->cancel));
     gsupplicant_interface_add_network_call_dispose(call);
     gsupplicant_interface_unref(call->iface);
     if (call->cancel_id) {
@@ -1326,6 +1511,7 @@ gsupplicant_interface_add_network_call_new(
     call->destroy = destroy;
     call->data = data;
     call->flags = flags;
+    GSUPPLICANT_TRACE3(call_start, "interface", iface->path, call);
     return call;
 }
 
@@ -1347,6 +1533,25 @@ gsupplicant_interface_call_finish_void(
     g_clear_error(&error);
 }
 
+static
+void
+gsupplicant_interface_call_finish_scan(
+    GSupplicantInterfaceCall* call,
+    GAsyncResult* result)
+{
+    GError* error = NULL;
+    GDBusProxy* proxy = G_DBUS_PROXY(call->iface->priv->proxy);
+    GVariant* var = g_dbus_proxy_call_finish(proxy, result, &error);
+    if (var) {
+        g_variant_unref(var);
+        gsupplicant_interface_scan_started(call->iface);
+    }
+    if (call->fn.fn_void) {
+        call->fn.fn_void(call->iface, call->cancel, error, call->data);
+    }
+    g_clear_error(&error);
+}
+
 static
 void
 gsupplicant_interface_call_finish_signal_poll(
@@ -1464,6 +1669,385 @@ gsupplicant_interface_call_string_void(
     return NULL;
 }
 
+static
+GCancellable*
+gsupplicant_interface_scan_full(
+    GSupplicantInterface* self,
+    GCancellable* cancel,
+    const GSupplicantScanParams* params,
+    GSupplicantInterfaceResultFunc fn,
+    GDestroyNotify destroy,
+    void* data)
+{
+    if (G_LIKELY(self) && self->valid) {
+        GSupplicantScanParams default_params;
+        GSupplicantInterfacePriv* priv = self->priv;
+        GSupplicantScanCoordinator* coord =
+            gsupplicant_scan_coordinator(self->supplicant);
+        GSupplicantInterfaceCall* call;
+        GVariantBuilder builder;
+        GVariant* dict;
+
+        /* Do passive scan by default */
+        if (!params) {
+            memset(&default_params, 0, sizeof(default_params));
+            default_params.type = GSUPPLICANT_SCAN_TYPE_PASSIVE;
+            params = &default_params;
+        }
+
+        /* Prepare scan parameters */
+        g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+        gsupplicant_dict_add_string(&builder, "Type",
+            params->type == GSUPPLICANT_SCAN_TYPE_ACTIVE ?
+            "active" : "passive");
+        if (params->ssids) {
+            gsupplicant_dict_add_value(&builder, "SSIDs",
+                gsupplicant_variant_new_ayy(params->ssids));
+        }
+        if (params->ies) {
+            gsupplicant_dict_add_value(&builder, "IEs",
+                gsupplicant_variant_new_ayy(params->ies));
+        }
+        if (params->channels) {
+            guint i;
+            const GSupplicantScanFrequency* freq = params->channels->freq;
+            GVariantBuilder auu;
+            g_variant_builder_init(&auu, G_VARIANT_TYPE("a(uu)"));
+            for (i=0; i<params->channels->count; i++, freq++) {
+                g_variant_builder_add(&auu, "(uu)", freq->center, freq->width);
+            }
+            gsupplicant_dict_add_value(&builder, "Channels",
+                g_variant_builder_end(&auu));
+        }
+        if (params->flags & GSUPPLICANT_SCAN_PARAM_ALLOW_ROAM) {
+            gsupplicant_dict_add_boolean(&builder, "AllowRoam",
+                params->allow_roam);
+        }
+
+        /* Queue the request if scans are coordinated */
+        if (coord) {
+            return gsupplicant_scan_coordinator_submit(coord, self,
+                g_variant_builder_end(&builder), cancel, fn, destroy, data);
+        }
+
+        /* Submit the call */
+        call = gsupplicant_interface_call_new(self, cancel,
+            gsupplicant_interface_call_finish_scan, G_CALLBACK(fn),
+            destroy, data);
+        dict = g_variant_ref_sink(g_variant_builder_end(&builder));
+        fi_w1_wpa_supplicant1_interface_call_scan(priv->proxy, dict,
+            call->cancel, gsupplicant_interface_call_finished, call);
+        g_variant_unref(dict);
+        return call->cancel;
+    }
+    return NULL;
+}
+
+static
+void
+gsupplicant_interface_directed_scan_stop_timer(
+    GSupplicantInterfaceDirectedScan* scan)
+{
+    if (scan->timeout) {
+        g_source_destroy(scan->timeout);
+        g_source_unref(scan->timeout);
+        scan->timeout = NULL;
+    }
+}
+
+static
+void
+gsupplicant_interface_directed_scan_free(
+    GSupplicantInterfaceDirectedScan* scan)
+{
+    GBytes** ptr;
+
+    gsupplicant_interface_directed_scan_stop_timer(scan);
+    if (scan->batch_cancel) {
+        /* The Scan call may still be pending, it must not call us back */
+        g_cancellable_cancel(scan->batch_cancel);
+        g_object_unref(scan->batch_cancel);
+    }
+    gsupplicant_interface_remove_all_handlers(scan->iface,
+        scan->iface_handler_id);
+    if (scan->cancel_id) {
+        g_signal_handler_disconnect(scan->cancel, scan->cancel_id);
+    }
+    g_object_unref(scan->cancel);
+    for (ptr = scan->ssids; *ptr; ptr++) {
+        g_bytes_unref(*ptr);
+    }
+    g_free(scan->ssids);
+    if (scan->params.ies) {
+        for (ptr = scan->params.ies; *ptr; ptr++) {
+            g_bytes_unref(*ptr);
+        }
+        g_free(scan->params.ies);
+    }
+    g_free((gpointer)scan->channels.freq);
+    gsupplicant_interface_unref(scan->iface);
+    if (scan->destroy) {
+        scan->destroy(scan->data);
+    }
+    gutil_slice_free(scan);
+}
+
+static
+void
+gsupplicant_interface_directed_scan_cancelled(
+    GCancellable* cancel,
+    gpointer scan)
+{
+    gsupplicant_interface_directed_scan_free(scan);
+}
+
+static
+void
+gsupplicant_interface_directed_scan_done(
+    GSupplicantInterfaceDirectedScan* scan,
+    const GError* error)
+{
+    if (scan->fn && !g_cancellable_is_cancelled(scan->cancel)) {
+        if (scan->cancel_id) {
+            /* In case if callback calls g_cancellable_cancel() */
+            g_signal_handler_disconnect(scan->cancel, scan->cancel_id);
+            scan->cancel_id = 0;
+        }
+        scan->fn(scan->iface, scan->cancel, error, scan->data);
+    }
+    gsupplicant_interface_directed_scan_free(scan);
+}
+
+static
+void
+gsupplicant_interface_directed_scan_fail(
+    GSupplicantInterfaceDirectedScan* scan,
+    const char* message)
+{
+    GError* error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_FAILED,
+        message);
+    gsupplicant_interface_directed_scan_done(scan, error);
+    g_error_free(error);
+}
+
+static
+void
+gsupplicant_interface_directed_scan_call_done(
+    GSupplicantInterface* iface,
+    GCancellable* cancel,
+    const GError* error,
+    void* data);
+
+static
+gboolean
+gsupplicant_interface_directed_scan_timeout(
+    gpointer data)
+{
+    GSupplicantInterfaceDirectedScan* scan = data;
+    GError* error;
+
+    GWARN("[%s] Directed scan %u of %u timed out", scan->iface->path,
+        scan->pos, scan->count);
+    g_source_unref(scan->timeout);
+    scan->timeout = NULL;
+    error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_TIMED_OUT,
+        "Directed scan timed out");
+    gsupplicant_interface_directed_scan_done(scan, error);
+    g_error_free(error);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+gsupplicant_interface_directed_scan_next(
+    GSupplicantInterfaceDirectedScan* scan)
+{
+    if (scan->pos < scan->count) {
+        const guint n = MIN(scan->batch, scan->count - scan->pos);
+        GBytes** ssids = g_new(GBytes*, n + 1);
+
+        GDEBUG("[%s] Directed scan %u..%u of %u", scan->iface->path,
+            scan->pos + 1, scan->pos + n, scan->count);
+        memcpy(ssids, scan->ssids + scan->pos, sizeof(ssids[0]) * n);
+        ssids[n] = NULL;
+        scan->pos += n;
+        scan->started = FALSE;
+        scan->scanning = FALSE;
+        scan->params.ssids = ssids;
+
+        /* Each batch gets its own time limit */
+        gsupplicant_interface_directed_scan_stop_timer(scan);
+        scan->timeout = g_timeout_source_new_seconds
+            (DIRECTED_SCAN_BATCH_TIMEOUT_SEC);
+        g_source_set_callback(scan->timeout,
+            gsupplicant_interface_directed_scan_timeout, scan, NULL);
+        g_source_attach(scan->timeout, scan->iface->priv->context);
+        if (scan->batch_cancel) {
+            /* The previous batch has completed */
+            g_object_unref(scan->batch_cancel);
+        }
+        scan->batch_cancel = g_cancellable_new();
+        if (gsupplicant_interface_scan_full(scan->iface, scan->batch_cancel,
+            &scan->params, gsupplicant_interface_directed_scan_call_done,
+            NULL, scan)) {
+            scan->params.ssids = NULL;
+            g_free(ssids);
+        } else {
+            g_free(ssids);
+            gsupplicant_interface_directed_scan_fail(scan,
+                "Interface is not valid");
+        }
+    } else {
+        gsupplicant_interface_directed_scan_done(scan, NULL);
+    }
+}
+
+static
+void
+gsupplicant_interface_directed_scan_call_done(
+    GSupplicantInterface* iface,
+    GCancellable* cancel,
+    const GError* error,
+    void* data)
+{
+    GSupplicantInterfaceDirectedScan* scan = data;
+
+    if (error) {
+        gsupplicant_interface_directed_scan_done(scan, error);
+    } else {
+        scan->started = TRUE;
+        if (scan->scanning && !iface->scanning) {
+            /* This batch is already done */
+            gsupplicant_interface_directed_scan_next(scan);
+        }
+    }
+}
+
+static
+void
+gsupplicant_interface_directed_scan_scanning_changed(
+    GSupplicantInterface* iface,
+    void* data)
+{
+    GSupplicantInterfaceDirectedScan* scan = data;
+
+    if (iface->scanning) {
+        scan->scanning = TRUE;
+    } else if (scan->scanning && scan->started) {
+        /* Submit the next batch right away */
+        gsupplicant_interface_directed_scan_next(scan);
+    }
+}
+
+static
+void
+gsupplicant_interface_directed_scan_valid_changed(
+    GSupplicantInterface* iface,
+    void* data)
+{
+    if (!iface->valid) {
+        gsupplicant_interface_directed_scan_fail(data, "Interface is gone");
+    }
+}
+
+static
+int
+gsupplicant_interface_directed_scan_compare(
+    const void* a,
+    const void* b)
+{
+    const GSupplicantDirectedScanSSID* s1 =
+        *(const GSupplicantDirectedScanSSID* const*)a;
+    const GSupplicantDirectedScanSSID* s2 =
+        *(const GSupplicantDirectedScanSSID* const*)b;
+
+    /* Higher priority first, otherwise keep the original order */
+    return (s1->priority > s2->priority) ? -1 :
+        (s1->priority < s2->priority) ? 1 :
+        (s1 < s2) ? -1 : (s1 > s2) ? 1 : 0;
+}
+
+static
+GSupplicantInterfaceDirectedScan*
+gsupplicant_interface_directed_scan_new(
+    GSupplicantInterface* iface,
+    GCancellable* cancel,
+    const GSupplicantScanParams* params,
+    const GSupplicantDirectedScanSSID* ssids,
+    guint count,
+    GSupplicantInterfaceResultFunc fn,
+    GDestroyNotify destroy,
+    void* data)
+{
+    GSupplicantInterfaceDirectedScan* scan =
+        g_slice_new0(GSupplicantInterfaceDirectedScan);
+    const GSupplicantDirectedScanSSID** sorted =
+        g_new(const GSupplicantDirectedScanSSID*, count);
+    const gint max_ssids = iface->caps.max_scan_ssid;
+    guint i, n = 0;
+
+    scan->iface = gsupplicant_interface_ref(iface);
+    scan->cancel = cancel ? g_object_ref(cancel) : g_cancellable_new();
+    scan->cancel_id = g_signal_connect(scan->cancel, "cancelled",
+        G_CALLBACK(gsupplicant_interface_directed_scan_cancelled), scan);
+    scan->batch = (max_ssids > 0) ? MIN(max_ssids, DIRECTED_SCAN_MAX_SSIDS) :
+        1;
+    scan->fn = fn;
+    scan->destroy = destroy;
+    scan->data = data;
+
+    /* Sort SSIDs by priority */
+    for (i = 0; i < count; i++) {
+        if (ssids[i].ssid) {
+            sorted[n++] = ssids + i;
+        }
+    }
+    qsort(sorted, n, sizeof(sorted[0]),
+        gsupplicant_interface_directed_scan_compare);
+    scan->ssids = g_new(GBytes*, n + 1);
+    for (i = 0; i < n; i++) {
+        scan->ssids[i] = g_bytes_ref(sorted[i]->ssid);
+    }
+    scan->ssids[n] = NULL;
+    scan->count = n;
+    g_free(sorted);
+
+    /* Copy the rest of parameters */
+    if (params) {
+        scan->params.flags = params->flags;
+        scan->params.allow_roam = params->allow_roam;
+        if (params->ies) {
+            GBytes** ptr;
+            guint k = 0;
+
+            for (ptr = params->ies; *ptr; ptr++) k++;
+            scan->params.ies = g_new(GBytes*, k + 1);
+            for (k = 0, ptr = params->ies; *ptr; ptr++) {
+                scan->params.ies[k++] = g_bytes_ref(*ptr);
+            }
+            scan->params.ies[k] = NULL;
+        }
+        if (params->channels && params->channels->count) {
+            scan->channels.count = params->channels->count;
+            scan->channels.freq = gutil_memdup(params->channels->freq,
+                sizeof(GSupplicantScanFrequency) * scan->channels.count);
+            scan->params.channels = &scan->channels;
+        }
+    }
+    scan->params.type = GSUPPLICANT_SCAN_TYPE_ACTIVE;
+
+    /* Track the progress */
+    scan->iface_handler_id[DIRECTED_SCAN_VALID_CHANGED] =
+        gsupplicant_interface_add_handler(iface,
+            GSUPPLICANT_INTERFACE_PROPERTY_VALID,
+            gsupplicant_interface_directed_scan_valid_changed, scan);
+    scan->iface_handler_id[DIRECTED_SCAN_SCANNING_CHANGED] =
+        gsupplicant_interface_add_handler(iface,
+            GSUPPLICANT_INTERFACE_PROPERTY_SCANNING,
+            gsupplicant_interface_directed_scan_scanning_changed, scan);
+    return scan;
+}
+
 static
 void
 gsupplicant_interface_update_valid(
@@ -1485,7 +2069,8 @@ gsupplicant_interface_update_present(
 {
     GSupplicantInterfacePriv* priv = self->priv;
     const gboolean present = priv->proxy && self->supplicant->valid &&
-        gutil_strv_contains(self->supplicant->interfaces, priv->path);
+        gsupplicant_intern_strv_contains(self->supplicant->interfaces,
+            priv->path);
     if (self->present != present) {
         self->present = present;
         GDEBUG("interface %s is %spresent", priv->path, present ? "" : "not ");
@@ -1585,6 +2170,7 @@ gsupplicant_interface_update_state(
         G_N_ELEMENTS(gsupplicant_interface_states),
         GSUPPLICANT_INTERFACE_STATE_UNKNOWN);
     if (self->state != state) {
+        GSUPPLICANT_TRACE3(state_changed, self->path, self->state, state);
         self->state = state;
         priv->pending_signals |= SIGNAL_BIT(STATE);
         GVERBOSE("[%s] %s: %s", priv->path, PROXY_PROPERTY_NAME_STATE,
@@ -1609,15 +2195,90 @@ gsupplicant_interface_update_scanning(
 
 static
 void
-gsupplicant_interface_update_ap_scan(
+gsupplicant_interface_adapt_filter(
     GSupplicantInterface* self)
 {
     GSupplicantInterfacePriv* priv = self->priv;
-    const guint val = fi_w1_wpa_supplicant1_interface_get_ap_scan(priv->proxy);
-    if (self->ap_scan != val) {
-        self->ap_scan = val;
-        priv->pending_signals |= SIGNAL_BIT(AP_SCAN);
-        GVERBOSE("[%s] %s: %u", priv->path, PROXY_PROPERTY_NAME_AP_SCAN, val);
+    const GSupplicantFilterPolicy* policy = &priv->filter_policy;
+    const guint count = gutil_strv_length(priv->bsss);
+    gint rssi = priv->filter_rssi;
+
+    /*
+     * BSSs which no longer pass the filter stay around until they
+     * expire, so the threshold moves by one step per scan.
+     */
+    if (count > policy->dense_count) {
+        rssi = MIN(rssi + (gint)policy->step, policy->max_rssi);
+    } else if (count < policy->sparse_count) {
+        rssi = MAX(rssi - (gint)policy->step, policy->min_rssi);
+    }
+    if (rssi != priv->filter_rssi) {
+        GDEBUG("[%s] %u BSS(s), %s %d", priv->path, count,
+            PROXY_PROPERTY_NAME_FILTER_RSSI, rssi);
+        gsupplicant_interface_set_filter_rssi(self, rssi);
+    }
+}
+
+static
+void
+gsupplicant_interface_bss_flush_done(
+    GSupplicantInterface* iface,
+    GCancellable* cancel,
+    const GError* error,
+    void* data)
+{
+    iface->priv->bss_flushing = FALSE;
+}
+
+static
+gboolean
+gsupplicant_interface_bss_flush_timer(
+    gpointer data)
+{
+    GSupplicantInterface* self = GSUPPLICANT_INTERFACE(data);
+    GSupplicantInterfacePriv* priv = self->priv;
+
+    /*
+     * The cached Age values can't tell which BSSs are stale (they're
+     * only updated together with the other BSS properties, and not all
+     * BSSs have client objects anyway). wpa_supplicant knows better,
+     * it's one D-Bus call per interval.
+     */
+    if (self->valid && !self->scanning && !priv->bss_flushing) {
+        GDEBUG("[%s] Flushing BSSs older than %u sec", priv->path,
+            priv->bss_expiry.max_age);
+        priv->bss_flushing = (gsupplicant_interface_remove_flush_bss(self,
+            priv->bss_expiry.max_age, gsupplicant_interface_bss_flush_done,
+            NULL) != NULL);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static
+void
+gsupplicant_interface_bss_flush_stop(
+    GSupplicantInterface* self)
+{
+    GSupplicantInterfacePriv* priv = self->priv;
+
+    if (priv->bss_flush_timer) {
+        g_source_destroy(priv->bss_flush_timer);
+        g_source_unref(priv->bss_flush_timer);
+        priv->bss_flush_timer = NULL;
+    }
+}
+
+static
+void
+gsupplicant_interface_update_ap_scan(
+    GSupplicantInterface* self)
+{
+    GSupplicantInterfacePriv* priv = self->priv;
+    const guint val = fi_w1_wpa_supplicant1_interface_get_ap_scan(priv->proxy);
+    if (self->ap_scan != val) {
+        self->ap_scan = val;
+        priv->pending_signals |= SIGNAL_BIT(AP_SCAN);
+        GVERBOSE("[%s] %s: %u", priv->path, PROXY_PROPERTY_NAME_AP_SCAN, val);
     }
 }
 
@@ -1636,6 +2297,21 @@ gsupplicant_interface_update_scan_interval(
     }
 }
 
+static
+void
+gsupplicant_interface_update_filter_rssi(
+    GSupplicantInterface* self)
+{
+    GSupplicantInterfacePriv* priv = self->priv;
+    const char* value =
+        fi_w1_wpa_supplicant1_interface_get_filter_rssi(priv->proxy);
+
+    /* Not a public property, there's no signal for it */
+    priv->filter_rssi = value ? atoi(value) : 0;
+    GVERBOSE("[%s] %s: %d", priv->path, PROXY_PROPERTY_NAME_FILTER_RSSI,
+        priv->filter_rssi);
+}
+
 static
 void
 gsupplicant_interface_update_country(
@@ -1752,22 +2428,13 @@ gsupplicant_interface_update_bsss(
      * returns shallow copy, i.e. the return result should be released
      * with g_free(), but the individual strings must not be modified. */
     if (!gutil_strv_equal((const GStrV*)bsss, priv->bsss)) {
-#if STRV_GETTERS_RETURN_SHALLOW_COPY
-        GStrV* ptr;
-        for (ptr = bsss; *ptr; ptr++) {
-            *ptr = g_strdup(*ptr);
-        }
-#else
-        bsss = g_strdupv(bsss);
-#endif
-        g_strfreev(priv->bsss);
-        self->bsss = priv->bsss = bsss;
+        GStrV* ibsss = gsupplicant_intern_strv((const GStrV*)bsss);
+        gsupplicant_intern_strv_free(priv->bsss);
+        self->bsss = priv->bsss = ibsss;
         priv->pending_signals |= SIGNAL_BIT(BSSS);
     }
 #if STRV_GETTERS_RETURN_SHALLOW_COPY
-    else {
-        g_free(bsss);
-    }
+    g_free(bsss);
 #endif
 }
 
@@ -1783,22 +2450,13 @@ gsupplicant_interface_update_networks(
      * returns shallow copy, i.e. the return result should be released
      * with g_free(), but the individual strings must not be modified. */
     if (!gutil_strv_equal((const GStrV*)networks, priv->networks)) {
-#if STRV_GETTERS_RETURN_SHALLOW_COPY
-        GStrV* ptr;
-        for (ptr = networks; *ptr; ptr++) {
-            *ptr = g_strdup(*ptr);
-        }
-#else
-        networks = g_strdupv(networks);
-#endif
-        g_strfreev(priv->networks);
-        self->networks = priv->networks = networks;
+        GStrV* inetworks = gsupplicant_intern_strv((const GStrV*)networks);
+        gsupplicant_intern_strv_free(priv->networks);
+        self->networks = priv->networks = inetworks;
         priv->pending_signals |= SIGNAL_BIT(NETWORKS);
     }
 #if STRV_GETTERS_RETURN_SHALLOW_COPY
-    else {
-        g_free(networks);
-    }
+    g_free(networks);
 #endif
 }
 
@@ -1877,6 +2535,9 @@ gsupplicant_interface_notify_scanning(
 {
     GSupplicantInterface* self = GSUPPLICANT_INTERFACE(data);
     gsupplicant_interface_update_scanning(self);
+    if (self->priv->filter_adaptive && self->valid && !self->scanning) {
+        gsupplicant_interface_adapt_filter(self);
+    }
     gsupplicant_interface_emit_pending_signals(self);
 }
 
@@ -1904,6 +2565,16 @@ gsupplicant_interface_notify_scan_interval(
     gsupplicant_interface_emit_pending_signals(self);
 }
 
+static
+void
+gsupplicant_interface_notify_filter_rssi(
+    FiW1Wpa_supplicant1Interface* proxy,
+    GParamSpec* param,
+    gpointer data)
+{
+    gsupplicant_interface_update_filter_rssi(GSUPPLICANT_INTERFACE(data));
+}
+
 static
 void
 gsupplicant_interface_notify_caps(
@@ -2092,6 +2763,55 @@ gsupplicant_interface_proxy_eap(
     }
 }
 
+static
+gboolean
+gsupplicant_interface_sched_scan_enabled(
+    GSupplicantInterface* self)
+{
+    FiW1Wpa_supplicant1Interface* proxy = self->priv->proxy;
+    const char* plans =
+        fi_w1_wpa_supplicant1_interface_get_sched_scan_plans(proxy);
+    const char* interval =
+        fi_w1_wpa_supplicant1_interface_get_sched_scan_interval(proxy);
+    const char* disable_offload =
+        fi_w1_wpa_supplicant1_interface_get_disable_scan_offload(proxy);
+
+    /* Scheduled scans need a plan or an interval and offload enabled */
+    return ((plans && plans[0]) || (interval && atoi(interval) > 0)) &&
+        !(disable_offload && atoi(disable_offload));
+}
+
+static
+void
+gsupplicant_interface_proxy_scan_done(
+    FiW1Wpa_supplicant1Interface* proxy,
+    gboolean success,
+    gpointer data)
+{
+    GSupplicantInterface* self = GSUPPLICANT_INTERFACE(data);
+    GSupplicantInterfacePriv* priv = self->priv;
+    GSupplicantScanSourceStats* stats = &priv->scan_source_stats;
+
+    if (priv->host_scan) {
+        GDEBUG("[%s] Host scan done, %u new BSS(s)", priv->path,
+            priv->new_bsss);
+        priv->host_scan = FALSE;
+        stats->host_scans++;
+        stats->host_results += priv->new_bsss;
+    } else if (gsupplicant_interface_sched_scan_enabled(self)) {
+        GDEBUG("[%s] Offloaded scan done, %u new BSS(s)", priv->path,
+            priv->new_bsss);
+        stats->offloaded_scans++;
+        stats->offloaded_results += priv->new_bsss;
+    } else {
+        GDEBUG("[%s] Other scan done, %u new BSS(s)", priv->path,
+            priv->new_bsss);
+        stats->other_scans++;
+        stats->other_results += priv->new_bsss;
+    }
+    priv->new_bsss = 0;
+}
+
 static
 void
 gsupplicant_interface_proxy_bss_added(
@@ -2102,12 +2822,16 @@ gsupplicant_interface_proxy_bss_added(
 {
     GSupplicantInterface* self = GSUPPLICANT_INTERFACE(data);
     GSupplicantInterfacePriv* priv = self->priv;
+    const char* ipath = gsupplicant_intern(path);
     GDEBUG("BSS added: %s", path);
-    if (!gutil_strv_contains(priv->bsss, path)) {
-        self->bsss = priv->bsss = gutil_strv_add(priv->bsss, path);
+    priv->new_bsss++;
+    if (!gsupplicant_intern_strv_contains(priv->bsss, ipath)) {
+        self->bsss = priv->bsss = gsupplicant_intern_strv_add(priv->bsss,
+            ipath);
         priv->pending_signals |= SIGNAL_BIT(BSSS);
         gsupplicant_interface_emit_pending_signals(self);
     }
+    gsupplicant_intern_unref(ipath);
 }
 
 static
@@ -2119,10 +2843,12 @@ gsupplicant_interface_proxy_bss_removed(
 {
     GSupplicantInterface* self = GSUPPLICANT_INTERFACE(data);
     GSupplicantInterfacePriv* priv = self->priv;
-    const int pos = gutil_strv_find(priv->bsss, path);
+    const int pos = gsupplicant_intern_strv_find(priv->bsss,
+        gsupplicant_intern_find(path));
     GDEBUG("BSS removed: %s", path);
     if (pos >= 0) {
-        self->bsss = priv->bsss = gutil_strv_remove_at(priv->bsss, pos, TRUE);
+        self->bsss = priv->bsss = gsupplicant_intern_strv_remove_at(priv->bsss,
+            pos);
         priv->pending_signals |= SIGNAL_BIT(BSSS);
         gsupplicant_interface_emit_pending_signals(self);
     }
@@ -2138,12 +2864,15 @@ gsupplicant_interface_proxy_network_added(
 {
     GSupplicantInterface* self = GSUPPLICANT_INTERFACE(data);
     GSupplicantInterfacePriv* priv = self->priv;
+    const char* ipath = gsupplicant_intern(path);
     GDEBUG("Network added: %s", path);
-    if (!gutil_strv_contains(priv->networks, path)) {
-        self->networks = priv->networks = gutil_strv_add(priv->networks, path);
+    if (!gsupplicant_intern_strv_contains(priv->networks, ipath)) {
+        self->networks = priv->networks =
+            gsupplicant_intern_strv_add(priv->networks, ipath);
         priv->pending_signals |= SIGNAL_BIT(NETWORKS);
         gsupplicant_interface_emit_pending_signals(self);
     }
+    gsupplicant_intern_unref(ipath);
 }
 
 static
@@ -2155,11 +2884,12 @@ gsupplicant_interface_proxy_network_removed(
 {
     GSupplicantInterface* self = GSUPPLICANT_INTERFACE(data);
     GSupplicantInterfacePriv* priv = self->priv;
-    const int pos = gutil_strv_find(priv->networks, path);
+    const int pos = gsupplicant_intern_strv_find(priv->networks,
+        gsupplicant_intern_find(path));
     GDEBUG("Network removed: %s", path);
     if (pos >= 0) {
         self->networks = priv->networks =
-            gutil_strv_remove_at(priv->networks, pos, TRUE);
+            gsupplicant_intern_strv_remove_at(priv->networks, pos);
         priv->pending_signals |= SIGNAL_BIT(NETWORKS);
         gsupplicant_interface_emit_pending_signals(self);
     }
@@ -2183,6 +2913,16 @@ gsupplicant_interface_proxy_network_selected(
     }
 }
 
+static
+void
+gsupplicant_interface_station_free(
+    gpointer data)
+{
+    GSupplicantStation* sta = data;
+    g_free((char*)sta->address);
+    g_slice_free(GSupplicantStation, sta);
+}
+
 static
 void
 gsupplicant_interface_proxy_sta_authorized(
@@ -2193,8 +2933,27 @@ gsupplicant_interface_proxy_sta_authorized(
     GSupplicantInterface* self = GSUPPLICANT_INTERFACE(data);
     GSupplicantInterfacePriv* priv = self->priv;
     GDEBUG("Station authorized: %s", mac);
-    if (!gutil_strv_contains(priv->stations, mac)) {
-        self->stations = priv->stations = gutil_strv_add(priv->stations, mac);
+    if (!priv->station_table) {
+        priv->station_table = g_hash_table_new_full(g_str_hash, g_str_equal,
+            NULL, gsupplicant_interface_station_free);
+        priv->stations = g_ptr_array_new();
+        g_ptr_array_add(priv->stations, NULL);
+    }
+    if (!g_hash_table_contains(priv->station_table, mac)) {
+        GSupplicantStation* sta = g_slice_new0(GSupplicantStation);
+        GPtrArray* list = priv->stations;
+
+        sta->address = g_strdup(mac);
+        sta->connected = g_get_monotonic_time();
+        sta->connected_real = g_get_real_time();
+        g_hash_table_insert(priv->station_table, (gpointer)sta->address, sta);
+
+        /* Replace the NULL terminator and add a new one */
+        list->pdata[list->len - 1] = (gpointer)sta->address;
+        g_ptr_array_add(list, NULL);
+        self->stations = (GStrV*)list->pdata;
+        g_signal_emit(self, gsupplicant_interface_signals
+            [SIGNAL_STATION_ADDED], 0, sta);
         priv->pending_signals |= SIGNAL_BIT(STATIONS);
         gsupplicant_interface_emit_pending_signals(self);
     }
@@ -2209,16 +2968,100 @@ gsupplicant_interface_proxy_sta_deauthorized(
 {
     GSupplicantInterface* self = GSUPPLICANT_INTERFACE(data);
     GSupplicantInterfacePriv* priv = self->priv;
-    const int pos = gutil_strv_find(priv->stations, mac);
+    GSupplicantStation* sta = priv->station_table ?
+        g_hash_table_lookup(priv->station_table, mac) : NULL;
     GDEBUG("Station deauthorized: %s", mac);
-    if (pos >= 0) {
-        self->stations = priv->stations =
-            gutil_strv_remove_at(priv->stations, pos, TRUE);
+    if (sta) {
+        GPtrArray* list = priv->stations;
+        guint i;
+
+        /* Keep the order, the following ones (and the NULL) get shifted */
+        for (i = 0; list->pdata[i] != sta->address; i++);
+        g_ptr_array_remove_index(list, i);
+        self->stations = (list->len > 1) ? (GStrV*)list->pdata : NULL;
+        g_hash_table_steal(priv->station_table, mac);
+        g_signal_emit(self, gsupplicant_interface_signals
+            [SIGNAL_STATION_REMOVED], 0, sta);
+        gsupplicant_interface_station_free(sta);
         priv->pending_signals |= SIGNAL_BIT(STATIONS);
         gsupplicant_interface_emit_pending_signals(self);
     }
 }
 
+static
+void
+gsupplicant_interface_update_all(
+    GSupplicantInterface* self)
+{
+    gsupplicant_interface_update_valid(self);
+    gsupplicant_interface_update_present(self);
+    gsupplicant_interface_update_caps(self);
+    gsupplicant_interface_update_state(self);
+    gsupplicant_interface_update_scanning(self);
+    gsupplicant_interface_update_ap_scan(self);
+    gsupplicant_interface_update_scan_interval(self);
+    gsupplicant_interface_update_filter_rssi(self);
+    gsupplicant_interface_update_country(self);
+    gsupplicant_interface_update_driver(self);
+    gsupplicant_interface_update_ifname(self);
+    gsupplicant_interface_update_bridge_ifname(self);
+    gsupplicant_interface_update_current_bss(self);
+    gsupplicant_interface_update_current_network(self);
+    gsupplicant_interface_update_bsss(self);
+    gsupplicant_interface_update_networks(self);
+    gsupplicant_interface_update_sae_check_mfp(self);
+    gsupplicant_interface_update_sae_pwe(self);
+}
+
+/* See the resync comment in gsupplicant.c */
+static
+void
+gsupplicant_interface_resync_finish(
+    GSupplicantInterface* self)
+{
+    GSupplicantInterfacePriv* priv = self->priv;
+
+    priv->resyncing = FALSE;
+    gsupplicant_unblock_handlers(priv->proxy, priv->proxy_handler_id,
+        G_N_ELEMENTS(priv->proxy_handler_id));
+    gsupplicant_interface_update_all(self);
+}
+
+static
+void
+gsupplicant_interface_resync_properties_changed(
+    GDBusProxy* proxy,
+    GVariant* changed,
+    GStrv invalidated,
+    gpointer data)
+{
+    GSupplicantInterface* self = GSUPPLICANT_INTERFACE(data);
+    GSupplicantInterfacePriv* priv = self->priv;
+
+    if (!priv->resyncing && gsupplicant_resync_enabled(self->supplicant) &&
+        self->supplicant->valid && !gsupplicant_proxy_has_owner(proxy)) {
+        GDEBUG("[%s] Resyncing", priv->path);
+        priv->resyncing = TRUE;
+        gsupplicant_block_handlers(priv->proxy, priv->proxy_handler_id,
+            G_N_ELEMENTS(priv->proxy_handler_id));
+    }
+}
+
+static
+void
+gsupplicant_interface_resync_notify_name_owner(
+    GDBusProxy* proxy,
+    GParamSpec* param,
+    gpointer data)
+{
+    GSupplicantInterface* self = GSUPPLICANT_INTERFACE(data);
+
+    if (self->priv->resyncing && gsupplicant_proxy_has_owner(proxy)) {
+        gsupplicant_interface_resync_finish(self);
+        gsupplicant_interface_emit_pending_signals(self);
+    }
+}
+
 static
 void
 gsupplicant_interface_supplicant_valid_changed(
@@ -2227,8 +3070,13 @@ gsupplicant_interface_supplicant_valid_changed(
 {
     GSupplicantInterface* self = GSUPPLICANT_INTERFACE(data);
     GASSERT(self->supplicant == supplicant);
-    gsupplicant_interface_update_valid(self);
-    gsupplicant_interface_update_present(self);
+    if (self->priv->resyncing) {
+        /* The supplicant has given up waiting */
+        gsupplicant_interface_resync_finish(self);
+    } else {
+        gsupplicant_interface_update_valid(self);
+        gsupplicant_interface_update_present(self);
+    }
     gsupplicant_interface_emit_pending_signals(self);
 }
 
@@ -2244,6 +3092,36 @@ gsupplicant_interface_supplicant_interfaces_changed(
     gsupplicant_interface_emit_pending_signals(self);
 }
 
+#if GSUPPLICANT_TRACE_ENABLED
+/*
+ * The notify:: signals are emitted by the default handler of
+ * g-properties-changed, these two bracket the whole dispatch.
+ */
+static
+void
+gsupplicant_interface_trace_properties_changed(
+    GDBusProxy* proxy,
+    GVariant* changed,
+    GStrv invalidated,
+    gpointer data)
+{
+    GSUPPLICANT_TRACE4(properties_changed, "interface",
+        GSUPPLICANT_INTERFACE(data)->path, changed, invalidated);
+}
+
+static
+void
+gsupplicant_interface_trace_properties_changed_done(
+    GDBusProxy* proxy,
+    GVariant* changed,
+    GStrv invalidated,
+    gpointer data)
+{
+    GSUPPLICANT_TRACE2(properties_changed_done, "interface",
+        GSUPPLICANT_INTERFACE(data)->path);
+}
+#endif
+
 static
 void
 gsupplicant_interface_create2(
@@ -2258,7 +3136,17 @@ gsupplicant_interface_create2(
     GASSERT(!priv->proxy);
     priv->proxy = fi_w1_wpa_supplicant1_interface_proxy_new_for_bus_finish(
         result, &error);
+    GSUPPLICANT_TRACE3(proxy_ready, "interface", self->path,
+        priv->proxy != NULL);
     if (priv->proxy) {
+        priv->resync_handler_id[RESYNC_PROPERTIES_CHANGED] =
+            g_signal_connect(priv->proxy, "g-properties-changed",
+            G_CALLBACK(gsupplicant_interface_resync_properties_changed),
+            self);
+        priv->resync_handler_id[RESYNC_NOTIFY_NAME_OWNER] =
+            g_signal_connect(priv->proxy, "notify::g-name-owner",
+            G_CALLBACK(gsupplicant_interface_resync_notify_name_owner),
+            self);
         priv->proxy_handler_id[PROXY_BSS_ADDED] =
             g_signal_connect(priv->proxy, "bssadded",
             G_CALLBACK(gsupplicant_interface_proxy_bss_added), self);
@@ -2326,9 +3214,24 @@ gsupplicant_interface_create2(
         priv->proxy_handler_id[PROXY_NOTIFY_SAE_PWE] =
             g_signal_connect(priv->proxy, "notify::sae-pwe",
             G_CALLBACK(gsupplicant_interface_notify_sae_pwe), self);
+        priv->proxy_handler_id[PROXY_NOTIFY_FILTER_RSSI] =
+            g_signal_connect(priv->proxy, "notify::filter-rssi",
+            G_CALLBACK(gsupplicant_interface_notify_filter_rssi), self);
         priv->proxy_handler_id[PROXY_EAP] =
             g_signal_connect(priv->proxy, "eap",
             G_CALLBACK(gsupplicant_interface_proxy_eap), self);
+        priv->proxy_handler_id[PROXY_SCAN_DONE] =
+            g_signal_connect(priv->proxy, "scan-done",
+            G_CALLBACK(gsupplicant_interface_proxy_scan_done), self);
+#if GSUPPLICANT_TRACE_ENABLED
+        priv->proxy_handler_id[PROXY_TRACE_PROPERTIES_CHANGED] =
+            g_signal_connect(priv->proxy, "g-properties-changed",
+            G_CALLBACK(gsupplicant_interface_trace_properties_changed), self);
+        priv->proxy_handler_id[PROXY_TRACE_PROPERTIES_CHANGED_DONE] =
+            g_signal_connect_after(priv->proxy, "g-properties-changed",
+            G_CALLBACK(gsupplicant_interface_trace_properties_changed_done),
+            self);
+#endif
 
         priv->supplicant_handler_id[SUPPLICANT_VALID_CHANGED] =
             gsupplicant_add_handler(self->supplicant,
@@ -2339,24 +3242,7 @@ gsupplicant_interface_create2(
                 GSUPPLICANT_PROPERTY_INTERFACES,
                 gsupplicant_interface_supplicant_interfaces_changed, self);
 
-        gsupplicant_interface_update_valid(self);
-        gsupplicant_interface_update_present(self);
-        gsupplicant_interface_update_caps(self);
-        gsupplicant_interface_update_state(self);
-        gsupplicant_interface_update_scanning(self);
-        gsupplicant_interface_update_ap_scan(self);
-        gsupplicant_interface_update_scan_interval(self);
-        gsupplicant_interface_update_country(self);
-        gsupplicant_interface_update_driver(self);
-        gsupplicant_interface_update_ifname(self);
-        gsupplicant_interface_update_bridge_ifname(self);
-        gsupplicant_interface_update_current_bss(self);
-        gsupplicant_interface_update_current_network(self);
-        gsupplicant_interface_update_bsss(self);
-        gsupplicant_interface_update_networks(self);
-        gsupplicant_interface_update_sae_check_mfp(self);
-        gsupplicant_interface_update_sae_pwe(self);
-
+        gsupplicant_interface_update_all(self);
         gsupplicant_interface_emit_pending_signals(self);
     } else {
         GERR("%s", GERRMSG(error));
@@ -2377,6 +3263,7 @@ gsupplicant_interface_create1(
     GError* error = NULL;
     priv->bus = g_bus_get_finish(result, &error);
     if (priv->bus) {
+        GSUPPLICANT_TRACE2(proxy_new, "interface", self->path);
         fi_w1_wpa_supplicant1_interface_proxy_new(priv->bus,
             G_DBUS_PROXY_FLAGS_NONE, GSUPPLICANT_SERVICE, priv->path, NULL,
             gsupplicant_interface_create2, gsupplicant_interface_ref(self));
@@ -2387,24 +3274,6 @@ gsupplicant_interface_create1(
     gsupplicant_interface_unref(self);
 }
 
-static
-void
-gsupplicant_interface_destroyed(
-    gpointer key,
-    GObject* dead)
-{
-    GVERBOSE_("%s", (char*)key);
-    GASSERT(gsupplicant_interface_table);
-    if (gsupplicant_interface_table) {
-        GASSERT(g_hash_table_lookup(gsupplicant_interface_table, key) == dead);
-        g_hash_table_remove(gsupplicant_interface_table, key);
-        if (g_hash_table_size(gsupplicant_interface_table) == 0) {
-            g_hash_table_unref(gsupplicant_interface_table);
-            gsupplicant_interface_table = NULL;
-        }
-    }
-}
-
 static
 GSupplicantInterface*
 gsupplicant_interface_create(
@@ -2412,8 +3281,10 @@ gsupplicant_interface_create(
 {
     GSupplicantInterface* self = g_object_new(GSUPPLICANT_INTERFACE_TYPE,NULL);
     GSupplicantInterfacePriv* priv = self->priv;
+    priv->context = g_main_context_ref_thread_default();
     self->supplicant = gsupplicant_new();
-    self->path = priv->path = g_strdup(path);
+    self->path = priv->path = gsupplicant_intern(path);
+    gsupplicant_interface_build_snapshot(self);
     g_bus_get(GSUPPLICANT_BUS_TYPE, NULL, gsupplicant_interface_create1,
         gsupplicant_interface_ref(self));
     return self;
@@ -2429,20 +3300,11 @@ gsupplicant_interface_new(
 {
     GSupplicantInterface* self = NULL;
     if (G_LIKELY(path)) {
-        self = gsupplicant_interface_table ?
-            gsupplicant_interface_ref(g_hash_table_lookup(
-                gsupplicant_interface_table, path)) : NULL;
+        self = gsupplicant_registry_get(&gsupplicant_interface_registry, path);
         if (!self) {
-            gpointer key = g_strdup(path);
             self = gsupplicant_interface_create(path);
-            if (!gsupplicant_interface_table) {
-                gsupplicant_interface_table =
-                    g_hash_table_new_full(g_str_hash, g_str_equal,
-                        g_free, NULL);
-            }
-            g_hash_table_replace(gsupplicant_interface_table, key, self);
-            g_object_weak_ref(G_OBJECT(self), gsupplicant_interface_destroyed,
-                key);
+            gsupplicant_registry_add(&gsupplicant_interface_registry,
+                self->path, self);
         }
     }
     return self;
@@ -2604,6 +3466,18 @@ gsupplicant_interface_reattach(
         fi_w1_wpa_supplicant1_interface_call_reattach);
 }
 
+GCancellable*
+gsupplicant_interface_roam(
+    GSupplicantInterface* self,
+    const char* bssid,
+    GSupplicantInterfaceResultFunc fn,
+    void* data) /* Since: 1.0.31 */
+{
+    return G_LIKELY(bssid) ? gsupplicant_interface_call_string_void(self,
+        NULL, bssid, fn, NULL, data,
+        fi_w1_wpa_supplicant1_interface_call_roam) : NULL;
+}
+
 static /* should be public? */
 GCancellable*
 gsupplicant_interface_add_blob_full(
@@ -2765,61 +3639,57 @@ gsupplicant_interface_scan(
     GSupplicantInterfaceResultFunc fn,
     void* data)
 {
-    if (G_LIKELY(self) && self->valid) {
-        GSupplicantScanParams default_params;
-        GSupplicantInterfacePriv* priv = self->priv;
-        GSupplicantInterfaceCall* call = gsupplicant_interface_call_new(self,
-            NULL, gsupplicant_interface_call_finish_void, G_CALLBACK(fn),
-            NULL, data);
-        GVariantBuilder builder;
-        GVariant* dict;
+    return gsupplicant_interface_scan_full(self, NULL, params, fn, NULL,
+        data);
+}
 
-        /* Do passive scan by default */
-        if (!params) {
-            memset(&default_params, 0, sizeof(default_params));
-            default_params.type = GSUPPLICANT_SCAN_TYPE_PASSIVE;
-            params = &default_params;
-        }
+GCancellable*
+gsupplicant_interface_directed_scan_full(
+    GSupplicantInterface* self,
+    GCancellable* cancel,
+    const GSupplicantScanParams* params,
+    const GSupplicantDirectedScanSSID* ssids,
+    guint count,
+    GSupplicantInterfaceResultFunc fn,
+    GDestroyNotify destroy,
+    void* data) /* Since: 1.0.31 */
+{
+    guint i, n = 0;
 
-        /* Prepare scan parameters */
-        g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
-        gsupplicant_dict_add_string(&builder, "Type",
-            params->type == GSUPPLICANT_SCAN_TYPE_ACTIVE ?
-            "active" : "passive");
-        if (params->ssids) {
-            gsupplicant_dict_add_value(&builder, "SSIDs",
-                gsupplicant_variant_new_ayy(params->ssids));
-        }
-        if (params->ies) {
-            gsupplicant_dict_add_value(&builder, "IEs",
-                gsupplicant_variant_new_ayy(params->ies));
-        }
-        if (params->channels) {
-            guint i;
-            const GSupplicantScanFrequency* freq = params->channels->freq;
-            GVariantBuilder auu;
-            g_variant_builder_init(&auu, G_VARIANT_TYPE("a(uu)"));
-            for (i=0; i<params->channels->count; i++, freq++) {
-                g_variant_builder_add(&auu, "(uu)", freq->center, freq->width);
-            }
-            gsupplicant_dict_add_value(&builder, "Channels",
-                g_variant_builder_end(&auu));
-        }
-        if (params->flags & GSUPPLICANT_SCAN_PARAM_ALLOW_ROAM) {
-            gsupplicant_dict_add_boolean(&builder, "AllowRoam",
-                params->allow_roam);
+    /* NULL SSIDs are skipped, there must be something to scan for */
+    for (i = 0; ssids && i < count; i++) {
+        if (ssids[i].ssid) {
+            n++;
         }
-
-        /* Submit the call */
-        dict = g_variant_ref_sink(g_variant_builder_end(&builder));
-        fi_w1_wpa_supplicant1_interface_call_scan(priv->proxy, dict,
-            call->cancel, gsupplicant_interface_call_finished, call);
-        g_variant_unref(dict);
-        return call->cancel;
     }
+    if (G_LIKELY(self) && self->valid && n &&
+        !(cancel && g_cancellable_is_cancelled(cancel))) {
+        GSupplicantInterfaceDirectedScan* scan =
+            gsupplicant_interface_directed_scan_new(self, cancel, params,
+                ssids, count, fn, destroy, data);
+        GCancellable* ret = scan->cancel;
+
+        /* The first batch may fail right away */
+        gsupplicant_interface_directed_scan_next(scan);
+        return ret;
+    }
+    gsupplicant_cancel_later(cancel);
     return NULL;
 }
 
+GCancellable*
+gsupplicant_interface_directed_scan(
+    GSupplicantInterface* self,
+    const GSupplicantScanParams* params,
+    const GSupplicantDirectedScanSSID* ssids,
+    guint count,
+    GSupplicantInterfaceResultFunc fn,
+    void* data) /* Since: 1.0.31 */
+{
+    return gsupplicant_interface_directed_scan_full(self, NULL, params,
+        ssids, count, fn, NULL, data);
+}
+
 static /* should be public? */
 GCancellable*
 gsupplicant_interface_auto_scan_full(
@@ -3282,6 +4152,624 @@ void gsupplicant_interface_set_sae_pwe(GSupplicantInterface* self,
     g_free(value);
 }
 
+GSupplicantBSS*
+gsupplicant_interface_find_bss(
+    GSupplicantInterface* self,
+    GBytes* bssid) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(bssid)) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        if (priv->bss_by_bssid) {
+            return g_hash_table_lookup(priv->bss_by_bssid, bssid);
+        }
+    }
+    return NULL;
+}
+
+const GPtrArray*
+gsupplicant_interface_find_bsss_on_frequency(
+    GSupplicantInterface* self,
+    guint frequency) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(frequency)) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        if (priv->bss_by_frequency) {
+            return g_hash_table_lookup(priv->bss_by_frequency,
+                GUINT_TO_POINTER(frequency));
+        }
+    }
+    return NULL;
+}
+
+const GSupplicantStation*
+gsupplicant_interface_find_station(
+    GSupplicantInterface* self,
+    const char* address) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(address)) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        if (priv->station_table) {
+            return g_hash_table_lookup(priv->station_table, address);
+        }
+    }
+    return NULL;
+}
+
+gulong
+gsupplicant_interface_add_station_added_handler(
+    GSupplicantInterface* self,
+    GSupplicantInterfaceStationFunc fn,
+    void* data) /* Since: 1.0.31 */
+{
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+        SIGNAL_STATION_ADDED_NAME, G_CALLBACK(fn), data) : 0;
+}
+
+gulong
+gsupplicant_interface_add_station_removed_handler(
+    GSupplicantInterface* self,
+    GSupplicantInterfaceStationFunc fn,
+    void* data) /* Since: 1.0.31 */
+{
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+        SIGNAL_STATION_REMOVED_NAME, G_CALLBACK(fn), data) : 0;
+}
+
+const GSupplicantInterfaceSnapshot*
+gsupplicant_interface_get_snapshot(
+    GSupplicantInterface* self) /* Since: 1.0.31 */
+{
+    /* Called on arbitrary threads, only touches the slot */
+    return G_LIKELY(self) ?
+        gsupplicant_snapshot_slot_get(&self->priv->snapshot) : NULL;
+}
+
+const GSupplicantScanTimes*
+gsupplicant_interface_get_scan_times(
+    GSupplicantInterface* self) /* Since: 1.0.31 */
+{
+    return G_LIKELY(self) ? &self->priv->scan_times : NULL;
+}
+
+gboolean
+gsupplicant_interface_set_filter_ssids(
+    GSupplicantInterface* self,
+    gboolean enable) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && self->valid) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        GDEBUG("[%s] %s: %s", priv->path, PROXY_PROPERTY_NAME_FILTER_SSIDS,
+            enable ? "1" : "0");
+        fi_w1_wpa_supplicant1_interface_set_filter_ssids(priv->proxy,
+            enable ? "1" : "0");
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+gsupplicant_interface_set_filter_rssi(
+    GSupplicantInterface* self,
+    gint rssi) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && self->valid) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        char* value = g_strdup_printf("%d", rssi);
+        GDEBUG("[%s] %s: %s", priv->path, PROXY_PROPERTY_NAME_FILTER_RSSI,
+            value);
+        fi_w1_wpa_supplicant1_interface_set_filter_rssi(priv->proxy, value);
+        priv->filter_rssi = rssi;
+        g_free(value);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gint
+gsupplicant_interface_get_filter_rssi(
+    GSupplicantInterface* self) /* Since: 1.0.31 */
+{
+    return G_LIKELY(self) ? self->priv->filter_rssi : 0;
+}
+
+gboolean
+gsupplicant_interface_set_bss_max_count(
+    GSupplicantInterface* self,
+    guint count) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && self->valid && G_LIKELY(count)) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        char* value = g_strdup_printf("%u", count);
+        GDEBUG("[%s] %s: %s", priv->path, PROXY_PROPERTY_NAME_BSS_MAX_COUNT,
+            value);
+        fi_w1_wpa_supplicant1_interface_set_bss_max_count(priv->proxy, value);
+        g_free(value);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+gsupplicant_interface_set_filter_policy(
+    GSupplicantInterface* self,
+    const GSupplicantFilterPolicy* policy) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        if (!policy) {
+            priv->filter_adaptive = FALSE;
+            return TRUE;
+        } else if (policy->step && policy->min_rssi <= policy->max_rssi &&
+            policy->sparse_count <= policy->dense_count) {
+            priv->filter_policy = *policy;
+            priv->filter_adaptive = TRUE;
+            if (self->valid && (priv->filter_rssi < policy->min_rssi ||
+                priv->filter_rssi > policy->max_rssi)) {
+                gsupplicant_interface_set_filter_rssi(self,
+                    CLAMP(priv->filter_rssi, policy->min_rssi,
+                    policy->max_rssi));
+            }
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+gboolean
+gsupplicant_interface_set_bss_expire_age(
+    GSupplicantInterface* self,
+    guint seconds) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && self->valid) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        GDEBUG("[%s] %s: %u", priv->path, PROXY_PROPERTY_NAME_BSS_EXPIRE_AGE,
+            seconds);
+        fi_w1_wpa_supplicant1_interface_set_bssexpire_age(priv->proxy,
+            seconds);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+gsupplicant_interface_set_bss_expire_count(
+    GSupplicantInterface* self,
+    guint count) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && self->valid) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        GDEBUG("[%s] %s: %u", priv->path,
+            PROXY_PROPERTY_NAME_BSS_EXPIRE_COUNT, count);
+        fi_w1_wpa_supplicant1_interface_set_bssexpire_count(priv->proxy,
+            count);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+gsupplicant_interface_set_bss_expiry(
+    GSupplicantInterface* self,
+    const GSupplicantBSSExpiry* expiry) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        if (!expiry) {
+            gsupplicant_interface_bss_flush_stop(self);
+            return TRUE;
+        } else if (self->valid &&
+            /* FlushBSS with zero age would flush everything */
+            (expiry->max_age || !expiry->flush_interval)) {
+            if (expiry->max_age) {
+                gsupplicant_interface_set_bss_expire_age(self,
+                    expiry->max_age);
+            }
+            if (expiry->max_count) {
+                gsupplicant_interface_set_bss_expire_count(self,
+                    expiry->max_count);
+            }
+            priv->bss_expiry = *expiry;
+            gsupplicant_interface_bss_flush_stop(self);
+            if (expiry->flush_interval) {
+                /* Attached to the context the interface is bound to */
+                priv->bss_flush_timer = g_timeout_source_new_seconds
+                    (expiry->flush_interval);
+                g_source_set_callback(priv->bss_flush_timer,
+                    gsupplicant_interface_bss_flush_timer, self, NULL);
+                g_source_attach(priv->bss_flush_timer, priv->context);
+            }
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+gboolean
+gsupplicant_interface_set_sched_scan_interval(
+    GSupplicantInterface* self,
+    guint seconds) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && self->valid && G_LIKELY(seconds)) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        char* value = g_strdup_printf("%u", seconds);
+        GDEBUG("[%s] %s: %s", priv->path,
+            PROXY_PROPERTY_NAME_SCHED_SCAN_INTERVAL, value);
+        fi_w1_wpa_supplicant1_interface_set_sched_scan_interval(priv->proxy,
+            value);
+        g_free(value);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+gsupplicant_interface_set_sched_scan_plans(
+    GSupplicantInterface* self,
+    const char* plans) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && self->valid) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        if (!plans) plans = "";
+        GDEBUG("[%s] %s: %s", priv->path,
+            PROXY_PROPERTY_NAME_SCHED_SCAN_PLANS, plans);
+        fi_w1_wpa_supplicant1_interface_set_sched_scan_plans(priv->proxy,
+            plans);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+gsupplicant_interface_set_scan_offload(
+    GSupplicantInterface* self,
+    gboolean enable) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && self->valid) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        GDEBUG("[%s] %s: %s", priv->path,
+            PROXY_PROPERTY_NAME_DISABLE_SCAN_OFFLOAD, enable ? "0" : "1");
+        fi_w1_wpa_supplicant1_interface_set_disable_scan_offload(priv->proxy,
+            enable ? "0" : "1");
+        return TRUE;
+    }
+    return FALSE;
+}
+
+const GSupplicantScanSourceStats*
+gsupplicant_interface_get_scan_source_stats(
+    GSupplicantInterface* self) /* Since: 1.0.31 */
+{
+    return G_LIKELY(self) ? &self->priv->scan_source_stats : NULL;
+}
+
+gboolean
+gsupplicant_interface_set_okc(
+    GSupplicantInterface* self,
+    gboolean enable) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && self->valid) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        GDEBUG("[%s] %s: %s", priv->path, PROXY_PROPERTY_NAME_OKC,
+            enable ? "1" : "0");
+        fi_w1_wpa_supplicant1_interface_set_okc(priv->proxy,
+            enable ? "1" : "0");
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+gsupplicant_interface_set_pmf(
+    GSupplicantInterface* self,
+    GSUPPLICANT_MFP_OPTIONS pmf) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && self->valid && pmf <= GSUPPLICANT_MFP_REQUIRED) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        char* value = g_strdup_printf("%u", pmf);
+        GDEBUG("[%s] %s: %s", priv->path, PROXY_PROPERTY_NAME_PMF, value);
+        fi_w1_wpa_supplicant1_interface_set_pmf(priv->proxy, value);
+        g_free(value);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+gsupplicant_interface_set_fast_reauth(
+    GSupplicantInterface* self,
+    gboolean enable) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && self->valid) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        GDEBUG("[%s] %s: %s", priv->path, PROXY_PROPERTY_NAME_FAST_REAUTH,
+            enable ? "true" : "false");
+        fi_w1_wpa_supplicant1_interface_set_fast_reauth(priv->proxy, enable);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+gsupplicant_interface_set_bgscan(
+    GSupplicantInterface* self,
+    const char* bgscan) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && self->valid) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        if (!bgscan) bgscan = "";
+        GDEBUG("[%s] %s: %s", priv->path, PROXY_PROPERTY_NAME_BGSCAN, bgscan);
+        fi_w1_wpa_supplicant1_interface_set_bgscan(priv->proxy, bgscan);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/*==========================================================================*
+ * Internal API
+ *==========================================================================*/
+
+static
+void
+gsupplicant_interface_bss_index_remove_bssid(
+    GSupplicantInterfacePriv* priv,
+    GSupplicantBSS* bss,
+    GBytes* bssid)
+{
+    if (bssid && priv->bss_by_bssid &&
+        g_hash_table_lookup(priv->bss_by_bssid, bssid) == bss) {
+        g_hash_table_remove(priv->bss_by_bssid, bssid);
+    }
+}
+
+static
+void
+gsupplicant_interface_bss_index_remove_frequency(
+    GSupplicantInterfacePriv* priv,
+    GSupplicantBSS* bss,
+    guint frequency)
+{
+    if (frequency && priv->bss_by_frequency) {
+        gpointer key = GUINT_TO_POINTER(frequency);
+        GPtrArray* list = g_hash_table_lookup(priv->bss_by_frequency, key);
+        if (list && g_ptr_array_remove_fast(list, bss) && !list->len) {
+            g_hash_table_remove(priv->bss_by_frequency, key);
+        }
+    }
+}
+
+void
+gsupplicant_interface_bss_bssid_changed(
+    GSupplicantInterface* self,
+    GSupplicantBSS* bss,
+    GBytes* old_bssid)
+{
+    GSupplicantInterfacePriv* priv = self->priv;
+    gsupplicant_interface_bss_index_remove_bssid(priv, bss, old_bssid);
+    if (bss->bssid) {
+        if (!priv->bss_by_bssid) {
+            priv->bss_by_bssid = g_hash_table_new_full(g_bytes_hash,
+                g_bytes_equal, (GDestroyNotify) g_bytes_unref, NULL);
+        }
+        g_hash_table_replace(priv->bss_by_bssid, g_bytes_ref(bss->bssid), bss);
+    }
+}
+
+void
+gsupplicant_interface_bss_frequency_changed(
+    GSupplicantInterface* self,
+    GSupplicantBSS* bss,
+    guint old_frequency)
+{
+    GSupplicantInterfacePriv* priv = self->priv;
+    gsupplicant_interface_bss_index_remove_frequency(priv, bss, old_frequency);
+    if (bss->frequency) {
+        gpointer key = GUINT_TO_POINTER(bss->frequency);
+        GPtrArray* list = NULL;
+        if (priv->bss_by_frequency) {
+            list = g_hash_table_lookup(priv->bss_by_frequency, key);
+        } else {
+            priv->bss_by_frequency = g_hash_table_new_full(g_direct_hash,
+                g_direct_equal, NULL, (GDestroyNotify) g_ptr_array_unref);
+        }
+        if (!list) {
+            list = g_ptr_array_new();
+            g_hash_table_insert(priv->bss_by_frequency, key, list);
+        }
+        g_ptr_array_add(list, bss);
+    }
+}
+
+guint*
+gsupplicant_interface_bss_frequencies(
+    GSupplicantInterface* self,
+    guint* count)
+{
+    GSupplicantInterfacePriv* priv = self->priv;
+    const guint n = priv->bss_by_frequency ?
+        g_hash_table_size(priv->bss_by_frequency) : 0;
+
+    *count = n;
+    if (n) {
+        guint* freqs = g_new(guint, n);
+        guint i = 0;
+        GHashTableIter it;
+        gpointer key;
+
+        g_hash_table_iter_init(&it, priv->bss_by_frequency);
+        while (g_hash_table_iter_next(&it, &key, NULL)) {
+            freqs[i++] = GPOINTER_TO_UINT(key);
+        }
+        return freqs;
+    }
+    return NULL;
+}
+
+void
+gsupplicant_interface_bss_gone(
+    GSupplicantInterface* self,
+    GSupplicantBSS* bss)
+{
+    GSupplicantInterfacePriv* priv = self->priv;
+    gsupplicant_interface_bss_index_remove_bssid(priv, bss, bss->bssid);
+    gsupplicant_interface_bss_index_remove_frequency(priv, bss,
+        bss->frequency);
+    if (priv->bss_snapshots &&
+        g_hash_table_remove(priv->bss_snapshots, bss->path)) {
+        gsupplicant_interface_publish_snapshot(self);
+    }
+}
+
+void
+gsupplicant_interface_bss_changed(
+    GSupplicantInterface* self,
+    GSupplicantBSS* bss)
+{
+    GSupplicantInterfacePriv* priv = self->priv;
+
+    if (bss->valid && bss->present) {
+        GSupplicantBSSSnapshot* snapshot = gsupplicant_bss_snapshot_new(bss);
+
+        if (!priv->bss_snapshots) {
+            priv->bss_snapshots = g_hash_table_new_full(g_str_hash,
+                g_str_equal, NULL, (GDestroyNotify)
+                gsupplicant_bss_snapshot_unref);
+        }
+        /* The key is owned by the snapshot */
+        g_hash_table_replace(priv->bss_snapshots, (gpointer)
+            snapshot->path, snapshot);
+    } else if (!priv->bss_snapshots ||
+        !g_hash_table_remove(priv->bss_snapshots, bss->path)) {
+        /* Nothing has changed */
+        return;
+    }
+    gsupplicant_interface_publish_snapshot(self);
+}
+
+gboolean
+gsupplicant_interface_call_scan(
+    GSupplicantInterface* self,
+    GVariant* args,
+    GAsyncReadyCallback callback,
+    gpointer data)
+{
+    if (self->valid) {
+        fi_w1_wpa_supplicant1_interface_call_scan(self->priv->proxy, args,
+            NULL, callback, data);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+void
+gsupplicant_interface_scan_started(
+    GSupplicantInterface* self)
+{
+    /* The next ScanDone completes the scan which we have requested */
+    self->priv->host_scan = TRUE;
+}
+
+void
+gsupplicant_interface_scan_finished(
+    GSupplicantInterface* self,
+    gint64 wait,
+    gint64 run,
+    guint retries)
+{
+    GSupplicantScanTimes* times = &self->priv->scan_times;
+
+    times->scans++;
+    times->retries += retries;
+    times->last_wait = wait;
+    times->last_run = run;
+    times->total_wait += wait;
+    times->total_run += run;
+}
+
+void
+gsupplicant_interface_get_roam_config(
+    GSupplicantInterface* self,
+    GSupplicantRoamConfig* config)
+{
+    FiW1Wpa_supplicant1Interface* proxy = self->priv->proxy;
+
+    /* wpa_supplicant defaults if nothing has been reported */
+    memset(config, 0, sizeof(*config));
+    config->fast_reauth = TRUE;
+    if (proxy) {
+        const char* okc = fi_w1_wpa_supplicant1_interface_get_okc(proxy);
+        const char* pmf = fi_w1_wpa_supplicant1_interface_get_pmf(proxy);
+
+        config->okc = okc && atoi(okc);
+        if (pmf && atoi(pmf) > 0) {
+            config->pmf = MIN(atoi(pmf), GSUPPLICANT_MFP_REQUIRED);
+        }
+        config->fast_reauth =
+            fi_w1_wpa_supplicant1_interface_get_fast_reauth(proxy);
+        config->bgscan = g_strdup
+            (fi_w1_wpa_supplicant1_interface_get_bgscan(proxy));
+    }
+}
+
+void
+gsupplicant_interface_get_sched_scan_config(
+    GSupplicantInterface* self,
+    GSupplicantSchedScanConfig* config)
+{
+    FiW1Wpa_supplicant1Interface* proxy = self->priv->proxy;
+
+    /* Whatever wpa_supplicant has reported, NULL if nothing */
+    memset(config, 0, sizeof(*config));
+    if (proxy) {
+        config->plans = g_strdup
+            (fi_w1_wpa_supplicant1_interface_get_sched_scan_plans(proxy));
+        config->interval = g_strdup
+            (fi_w1_wpa_supplicant1_interface_get_sched_scan_interval(proxy));
+        config->disable_offload = g_strdup
+            (fi_w1_wpa_supplicant1_interface_get_disable_scan_offload(proxy));
+        config->freq_list = g_strdup
+            (fi_w1_wpa_supplicant1_interface_get_freq_list(proxy));
+    }
+}
+
+gboolean
+gsupplicant_interface_set_sched_scan_config(
+    GSupplicantInterface* self,
+    const GSupplicantSchedScanConfig* config)
+{
+    if (self->valid) {
+        GSupplicantInterfacePriv* priv = self->priv;
+        FiW1Wpa_supplicant1Interface* proxy = priv->proxy;
+
+        if (config->freq_list) {
+            GDEBUG("[%s] %s: %s", priv->path, PROXY_PROPERTY_NAME_FREQ_LIST,
+                config->freq_list);
+            fi_w1_wpa_supplicant1_interface_set_freq_list(proxy,
+                config->freq_list);
+        }
+        if (config->plans) {
+            GDEBUG("[%s] %s: %s", priv->path,
+                PROXY_PROPERTY_NAME_SCHED_SCAN_PLANS, config->plans);
+            fi_w1_wpa_supplicant1_interface_set_sched_scan_plans(proxy,
+                config->plans);
+        }
+        if (config->interval) {
+            GDEBUG("[%s] %s: %s", priv->path,
+                PROXY_PROPERTY_NAME_SCHED_SCAN_INTERVAL, config->interval);
+            fi_w1_wpa_supplicant1_interface_set_sched_scan_interval(proxy,
+                config->interval);
+        }
+        if (config->disable_offload) {
+            GDEBUG("[%s] %s: %s", priv->path,
+                PROXY_PROPERTY_NAME_DISABLE_SCAN_OFFLOAD,
+                config->disable_offload);
+            fi_w1_wpa_supplicant1_interface_set_disable_scan_offload(proxy,
+                config->disable_offload);
+        }
+        return TRUE;
+    }
+    return FALSE;
+}
+
 /*==========================================================================*
  * Internals
  *==========================================================================*/
@@ -3310,9 +4798,12 @@ gsupplicant_interface_dispose(
     GSupplicantInterface* self = GSUPPLICANT_INTERFACE(object);
     GSupplicantInterfacePriv* priv = self->priv;
     gsupplicant_interface_clear_wps_credentials(self);
+    gsupplicant_interface_bss_flush_stop(self);
     if (priv->proxy) {
         gutil_disconnect_handlers(priv->proxy, priv->proxy_handler_id,
             G_N_ELEMENTS(priv->proxy_handler_id));
+        gutil_disconnect_handlers(priv->proxy, priv->resync_handler_id,
+            G_N_ELEMENTS(priv->resync_handler_id));
         g_object_unref(priv->proxy);
         priv->proxy = NULL;
     }
@@ -3337,17 +4828,36 @@ gsupplicant_interface_finalize(
     GSupplicantInterfacePriv* priv = self->priv;
     GASSERT(!priv->bus);
     GASSERT(!priv->proxy);
-    g_strfreev(priv->bsss);
-    g_strfreev(priv->networks);
-    g_strfreev(priv->stations);
-    g_free(priv->path);
+    gsupplicant_intern_strv_free(priv->bsss);
+    gsupplicant_intern_strv_free(priv->networks);
+    if (priv->station_table) {
+        /* The array points to the addresses owned by the table */
+        g_ptr_array_free(priv->stations, TRUE);
+        g_hash_table_destroy(priv->station_table);
+    }
+    gsupplicant_intern_unref(priv->path);
     g_free(priv->country);
     g_free(priv->driver);
     g_free(priv->ifname);
     g_free(priv->bridge_ifname);
     g_free(priv->current_bss);
     g_free(priv->current_network);
+    if (priv->bss_by_bssid) {
+        g_hash_table_destroy(priv->bss_by_bssid);
+    }
+    if (priv->bss_by_frequency) {
+        g_hash_table_destroy(priv->bss_by_frequency);
+    }
+    if (priv->bss_snapshots) {
+        g_hash_table_destroy(priv->bss_snapshots);
+    }
+    if (priv->snapshot_idle) {
+        g_source_destroy(priv->snapshot_idle);
+        g_source_unref(priv->snapshot_idle);
+    }
+    gsupplicant_interface_snapshot_unref(priv->snapshot.snapshot);
     gsupplicant_unref(self->supplicant);
+    g_main_context_unref(priv->context);
     G_OBJECT_CLASS(SUPER_CLASS)->finalize(object);
 }
 
@@ -3379,6 +4889,14 @@ gsupplicant_interface_class_init(
         g_signal_new(SIGNAL_EAP_NAME, G_OBJECT_CLASS_TYPE(klass),
             G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL,
             G_TYPE_NONE, 1, G_TYPE_UINT);
+    gsupplicant_interface_signals[SIGNAL_STATION_ADDED] =
+        g_signal_new(SIGNAL_STATION_ADDED_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL,
+            G_TYPE_NONE, 1, G_TYPE_POINTER);
+    gsupplicant_interface_signals[SIGNAL_STATION_REMOVED] =
+        g_signal_new(SIGNAL_STATION_REMOVED_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL,
+            G_TYPE_NONE, 1, G_TYPE_POINTER);
 }
 
 /*
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2023 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef GSUPPLICANT_INTERFACE_PRIVATE_H
+#define GSUPPLICANT_INTERFACE_PRIVATE_H
+
+#include "gsupplicant_types_p.h"
+
+/* BSS lookup indices, maintained by GSupplicantBSS */
+
+void
+gsupplicant_interface_bss_bssid_changed(
+    GSupplicantInterface* iface,
+    GSupplicantBSS* bss,
+    GBytes* old_bssid)
+    GSUPPLICANT_INTERNAL;
+
+void
+gsupplicant_interface_bss_frequency_changed(
+    GSupplicantInterface* iface,
+    GSupplicantBSS* bss,
+    guint old_frequency)
+    GSUPPLICANT_INTERNAL;
+
+void
+gsupplicant_interface_bss_gone(
+    GSupplicantInterface* iface,
+    GSupplicantBSS* bss)
+    GSUPPLICANT_INTERNAL;
+
+/* Frequencies of the indexed BSSs, the caller frees the array */
+guint*
+gsupplicant_interface_bss_frequencies(
+    GSupplicantInterface* iface,
+    guint* count)
+    GSUPPLICANT_INTERNAL;
+
+/* Invoked after each batch of BSS property change signals */
+void
+gsupplicant_interface_bss_changed(
+    GSupplicantInterface* iface,
+    GSupplicantBSS* bss)
+    GSUPPLICANT_INTERNAL;
+
+/* Used by GSupplicantScanCoordinator */
+
+gboolean
+gsupplicant_interface_call_scan(
+    GSupplicantInterface* iface,
+    GVariant* args,
+    GAsyncReadyCallback callback,
+    gpointer data)
+    GSUPPLICANT_INTERNAL;
+
+void
+gsupplicant_interface_scan_started(
+    GSupplicantInterface* iface)
+    GSUPPLICANT_INTERNAL;
+
+void
+gsupplicant_interface_scan_finished(
+    GSupplicantInterface* iface,
+    gint64 wait,
+    gint64 run,
+    guint retries)
+    GSUPPLICANT_INTERNAL;
+
+/* Used by GSupplicantRoamProfile */
+
+typedef struct gsupplicant_roam_config {
+    gboolean okc;
+    gboolean fast_reauth;
+    GSUPPLICANT_MFP_OPTIONS pmf;
+    char* bgscan;
+} GSupplicantRoamConfig;
+
+/* The caller frees bgscan */
+void
+gsupplicant_interface_get_roam_config(
+    GSupplicantInterface* iface,
+    GSupplicantRoamConfig* config)
+    GSUPPLICANT_INTERNAL;
+
+/* Used by GSupplicantSchedScanPlan */
+
+typedef struct gsupplicant_sched_scan_config {
+    char* plans;
+    char* interval;
+    char* disable_offload;
+    char* freq_list;
+} GSupplicantSchedScanConfig;
+
+void
+gsupplicant_interface_get_sched_scan_config(
+    GSupplicantInterface* iface,
+    GSupplicantSchedScanConfig* config)
+    GSUPPLICANT_INTERNAL;
+
+/* NULL fields are left alone */
+gboolean
+gsupplicant_interface_set_sched_scan_config(
+    GSupplicantInterface* iface,
+    const GSupplicantSchedScanConfig* config)
+    GSUPPLICANT_INTERNAL;
+
+#endif /* GSUPPLICANT_INTERFACE_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
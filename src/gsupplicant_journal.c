@@ -0,0 +1,508 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gsupplicant_journal_p.h"
+#include "gsupplicant_dbus.h"
+#include "gsupplicant_log.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct gsupplicant_journal_writer {
+    GMutex mutex;
+    FILE* out;
+    gint64 start;
+    GHashTable* calls;  /* Serials of the calls waiting for reply */
+    GDBusConnection* bus;
+    guint filter_id;
+} GSupplicantJournalWriter;
+
+#define JOURNAL_HEADER_SIZE (16)
+#define JOURNAL_RECORD_HEADER_SIZE (16)
+#define JOURNAL_REDACTED "<redacted>"
+
+/* Network (and WPS) parameters which never get written to disk */
+static const char* gsupplicant_journal_secrets[] = {
+    "passphrase",
+    "password",
+    "pin",
+    "private_key2_passwd",
+    "private_key_passwd",
+    "private_key_passwd2",
+    "psk",
+    "sae_password"
+};
+
+#define JOURNAL_SECRET_PREFIX "wep_key"
+
+static GSupplicantJournalWriter* gsupplicant_journal_writer = NULL;
+
+/*==========================================================================*
+ * Implementation
+ *==========================================================================*/
+
+static
+gboolean
+gsupplicant_journal_path_match(
+    const char* path)
+{
+    static const char prefix[] = GSUPPLICANT_PATH;
+    return path && !strncmp(path, prefix, sizeof(prefix) - 1) &&
+        (!path[sizeof(prefix) - 1] || path[sizeof(prefix) - 1] == '/');
+}
+
+static
+gboolean
+gsupplicant_journal_secret(
+    const char* key)
+{
+    guint i;
+    if (!g_ascii_strncasecmp(key, JOURNAL_SECRET_PREFIX,
+        sizeof(JOURNAL_SECRET_PREFIX) - 1)) {
+        return TRUE;
+    }
+    for (i = 0; i < G_N_ELEMENTS(gsupplicant_journal_secrets); i++) {
+        if (!g_ascii_strcasecmp(key, gsupplicant_journal_secrets[i])) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/*
+ * Returns a floating copy of the value with secrets replaced, or NULL
+ * if there was nothing to hide.
+ */
+static
+GVariant*
+gsupplicant_journal_redact_value(
+    GVariant* value)
+{
+    GVariant* redacted = NULL;
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_VARIANT)) {
+        GVariant* inner = g_variant_get_variant(value);
+        GVariant* tmp = gsupplicant_journal_redact_value(inner);
+        if (tmp) {
+            redacted = g_variant_new_variant(tmp);
+        }
+        g_variant_unref(inner);
+    } else if (g_variant_is_of_type(value, G_VARIANT_TYPE_VARDICT)) {
+        GVariantBuilder builder;
+        GVariantIter it;
+        GVariant* v;
+        const char* key;
+        gboolean changed = FALSE;
+
+        g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+        g_variant_iter_init(&it, value);
+        while (g_variant_iter_next(&it, "{&sv}", &key, &v)) {
+            GVariant* tmp = NULL;
+            if (gsupplicant_journal_secret(key)) {
+                tmp = g_variant_new_string(JOURNAL_REDACTED);
+            } else {
+                tmp = gsupplicant_journal_redact_value(v);
+            }
+            if (tmp) {
+                g_variant_builder_add(&builder, "{sv}", key, tmp);
+                changed = TRUE;
+            } else {
+                g_variant_builder_add(&builder, "{sv}", key, v);
+            }
+            g_variant_unref(v);
+        }
+        redacted = g_variant_builder_end(&builder);
+        if (!changed) {
+            g_variant_unref(g_variant_ref_sink(redacted));
+            redacted = NULL;
+        }
+    }
+    return redacted;
+}
+
+/*
+ * Returns a copy of the outgoing call with all secrets removed, or NULL
+ * if the message can be written as is. The arguments which are secret
+ * by themselves (blob contents and NetworkReply value) are replaced with
+ * the values of the same type.
+ */
+static
+GDBusMessage*
+gsupplicant_journal_redact(
+    GDBusMessage* message)
+{
+    GVariant* body = g_dbus_message_get_body(message);
+    GDBusMessage* copy = NULL;
+
+    if (body && g_variant_is_container(body)) {
+        const char* member = g_dbus_message_get_member(message);
+        const gsize n = g_variant_n_children(body);
+        GVariant** args = g_new(GVariant*, n);
+        gboolean changed = FALSE;
+        gsize i;
+
+        for (i = 0; i < n; i++) {
+            GVariant* arg = g_variant_get_child_value(body, i);
+            GVariant* tmp = NULL;
+            if (!g_strcmp0(member, "AddBlob") &&
+                g_variant_is_of_type(arg, G_VARIANT_TYPE_BYTESTRING)) {
+                tmp = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE,
+                    NULL, 0, 1);
+            } else if (!g_strcmp0(member, "NetworkReply") && i == 2 &&
+                g_variant_is_of_type(arg, G_VARIANT_TYPE_STRING)) {
+                tmp = g_variant_new_string(JOURNAL_REDACTED);
+            } else {
+                tmp = gsupplicant_journal_redact_value(arg);
+            }
+            if (tmp) {
+                g_variant_unref(arg);
+                args[i] = g_variant_ref_sink(tmp);
+                changed = TRUE;
+            } else {
+                args[i] = arg;
+            }
+        }
+        if (changed) {
+            copy = g_dbus_message_copy(message, NULL);
+            if (copy) {
+                g_dbus_message_set_body(copy, g_variant_new_tuple(args, n));
+            }
+        }
+        for (i = 0; i < n; i++) {
+            g_variant_unref(args[i]);
+        }
+        g_free(args);
+    }
+    return copy;
+}
+
+/* Must be called under lock */
+static
+void
+gsupplicant_journal_write(
+    GSupplicantJournalWriter* writer,
+    GSUPPLICANT_JOURNAL_RECORD_TYPE type,
+    GDBusMessage* message)
+{
+    gsize size = 0;
+    guchar* blob = g_dbus_message_to_blob(message, &size,
+        G_DBUS_CAPABILITY_FLAGS_NONE, NULL);
+
+    if (blob) {
+        guint8 header[JOURNAL_RECORD_HEADER_SIZE];
+        const guint64 time = GUINT64_TO_LE(g_get_monotonic_time() -
+            writer->start);
+        const guint32 type32 = GUINT32_TO_LE(type);
+        const guint32 size32 = GUINT32_TO_LE(size);
+
+        memcpy(header, &time, 8);
+        memcpy(header + 8, &type32, 4);
+        memcpy(header + 12, &size32, 4);
+        if (fwrite(header, sizeof(header), 1, writer->out) != 1 ||
+            fwrite(blob, size, 1, writer->out) != 1) {
+            GERR("Journal write error: %s", strerror(errno));
+        }
+        g_free(blob);
+    }
+}
+
+/* Invoked on GDBus worker thread */
+static
+GDBusMessage*
+gsupplicant_journal_filter(
+    GDBusConnection* bus,
+    GDBusMessage* message,
+    gboolean incoming,
+    gpointer user_data)
+{
+    GSupplicantJournalWriter* writer = user_data;
+
+    g_mutex_lock(&writer->mutex);
+    if (writer->out) {
+        gpointer serial;
+
+        switch (g_dbus_message_get_message_type(message)) {
+        case G_DBUS_MESSAGE_TYPE_METHOD_CALL:
+            /*
+             * GDBusProxy sends calls to the unique name of the owner,
+             * so the path is the only thing to go by.
+             */
+            if (!incoming && gsupplicant_journal_path_match
+                (g_dbus_message_get_path(message))) {
+                GDBusMessage* redacted;
+
+                if (!(g_dbus_message_get_flags(message) &
+                    G_DBUS_MESSAGE_FLAGS_NO_REPLY_EXPECTED)) {
+                    serial = GUINT_TO_POINTER(g_dbus_message_get_serial
+                        (message));
+                    g_hash_table_add(writer->calls, serial);
+                }
+                redacted = gsupplicant_journal_redact(message);
+                if (redacted) {
+                    gsupplicant_journal_write(writer,
+                        GSUPPLICANT_JOURNAL_RECORD_CALL, redacted);
+                    g_object_unref(redacted);
+                } else {
+                    gsupplicant_journal_write(writer,
+                        GSUPPLICANT_JOURNAL_RECORD_CALL, message);
+                }
+            }
+            break;
+        case G_DBUS_MESSAGE_TYPE_METHOD_RETURN:
+        case G_DBUS_MESSAGE_TYPE_ERROR:
+            serial = GUINT_TO_POINTER(g_dbus_message_get_reply_serial
+                (message));
+            if (incoming && g_hash_table_remove(writer->calls, serial)) {
+                gsupplicant_journal_write(writer,
+                    GSUPPLICANT_JOURNAL_RECORD_REPLY, message);
+            }
+            break;
+        case G_DBUS_MESSAGE_TYPE_SIGNAL:
+            if (incoming && gsupplicant_journal_path_match
+                (g_dbus_message_get_path(message))) {
+                gsupplicant_journal_write(writer,
+                    GSUPPLICANT_JOURNAL_RECORD_SIGNAL, message);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    g_mutex_unlock(&writer->mutex);
+    return message;
+}
+
+static
+void
+gsupplicant_journal_close(
+    GSupplicantJournalWriter* writer)
+{
+    g_mutex_lock(&writer->mutex);
+    if (writer->out) {
+        fclose(writer->out);
+        writer->out = NULL;
+    }
+    g_mutex_unlock(&writer->mutex);
+}
+
+/* Called when the filter is removed */
+static
+void
+gsupplicant_journal_writer_free(
+    gpointer data)
+{
+    GSupplicantJournalWriter* writer = data;
+
+    gsupplicant_journal_close(writer);
+    g_hash_table_destroy(writer->calls);
+    g_mutex_clear(&writer->mutex);
+    g_slice_free(GSupplicantJournalWriter, writer);
+}
+
+static
+void
+gsupplicant_journal_record_free(
+    gpointer data)
+{
+    GSupplicantJournalRecord* record = data;
+
+    g_object_unref(record->message);
+    g_slice_free(GSupplicantJournalRecord, record);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+gboolean
+gsupplicant_journal_start(
+    const char* file,
+    GError** error)
+{
+    GDBusConnection* bus = g_bus_get_sync(GSUPPLICANT_BUS_TYPE, NULL, error);
+
+    if (bus) {
+        const gboolean ok = gsupplicant_journal_start_on_bus(file, bus,
+            error);
+
+        g_object_unref(bus);
+        return ok;
+    }
+    return FALSE;
+}
+
+void
+gsupplicant_journal_stop(
+    void)
+{
+    GSupplicantJournalWriter* writer = gsupplicant_journal_writer;
+
+    if (writer) {
+        GDBusConnection* bus = writer->bus;
+
+        gsupplicant_journal_writer = NULL;
+        /* The filter may still be running on the worker thread */
+        gsupplicant_journal_close(writer);
+        g_dbus_connection_remove_filter(bus, writer->filter_id);
+        g_object_unref(bus);
+    }
+}
+
+/*==========================================================================*
+ * Internal API
+ *==========================================================================*/
+
+gboolean
+gsupplicant_journal_start_on_bus(
+    const char* file,
+    GDBusConnection* bus,
+    GError** error)
+{
+    GSupplicantJournalWriter* writer;
+    guint8 header[JOURNAL_HEADER_SIZE];
+    guint32 version = GUINT32_TO_LE(GSUPPLICANT_JOURNAL_VERSION);
+    FILE* out = NULL;
+    int fd;
+
+    gsupplicant_journal_stop();
+
+    /* The journal may contain private data, only the owner can read it */
+    fd = open(file, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd >= 0) {
+        out = fdopen(fd, "wb");
+        if (!out) {
+            const int err = errno;
+            close(fd);
+            errno = err;
+        }
+    }
+    if (!out) {
+        const int err = errno;
+        GERR("Can't create %s: %s", file, strerror(err));
+        g_set_error(error, G_IO_ERROR, g_io_error_from_errno(err),
+            "Can't create %s: %s", file, strerror(err));
+        return FALSE;
+    }
+
+    memset(header, 0, sizeof(header));
+    memcpy(header, GSUPPLICANT_JOURNAL_MAGIC, 8);
+    memcpy(header + 8, &version, 4);
+    fwrite(header, sizeof(header), 1, out);
+
+    writer = g_slice_new0(GSupplicantJournalWriter);
+    g_mutex_init(&writer->mutex);
+    writer->out = out;
+    writer->start = g_get_monotonic_time();
+    writer->calls = g_hash_table_new(g_direct_hash, g_direct_equal);
+    writer->bus = g_object_ref(bus);
+    writer->filter_id = g_dbus_connection_add_filter(bus,
+        gsupplicant_journal_filter, writer, gsupplicant_journal_writer_free);
+    gsupplicant_journal_writer = writer;
+    GINFO("Recording D-Bus traffic to %s", file);
+    return TRUE;
+}
+
+GPtrArray*
+gsupplicant_journal_load(
+    const char* file,
+    GError** error)
+{
+    gchar* contents = NULL;
+    gsize length = 0;
+    GPtrArray* records = NULL;
+
+    if (g_file_get_contents(file, &contents, &length, error)) {
+        const guint8* ptr = (guint8*)contents;
+        const guint8* end = ptr + length;
+        guint32 version = 0;
+
+        if (length >= JOURNAL_HEADER_SIZE) {
+            memcpy(&version, ptr + 8, 4);
+            version = GUINT32_FROM_LE(version);
+        }
+        if (length < JOURNAL_HEADER_SIZE ||
+            memcmp(ptr, GSUPPLICANT_JOURNAL_MAGIC, 8) ||
+            version != GSUPPLICANT_JOURNAL_VERSION) {
+            g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "%s is not a journal file", file);
+        } else {
+            records = g_ptr_array_new_with_free_func
+                (gsupplicant_journal_record_free);
+            ptr += JOURNAL_HEADER_SIZE;
+            while (ptr < end) {
+                GSupplicantJournalRecord* record;
+                GDBusMessage* message;
+                guint64 time;
+                guint32 type, size;
+
+                if ((gsize)(end - ptr) < JOURNAL_RECORD_HEADER_SIZE) {
+                    /* Recording may have been interrupted */
+                    GWARN("%s: truncated record", file);
+                    break;
+                }
+                memcpy(&time, ptr, 8);
+                memcpy(&type, ptr + 8, 4);
+                memcpy(&size, ptr + 12, 4);
+                ptr += JOURNAL_RECORD_HEADER_SIZE;
+                size = GUINT32_FROM_LE(size);
+                if ((gsize)(end - ptr) < size) {
+                    GWARN("%s: truncated record", file);
+                    break;
+                }
+                message = g_dbus_message_new_from_blob((guchar*)ptr, size,
+                    G_DBUS_CAPABILITY_FLAGS_NONE, error);
+                if (!message) {
+                    g_ptr_array_free(records, TRUE);
+                    records = NULL;
+                    break;
+                }
+                ptr += size;
+                record = g_slice_new(GSupplicantJournalRecord);
+                record->time = GUINT64_FROM_LE(time);
+                record->type = GUINT32_FROM_LE(type);
+                record->message = message;
+                g_ptr_array_add(records, record);
+            }
+        }
+        g_free(contents);
+    }
+    return records;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GSUPPLICANT_JOURNAL_PRIVATE_H
+#define GSUPPLICANT_JOURNAL_PRIVATE_H
+
+#include "gsupplicant_types_p.h"
+#include "gsupplicant_journal.h"
+#include <gio/gio.h>
+
+/*
+ * Journal file format (all integers are little-endian):
+ *
+ *   Header:  "GSUPJRNL" magic, guint32 version, guint32 reserved
+ *   Record:  guint64 time (microseconds since the start of recording),
+ *            guint32 type, guint32 size, followed by the size bytes
+ *            of D-Bus message (as serialized by g_dbus_message_to_blob)
+ */
+
+#define GSUPPLICANT_JOURNAL_MAGIC "GSUPJRNL"
+#define GSUPPLICANT_JOURNAL_VERSION (1)
+
+typedef enum gsupplicant_journal_record_type {
+    GSUPPLICANT_JOURNAL_RECORD_CALL = 1,   /* Outgoing method call */
+    GSUPPLICANT_JOURNAL_RECORD_REPLY,      /* Method return or error */
+    GSUPPLICANT_JOURNAL_RECORD_SIGNAL      /* Incoming signal */
+} GSUPPLICANT_JOURNAL_RECORD_TYPE;
+
+typedef struct gsupplicant_journal_record {
+    gint64 time;
+    GSUPPLICANT_JOURNAL_RECORD_TYPE type;
+    GDBusMessage* message;
+} GSupplicantJournalRecord;
+
+/* Same as gsupplicant_journal_start() but doesn't block */
+gboolean
+gsupplicant_journal_start_on_bus(
+    const char* file,
+    GDBusConnection* bus,
+    GError** error)
+    GSUPPLICANT_INTERNAL;
+
+/* Returns array of GSupplicantJournalRecord pointers */
+GPtrArray*
+gsupplicant_journal_load(
+    const char* file,
+    GError** error)
+    GSUPPLICANT_INTERNAL;
+
+#endif /* GSUPPLICANT_JOURNAL_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,683 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define GLIB_DISABLE_DEPRECATION_WARNINGS /* G_ADD_PRIVATE */
+
+#include "gsupplicant_link_predictor.h"
+#include "gsupplicant.h"
+#include "gsupplicant_bss.h"
+#include "gsupplicant_interface_p.h"
+#include "gsupplicant_log.h"
+
+/* Object definition */
+#define LINK_PREDICTOR_SAMPLES          (8)
+#define LINK_PREDICTOR_MIN_SAMPLES      (3)
+#define LINK_PREDICTOR_HYSTERESIS       (5)  /* dB */
+#define LINK_PREDICTOR_CHANNEL_WIDTH    (20) /* MHz */
+
+enum gsupplicant_link_predictor_iface_handler_id {
+    INTERFACE_VALID_CHANGED,
+    INTERFACE_STATE_CHANGED,
+    INTERFACE_CURRENT_BSS_CHANGED,
+    INTERFACE_HANDLER_COUNT
+};
+
+typedef struct gsupplicant_link_predictor_sample {
+    gint64 time;            /* Monotonic, microseconds */
+    gint rssi;              /* dBm */
+} GSupplicantLinkPredictorSample;
+
+struct gsupplicant_link_predictor_priv {
+    gulong iface_handler_id[INTERFACE_HANDLER_COUNT];
+    GSupplicantBSS* current;
+    gulong current_signal_id;
+    GSupplicantLinkPredictorPolicy policy;
+    GSupplicantLinkPredictorStats stats;
+    GSupplicantLinkPredictorSample samples[LINK_PREDICTOR_SAMPLES];
+    guint first;
+    guint count;
+    gint linkspeed;         /* Mbps, zero if unknown */
+    gboolean completed;
+    GSource* poll;
+    GCancellable* poll_call;
+    GCancellable* scan;
+    gint64 last_scan;
+};
+
+typedef GObjectClass GSupplicantLinkPredictorClass;
+G_DEFINE_TYPE(GSupplicantLinkPredictor, gsupplicant_link_predictor,
+    G_TYPE_OBJECT)
+#define GSUPPLICANT_LINK_PREDICTOR_TYPE \
+    (gsupplicant_link_predictor_get_type())
+#define GSUPPLICANT_LINK_PREDICTOR(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), \
+        GSUPPLICANT_LINK_PREDICTOR_TYPE, GSupplicantLinkPredictor))
+#define SUPER_CLASS gsupplicant_link_predictor_parent_class
+
+enum gsupplicant_link_predictor_signal {
+    SIGNAL_AT_RISK_CHANGED,
+    SIGNAL_COUNT
+};
+
+#define SIGNAL_AT_RISK_CHANGED_NAME "at-risk-changed"
+
+static guint gsupplicant_link_predictor_signals[SIGNAL_COUNT];
+
+static const GSupplicantLinkPredictorPolicy
+gsupplicant_link_predictor_default = {
+    0,                      /* flags */
+    2000,                   /* poll_interval */
+    3000,                   /* horizon */
+    -80,                    /* rssi_threshold */
+    6,                      /* linkspeed_threshold */
+    10                      /* min_scan_interval */
+};
+
+/*==========================================================================*
+ * Implementation
+ *==========================================================================*/
+
+static
+void
+gsupplicant_link_predictor_reset_samples(
+    GSupplicantLinkPredictor* self)
+{
+    GSupplicantLinkPredictorPriv* priv = self->priv;
+    priv->first = priv->count = 0;
+    priv->linkspeed = 0;
+}
+
+/* Least squares fit, the slope is in dB per second */
+static
+gboolean
+gsupplicant_link_predictor_fit(
+    GSupplicantLinkPredictor* self,
+    double* last,
+    double* slope)
+{
+    GSupplicantLinkPredictorPriv* priv = self->priv;
+    const guint n = priv->count;
+
+    if (n >= LINK_PREDICTOR_MIN_SAMPLES) {
+        const GSupplicantLinkPredictorSample* s = priv->samples;
+        const gint64 t0 = s[(priv->first + n - 1) %
+            LINK_PREDICTOR_SAMPLES].time;
+        double mt = 0, mr = 0, stt = 0, str = 0;
+        guint i;
+
+        /* Time is relative to the last sample */
+        for (i = 0; i < n; i++) {
+            const GSupplicantLinkPredictorSample* si =
+                s + (priv->first + i) % LINK_PREDICTOR_SAMPLES;
+            mt += (si->time - t0) / (double)G_TIME_SPAN_SECOND;
+            mr += si->rssi;
+        }
+        mt /= n;
+        mr /= n;
+        for (i = 0; i < n; i++) {
+            const GSupplicantLinkPredictorSample* si =
+                s + (priv->first + i) % LINK_PREDICTOR_SAMPLES;
+            const double dt = (si->time - t0) / (double)G_TIME_SPAN_SECOND
+                - mt;
+            stt += dt * dt;
+            str += dt * (si->rssi - mr);
+        }
+        *slope = (stt > 0) ? (str / stt) : 0;
+        *last = mr - (*slope) * mt;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static
+void
+gsupplicant_link_predictor_scan_done(
+    GSupplicantInterface* iface,
+    GCancellable* cancel,
+    const GError* error,
+    void* data)
+{
+    GSupplicantLinkPredictor* self = GSUPPLICANT_LINK_PREDICTOR(data);
+    GSupplicantLinkPredictorPriv* priv = self->priv;
+
+    GASSERT(priv->scan == cancel);
+    g_object_unref(priv->scan);
+    priv->scan = NULL;
+    if (error) {
+        GDEBUG("[%s] Pre-scan failed: %s", iface->path, GERRMSG(error));
+    }
+}
+
+static
+void
+gsupplicant_link_predictor_add_channel(
+    GArray* channels,
+    guint freq)
+{
+    guint i;
+    GSupplicantScanFrequency add;
+
+    for (i = 0; i < channels->len; i++) {
+        if (g_array_index(channels, GSupplicantScanFrequency, i).center ==
+            freq) {
+            return;
+        }
+    }
+    add.center = freq;
+    add.width = LINK_PREDICTOR_CHANNEL_WIDTH;
+    g_array_append_val(channels, add);
+}
+
+static
+void
+gsupplicant_link_predictor_prescan(
+    GSupplicantLinkPredictor* self)
+{
+    GSupplicantLinkPredictorPriv* priv = self->priv;
+    GSupplicantBSS* current = priv->current;
+    const gint64 now = g_get_monotonic_time();
+
+    if (!(priv->policy.flags & GSUPPLICANT_LINK_PREDICTOR_NO_SCAN) &&
+        !priv->scan && current && current->valid && current->ssid &&
+        (!priv->last_scan || (now - priv->last_scan) >=
+        priv->policy.min_scan_interval * G_TIME_SPAN_SECOND)) {
+        GArray* channels = g_array_new(FALSE, FALSE,
+            sizeof(GSupplicantScanFrequency));
+        GSupplicantScanFrequencies freqs;
+        GSupplicantScanParams params;
+        GBytes* ssids[2];
+        GCancellable* cancel;
+        guint* known;
+        guint i, n;
+
+        /* Channels where this ESS has been seen */
+        if (current->frequency) {
+            gsupplicant_link_predictor_add_channel(channels,
+                current->frequency);
+        }
+        known = gsupplicant_interface_bss_frequencies(self->iface, &n);
+        for (i = 0; i < n; i++) {
+            const GPtrArray* list =
+                gsupplicant_interface_find_bsss_on_frequency(self->iface,
+                    known[i]);
+            guint k;
+
+            for (k = 0; list && k < list->len; k++) {
+                GSupplicantBSS* bss = list->pdata[k];
+                if (bss->valid && bss->ssid &&
+                    g_bytes_equal(bss->ssid, current->ssid)) {
+                    gsupplicant_link_predictor_add_channel(channels,
+                        known[i]);
+                    break;
+                }
+            }
+        }
+        g_free(known);
+
+        memset(&params, 0, sizeof(params));
+        params.type = GSUPPLICANT_SCAN_TYPE_ACTIVE;
+        ssids[0] = current->ssid;
+        ssids[1] = NULL;
+        params.ssids = ssids;
+        if (channels->len) {
+            freqs.freq = (GSupplicantScanFrequency*)channels->data;
+            freqs.count = channels->len;
+            params.channels = &freqs;
+        }
+        GDEBUG("[%s] Pre-scanning %u channel(s) for %s", self->iface->path,
+            channels->len, current->ssid_str);
+        cancel = gsupplicant_interface_scan(self->iface, &params,
+            gsupplicant_link_predictor_scan_done, self);
+        if (cancel) {
+            priv->scan = g_object_ref(cancel);
+            priv->last_scan = now;
+            priv->stats.scans++;
+            priv->stats.channels += channels->len;
+        }
+        g_array_free(channels, TRUE);
+    }
+}
+
+static
+void
+gsupplicant_link_predictor_set_at_risk(
+    GSupplicantLinkPredictor* self,
+    gboolean at_risk)
+{
+    if (self->at_risk != at_risk) {
+        self->at_risk = at_risk;
+        if (at_risk) {
+            GDEBUG("[%s] Link is at risk", self->iface->path);
+            self->priv->stats.predictions++;
+            gsupplicant_link_predictor_prescan(self);
+        } else {
+            GDEBUG("[%s] Link is OK", self->iface->path);
+        }
+        g_signal_emit(self, gsupplicant_link_predictor_signals
+            [SIGNAL_AT_RISK_CHANGED], 0);
+    }
+}
+
+static
+void
+gsupplicant_link_predictor_evaluate(
+    GSupplicantLinkPredictor* self)
+{
+    GSupplicantLinkPredictorPriv* priv = self->priv;
+    const GSupplicantLinkPredictorPolicy* policy = &priv->policy;
+    double last, slope;
+
+    if (priv->completed && gsupplicant_link_predictor_fit(self, &last,
+        &slope)) {
+        const double predicted = last + slope * policy->horizon / 1000;
+
+        if (!self->at_risk) {
+            if ((slope < 0 && predicted < policy->rssi_threshold) ||
+                last < policy->rssi_threshold || (slope < 0 &&
+                policy->linkspeed_threshold && priv->linkspeed > 0 &&
+                priv->linkspeed < policy->linkspeed_threshold)) {
+                gsupplicant_link_predictor_set_at_risk(self, TRUE);
+            }
+        } else if (slope >= 0 && predicted >= (policy->rssi_threshold +
+            LINK_PREDICTOR_HYSTERESIS)) {
+            gsupplicant_link_predictor_set_at_risk(self, FALSE);
+        }
+    }
+}
+
+static
+void
+gsupplicant_link_predictor_add_sample(
+    GSupplicantLinkPredictor* self,
+    gint rssi)
+{
+    GSupplicantLinkPredictorPriv* priv = self->priv;
+    GSupplicantLinkPredictorSample* sample;
+
+    if (priv->count < LINK_PREDICTOR_SAMPLES) {
+        sample = priv->samples + (priv->first + priv->count++) %
+            LINK_PREDICTOR_SAMPLES;
+    } else {
+        /* Replace the oldest one */
+        sample = priv->samples + priv->first;
+        priv->first = (priv->first + 1) % LINK_PREDICTOR_SAMPLES;
+    }
+    sample->time = g_get_monotonic_time();
+    sample->rssi = rssi;
+    priv->stats.samples++;
+    gsupplicant_link_predictor_evaluate(self);
+}
+
+static
+void
+gsupplicant_link_predictor_poll_done(
+    GSupplicantInterface* iface,
+    GCancellable* cancel,
+    const GError* error,
+    const GSupplicantSignalPoll* info,
+    void* data)
+{
+    GSupplicantLinkPredictor* self = GSUPPLICANT_LINK_PREDICTOR(data);
+    GSupplicantLinkPredictorPriv* priv = self->priv;
+
+    GASSERT(priv->poll_call == cancel);
+    g_object_unref(priv->poll_call);
+    priv->poll_call = NULL;
+    if (info) {
+        if (info->flags & GSUPPLICANT_SIGNAL_POLL_LINKSPEED) {
+            priv->linkspeed = info->linkspeed;
+        }
+        if (info->flags & GSUPPLICANT_SIGNAL_POLL_RSSI) {
+            gsupplicant_link_predictor_add_sample(self, info->rssi);
+        }
+    }
+}
+
+static
+gboolean
+gsupplicant_link_predictor_poll(
+    gpointer data)
+{
+    GSupplicantLinkPredictor* self = GSUPPLICANT_LINK_PREDICTOR(data);
+    GSupplicantLinkPredictorPriv* priv = self->priv;
+
+    if (!priv->poll_call) {
+        GCancellable* cancel = gsupplicant_interface_signal_poll(self->iface,
+            gsupplicant_link_predictor_poll_done, self);
+        if (cancel) {
+            priv->poll_call = g_object_ref(cancel);
+        }
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static
+void
+gsupplicant_link_predictor_stop_poll(
+    GSupplicantLinkPredictor* self)
+{
+    GSupplicantLinkPredictorPriv* priv = self->priv;
+
+    if (priv->poll) {
+        g_source_destroy(priv->poll);
+        g_source_unref(priv->poll);
+        priv->poll = NULL;
+    }
+    if (priv->poll_call) {
+        g_cancellable_cancel(priv->poll_call);
+        g_object_unref(priv->poll_call);
+        priv->poll_call = NULL;
+    }
+}
+
+static
+void
+gsupplicant_link_predictor_update_poll(
+    GSupplicantLinkPredictor* self)
+{
+    GSupplicantLinkPredictorPriv* priv = self->priv;
+    const guint interval = priv->policy.poll_interval;
+
+    gsupplicant_link_predictor_stop_poll(self);
+    if (priv->completed && interval) {
+        priv->poll = g_timeout_source_new(interval);
+        g_source_set_callback(priv->poll, gsupplicant_link_predictor_poll,
+            self, NULL);
+        g_source_attach(priv->poll,
+            gsupplicant_get_context(self->iface->supplicant));
+    }
+}
+
+static
+void
+gsupplicant_link_predictor_bss_signal_changed(
+    GSupplicantBSS* bss,
+    void* data)
+{
+    GSupplicantLinkPredictor* self = GSUPPLICANT_LINK_PREDICTOR(data);
+
+    if (bss->valid) {
+        gsupplicant_link_predictor_add_sample(self, bss->signal);
+    }
+}
+
+static
+void
+gsupplicant_link_predictor_set_current(
+    GSupplicantLinkPredictor* self,
+    const char* path)
+{
+    GSupplicantLinkPredictorPriv* priv = self->priv;
+
+    if (g_strcmp0(priv->current ? priv->current->path : NULL, path)) {
+        gsupplicant_bss_remove_handler(priv->current,
+            priv->current_signal_id);
+        gsupplicant_bss_unref(priv->current);
+        priv->current_signal_id = 0;
+        priv->current = NULL;
+        gsupplicant_link_predictor_reset_samples(self);
+        if (path) {
+            priv->current = gsupplicant_bss_new(path);
+            priv->current_signal_id = gsupplicant_bss_add_handler
+                (priv->current, GSUPPLICANT_BSS_PROPERTY_SIGNAL,
+                gsupplicant_link_predictor_bss_signal_changed, self);
+        }
+    }
+}
+
+static
+void
+gsupplicant_link_predictor_update(
+    GSupplicantLinkPredictor* self)
+{
+    GSupplicantLinkPredictorPriv* priv = self->priv;
+    GSupplicantInterface* iface = self->iface;
+    const gboolean completed = iface->valid && iface->current_bss &&
+        iface->state == GSUPPLICANT_INTERFACE_STATE_COMPLETED;
+
+    if (priv->completed && !completed && (!iface->valid ||
+        iface->state <= GSUPPLICANT_INTERFACE_STATE_SCANNING)) {
+        /* Connection is gone (as opposed to roaming) */
+        GDEBUG("[%s] Link lost%s", iface->path, self->at_risk ?
+            " (predicted)" : "");
+        priv->stats.drops++;
+        if (self->at_risk) {
+            priv->stats.predicted_drops++;
+        }
+    }
+    gsupplicant_link_predictor_set_current(self, completed ?
+        iface->current_bss : NULL);
+    if (priv->completed != completed) {
+        priv->completed = completed;
+        gsupplicant_link_predictor_reset_samples(self);
+        gsupplicant_link_predictor_update_poll(self);
+    }
+    if (!completed || !priv->count) {
+        gsupplicant_link_predictor_set_at_risk(self, FALSE);
+    }
+}
+
+static
+void
+gsupplicant_link_predictor_interface_changed(
+    GSupplicantInterface* iface,
+    void* data)
+{
+    gsupplicant_link_predictor_update(GSUPPLICANT_LINK_PREDICTOR(data));
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+GSupplicantLinkPredictor*
+gsupplicant_link_predictor_new(
+    GSupplicantInterface* iface) /* Since 1.0.31 */
+{
+    if (G_LIKELY(iface)) {
+        GSupplicantLinkPredictor* self = g_object_new
+            (GSUPPLICANT_LINK_PREDICTOR_TYPE, NULL);
+        GSupplicantLinkPredictorPriv* priv = self->priv;
+
+        self->iface = gsupplicant_interface_ref(iface);
+        priv->iface_handler_id[INTERFACE_VALID_CHANGED] =
+            gsupplicant_interface_add_handler(iface,
+                GSUPPLICANT_INTERFACE_PROPERTY_VALID,
+                gsupplicant_link_predictor_interface_changed, self);
+        priv->iface_handler_id[INTERFACE_STATE_CHANGED] =
+            gsupplicant_interface_add_handler(iface,
+                GSUPPLICANT_INTERFACE_PROPERTY_STATE,
+                gsupplicant_link_predictor_interface_changed, self);
+        priv->iface_handler_id[INTERFACE_CURRENT_BSS_CHANGED] =
+            gsupplicant_interface_add_handler(iface,
+                GSUPPLICANT_INTERFACE_PROPERTY_CURRENT_BSS,
+                gsupplicant_link_predictor_interface_changed, self);
+        gsupplicant_link_predictor_update(self);
+        return self;
+    }
+    return NULL;
+}
+
+GSupplicantLinkPredictor*
+gsupplicant_link_predictor_ref(
+    GSupplicantLinkPredictor* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        g_object_ref(GSUPPLICANT_LINK_PREDICTOR(self));
+        return self;
+    } else {
+        return NULL;
+    }
+}
+
+void
+gsupplicant_link_predictor_unref(
+    GSupplicantLinkPredictor* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        g_object_unref(GSUPPLICANT_LINK_PREDICTOR(self));
+    }
+}
+
+void
+gsupplicant_link_predictor_set_policy(
+    GSupplicantLinkPredictor* self,
+    const GSupplicantLinkPredictorPolicy* policy) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        GSupplicantLinkPredictorPriv* priv = self->priv;
+        const guint interval = priv->policy.poll_interval;
+
+        priv->policy = policy ? *policy : gsupplicant_link_predictor_default;
+        if (priv->policy.poll_interval != interval) {
+            gsupplicant_link_predictor_update_poll(self);
+        }
+    }
+}
+
+const GSupplicantLinkPredictorPolicy*
+gsupplicant_link_predictor_get_policy(
+    GSupplicantLinkPredictor* self) /* Since 1.0.31 */
+{
+    return G_LIKELY(self) ? &self->priv->policy : NULL;
+}
+
+const GSupplicantLinkPredictorStats*
+gsupplicant_link_predictor_get_stats(
+    GSupplicantLinkPredictor* self) /* Since 1.0.31 */
+{
+    return G_LIKELY(self) ? &self->priv->stats : NULL;
+}
+
+gboolean
+gsupplicant_link_predictor_predict(
+    GSupplicantLinkPredictor* self,
+    gint* rssi) /* Since 1.0.31 */
+{
+    double last, slope;
+
+    if (G_LIKELY(self) && gsupplicant_link_predictor_fit(self, &last,
+        &slope)) {
+        if (rssi) {
+            const double predicted = last + slope *
+                self->priv->policy.horizon / 1000;
+            *rssi = (gint)(predicted < 0 ? (predicted - 0.5) :
+                (predicted + 0.5));
+        }
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gulong
+gsupplicant_link_predictor_add_at_risk_handler(
+    GSupplicantLinkPredictor* self,
+    GSupplicantLinkPredictorFunc fn,
+    void* data) /* Since 1.0.31 */
+{
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+        SIGNAL_AT_RISK_CHANGED_NAME, G_CALLBACK(fn), data) : 0;
+}
+
+void
+gsupplicant_link_predictor_remove_handler(
+    GSupplicantLinkPredictor* self,
+    gulong id) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(id)) {
+        g_signal_handler_disconnect(self, id);
+    }
+}
+
+/*==========================================================================*
+ * Internals
+ *==========================================================================*/
+
+/**
+ * Per instance initializer
+ */
+static
+void
+gsupplicant_link_predictor_init(
+    GSupplicantLinkPredictor* self)
+{
+    GSupplicantLinkPredictorPriv* priv = G_TYPE_INSTANCE_GET_PRIVATE(self,
+        GSUPPLICANT_LINK_PREDICTOR_TYPE, GSupplicantLinkPredictorPriv);
+    self->priv = priv;
+    priv->policy = gsupplicant_link_predictor_default;
+}
+
+/**
+ * Final stage of deinitialization
+ */
+static
+void
+gsupplicant_link_predictor_finalize(
+    GObject* object)
+{
+    GSupplicantLinkPredictor* self = GSUPPLICANT_LINK_PREDICTOR(object);
+    GSupplicantLinkPredictorPriv* priv = self->priv;
+    gsupplicant_link_predictor_stop_poll(self);
+    if (priv->scan) {
+        g_cancellable_cancel(priv->scan);
+        g_object_unref(priv->scan);
+    }
+    gsupplicant_bss_remove_handler(priv->current, priv->current_signal_id);
+    gsupplicant_bss_unref(priv->current);
+    gsupplicant_interface_remove_all_handlers(self->iface,
+        priv->iface_handler_id);
+    gsupplicant_interface_unref(self->iface);
+    G_OBJECT_CLASS(SUPER_CLASS)->finalize(object);
+}
+
+/**
+ * Per class initializer
+ */
+static
+void
+gsupplicant_link_predictor_class_init(
+    GSupplicantLinkPredictorClass* klass)
+{
+    G_OBJECT_CLASS(klass)->finalize = gsupplicant_link_predictor_finalize;
+    G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    g_type_class_add_private(klass, sizeof(GSupplicantLinkPredictorPriv));
+    G_GNUC_END_IGNORE_DEPRECATIONS
+    gsupplicant_link_predictor_signals[SIGNAL_AT_RISK_CHANGED] =
+        g_signal_new(SIGNAL_AT_RISK_CHANGED_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE, 0);
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
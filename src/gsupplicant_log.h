@@ -33,11 +33,45 @@
 #ifndef GSUPPLICANT_LOG_H
 #define GSUPPLICANT_LOG_H
 
-#include "gsupplicant_types.h"
+#include "gsupplicant_types_p.h"
 
 #define GLOG_MODULE_NAME GSUPPLICANT_LOG_MODULE
 #include <gutil_log.h>
 
+/*
+ * Logs the message followed by the hex dump of the bytes. Nothing is
+ * formatted unless the message is going to be printed or there is a
+ * structured sink (see gsupplicant_log_set_bytes_func) to receive it.
+ *
+ * The dump always goes last, separated by a space. Messages which used
+ * to have it in the middle have been reworded, e.g. the SSID one now
+ * reads '[path] SSID "name": 6d:6f:63:6b' rather than having the dump
+ * before the name.
+ */
+void
+gsupplicant_log_bytes(
+    const GLogModule* module,
+    int level,
+    GBytes* bytes,
+    gboolean append_length,
+    const char* format,
+    ...) G_GNUC_PRINTF(5,6)
+    GSUPPLICANT_INTERNAL;
+
+#if GUTIL_LOG_DEBUG
+#  define GDEBUG_BYTES(bytes,len,f,args...) gsupplicant_log_bytes( \
+    GLOG_MODULE_CURRENT, GLOG_LEVEL_DEBUG, bytes, len, f, ##args)
+#else
+#  define GDEBUG_BYTES(bytes,len,f,args...) ((void)0)
+#endif
+
+#if GUTIL_LOG_VERBOSE
+#  define GVERBOSE_BYTES(bytes,len,f,args...) gsupplicant_log_bytes( \
+    GLOG_MODULE_CURRENT, GLOG_LEVEL_VERBOSE, bytes, len, f, ##args)
+#else
+#  define GVERBOSE_BYTES(bytes,len,f,args...) ((void)0)
+#endif
+
 #endif /* GSUPPLICANT_LOG_H */
 
 /*
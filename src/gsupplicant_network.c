@@ -34,11 +34,13 @@
 
 #include "gsupplicant_network.h"
 #include "gsupplicant_interface.h"
+#include "gsupplicant_p.h"
+#include "gsupplicant_util_p.h"
 #include "gsupplicant_dbus.h"
 #include "gsupplicant_log.h"
+#include "gsupplicant_trace.h"
 
 #include <gutil_misc.h>
-#include <gutil_strv.h>
 
 /* Generated headers */
 #include "fi.w1.wpa_supplicant1.Network.h"
@@ -56,12 +58,25 @@ enum supplicant_interface_handler_id {
     INTERFACE_HANDLER_COUNT
 };
 
+/* These are never blocked */
+enum supplicant_network_resync_handler_id {
+    RESYNC_PROPERTIES_CHANGED,
+    RESYNC_NOTIFY_NAME_OWNER,
+    RESYNC_HANDLER_COUNT
+};
+
 struct gsupplicant_network_priv {
     FiW1Wpa_supplicant1Network* proxy;
     gulong proxy_handler_id[PROXY_HANDLER_COUNT];
     gulong iface_handler_id[INTERFACE_HANDLER_COUNT];
-    char* path;
+    gulong resync_handler_id[RESYNC_HANDLER_COUNT];
+    gboolean resyncing;
+    const char* path;       /* Interned */
     guint32 pending_signals;
+    GVariant* props_dict;   /* a{sv} which owns the values */
+    GSupplicantNetworkKeyValue* props; /* Sorted by key */
+    guint props_count;
+    const char** changed_keys; /* Not yet signalled, interned */
 };
 
 typedef GObjectClass GSupplicantNetworkClass;
@@ -83,6 +98,7 @@ typedef enum gsupplicant_network_signal {
     GSUPPLICANT_NETWORK_PROPERTIES_(SIGNAL_ENUM_)
 #undef SIGNAL_ENUM_
     SIGNAL_PROPERTY_CHANGED,
+    SIGNAL_PROPERTIES_KEY_CHANGED,
     SIGNAL_COUNT
 } GSUPPLICANT_NETWORK_SIGNAL;
 
@@ -102,6 +118,7 @@ G_STATIC_ASSERT((int)SIGNAL_PROPERTY_CHANGED ==
 #define SIGNAL_PROPERTY_CHANGED_NAME            "property-changed"
 #define SIGNAL_PROPERTY_CHANGED_DETAIL          "%x"
 #define SIGNAL_PROPERTY_CHANGED_DETAIL_MAX_LEN  (8)
+#define SIGNAL_PROPERTIES_KEY_CHANGED_NAME      "properties-key-changed"
 
 static GQuark gsupplicant_network_property_quarks[SIGNAL_PROPERTY_CHANGED];
 static guint gsupplicant_network_signals[SIGNAL_COUNT];
@@ -109,7 +126,8 @@ static const char* gsupplicant_network_signame[] = {
 #define SIGNAL_NAME_(P,p) #p "-changed",
     GSUPPLICANT_NETWORK_PROPERTIES_(SIGNAL_NAME_)
 #undef SIGNAL_NAME_
-    SIGNAL_PROPERTY_CHANGED_NAME
+    SIGNAL_PROPERTY_CHANGED_NAME,
+    SIGNAL_PROPERTIES_KEY_CHANGED_NAME
 };
 
 G_STATIC_ASSERT(G_N_ELEMENTS(gsupplicant_network_signame) == SIGNAL_COUNT);
@@ -118,8 +136,8 @@ G_STATIC_ASSERT(G_N_ELEMENTS(gsupplicant_network_signame) == SIGNAL_COUNT);
 #define PROXY_PROPERTY_NAME_ENABLED        "Enabled"
 #define PROXY_PROPERTY_NAME_PROPERTIES     "Properties"
 
-/* Weak references to the instances of GSupplicantNetwork */
-static GHashTable* gsupplicant_network_table = NULL;
+/* Weak references to the instances of GSupplicantNetwork (per main context) */
+static GSupplicantRegistry gsupplicant_network_registry;
 
 /*==========================================================================*
  * Implementation
@@ -162,6 +180,20 @@ gsupplicant_network_signal_property_change(
         gsupplicant_network_property_quarks[sig], prop);
 }
 
+static
+void
+gsupplicant_network_changed_keys_free(
+    const char** keys)
+{
+    if (keys) {
+        const char** ptr;
+        for (ptr = keys; *ptr; ptr++) {
+            gsupplicant_intern_unref(*ptr);
+        }
+        g_free(keys);
+    }
+}
+
 static
 void
 gsupplicant_network_emit_pending_signals(
@@ -173,6 +205,8 @@ gsupplicant_network_emit_pending_signals(
 
     /* Handlers could drops their references to us */
     gsupplicant_network_ref(self);
+    GSUPPLICANT_TRACE3(emit_pending_signals, "network", self->path,
+        priv->pending_signals);
 
     /* VALID is the last one to be emitted if we BECOME valid */
     if ((priv->pending_signals & SIGNAL_BIT(VALID)) && self->valid) {
@@ -182,6 +216,19 @@ gsupplicant_network_emit_pending_signals(
         valid_changed = FALSE;
     }
 
+    /* Per-key notifications precede PROPERTIES */
+    if (priv->changed_keys) {
+        const char** keys = priv->changed_keys;
+        const char** ptr;
+        priv->changed_keys = NULL;
+        for (ptr = keys; *ptr; ptr++) {
+            g_signal_emit(self,
+                gsupplicant_network_signals[SIGNAL_PROPERTIES_KEY_CHANGED],
+                g_quark_from_string(*ptr), *ptr);
+        }
+        gsupplicant_network_changed_keys_free(keys);
+    }
+
     /* Emit the signals. Not that in case if valid has become FALSE, then
      * VALID is emitted first, otherwise it's emitted last */
     for (sig = SIGNAL_VALID_CHANGED;
@@ -199,6 +246,8 @@ gsupplicant_network_emit_pending_signals(
             GSUPPLICANT_NETWORK_PROPERTY_VALID);
     }
 
+    GSUPPLICANT_TRACE2(emit_pending_signals_done, "network", self->path);
+
     /* And release the temporary reference */
     gsupplicant_network_unref(self);
 }
@@ -224,7 +273,7 @@ gsupplicant_network_update_present(
 {
     GSupplicantNetworkPriv* priv = self->priv;
     const gboolean present = priv->proxy && self->iface->valid &&
-        gutil_strv_contains(self->iface->networks, priv->path);
+        gsupplicant_intern_strv_contains(self->iface->networks, priv->path);
     if (self->present != present) {
         self->present = present;
         GDEBUG("Network %s is %spresent", priv->path, present ? "" : "not ");
@@ -233,77 +282,198 @@ gsupplicant_network_update_present(
 }
 
 static
-GHashTable*
-gsupplicant_network_get_properties(
-    GSupplicantNetwork* self)
+int
+gsupplicant_network_key_value_compare(
+    const void* p1,
+    const void* p2)
 {
-    GHashTable* props = NULL;
-    GSupplicantNetworkPriv* priv = self->priv;
-    GVariant* dict = fi_w1_wpa_supplicant1_network_get_properties(priv->proxy);
-    if (dict) {
-        GVariantIter it;
-        GVariant* entry;
-        if (g_variant_is_of_type(dict, G_VARIANT_TYPE_VARIANT)) {
-            GVariant* tmp = g_variant_get_variant(dict);
-            g_variant_unref(dict);
-            dict = tmp;
+    const GSupplicantNetworkKeyValue* kv1 = p1;
+    const GSupplicantNetworkKeyValue* kv2 = p2;
+    return strcmp(kv1->key, kv2->key);
+}
+
+static
+void
+gsupplicant_network_key_values_free(
+    GSupplicantNetworkKeyValue* kv,
+    guint count)
+{
+    if (kv) {
+        guint i;
+        for (i = 0; i < count; i++) {
+            gsupplicant_intern_unref(kv[i].key);
         }
-        props = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
-        for (g_variant_iter_init(&it, dict);
-             (entry = g_variant_iter_next_value(&it)) != NULL;
-             g_variant_unref(entry)) {
-            const guint num = g_variant_n_children(entry);
-            if (G_LIKELY(num == 2)) {
-                GVariant* key = g_variant_get_child_value(entry, 0);
-                GVariant* value = g_variant_get_child_value(entry, 1);
-                if (g_variant_is_of_type(value, G_VARIANT_TYPE_VARIANT)) {
-                    GVariant* tmp = g_variant_get_variant(value);
-                    g_variant_unref(value);
-                    value = tmp;
-                }
-                if (g_variant_is_of_type(key, G_VARIANT_TYPE_STRING) &&
-                    g_variant_is_of_type(value, G_VARIANT_TYPE_STRING)) {
-                    g_hash_table_replace(props,
-                        g_strdup(g_variant_get_string(key, NULL)),
-                        g_strdup(g_variant_get_string(value, NULL)));
-                }
-                g_variant_unref(key);
+        g_free(kv);
+    }
+}
+
+/*
+ * Builds the sorted view of the Properties dictionary. Keys are interned,
+ * values point into the dictionary which therefore has to stay alive for
+ * as long as the view is in use.
+ */
+static
+GSupplicantNetworkKeyValue*
+gsupplicant_network_parse_properties(
+    GVariant* dict,
+    guint* count)
+{
+    GSupplicantNetworkKeyValue* kv = NULL;
+    guint n = 0;
+    const gsize size = g_variant_n_children(dict);
+    if (size) {
+        GVariantIter it;
+        GVariant* value;
+        const char* key;
+        kv = g_new(GSupplicantNetworkKeyValue, size);
+        g_variant_iter_init(&it, dict);
+        while (g_variant_iter_next(&it, "{&sv}", &key, &value)) {
+            if (g_variant_is_of_type(value, G_VARIANT_TYPE_VARIANT)) {
+                GVariant* tmp = g_variant_get_variant(value);
                 g_variant_unref(value);
+                value = tmp;
+            }
+            if (g_variant_is_of_type(value, G_VARIANT_TYPE_STRING)) {
+                GASSERT(n < size);
+                kv[n].key = gsupplicant_intern(key);
+                /* The string data is owned by the dictionary */
+                kv[n].value = g_variant_get_string(value, NULL);
+                n++;
             }
+            g_variant_unref(value);
+        }
+        if (n > 1) {
+            qsort(kv, n, sizeof(kv[0]), gsupplicant_network_key_value_compare);
+        } else if (!n) {
+            g_free(kv);
+            kv = NULL;
         }
     }
-    return props;
+    *count = n;
+    return kv;
 }
 
+/*
+ * Merges two sorted views and collects the keys which have been added,
+ * removed or changed their values. Returns NULL if there's no difference.
+ * The returned array is NULL-terminated and holds references to the
+ * interned keys.
+ */
 static
-gboolean
-gsupplicant_network_properties_equal(
-    GHashTable* p1,
-    GHashTable* p2)
-{
-    if (p1 && p2) {
-        const gsize size = g_hash_table_size(p1);
-        if (g_hash_table_size(p2) == size) {
-            if (size) {
-                GHashTableIter it;
-                gpointer key, value;
-                gboolean equal = TRUE;
-                g_hash_table_iter_init(&it, p1);
-                while (g_hash_table_iter_next(&it, &key, &value)) {
-                    const char* value2 = g_hash_table_lookup(p2, key);
-                    if (g_strcmp0(value, value2)) {
-                        equal = FALSE;
-                        break;
-                    }
-                }
-                return equal;
+const char**
+gsupplicant_network_properties_diff(
+    const GSupplicantNetworkKeyValue* kv1,
+    guint n1,
+    const GSupplicantNetworkKeyValue* kv2,
+    guint n2)
+{
+    const char** keys = NULL;
+    guint i1 = 0, i2 = 0, n = 0;
+    while (i1 < n1 || i2 < n2) {
+        const char* key;
+        if (i1 < n1 && i2 < n2) {
+            /* Interned strings can be compared by pointer */
+            const int diff = (kv1[i1].key == kv2[i2].key) ? 0 :
+                strcmp(kv1[i1].key, kv2[i2].key);
+            if (diff < 0) {
+                key = kv1[i1++].key;
+            } else if (diff > 0) {
+                key = kv2[i2++].key;
+            } else if (strcmp(kv1[i1].value, kv2[i2].value)) {
+                key = kv1[i1].key;
+                i1++;
+                i2++;
+            } else {
+                i1++;
+                i2++;
+                continue;
+            }
+        } else if (i1 < n1) {
+            key = kv1[i1++].key;
+        } else {
+            key = kv2[i2++].key;
+        }
+        if (!keys) {
+            /* The number of changes can't exceed n1 + n2 */
+            keys = g_new(const char*, n1 + n2 + 1);
+        }
+        keys[n++] = gsupplicant_intern_ref(key);
+    }
+    if (keys) {
+        keys[n] = NULL;
+    }
+    return keys;
+}
+
+static
+void
+gsupplicant_network_add_changed_keys(
+    GSupplicantNetwork* self,
+    const char** keys)
+{
+    GSupplicantNetworkPriv* priv = self->priv;
+    if (priv->changed_keys) {
+        /* Signals haven't been emitted yet, merge the change sets */
+        const guint n1 = g_strv_length((char**)priv->changed_keys);
+        const guint n2 = g_strv_length((char**)keys);
+        const char** merged = g_renew(const char*, priv->changed_keys,
+            n1 + n2 + 1);
+        guint i, n = n1;
+        for (i = 0; i < n2; i++) {
+            const char* key = keys[i];
+            guint k;
+            for (k = 0; k < n1 && merged[k] != key; k++);
+            if (k < n1) {
+                gsupplicant_intern_unref(key);
+            } else {
+                merged[n++] = key;
             }
-            return TRUE;
         }
-        return FALSE;
+        merged[n] = NULL;
+        priv->changed_keys = merged;
+        g_free(keys);
     } else {
-        return !p1 && !p2;
+        priv->changed_keys = keys;
+    }
+}
+
+static
+GHashTable*
+gsupplicant_network_properties_table(
+    const GSupplicantNetworkKeyValue* kv,
+    guint count)
+{
+    /* Both keys and values are owned by the sorted view */
+    GHashTable* props = g_hash_table_new(g_str_hash, g_str_equal);
+    guint i;
+    for (i = 0; i < count; i++) {
+        g_hash_table_insert(props, (gpointer)kv[i].key,
+            (gpointer)kv[i].value);
+    }
+    return props;
+}
+
+static
+void
+gsupplicant_network_set_properties(
+    GSupplicantNetwork* self,
+    GVariant* dict,
+    GSupplicantNetworkKeyValue* kv,
+    guint count)
+{
+    GSupplicantNetworkPriv* priv = self->priv;
+    if (self->properties) {
+        g_hash_table_unref(self->properties);
     }
+    gsupplicant_network_key_values_free(priv->props, priv->props_count);
+    if (priv->props_dict) {
+        g_variant_unref(priv->props_dict);
+    }
+    priv->props_dict = dict;
+    priv->props = kv;
+    priv->props_count = count;
+    self->properties = dict ?
+        gsupplicant_network_properties_table(kv, count) : NULL;
 }
 
 static
@@ -312,38 +482,68 @@ gsupplicant_network_update_properties(
     GSupplicantNetwork* self)
 {
     GSupplicantNetworkPriv* priv = self->priv;
-    GHashTable* props = gsupplicant_network_get_properties(self);
-    if (!gsupplicant_network_properties_equal(props, self->properties)) {
-        if (self->properties) {
-            g_hash_table_unref(self->properties);
+    /* The view borrows from the dictionary, hence dup rather than get */
+    GVariant* dict = fi_w1_wpa_supplicant1_network_dup_properties(priv->proxy);
+    GSupplicantNetworkKeyValue* kv = NULL;
+    const char** keys;
+    guint count = 0;
+    if (dict) {
+        if (g_variant_is_of_type(dict, G_VARIANT_TYPE_VARIANT)) {
+            GVariant* tmp = g_variant_get_variant(dict);
+            g_variant_unref(dict);
+            dict = tmp;
+        }
+        if (dict == priv->props_dict) {
+            /* Same dictionary, nothing to do */
+            g_variant_unref(dict);
+            return;
+        }
+        kv = gsupplicant_network_parse_properties(dict, &count);
+    }
+    keys = gsupplicant_network_properties_diff(priv->props,
+        priv->props_count, kv, count);
+    if (keys || !dict != !priv->props_dict) {
+        if (keys) {
+            gsupplicant_network_add_changed_keys(self, keys);
         }
-        self->properties = props;
+        gsupplicant_network_set_properties(self, dict, kv, count);
         priv->pending_signals |= SIGNAL_BIT(PROPERTIES);
 #if GUTIL_LOG_VERBOSE
         if (GLOG_ENABLED(GUTIL_LOG_VERBOSE)) {
-            if (props) {
-                GHashTableIter it;
-                gpointer key;
-                char** keys = g_new(char*, g_hash_table_size(props) + 1);
-                char** ptr = keys;
-                g_hash_table_iter_init(&it, props);
-                while (g_hash_table_iter_next(&it, &key, NULL)) *ptr++ = key;
-                *ptr++ = NULL;
+            if (dict) {
+                guint i;
                 GVERBOSE("[%s] Properties:", self->path);
-                gutil_strv_sort(keys, TRUE);
-                for (ptr = keys; *ptr; ptr++) {
-                    const char* key = *ptr;
-                    const char* value = g_hash_table_lookup(props, key);
-                    GVERBOSE("  %s: %s", key, value);
+                for (i = 0; i < count; i++) {
+                    GVERBOSE("  %s: %s", kv[i].key, kv[i].value);
                 }
-                g_free(keys);
             } else {
                 GVERBOSE("[%s] Properties: (null)", self->path);
             }
         }
 #endif
-    } else if (props) {
-        g_hash_table_unref(props);
+    } else {
+        /* Nothing has changed, keep the old view */
+        gsupplicant_network_key_values_free(kv, count);
+        if (dict) {
+            g_variant_unref(dict);
+        }
+    }
+}
+
+static
+void
+gsupplicant_network_drop_properties(
+    GSupplicantNetwork* self)
+{
+    GSupplicantNetworkPriv* priv = self->priv;
+    if (priv->props_dict) {
+        const char** keys = gsupplicant_network_properties_diff(priv->props,
+            priv->props_count, NULL, 0);
+        if (keys) {
+            gsupplicant_network_add_changed_keys(self, keys);
+        }
+        gsupplicant_network_set_properties(self, NULL, NULL, 0);
+        priv->pending_signals |= SIGNAL_BIT(PROPERTIES);
     }
 }
 
@@ -372,16 +572,14 @@ gsupplicant_network_proxy_gproperties_changed(
 {
     GSupplicantNetwork* self = GSUPPLICANT_NETWORK(data);
     GSupplicantNetworkPriv* priv = self->priv;
+    GSUPPLICANT_TRACE4(properties_changed, "network", self->path, changed,
+        invalidated);
     if (invalidated) {
         char** ptr;
         for (ptr = invalidated; *ptr; ptr++) {
             const char* name = *ptr;
             if (!strcmp(name, PROXY_PROPERTY_NAME_PROPERTIES)) {
-                if (self->properties) {
-                    g_hash_table_unref(self->properties);
-                    self->properties = NULL;
-                    priv->pending_signals |= SIGNAL_BIT(PROPERTIES);
-                }
+                gsupplicant_network_drop_properties(self);
             } else if (!strcmp(name, PROXY_PROPERTY_NAME_ENABLED)) {
                 if (self->enabled) {
                     self->enabled = FALSE;
@@ -405,6 +603,7 @@ gsupplicant_network_proxy_gproperties_changed(
         }
     }
     gsupplicant_network_emit_pending_signals(self);
+    GSUPPLICANT_TRACE2(properties_changed_done, "network", self->path);
 }
 
 static
@@ -417,6 +616,67 @@ gsupplicant_network_proxy_properties_changed(
     gsupplicant_network_proxy_gproperties_changed(proxy, change, NULL, data);
 }
 
+static
+void
+gsupplicant_network_update_all(
+    GSupplicantNetwork* self)
+{
+    gsupplicant_network_update_valid(self);
+    gsupplicant_network_update_present(self);
+    gsupplicant_network_update_properties(self);
+    gsupplicant_network_update_enabled(self);
+}
+
+/* See the resync comment in gsupplicant.c */
+static
+void
+gsupplicant_network_resync_finish(
+    GSupplicantNetwork* self)
+{
+    GSupplicantNetworkPriv* priv = self->priv;
+
+    priv->resyncing = FALSE;
+    gsupplicant_unblock_handlers(priv->proxy, priv->proxy_handler_id,
+        G_N_ELEMENTS(priv->proxy_handler_id));
+    gsupplicant_network_update_all(self);
+}
+
+static
+void
+gsupplicant_network_resync_properties_changed(
+    GDBusProxy* proxy,
+    GVariant* changed,
+    GStrv invalidated,
+    gpointer data)
+{
+    GSupplicantNetwork* self = GSUPPLICANT_NETWORK(data);
+    GSupplicantNetworkPriv* priv = self->priv;
+
+    if (!priv->resyncing &&
+        gsupplicant_resync_enabled(self->iface->supplicant) &&
+        self->iface->valid && !gsupplicant_proxy_has_owner(proxy)) {
+        GDEBUG("[%s] Resyncing", self->path);
+        priv->resyncing = TRUE;
+        gsupplicant_block_handlers(priv->proxy, priv->proxy_handler_id,
+            G_N_ELEMENTS(priv->proxy_handler_id));
+    }
+}
+
+static
+void
+gsupplicant_network_resync_notify_name_owner(
+    GDBusProxy* proxy,
+    GParamSpec* param,
+    gpointer data)
+{
+    GSupplicantNetwork* self = GSUPPLICANT_NETWORK(data);
+
+    if (self->priv->resyncing && gsupplicant_proxy_has_owner(proxy)) {
+        gsupplicant_network_resync_finish(self);
+        gsupplicant_network_emit_pending_signals(self);
+    }
+}
+
 static
 void
 gsupplicant_network_interface_valid_changed(
@@ -425,8 +685,13 @@ gsupplicant_network_interface_valid_changed(
 {
     GSupplicantNetwork* self = GSUPPLICANT_NETWORK(data);
     GASSERT(self->iface == iface);
-    gsupplicant_network_update_valid(self);
-    gsupplicant_network_update_present(self);
+    if (self->priv->resyncing) {
+        /* The interface has given up waiting */
+        gsupplicant_network_resync_finish(self);
+    } else {
+        gsupplicant_network_update_valid(self);
+        gsupplicant_network_update_present(self);
+    }
     gsupplicant_network_emit_pending_signals(self);
 }
 
@@ -456,7 +721,15 @@ gsupplicant_network_proxy_created(
     GASSERT(!priv->proxy);
     priv->proxy = fi_w1_wpa_supplicant1_network_proxy_new_for_bus_finish(res,
         &error);
+    GSUPPLICANT_TRACE3(proxy_ready, "network", self->path,
+        priv->proxy != NULL);
     if (priv->proxy) {
+        priv->resync_handler_id[RESYNC_PROPERTIES_CHANGED] =
+            g_signal_connect(priv->proxy, "g-properties-changed",
+            G_CALLBACK(gsupplicant_network_resync_properties_changed), self);
+        priv->resync_handler_id[RESYNC_NOTIFY_NAME_OWNER] =
+            g_signal_connect(priv->proxy, "notify::g-name-owner",
+            G_CALLBACK(gsupplicant_network_resync_notify_name_owner), self);
         priv->proxy_handler_id[PROXY_GPROPERTIES_CHANGED] =
             g_signal_connect(priv->proxy, "g-properties-changed",
             G_CALLBACK(gsupplicant_network_proxy_gproperties_changed), self);
@@ -473,11 +746,7 @@ gsupplicant_network_proxy_created(
                 GSUPPLICANT_INTERFACE_PROPERTY_NETWORKS,
                 gsupplicant_network_interface_networks_changed, self);
 
-        gsupplicant_network_update_valid(self);
-        gsupplicant_network_update_present(self);
-        gsupplicant_network_update_properties(self);
-        gsupplicant_network_update_enabled(self);
-
+        gsupplicant_network_update_all(self);
         gsupplicant_network_emit_pending_signals(self);
     } else {
         GERR("%s", GERRMSG(error));
@@ -486,24 +755,6 @@ gsupplicant_network_proxy_created(
     gsupplicant_network_unref(self);
 }
 
-static
-void
-gsupplicant_network_destroyed(
-    gpointer key,
-    GObject* dead)
-{
-    GVERBOSE_("%s", (char*)key);
-    GASSERT(gsupplicant_network_table);
-    if (gsupplicant_network_table) {
-        GASSERT(g_hash_table_lookup(gsupplicant_network_table, key) == dead);
-        g_hash_table_remove(gsupplicant_network_table, key);
-        if (g_hash_table_size(gsupplicant_network_table) == 0) {
-            g_hash_table_unref(gsupplicant_network_table);
-            gsupplicant_network_table = NULL;
-        }
-    }
-}
-
 static
 GSupplicantNetwork*
 gsupplicant_network_create(
@@ -529,20 +780,17 @@ gsupplicant_network_create(
     }
     if (ptr > path) {
         GSupplicantInterface* iface;
-        /* Temporarily shorten the path to lookup the interface */
-        char* path2 = g_strdup(path);
-        const gsize slash_index = ptr - path;
-        path2[slash_index] = 0;
+        char* path2 = g_strndup(path, ptr - path);
         GDEBUG_("%s -> %s", path, path2);
         iface = gsupplicant_interface_new(path2);
+        g_free(path2);
         if (iface) {
             GSupplicantNetwork* self =
                 g_object_new(GSUPPLICANT_NETWORK_TYPE,NULL);
             GSupplicantNetworkPriv* priv = self->priv;
-            /* Path is already allocated (but truncated) */
-            path2[slash_index] = '/';
-            self->path = priv->path = path2;
+            self->path = priv->path = gsupplicant_intern(path);
             self->iface = iface;
+            GSUPPLICANT_TRACE2(proxy_new, "network", self->path);
             fi_w1_wpa_supplicant1_network_proxy_new_for_bus(
                 GSUPPLICANT_BUS_TYPE, G_DBUS_PROXY_FLAGS_NONE,
                 GSUPPLICANT_SERVICE, self->path, NULL,
@@ -550,7 +798,6 @@ gsupplicant_network_create(
                 gsupplicant_network_ref(self));
             return self;
         }
-        g_free(path2);
     }
     return NULL;
 }
@@ -565,20 +812,12 @@ gsupplicant_network_new(
 {
     GSupplicantNetwork* self = NULL;
     if (G_LIKELY(path)) {
-        self = gsupplicant_network_table ? gsupplicant_network_ref(
-            g_hash_table_lookup(gsupplicant_network_table, path)) : NULL;
+        self = gsupplicant_registry_get(&gsupplicant_network_registry, path);
         if (!self) {
             self = gsupplicant_network_create(path);
             if (self) {
-                gpointer key = g_strdup(path);
-                if (!gsupplicant_network_table) {
-                    gsupplicant_network_table =
-                        g_hash_table_new_full(g_str_hash, g_str_equal,
-                            g_free, NULL);
-                }
-                g_hash_table_replace(gsupplicant_network_table, key, self);
-                g_object_weak_ref(G_OBJECT(self),
-                    gsupplicant_network_destroyed, key);
+                gsupplicant_registry_add(&gsupplicant_network_registry,
+                    self->path, self);
             }
         }
     }
@@ -630,6 +869,22 @@ gsupplicant_network_add_property_changed_handler(
     return 0;
 }
 
+gulong
+gsupplicant_network_add_properties_key_handler(
+    GSupplicantNetwork* self,
+    const char* key,
+    GSupplicantNetworkKeyFunc fn,
+    void* data) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(fn)) {
+        return g_signal_connect_closure_by_id(self,
+            gsupplicant_network_signals[SIGNAL_PROPERTIES_KEY_CHANGED],
+            key ? g_quark_from_string(key) : 0,
+            g_cclosure_new(G_CALLBACK(fn), data, NULL), FALSE);
+    }
+    return 0;
+}
+
 gulong
 gsupplicant_network_add_handler(
     GSupplicantNetwork* self,
@@ -674,6 +929,46 @@ gsupplicant_network_remove_handlers(
     gutil_disconnect_handlers(self, ids, count);
 }
 
+const GSupplicantNetworkKeyValue*
+gsupplicant_network_properties(
+    GSupplicantNetwork* self,
+    guint* count) /* Since: 1.0.31 */
+{
+    const GSupplicantNetworkKeyValue* kv = NULL;
+    guint n = 0;
+    if (G_LIKELY(self)) {
+        GSupplicantNetworkPriv* priv = self->priv;
+        kv = priv->props;
+        n = priv->props_count;
+    }
+    if (count) {
+        *count = n;
+    }
+    return kv;
+}
+
+const char*
+gsupplicant_network_property(
+    GSupplicantNetwork* self,
+    const char* key) /* Since: 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(key)) {
+        GSupplicantNetworkPriv* priv = self->priv;
+        if (priv->props) {
+            GSupplicantNetworkKeyValue kv;
+            const GSupplicantNetworkKeyValue* found;
+            kv.key = key;
+            kv.value = NULL;
+            found = bsearch(&kv, priv->props, priv->props_count,
+                sizeof(kv), gsupplicant_network_key_value_compare);
+            if (found) {
+                return found->value;
+            }
+        }
+    }
+    return NULL;
+}
+
 gboolean
 gsupplicant_network_set_enabled(
     GSupplicantNetwork* self,
@@ -715,6 +1010,8 @@ gsupplicant_network_dispose(
     GSupplicantNetwork* self = GSUPPLICANT_NETWORK(object);
     GSupplicantNetworkPriv* priv = self->priv;
     if (priv->proxy) {
+        gutil_disconnect_handlers(priv->proxy, priv->resync_handler_id,
+            G_N_ELEMENTS(priv->resync_handler_id));
         gutil_disconnect_handlers(priv->proxy, priv->proxy_handler_id,
             G_N_ELEMENTS(priv->proxy_handler_id));
         g_object_unref(priv->proxy);
@@ -736,11 +1033,10 @@ gsupplicant_network_finalize(
     GSupplicantNetwork* self = GSUPPLICANT_NETWORK(object);
     GSupplicantNetworkPriv* priv = self->priv;
     GASSERT(!priv->proxy);
-    g_free(priv->path);
+    gsupplicant_intern_unref(priv->path);
     gsupplicant_interface_unref(self->iface);
-    if (self->properties) {
-        g_hash_table_unref(self->properties);
-    }
+    gsupplicant_network_set_properties(self, NULL, NULL, 0);
+    gsupplicant_network_changed_keys_free(priv->changed_keys);
     G_OBJECT_CLASS(SUPER_CLASS)->finalize(object);
 }
 
@@ -768,6 +1064,11 @@ gsupplicant_network_class_init(
         g_signal_new(SIGNAL_PROPERTY_CHANGED_NAME, G_OBJECT_CLASS_TYPE(klass),
             G_SIGNAL_RUN_FIRST | G_SIGNAL_DETAILED, 0, NULL, NULL, NULL,
             G_TYPE_NONE, 1, G_TYPE_UINT);
+    gsupplicant_network_signals[SIGNAL_PROPERTIES_KEY_CHANGED] =
+        g_signal_new(SIGNAL_PROPERTIES_KEY_CHANGED_NAME,
+            G_OBJECT_CLASS_TYPE(klass), G_SIGNAL_RUN_FIRST |
+            G_SIGNAL_DETAILED, 0, NULL, NULL, NULL,
+            G_TYPE_NONE, 1, G_TYPE_STRING);
 }
 
 /*
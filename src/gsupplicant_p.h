@@ -52,6 +52,27 @@ gsupplicant_parse_keymgmt_list(
     GVariant* value) /* G_VARIANT_TYPE_STRING_ARRAY */
     GSUPPLICANT_INTERNAL;
 
+GSUPPLICANT_KEYMGMT
+gsupplicant_parse_keymgmt_names(
+    const char* names) /* Space separated, as in network config */
+    GSUPPLICANT_INTERNAL;
+
+GSUPPLICANT_EAP_METHOD
+gsupplicant_parse_eap_method_names(
+    const char* names) /* Space separated, as in network config */
+    GSUPPLICANT_INTERNAL;
+
+gboolean
+gsupplicant_resync_enabled(
+    GSupplicant* supplicant)
+    GSUPPLICANT_INTERNAL;
+
+/* NULL unless scans are coordinated */
+struct gsupplicant_scan_coordinator*
+gsupplicant_scan_coordinator(
+    GSupplicant* supplicant)
+    GSUPPLICANT_INTERNAL;
+
 #endif /* GSUPPLICANT_PRIVATE_H */
 
 /*
@@ -0,0 +1,468 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define GLIB_DISABLE_DEPRECATION_WARNINGS /* G_ADD_PRIVATE */
+
+#include "gsupplicant_roam_profile.h"
+#include "gsupplicant_interface_p.h"
+#include "gsupplicant_bss.h"
+#include "gsupplicant_log.h"
+
+/* Object definition */
+#define ROAM_MAX_GAP_SEC    (10) /* Longer than that is a reconnect */
+
+#define ROAM_FT_KEYMGMT (\
+    GSUPPLICANT_KEYMGMT_WPA_FT_PSK | \
+    GSUPPLICANT_KEYMGMT_WPA_FT_EAP | \
+    GSUPPLICANT_KEYMGMT_FT_SAE | \
+    GSUPPLICANT_KEYMGMT_FT_SAE_EXT_KEY)
+
+/* Interface-wide settings, restored when no longer requested */
+#define ROAM_IFACE_FEATURES (\
+    GSUPPLICANT_ROAM_OKC | \
+    GSUPPLICANT_ROAM_FAST_REAUTH | \
+    GSUPPLICANT_ROAM_PMF | \
+    GSUPPLICANT_ROAM_BGSCAN)
+
+#define ROAM_EAP_KEYMGMT (\
+    GSUPPLICANT_KEYMGMT_WPA_EAP | \
+    GSUPPLICANT_KEYMGMT_WPA_FT_EAP | \
+    GSUPPLICANT_KEYMGMT_WPA_EAP_SHA256 | \
+    GSUPPLICANT_KEYMGMT_IEEE8021X)
+
+enum gsupplicant_roam_profile_iface_handler_id {
+    INTERFACE_VALID_CHANGED,
+    INTERFACE_STATE_CHANGED,
+    INTERFACE_CURRENT_BSS_CHANGED,
+    INTERFACE_HANDLER_COUNT
+};
+
+struct gsupplicant_roam_profile_priv {
+    gulong iface_handler_id[INTERFACE_HANDLER_COUNT];
+    GSUPPLICANT_ROAM_FEATURE features;
+    GSUPPLICANT_ROAM_FEATURE saved;     /* Valid fields of the config */
+    GSupplicantRoamConfig config;       /* Values before we touched them */
+    char* bgscan;
+    char* bss;              /* The last BSS we were associated with */
+    gint64 lost;            /* When the association was lost */
+    GSupplicantRoamStats stats;
+};
+
+typedef GObjectClass GSupplicantRoamProfileClass;
+G_DEFINE_TYPE(GSupplicantRoamProfile, gsupplicant_roam_profile, G_TYPE_OBJECT)
+#define GSUPPLICANT_ROAM_PROFILE_TYPE (gsupplicant_roam_profile_get_type())
+#define GSUPPLICANT_ROAM_PROFILE(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), \
+        GSUPPLICANT_ROAM_PROFILE_TYPE, GSupplicantRoamProfile))
+#define SUPER_CLASS gsupplicant_roam_profile_parent_class
+
+enum gsupplicant_roam_profile_signal {
+    SIGNAL_ROAM,
+    SIGNAL_COUNT
+};
+
+#define SIGNAL_ROAM_NAME "roam"
+
+static guint gsupplicant_roam_profile_signals[SIGNAL_COUNT];
+
+/*==========================================================================*
+ * Implementation
+ *==========================================================================*/
+
+static
+void
+gsupplicant_roam_profile_forget(
+    GSupplicantRoamProfile* self)
+{
+    GSupplicantRoamProfilePriv* priv = self->priv;
+
+    g_free(priv->bss);
+    priv->bss = NULL;
+    priv->lost = 0;
+}
+
+static
+void
+gsupplicant_roam_profile_roamed(
+    GSupplicantRoamProfile* self,
+    const char* bss,
+    gint64 gap)
+{
+    GSupplicantRoamProfilePriv* priv = self->priv;
+    GSupplicantRoamStats* stats = &priv->stats;
+    GSupplicantRoamEvent event;
+
+    GDEBUG("[%s] Roamed %s => %s in %d ms", self->iface->path, priv->bss,
+        bss, (int)(gap / 1000));
+    stats->roams++;
+    stats->last_gap = gap;
+    stats->total_gap += gap;
+    if (stats->max_gap < gap) {
+        stats->max_gap = gap;
+    }
+    event.from = priv->bss;
+    event.to = bss;
+    event.gap = gap;
+    g_signal_emit(self, gsupplicant_roam_profile_signals[SIGNAL_ROAM], 0,
+        &event);
+}
+
+static
+void
+gsupplicant_roam_profile_update(
+    GSupplicantRoamProfile* self)
+{
+    GSupplicantRoamProfilePriv* priv = self->priv;
+    GSupplicantInterface* iface = self->iface;
+    const char* bss = iface->current_bss;
+
+    if (!iface->valid) {
+        gsupplicant_roam_profile_forget(self);
+    } else if (iface->state == GSUPPLICANT_INTERFACE_STATE_COMPLETED &&
+        bss) {
+        if (priv->bss && strcmp(priv->bss, bss)) {
+            /* CurrentBSS may change without leaving the completed state */
+            const gint64 gap = priv->lost ?
+                (g_get_monotonic_time() - priv->lost) : 0;
+
+            if (gap <= ROAM_MAX_GAP_SEC * G_TIME_SPAN_SECOND) {
+                gsupplicant_roam_profile_roamed(self, bss, gap);
+            }
+        }
+        if (g_strcmp0(priv->bss, bss)) {
+            g_free(priv->bss);
+            priv->bss = g_strdup(bss);
+        }
+        priv->lost = 0;
+    } else if (priv->bss && !priv->lost) {
+        priv->lost = g_get_monotonic_time();
+    }
+}
+
+static
+void
+gsupplicant_roam_profile_interface_changed(
+    GSupplicantInterface* iface,
+    void* data)
+{
+    gsupplicant_roam_profile_update(GSUPPLICANT_ROAM_PROFILE(data));
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+GSupplicantRoamProfile*
+gsupplicant_roam_profile_new(
+    GSupplicantInterface* iface) /* Since 1.0.31 */
+{
+    if (G_LIKELY(iface)) {
+        GSupplicantRoamProfile* self = g_object_new
+            (GSUPPLICANT_ROAM_PROFILE_TYPE, NULL);
+        GSupplicantRoamProfilePriv* priv = self->priv;
+
+        self->iface = gsupplicant_interface_ref(iface);
+        priv->iface_handler_id[INTERFACE_VALID_CHANGED] =
+            gsupplicant_interface_add_handler(iface,
+                GSUPPLICANT_INTERFACE_PROPERTY_VALID,
+                gsupplicant_roam_profile_interface_changed, self);
+        priv->iface_handler_id[INTERFACE_STATE_CHANGED] =
+            gsupplicant_interface_add_handler(iface,
+                GSUPPLICANT_INTERFACE_PROPERTY_STATE,
+                gsupplicant_roam_profile_interface_changed, self);
+        priv->iface_handler_id[INTERFACE_CURRENT_BSS_CHANGED] =
+            gsupplicant_interface_add_handler(iface,
+                GSUPPLICANT_INTERFACE_PROPERTY_CURRENT_BSS,
+                gsupplicant_roam_profile_interface_changed, self);
+        gsupplicant_roam_profile_update(self);
+        return self;
+    }
+    return NULL;
+}
+
+GSupplicantRoamProfile*
+gsupplicant_roam_profile_ref(
+    GSupplicantRoamProfile* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        g_object_ref(GSUPPLICANT_ROAM_PROFILE(self));
+        return self;
+    } else {
+        return NULL;
+    }
+}
+
+void
+gsupplicant_roam_profile_unref(
+    GSupplicantRoamProfile* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        g_object_unref(GSUPPLICANT_ROAM_PROFILE(self));
+    }
+}
+
+GSUPPLICANT_ROAM_FEATURE
+gsupplicant_roam_profile_check(
+    GSupplicantRoamProfile* self,
+    const GSupplicantRoamProfileConfig* config,
+    GSupplicantBSS* target) /* Since 1.0.31 */
+{
+    GSUPPLICANT_ROAM_FEATURE missing = GSUPPLICANT_ROAM_NONE;
+
+    if (G_LIKELY(self) && G_LIKELY(config)) {
+        const GSupplicantInterface* iface = self->iface;
+        const GSUPPLICANT_ROAM_FEATURE want = config->features;
+        const GSupplicantBSSRSN* rsn = target ? target->rsn : NULL;
+        const GSupplicantBSSWPA* wpa = target ? target->wpa : NULL;
+        GSUPPLICANT_KEYMGMT keymgmt = iface->caps.keymgmt;
+
+        /* The target BSS has the final say */
+        if (target) {
+            keymgmt &= (rsn ? rsn->keymgmt : 0) | (wpa ? wpa->keymgmt : 0);
+        }
+        if (!iface->valid) {
+            missing = want;
+        } else {
+            if ((want & GSUPPLICANT_ROAM_FT) &&
+                !(keymgmt & ROAM_FT_KEYMGMT)) {
+                missing |= GSUPPLICANT_ROAM_FT;
+            }
+            /* These two are EAP only */
+            if (!(keymgmt & ROAM_EAP_KEYMGMT)) {
+                missing |= want & (GSUPPLICANT_ROAM_OKC |
+                    GSUPPLICANT_ROAM_FAST_REAUTH);
+            }
+            if ((want & GSUPPLICANT_ROAM_PMF) &&
+                config->pmf != GSUPPLICANT_MFP_NONE &&
+                (!iface->caps.group_mgmt || (target &&
+                config->pmf == GSUPPLICANT_MFP_REQUIRED &&
+                !(rsn && rsn->mgmt_group)))) {
+                missing |= GSUPPLICANT_ROAM_PMF;
+            }
+            if ((want & GSUPPLICANT_ROAM_BGSCAN) && !config->bgscan) {
+                missing |= GSUPPLICANT_ROAM_BGSCAN;
+            }
+        }
+    }
+    return missing;
+}
+
+gboolean
+gsupplicant_roam_profile_apply(
+    GSupplicantRoamProfile* self,
+    const GSupplicantRoamProfileConfig* config) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(config) && self->iface->valid) {
+        GSupplicantRoamProfilePriv* priv = self->priv;
+        GSupplicantInterface* iface = self->iface;
+        GSupplicantRoamConfig* saved = &priv->config;
+        const GSUPPLICANT_ROAM_FEATURE want = config->features;
+        const GSUPPLICANT_ROAM_FEATURE restore = priv->saved & ~want;
+
+        /* Save the current values before changing them for the first time */
+        if ((want & ROAM_IFACE_FEATURES) & ~priv->saved) {
+            GSupplicantRoamConfig current;
+
+            gsupplicant_interface_get_roam_config(iface, &current);
+            if (!(priv->saved & GSUPPLICANT_ROAM_BGSCAN)) {
+                g_free(saved->bgscan);
+                saved->bgscan = current.bgscan;
+                current.bgscan = NULL;
+            }
+            if (!(priv->saved & GSUPPLICANT_ROAM_OKC)) {
+                saved->okc = current.okc;
+            }
+            if (!(priv->saved & GSUPPLICANT_ROAM_FAST_REAUTH)) {
+                saved->fast_reauth = current.fast_reauth;
+            }
+            if (!(priv->saved & GSUPPLICANT_ROAM_PMF)) {
+                saved->pmf = current.pmf;
+            }
+            g_free(current.bgscan);
+            priv->saved |= want & ROAM_IFACE_FEATURES;
+        }
+
+        /* Features which are not requested are left alone... */
+        if (want & GSUPPLICANT_ROAM_OKC) {
+            gsupplicant_interface_set_okc(iface, TRUE);
+        }
+        if (want & GSUPPLICANT_ROAM_FAST_REAUTH) {
+            gsupplicant_interface_set_fast_reauth(iface, TRUE);
+        }
+        if (want & GSUPPLICANT_ROAM_PMF) {
+            gsupplicant_interface_set_pmf(iface, config->pmf);
+        }
+        if (want & GSUPPLICANT_ROAM_BGSCAN) {
+            gsupplicant_interface_set_bgscan(iface, config->bgscan);
+        }
+
+        /* ...unless we have changed them before */
+        if (restore & GSUPPLICANT_ROAM_OKC) {
+            gsupplicant_interface_set_okc(iface, saved->okc);
+        }
+        if (restore & GSUPPLICANT_ROAM_FAST_REAUTH) {
+            gsupplicant_interface_set_fast_reauth(iface, saved->fast_reauth);
+        }
+        if (restore & GSUPPLICANT_ROAM_PMF) {
+            gsupplicant_interface_set_pmf(iface, saved->pmf);
+        }
+        if (restore & GSUPPLICANT_ROAM_BGSCAN) {
+            gsupplicant_interface_set_bgscan(iface, saved->bgscan);
+            g_free(saved->bgscan);
+            saved->bgscan = NULL;
+        }
+        priv->saved &= ~restore;
+        priv->features = want;
+        g_free(priv->bgscan);
+        priv->bgscan = g_strdup(config->bgscan);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+void
+gsupplicant_roam_profile_network_params(
+    GSupplicantRoamProfile* self,
+    GSupplicantNetworkParams* params) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(params)) {
+        GSupplicantRoamProfilePriv* priv = self->priv;
+
+        if (priv->features & GSUPPLICANT_ROAM_FT) {
+            switch (params->security) {
+            case GSUPPLICANT_SECURITY_PSK:
+            case GSUPPLICANT_SECURITY_PSK_SAE:
+            case GSUPPLICANT_SECURITY_SAE:
+                params->flags |= GSUPPLICANT_NETWORK_PARAM_FT;
+                params->keymgmt |= GSUPPLICANT_KEYMGMT_WPA_FT_PSK |
+                    GSUPPLICANT_KEYMGMT_FT_SAE;
+                break;
+            case GSUPPLICANT_SECURITY_EAP:
+                params->flags |= GSUPPLICANT_NETWORK_PARAM_FT;
+                params->keymgmt |= GSUPPLICANT_KEYMGMT_WPA_FT_EAP;
+                break;
+            default:
+                break;
+            }
+        }
+        /* The string remains owned by the profile */
+        if ((priv->features & GSUPPLICANT_ROAM_BGSCAN) && !params->bgscan) {
+            params->bgscan = priv->bgscan;
+        }
+    }
+}
+
+const GSupplicantRoamStats*
+gsupplicant_roam_profile_get_stats(
+    GSupplicantRoamProfile* self) /* Since 1.0.31 */
+{
+    return G_LIKELY(self) ? &self->priv->stats : NULL;
+}
+
+gulong
+gsupplicant_roam_profile_add_roam_handler(
+    GSupplicantRoamProfile* self,
+    GSupplicantRoamProfileEventFunc fn,
+    void* data) /* Since 1.0.31 */
+{
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+        SIGNAL_ROAM_NAME, G_CALLBACK(fn), data) : 0;
+}
+
+void
+gsupplicant_roam_profile_remove_handler(
+    GSupplicantRoamProfile* self,
+    gulong id) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(id)) {
+        g_signal_handler_disconnect(self, id);
+    }
+}
+
+/*==========================================================================*
+ * Internals
+ *==========================================================================*/
+
+/**
+ * Per instance initializer
+ */
+static
+void
+gsupplicant_roam_profile_init(
+    GSupplicantRoamProfile* self)
+{
+    self->priv = G_TYPE_INSTANCE_GET_PRIVATE(self,
+        GSUPPLICANT_ROAM_PROFILE_TYPE, GSupplicantRoamProfilePriv);
+}
+
+/**
+ * Final stage of deinitialization
+ */
+static
+void
+gsupplicant_roam_profile_finalize(
+    GObject* object)
+{
+    GSupplicantRoamProfile* self = GSUPPLICANT_ROAM_PROFILE(object);
+    GSupplicantRoamProfilePriv* priv = self->priv;
+    gsupplicant_interface_remove_all_handlers(self->iface,
+        priv->iface_handler_id);
+    gsupplicant_interface_unref(self->iface);
+    g_free(priv->config.bgscan);
+    g_free(priv->bgscan);
+    g_free(priv->bss);
+    G_OBJECT_CLASS(SUPER_CLASS)->finalize(object);
+}
+
+/**
+ * Per class initializer
+ */
+static
+void
+gsupplicant_roam_profile_class_init(
+    GSupplicantRoamProfileClass* klass)
+{
+    G_OBJECT_CLASS(klass)->finalize = gsupplicant_roam_profile_finalize;
+    G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    g_type_class_add_private(klass, sizeof(GSupplicantRoamProfilePriv));
+    G_GNUC_END_IGNORE_DEPRECATIONS
+    gsupplicant_roam_profile_signals[SIGNAL_ROAM] =
+        g_signal_new(SIGNAL_ROAM_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
+            1, G_TYPE_POINTER);
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
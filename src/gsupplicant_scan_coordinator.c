@@ -0,0 +1,535 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gsupplicant_scan_coordinator_p.h"
+#include "gsupplicant_interface_p.h"
+#include "gsupplicant_error.h"
+#include "gsupplicant_log.h"
+
+#include <gutil_macros.h>
+
+/* If the interface never reports the end of the scan */
+#define SCAN_COORDINATOR_MAX_RUN_SEC    (30)
+#define SCAN_COORDINATOR_MAX_BACKOFF    (6)
+
+enum scan_request_iface_handler_id {
+    REQUEST_VALID_CHANGED,
+    REQUEST_SCANNING_CHANGED,
+    REQUEST_HANDLER_COUNT
+};
+
+typedef enum scan_request_state {
+    SCAN_REQUEST_QUEUED,
+    SCAN_REQUEST_CALLING,   /* Scan call is pending */
+    SCAN_REQUEST_RUNNING    /* Waiting for the scan to finish */
+} SCAN_REQUEST_STATE;
+
+typedef struct gsupplicant_scan_request GSupplicantScanRequest;
+
+typedef struct gsupplicant_scan_waiter {
+    GSupplicantScanRequest* req;
+    GCancellable* cancel;
+    gulong cancel_id;
+    GSupplicantInterfaceResultFunc fn;
+    GDestroyNotify destroy;
+    void* data;
+} GSupplicantScanWaiter;
+
+struct gsupplicant_scan_request {
+    GSupplicantScanCoordinator* coord;
+    GSupplicantInterface* iface;
+    gulong iface_handler_id[REQUEST_HANDLER_COUNT];
+    GVariant* args;
+    GSList* waiters;
+    GSource* timeout;
+    SCAN_REQUEST_STATE state;
+    gboolean scanning;      /* Interface has been seen scanning */
+    gboolean done;          /* Scan call has completed */
+    guint retries;
+    gint64 queued;
+    gint64 started;
+    gint64 not_before;
+};
+
+struct gsupplicant_scan_coordinator {
+    GMainContext* context;
+    GSupplicantScanPolicy policy;
+    GQueue queue;           /* Waiting requests */
+    GHashTable* active;     /* GSupplicantInterface* => request */
+    GSource* timer;
+    gint64 last_start;
+};
+
+static
+void
+gsupplicant_scan_coordinator_schedule(
+    GSupplicantScanCoordinator* self);
+
+/*==========================================================================*
+ * Requests
+ *==========================================================================*/
+
+static
+void
+gsupplicant_scan_waiter_free(
+    GSupplicantScanWaiter* waiter)
+{
+    if (waiter->cancel_id) {
+        g_signal_handler_disconnect(waiter->cancel, waiter->cancel_id);
+    }
+    g_object_unref(waiter->cancel);
+    if (waiter->destroy) {
+        waiter->destroy(waiter->data);
+    }
+    g_slice_free(GSupplicantScanWaiter, waiter);
+}
+
+static
+void
+gsupplicant_scan_request_free(
+    GSupplicantScanRequest* req)
+{
+    gsupplicant_interface_remove_all_handlers(req->iface,
+        req->iface_handler_id);
+    if (req->timeout) {
+        g_source_destroy(req->timeout);
+        g_source_unref(req->timeout);
+    }
+    g_slist_free_full(req->waiters, (GDestroyNotify)
+        gsupplicant_scan_waiter_free);
+    g_variant_unref(req->args);
+    gsupplicant_interface_unref(req->iface);
+    g_slice_free(GSupplicantScanRequest, req);
+}
+
+/* Invokes and frees all the waiters */
+static
+void
+gsupplicant_scan_request_notify(
+    GSupplicantScanRequest* req,
+    const GError* error)
+{
+    GSList* waiters = req->waiters;
+    GSList* l;
+
+    req->waiters = NULL;
+    for (l = waiters; l; l = l->next) {
+        GSupplicantScanWaiter* waiter = l->data;
+        if (waiter->fn && !g_cancellable_is_cancelled(waiter->cancel)) {
+            /* In case if callback calls g_cancellable_cancel() */
+            g_signal_handler_disconnect(waiter->cancel, waiter->cancel_id);
+            waiter->cancel_id = 0;
+            waiter->fn(req->iface, waiter->cancel, error, waiter->data);
+        }
+        gsupplicant_scan_waiter_free(waiter);
+    }
+    g_slist_free(waiters);
+}
+
+/* Releases the slot occupied by the request */
+static
+void
+gsupplicant_scan_request_finish(
+    GSupplicantScanRequest* req)
+{
+    GSupplicantScanCoordinator* self = req->coord;
+    const gint64 run = g_get_monotonic_time() - req->started;
+
+    GDEBUG("[%s] Scan took %d ms", req->iface->path, (int)(run / 1000));
+    gsupplicant_interface_scan_finished(req->iface, req->started -
+        req->queued, run, req->retries);
+    g_hash_table_remove(self->active, req->iface);
+    gsupplicant_scan_request_free(req);
+    gsupplicant_scan_coordinator_schedule(self);
+}
+
+static
+gboolean
+gsupplicant_scan_request_timeout(
+    gpointer data)
+{
+    GSupplicantScanRequest* req = data;
+
+    GWARN("[%s] Scan didn't finish in %d sec", req->iface->path,
+        SCAN_COORDINATOR_MAX_RUN_SEC);
+    g_source_unref(req->timeout);
+    req->timeout = NULL;
+    gsupplicant_scan_request_finish(req);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+gsupplicant_scan_request_call_done(
+    GObject* proxy,
+    GAsyncResult* result,
+    gpointer data)
+{
+    GSupplicantScanRequest* req = data;
+    GSupplicantScanCoordinator* self = req->coord;
+    GError* error = NULL;
+    GVariant* ret = g_dbus_proxy_call_finish(G_DBUS_PROXY(proxy), result,
+        &error);
+
+    GASSERT(req->state == SCAN_REQUEST_CALLING);
+    if (ret) {
+        g_variant_unref(ret);
+        gsupplicant_interface_scan_started(req->iface);
+        req->state = SCAN_REQUEST_RUNNING;
+        req->done = TRUE;
+        req->timeout = g_timeout_source_new_seconds
+            (SCAN_COORDINATOR_MAX_RUN_SEC);
+        g_source_set_callback(req->timeout, gsupplicant_scan_request_timeout,
+            req, NULL);
+        g_source_attach(req->timeout, self->context);
+        gsupplicant_scan_request_notify(req, NULL);
+        if (req->scanning && !req->iface->scanning) {
+            /* Already finished */
+            gsupplicant_scan_request_finish(req);
+        }
+    } else if (gsupplicant_is_error(error, GSUPPLICANT_ERROR_SCAN_ERROR) &&
+        req->retries < self->policy.retry_count && req->waiters) {
+        const guint shift = MIN(req->retries, SCAN_COORDINATOR_MAX_BACKOFF);
+        const gint64 delay = (gint64)self->policy.retry_delay_ms *
+            (1 << shift) * 1000;
+
+        GDEBUG("[%s] Scan rejected, retrying in %d ms", req->iface->path,
+            (int)(delay / 1000));
+        req->retries++;
+        req->state = SCAN_REQUEST_QUEUED;
+        req->scanning = FALSE;
+        req->not_before = g_get_monotonic_time() + delay;
+        g_hash_table_remove(self->active, req->iface);
+        g_queue_push_head(&self->queue, req);
+        gsupplicant_scan_coordinator_schedule(self);
+    } else {
+        GDEBUG("[%s] Scan failed: %s", req->iface->path, GERRMSG(error));
+        gsupplicant_scan_request_notify(req, error);
+        g_hash_table_remove(self->active, req->iface);
+        gsupplicant_scan_request_free(req);
+        gsupplicant_scan_coordinator_schedule(self);
+    }
+    if (error) {
+        g_error_free(error);
+    }
+}
+
+static
+void
+gsupplicant_scan_request_scanning_changed(
+    GSupplicantInterface* iface,
+    void* data)
+{
+    GSupplicantScanRequest* req = data;
+
+    if (req->state != SCAN_REQUEST_QUEUED) {
+        if (iface->scanning) {
+            req->scanning = TRUE;
+        } else if (req->scanning && req->done) {
+            gsupplicant_scan_request_finish(req);
+        }
+    }
+}
+
+static
+void
+gsupplicant_scan_request_valid_changed(
+    GSupplicantInterface* iface,
+    void* data)
+{
+    GSupplicantScanRequest* req = data;
+
+    if (!iface->valid) {
+        if (req->state == SCAN_REQUEST_RUNNING) {
+            gsupplicant_scan_request_finish(req);
+        } else if (req->state == SCAN_REQUEST_QUEUED) {
+            GSupplicantScanCoordinator* self = req->coord;
+            GError* error = g_error_new_literal(GSUPPLICANT_ERROR,
+                GSUPPLICANT_ERROR_INTERFACE_UNKNOWN, "Interface is gone");
+
+            g_queue_remove(&self->queue, req);
+            gsupplicant_scan_request_notify(req, error);
+            gsupplicant_scan_request_free(req);
+            g_error_free(error);
+        }
+        /* Otherwise the pending call will fail */
+    }
+}
+
+static
+void
+gsupplicant_scan_waiter_cancelled(
+    GCancellable* cancel,
+    gpointer data)
+{
+    GSupplicantScanWaiter* waiter = data;
+    GSupplicantScanRequest* req = waiter->req;
+
+    req->waiters = g_slist_remove(req->waiters, waiter);
+    gsupplicant_scan_waiter_free(waiter);
+    if (!req->waiters && req->state == SCAN_REQUEST_QUEUED) {
+        /* Nobody is interested anymore */
+        g_queue_remove(&req->coord->queue, req);
+        gsupplicant_scan_request_free(req);
+    }
+}
+
+static
+GCancellable*
+gsupplicant_scan_request_add_waiter(
+    GSupplicantScanRequest* req,
+    GCancellable* cancel,
+    GSupplicantInterfaceResultFunc fn,
+    GDestroyNotify destroy,
+    void* data)
+{
+    GSupplicantScanWaiter* waiter = g_slice_new0(GSupplicantScanWaiter);
+
+    waiter->req = req;
+    waiter->cancel = cancel ? g_object_ref(cancel) : g_cancellable_new();
+    waiter->cancel_id = g_signal_connect(waiter->cancel, "cancelled",
+        G_CALLBACK(gsupplicant_scan_waiter_cancelled), waiter);
+    waiter->fn = fn;
+    waiter->destroy = destroy;
+    waiter->data = data;
+    req->waiters = g_slist_append(req->waiters, waiter);
+    return waiter->cancel;
+}
+
+static
+GSupplicantScanRequest*
+gsupplicant_scan_request_new(
+    GSupplicantScanCoordinator* coord,
+    GSupplicantInterface* iface,
+    GVariant* args)
+{
+    GSupplicantScanRequest* req = g_slice_new0(GSupplicantScanRequest);
+
+    req->coord = coord;
+    req->iface = gsupplicant_interface_ref(iface);
+    req->args = g_variant_ref_sink(args);
+    req->queued = g_get_monotonic_time();
+    req->iface_handler_id[REQUEST_VALID_CHANGED] =
+        gsupplicant_interface_add_handler(iface,
+            GSUPPLICANT_INTERFACE_PROPERTY_VALID,
+            gsupplicant_scan_request_valid_changed, req);
+    req->iface_handler_id[REQUEST_SCANNING_CHANGED] =
+        gsupplicant_interface_add_handler(iface,
+            GSUPPLICANT_INTERFACE_PROPERTY_SCANNING,
+            gsupplicant_scan_request_scanning_changed, req);
+    return req;
+}
+
+static
+void
+gsupplicant_scan_request_start(
+    GSupplicantScanRequest* req)
+{
+    GSupplicantScanCoordinator* self = req->coord;
+    const gint64 now = g_get_monotonic_time();
+
+    GDEBUG("[%s] Starting scan after %d ms", req->iface->path,
+        (int)((now - req->queued) / 1000));
+    self->last_start = req->started = now;
+    req->scanning = FALSE;
+    req->done = FALSE;
+    if (gsupplicant_interface_call_scan(req->iface, req->args,
+        gsupplicant_scan_request_call_done, req)) {
+        req->state = SCAN_REQUEST_CALLING;
+        g_hash_table_insert(self->active, req->iface, req);
+    } else {
+        GError* error = g_error_new_literal(GSUPPLICANT_ERROR,
+            GSUPPLICANT_ERROR_INTERFACE_UNKNOWN, "Interface is not valid");
+
+        gsupplicant_scan_request_notify(req, error);
+        gsupplicant_scan_request_free(req);
+        g_error_free(error);
+    }
+}
+
+/*==========================================================================*
+ * Coordinator
+ *==========================================================================*/
+
+static
+gboolean
+gsupplicant_scan_coordinator_timer(
+    gpointer data)
+{
+    GSupplicantScanCoordinator* self = data;
+
+    g_source_unref(self->timer);
+    self->timer = NULL;
+    gsupplicant_scan_coordinator_schedule(self);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+gsupplicant_scan_coordinator_schedule(
+    GSupplicantScanCoordinator* self)
+{
+    const GSupplicantScanPolicy* policy = &self->policy;
+    const gint64 stagger = (gint64)policy->stagger_ms * 1000;
+    gint64 now = g_get_monotonic_time();
+    gint64 next = G_MAXINT64;
+    GList* l = self->queue.head;
+
+    while (l && (!policy->max_active ||
+        g_hash_table_size(self->active) < policy->max_active)) {
+        GSupplicantScanRequest* req = l->data;
+        gint64 t = req->not_before;
+
+        if (self->last_start && stagger) {
+            t = MAX(t, self->last_start + stagger);
+        }
+        if (g_hash_table_contains(self->active, req->iface)) {
+            /* One scan per interface at a time */
+            l = l->next;
+        } else if (t > now) {
+            next = MIN(next, t);
+            if (t > req->not_before) {
+                /* Staggering affects everyone */
+                break;
+            }
+            l = l->next;
+        } else {
+            g_queue_delete_link(&self->queue, l);
+            gsupplicant_scan_request_start(req);
+            /* Callbacks may have changed the queue, start over */
+            now = g_get_monotonic_time();
+            next = G_MAXINT64;
+            l = self->queue.head;
+        }
+    }
+    if (self->timer) {
+        g_source_destroy(self->timer);
+        g_source_unref(self->timer);
+        self->timer = NULL;
+    }
+    if (next != G_MAXINT64) {
+        self->timer = g_timeout_source_new((guint)((next - now + 999)/1000));
+        g_source_set_callback(self->timer, gsupplicant_scan_coordinator_timer,
+            self, NULL);
+        g_source_attach(self->timer, self->context);
+    }
+}
+
+GSupplicantScanCoordinator*
+gsupplicant_scan_coordinator_new(
+    GMainContext* context)
+{
+    GSupplicantScanCoordinator* self =
+        g_slice_new0(GSupplicantScanCoordinator);
+
+    /* Register the error domain before any ScanError comes in */
+    gsupplicant_error_quark();
+    self->context = g_main_context_ref(context);
+    self->active = g_hash_table_new(g_direct_hash, g_direct_equal);
+    g_queue_init(&self->queue);
+    return self;
+}
+
+void
+gsupplicant_scan_coordinator_free(
+    GSupplicantScanCoordinator* self)
+{
+    if (self) {
+        /* Requests keep GSupplicant alive, nothing can be pending here */
+        GASSERT(g_queue_is_empty(&self->queue));
+        GASSERT(!g_hash_table_size(self->active));
+        if (self->timer) {
+            g_source_destroy(self->timer);
+            g_source_unref(self->timer);
+        }
+        g_hash_table_destroy(self->active);
+        g_main_context_unref(self->context);
+        g_slice_free(GSupplicantScanCoordinator, self);
+    }
+}
+
+void
+gsupplicant_scan_coordinator_set_policy(
+    GSupplicantScanCoordinator* self,
+    const GSupplicantScanPolicy* policy)
+{
+    if (policy) {
+        self->policy = *policy;
+    } else {
+        memset(&self->policy, 0, sizeof(self->policy));
+    }
+    gsupplicant_scan_coordinator_schedule(self);
+}
+
+GCancellable*
+gsupplicant_scan_coordinator_submit(
+    GSupplicantScanCoordinator* self,
+    GSupplicantInterface* iface,
+    GVariant* args,
+    GCancellable* cancel,
+    GSupplicantInterfaceResultFunc fn,
+    GDestroyNotify destroy,
+    void* data)
+{
+    GSupplicantScanRequest* req = NULL;
+    GCancellable* ret;
+
+    if (self->policy.flags & GSUPPLICANT_SCAN_POLICY_MERGE) {
+        GList* l;
+
+        for (l = self->queue.head; l; l = l->next) {
+            GSupplicantScanRequest* queued = l->data;
+            if (queued->iface == iface && g_variant_equal(queued->args,
+                args)) {
+                GDEBUG("[%s] Merging scan requests", iface->path);
+                req = queued;
+                g_variant_unref(g_variant_ref_sink(args));
+                break;
+            }
+        }
+    }
+    if (!req) {
+        req = gsupplicant_scan_request_new(self, iface, args);
+        g_queue_push_tail(&self->queue, req);
+    }
+    ret = gsupplicant_scan_request_add_waiter(req, cancel, fn, destroy,
+        data);
+    gsupplicant_scan_coordinator_schedule(self);
+    return ret;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GSUPPLICANT_SCAN_COORDINATOR_PRIVATE_H
+#define GSUPPLICANT_SCAN_COORDINATOR_PRIVATE_H
+
+#include "gsupplicant_types_p.h"
+
+#include <gsupplicant.h>
+#include <gsupplicant_interface.h>
+
+/*
+ * Queues the scan requests of all interfaces bound to the same context
+ * and starts them according to GSupplicantScanPolicy. Owned by the
+ * GSupplicant object. Requests hold references to their interfaces and
+ * therefore to the GSupplicant, so the coordinator can't be freed with
+ * requests pending.
+ */
+typedef struct gsupplicant_scan_coordinator GSupplicantScanCoordinator;
+
+GSupplicantScanCoordinator*
+gsupplicant_scan_coordinator_new(
+    GMainContext* context)
+    GSUPPLICANT_INTERNAL;
+
+void
+gsupplicant_scan_coordinator_free(
+    GSupplicantScanCoordinator* coord)
+    GSUPPLICANT_INTERNAL;
+
+/* NULL policy starts everything as soon as possible */
+void
+gsupplicant_scan_coordinator_set_policy(
+    GSupplicantScanCoordinator* coord,
+    const GSupplicantScanPolicy* policy)
+    GSUPPLICANT_INTERNAL;
+
+/* Takes ownership of the floating args reference, if any */
+GCancellable*
+gsupplicant_scan_coordinator_submit(
+    GSupplicantScanCoordinator* coord,
+    GSupplicantInterface* iface,
+    GVariant* args,
+    GCancellable* cancel,
+    GSupplicantInterfaceResultFunc fn,
+    GDestroyNotify destroy,
+    void* data)
+    GSUPPLICANT_INTERNAL;
+
+#endif /* GSUPPLICANT_SCAN_COORDINATOR_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
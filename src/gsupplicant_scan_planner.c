@@ -0,0 +1,903 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define GLIB_DISABLE_DEPRECATION_WARNINGS /* G_ADD_PRIVATE */
+
+#include "gsupplicant_scan_planner.h"
+#include "gsupplicant.h"
+#include "gsupplicant_bss.h"
+#include "gsupplicant_catalog.h"
+#include "gsupplicant_error.h"
+#include "gsupplicant_log.h"
+
+#include <stdlib.h>
+
+/* Object definition */
+#define SCAN_PLANNER_HISTORY_SIZE   (8)  /* Channels per SSID */
+#define SCAN_PLANNER_CHANNEL_WIDTH  (20) /* MHz */
+#define SCAN_PLANNER_SETTLE_MS      (200)
+
+enum gsupplicant_scan_planner_iface_handler_id {
+    INTERFACE_VALID_CHANGED,
+    INTERFACE_BSSS_CHANGED,
+    INTERFACE_SCANNING_CHANGED,
+    INTERFACE_HANDLER_COUNT
+};
+
+enum gsupplicant_scan_planner_bss_handler_id {
+    BSS_VALID_CHANGED,
+    BSS_FREQUENCY_CHANGED,
+    BSS_SIGNAL_CHANGED,
+    BSS_HANDLER_COUNT
+};
+
+typedef struct gsupplicant_scan_planner_bss {
+    GSupplicantBSS* bss;
+    GSupplicantScanPlanner* planner;
+    gulong handler_id[BSS_HANDLER_COUNT];
+    guint generation;
+} GSupplicantScanPlannerBSS;
+
+typedef struct gsupplicant_scan_planner_history {
+    guint freq[SCAN_PLANNER_HISTORY_SIZE];
+    gint64 seen[SCAN_PLANNER_HISTORY_SIZE];  /* Monotonic, microseconds */
+    guint count;
+} GSupplicantScanPlannerHistory;
+
+typedef struct gsupplicant_scan_planner_channel {
+    guint freq;
+    gint64 seen;
+} GSupplicantScanPlannerChannel;
+
+struct gsupplicant_scan_planner_priv {
+    GSupplicantCatalog* catalog;
+    gulong catalog_handler_id;
+    gulong iface_handler_id[INTERFACE_HANDLER_COUNT];
+    guint generation;
+    GHashTable* bsss;       /* Interned path => GSupplicantScanPlannerBSS */
+    GHashTable* history;    /* GBytes => GSupplicantScanPlannerHistory */
+    GSupplicantScanPlannerPolicy policy;
+    GSupplicantScanPlannerStats stats;
+    guint partial_in_row;
+
+    /* The scan in progress */
+    GSupplicantScanPlannerFunc fn;
+    void* fn_data;
+    GCancellable* cancel;   /* Pending Scan call */
+    GSource* settle;        /* Waiting for the results to trickle in */
+    GSource* timeout;       /* The whole pass, including the fallback */
+    gboolean full;
+    gboolean started;       /* Scan call has completed */
+    gboolean scanning;      /* Interface has been seen scanning */
+    guint channels;
+    guint* freqs;           /* Planned channels (partial scan only) */
+    gint64 start_time;
+    gint64 end_time;
+};
+
+typedef GObjectClass GSupplicantScanPlannerClass;
+G_DEFINE_TYPE(GSupplicantScanPlanner, gsupplicant_scan_planner, G_TYPE_OBJECT)
+#define GSUPPLICANT_SCAN_PLANNER_TYPE (gsupplicant_scan_planner_get_type())
+#define GSUPPLICANT_SCAN_PLANNER(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), \
+        GSUPPLICANT_SCAN_PLANNER_TYPE, GSupplicantScanPlanner))
+#define SUPER_CLASS gsupplicant_scan_planner_parent_class
+
+static const GSupplicantScanPlannerPolicy gsupplicant_scan_planner_default =
+{
+    0,                              /* flags */
+    GSUPPLICANT_SCAN_TYPE_PASSIVE,  /* type */
+    0,                              /* max_channels */
+    24 * 60 * 60,                   /* max_age */
+    5,                              /* max_partial */
+    30000                           /* timeout */
+};
+
+static
+void
+gsupplicant_scan_planner_start(
+    GSupplicantScanPlanner* self,
+    gboolean full);
+
+/*==========================================================================*
+ * Implementation
+ *==========================================================================*/
+
+/* Returns TRUE if this SSID belongs to at least one enabled network */
+static
+gboolean
+gsupplicant_scan_planner_saved(
+    GSupplicantScanPlanner* self,
+    GBytes* ssid)
+{
+    const GPtrArray* list = gsupplicant_catalog_find_ssid(self->priv->catalog,
+        ssid);
+    if (list) {
+        guint i;
+        for (i = 0; i < list->len; i++) {
+            const GSupplicantCatalogEntry* entry = list->pdata[i];
+            if (!entry->disabled) {
+                return TRUE;
+            }
+        }
+    }
+    return FALSE;
+}
+
+static
+void
+gsupplicant_scan_planner_history_update(
+    GSupplicantScanPlannerHistory* history,
+    guint freq,
+    gint64 now)
+{
+    guint i, oldest = 0;
+    for (i = 0; i < history->count; i++) {
+        if (history->freq[i] == freq) {
+            history->seen[i] = now;
+            return;
+        } else if (history->seen[i] < history->seen[oldest]) {
+            oldest = i;
+        }
+    }
+    if (history->count < SCAN_PLANNER_HISTORY_SIZE) {
+        i = history->count++;
+    } else {
+        i = oldest;
+    }
+    history->freq[i] = freq;
+    history->seen[i] = now;
+}
+
+/* Returns TRUE if the BSS belongs to a saved network */
+static
+gboolean
+gsupplicant_scan_planner_bss_seen(
+    GSupplicantScanPlannerBSS* item)
+{
+    GSupplicantScanPlanner* self = item->planner;
+    GSupplicantScanPlannerPriv* priv = self->priv;
+    GSupplicantBSS* bss = item->bss;
+    if (bss->valid && bss->present && bss->ssid && bss->frequency &&
+        gsupplicant_scan_planner_saved(self, bss->ssid)) {
+        GSupplicantScanPlannerHistory* history =
+            g_hash_table_lookup(priv->history, bss->ssid);
+        if (!history) {
+            history = g_slice_new0(GSupplicantScanPlannerHistory);
+            g_hash_table_insert(priv->history, g_bytes_ref(bss->ssid),
+                history);
+        }
+        gsupplicant_scan_planner_history_update(history, bss->frequency,
+            g_get_monotonic_time());
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static
+void
+gsupplicant_scan_planner_bss_changed(
+    GSupplicantBSS* bss,
+    void* data)
+{
+    gsupplicant_scan_planner_bss_seen(data);
+}
+
+static
+GSupplicantScanPlannerBSS*
+gsupplicant_scan_planner_bss_new(
+    GSupplicantScanPlanner* self,
+    const char* path)
+{
+    GSupplicantScanPlannerBSS* item = g_slice_new0(GSupplicantScanPlannerBSS);
+    GSupplicantBSS* bss = gsupplicant_bss_new(path);
+    item->bss = bss;
+    item->planner = self;
+    item->handler_id[BSS_VALID_CHANGED] = gsupplicant_bss_add_handler(bss,
+        GSUPPLICANT_BSS_PROPERTY_VALID,
+        gsupplicant_scan_planner_bss_changed, item);
+    item->handler_id[BSS_FREQUENCY_CHANGED] = gsupplicant_bss_add_handler(bss,
+        GSUPPLICANT_BSS_PROPERTY_FREQUENCY,
+        gsupplicant_scan_planner_bss_changed, item);
+    item->handler_id[BSS_SIGNAL_CHANGED] = gsupplicant_bss_add_handler(bss,
+        GSUPPLICANT_BSS_PROPERTY_SIGNAL,
+        gsupplicant_scan_planner_bss_changed, item);
+    gsupplicant_scan_planner_bss_seen(item);
+    return item;
+}
+
+static
+void
+gsupplicant_scan_planner_bss_destroy(
+    gpointer data)
+{
+    GSupplicantScanPlannerBSS* item = data;
+    gsupplicant_bss_remove_all_handlers(item->bss, item->handler_id);
+    gsupplicant_bss_unref(item->bss);
+    g_slice_free(GSupplicantScanPlannerBSS, item);
+}
+
+static
+void
+gsupplicant_scan_planner_history_destroy(
+    gpointer data)
+{
+    g_slice_free(GSupplicantScanPlannerHistory, data);
+}
+
+static
+void
+gsupplicant_scan_planner_sync_bsss(
+    GSupplicantScanPlanner* self)
+{
+    GSupplicantScanPlannerPriv* priv = self->priv;
+    const GStrV* bsss = self->iface->valid ? self->iface->bsss : NULL;
+    const guint gen = ++priv->generation;
+    guint n = 0;
+
+    if (bsss) {
+        const GStrV* ptr;
+        for (ptr = bsss; *ptr; ptr++) {
+            const char* path = *ptr; /* Interned */
+            GSupplicantScanPlannerBSS* item =
+                g_hash_table_lookup(priv->bsss, path);
+            if (!item) {
+                item = gsupplicant_scan_planner_bss_new(self, path);
+                g_hash_table_insert(priv->bsss, (gpointer)item->bss->path,
+                    item);
+            }
+            item->generation = gen;
+            n++;
+        }
+    }
+    if (g_hash_table_size(priv->bsss) > n) {
+        GHashTableIter it;
+        gpointer value;
+        g_hash_table_iter_init(&it, priv->bsss);
+        while (g_hash_table_iter_next(&it, NULL, &value)) {
+            GSupplicantScanPlannerBSS* item = value;
+            if (item->generation != gen) {
+                g_hash_table_iter_remove(&it);
+            }
+        }
+    }
+}
+
+static
+int
+gsupplicant_scan_planner_channel_compare(
+    const void* a,
+    const void* b)
+{
+    const GSupplicantScanPlannerChannel* c1 = a;
+    const GSupplicantScanPlannerChannel* c2 = b;
+    /* Most recently seen first */
+    return (c1->seen < c2->seen) ? 1 : (c1->seen > c2->seen) ? -1 : 0;
+}
+
+/*
+ * Collects the channels on which the saved networks have been recently
+ * seen, most recent first. Forgets the old ones and the SSIDs which are
+ * no longer saved.
+ */
+static
+GArray*
+gsupplicant_scan_planner_plan(
+    GSupplicantScanPlanner* self)
+{
+    GSupplicantScanPlannerPriv* priv = self->priv;
+    const GSupplicantScanPlannerPolicy* policy = &priv->policy;
+    const gint64 min_seen = policy->max_age ? (g_get_monotonic_time() -
+        (gint64)policy->max_age * G_TIME_SPAN_SECOND) : G_MININT64;
+    GArray* channels = g_array_new(FALSE, FALSE,
+        sizeof(GSupplicantScanPlannerChannel));
+    GHashTableIter it;
+    gpointer key, value;
+
+    g_hash_table_iter_init(&it, priv->history);
+    while (g_hash_table_iter_next(&it, &key, &value)) {
+        GSupplicantScanPlannerHistory* history = value;
+        guint i = 0;
+
+        while (i < history->count) {
+            if (history->seen[i] < min_seen) {
+                /* Too old, replace it with the last one */
+                history->count--;
+                history->freq[i] = history->freq[history->count];
+                history->seen[i] = history->seen[history->count];
+            } else {
+                i++;
+            }
+        }
+        if (!history->count || !gsupplicant_scan_planner_saved(self, key)) {
+            g_hash_table_iter_remove(&it);
+            continue;
+        }
+        for (i = 0; i < history->count; i++) {
+            GSupplicantScanPlannerChannel* ch =
+                (GSupplicantScanPlannerChannel*)channels->data;
+            guint k;
+
+            for (k = 0; k < channels->len && ch[k].freq != history->freq[i];
+                k++);
+            if (k < channels->len) {
+                ch[k].seen = MAX(ch[k].seen, history->seen[i]);
+            } else {
+                GSupplicantScanPlannerChannel add;
+                add.freq = history->freq[i];
+                add.seen = history->seen[i];
+                g_array_append_val(channels, add);
+            }
+        }
+    }
+    if (channels->len > 1) {
+        qsort(channels->data, channels->len,
+            sizeof(GSupplicantScanPlannerChannel),
+            gsupplicant_scan_planner_channel_compare);
+    }
+    if (policy->max_channels && channels->len > policy->max_channels) {
+        g_array_set_size(channels, policy->max_channels);
+    }
+    return channels;
+}
+
+static
+gboolean
+gsupplicant_scan_planner_planned(
+    GSupplicantScanPlanner* self,
+    guint freq)
+{
+    GSupplicantScanPlannerPriv* priv = self->priv;
+    guint i;
+    for (i = 0; i < priv->channels; i++) {
+        if (priv->freqs[i] == freq) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/*
+ * Counts the saved networks in the scan results, i.e. the BSSs which
+ * the scan has reported (seen since it started) on the planned channels.
+ */
+static
+guint
+gsupplicant_scan_planner_count_hits(
+    GSupplicantScanPlanner* self)
+{
+    GSupplicantScanPlannerPriv* priv = self->priv;
+    GHashTableIter it;
+    gpointer value;
+    guint hits = 0;
+
+    g_hash_table_iter_init(&it, priv->bsss);
+    while (g_hash_table_iter_next(&it, NULL, &value)) {
+        GSupplicantScanPlannerBSS* item = value;
+        GSupplicantBSS* bss = item->bss;
+        if (bss->valid && bss->present && bss->ssid &&
+            bss->last_seen >= priv->start_time &&
+            gsupplicant_scan_planner_planned(self, bss->frequency) &&
+            gsupplicant_scan_planner_saved(self, bss->ssid)) {
+            hits++;
+        }
+    }
+    return hits;
+}
+
+static
+void
+gsupplicant_scan_planner_clear_scan(
+    GSupplicantScanPlanner* self)
+{
+    GSupplicantScanPlannerPriv* priv = self->priv;
+    if (priv->cancel) {
+        g_cancellable_cancel(priv->cancel);
+        g_object_unref(priv->cancel);
+        priv->cancel = NULL;
+    }
+    if (priv->settle) {
+        g_source_destroy(priv->settle);
+        g_source_unref(priv->settle);
+        priv->settle = NULL;
+    }
+    if (priv->timeout) {
+        g_source_destroy(priv->timeout);
+        g_source_unref(priv->timeout);
+        priv->timeout = NULL;
+    }
+}
+
+static
+void
+gsupplicant_scan_planner_complete(
+    GSupplicantScanPlanner* self,
+    const GError* error)
+{
+    GSupplicantScanPlannerPriv* priv = self->priv;
+    GSupplicantScanPlannerFunc fn = priv->fn;
+    void* fn_data = priv->fn_data;
+
+    gsupplicant_scan_planner_clear_scan(self);
+    priv->fn = NULL;
+    priv->fn_data = NULL;
+    self->busy = FALSE;
+    if (fn) {
+        gsupplicant_scan_planner_ref(self);
+        fn(self, error, priv->full, fn_data);
+        gsupplicant_scan_planner_unref(self);
+    }
+}
+
+static
+void
+gsupplicant_scan_planner_fail(
+    GSupplicantScanPlanner* self,
+    GSUPPLICANT_ERROR_CODE code,
+    const char* message)
+{
+    GError* error = g_error_new_literal(GSUPPLICANT_ERROR, code, message);
+    gsupplicant_scan_planner_complete(self, error);
+    g_error_free(error);
+}
+
+static
+gboolean
+gsupplicant_scan_planner_timeout(
+    gpointer data)
+{
+    GSupplicantScanPlanner* self = GSUPPLICANT_SCAN_PLANNER(data);
+    GSupplicantScanPlannerPriv* priv = self->priv;
+    GError* error;
+
+    GWARN("[%s] Scan timed out", self->iface->path);
+    g_source_unref(priv->timeout);
+    priv->timeout = NULL;
+    error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_TIMED_OUT,
+        "Scan timed out");
+    gsupplicant_scan_planner_complete(self, error);
+    g_error_free(error);
+    return G_SOURCE_REMOVE;
+}
+
+static
+gboolean
+gsupplicant_scan_planner_settled(
+    gpointer data)
+{
+    GSupplicantScanPlanner* self = GSUPPLICANT_SCAN_PLANNER(data);
+    GSupplicantScanPlannerPriv* priv = self->priv;
+    GSupplicantScanPlannerStats* stats = &priv->stats;
+    const gint64 duration = priv->end_time - priv->start_time;
+
+    g_source_unref(priv->settle);
+    priv->settle = NULL;
+    if (priv->full) {
+        GDEBUG("[%s] Full scan took %d ms", self->iface->path,
+            (int)(duration / 1000));
+        stats->full_scans++;
+        stats->full_time += duration;
+        priv->partial_in_row = 0;
+        gsupplicant_scan_planner_complete(self, NULL);
+    } else {
+        const guint hits = gsupplicant_scan_planner_count_hits(self);
+        GDEBUG("[%s] Partial scan (%u channel(s)) took %d ms, %u hit(s)",
+            self->iface->path, priv->channels, (int)(duration / 1000), hits);
+        stats->partial_scans++;
+        stats->partial_time += duration;
+        stats->channels += priv->channels;
+        priv->partial_in_row++;
+        if (hits) {
+            if (stats->full_scans) {
+                /* Compared to the average full scan */
+                const gint64 full = stats->full_time / stats->full_scans;
+                if (full > duration) {
+                    stats->time_saved += full - duration;
+                }
+            }
+            gsupplicant_scan_planner_complete(self, NULL);
+        } else {
+            stats->fallbacks++;
+            if (priv->policy.flags & GSUPPLICANT_SCAN_PLANNER_NO_FALLBACK) {
+                gsupplicant_scan_planner_complete(self, NULL);
+            } else {
+                gsupplicant_scan_planner_start(self, TRUE);
+            }
+        }
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+gsupplicant_scan_planner_scan_finished(
+    GSupplicantScanPlanner* self)
+{
+    GSupplicantScanPlannerPriv* priv = self->priv;
+
+    /*
+     * BSS properties may arrive after the interface has stopped
+     * scanning. Give them a bit of time before counting the hits.
+     */
+    priv->end_time = g_get_monotonic_time();
+    priv->settle = g_timeout_source_new(SCAN_PLANNER_SETTLE_MS);
+    g_source_set_callback(priv->settle, gsupplicant_scan_planner_settled,
+        self, NULL);
+    g_source_attach(priv->settle,
+        gsupplicant_get_context(self->iface->supplicant));
+}
+
+static
+void
+gsupplicant_scan_planner_scan_call_done(
+    GSupplicantInterface* iface,
+    GCancellable* cancel,
+    const GError* error,
+    void* data)
+{
+    GSupplicantScanPlanner* self = GSUPPLICANT_SCAN_PLANNER(data);
+    GSupplicantScanPlannerPriv* priv = self->priv;
+
+    GASSERT(priv->cancel == cancel);
+    g_object_unref(priv->cancel);
+    priv->cancel = NULL;
+    if (error) {
+        gsupplicant_scan_planner_complete(self, error);
+    } else {
+        priv->started = TRUE;
+        if (priv->scanning && !iface->scanning) {
+            /* Already done */
+            gsupplicant_scan_planner_scan_finished(self);
+        }
+    }
+}
+
+static
+void
+gsupplicant_scan_planner_start(
+    GSupplicantScanPlanner* self,
+    gboolean full)
+{
+    GSupplicantScanPlannerPriv* priv = self->priv;
+    GSupplicantScanFrequencies freqs;
+    GSupplicantScanFrequency* freq = NULL;
+    GSupplicantScanParams params;
+    GCancellable* cancel;
+
+    memset(&params, 0, sizeof(params));
+    params.type = priv->policy.type;
+    priv->channels = 0;
+    g_free(priv->freqs);
+    priv->freqs = NULL;
+    if (!full) {
+        GArray* plan = gsupplicant_scan_planner_plan(self);
+        const GSupplicantScanPlannerChannel* ch =
+            (GSupplicantScanPlannerChannel*)plan->data;
+        guint i;
+
+        if (plan->len) {
+            freq = g_new(GSupplicantScanFrequency, plan->len);
+            priv->freqs = g_new(guint, plan->len);
+            for (i = 0; i < plan->len; i++) {
+                freq[i].center = priv->freqs[i] = ch[i].freq;
+                freq[i].width = SCAN_PLANNER_CHANNEL_WIDTH;
+            }
+            freqs.freq = freq;
+            freqs.count = priv->channels = plan->len;
+            params.channels = &freqs;
+        } else {
+            /* Nothing to go on */
+            full = TRUE;
+        }
+        g_array_free(plan, TRUE);
+    }
+
+    priv->full = full;
+    priv->started = FALSE;
+    priv->scanning = FALSE;
+    priv->start_time = g_get_monotonic_time();
+    cancel = gsupplicant_interface_scan(self->iface, &params,
+        gsupplicant_scan_planner_scan_call_done, self);
+    g_free(freq);
+    if (cancel) {
+        priv->cancel = g_object_ref(cancel);
+    } else {
+        gsupplicant_scan_planner_fail(self,
+            GSUPPLICANT_ERROR_INTERFACE_UNKNOWN, "Interface is gone");
+    }
+}
+
+static
+void
+gsupplicant_scan_planner_interface_valid_changed(
+    GSupplicantInterface* iface,
+    void* data)
+{
+    GSupplicantScanPlanner* self = GSUPPLICANT_SCAN_PLANNER(data);
+    gsupplicant_scan_planner_sync_bsss(self);
+    if (!iface->valid && self->busy) {
+        gsupplicant_scan_planner_fail(self,
+            GSUPPLICANT_ERROR_INTERFACE_UNKNOWN, "Interface is gone");
+    }
+}
+
+static
+void
+gsupplicant_scan_planner_interface_bsss_changed(
+    GSupplicantInterface* iface,
+    void* data)
+{
+    gsupplicant_scan_planner_sync_bsss(GSUPPLICANT_SCAN_PLANNER(data));
+}
+
+static
+void
+gsupplicant_scan_planner_interface_scanning_changed(
+    GSupplicantInterface* iface,
+    void* data)
+{
+    GSupplicantScanPlanner* self = GSUPPLICANT_SCAN_PLANNER(data);
+    GSupplicantScanPlannerPriv* priv = self->priv;
+    if (self->busy && !priv->settle) {
+        if (iface->scanning) {
+            priv->scanning = TRUE;
+        } else if (priv->scanning && priv->started) {
+            gsupplicant_scan_planner_scan_finished(self);
+        }
+    }
+}
+
+static
+void
+gsupplicant_scan_planner_catalog_changed(
+    GSupplicantCatalog* catalog,
+    void* data)
+{
+    GSupplicantScanPlanner* self = GSUPPLICANT_SCAN_PLANNER(data);
+    GHashTableIter it;
+    gpointer value;
+
+    /* Newly saved networks may already be around */
+    g_hash_table_iter_init(&it, self->priv->bsss);
+    while (g_hash_table_iter_next(&it, NULL, &value)) {
+        gsupplicant_scan_planner_bss_seen(value);
+    }
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+GSupplicantScanPlanner*
+gsupplicant_scan_planner_new(
+    GSupplicantInterface* iface) /* Since 1.0.31 */
+{
+    if (G_LIKELY(iface)) {
+        GSupplicantScanPlanner* self = g_object_new
+            (GSUPPLICANT_SCAN_PLANNER_TYPE, NULL);
+        GSupplicantScanPlannerPriv* priv = self->priv;
+        self->iface = gsupplicant_interface_ref(iface);
+        priv->catalog = gsupplicant_catalog_new(iface);
+        priv->catalog_handler_id = gsupplicant_catalog_add_changed_handler
+            (priv->catalog, gsupplicant_scan_planner_catalog_changed, self);
+        priv->iface_handler_id[INTERFACE_VALID_CHANGED] =
+            gsupplicant_interface_add_handler(iface,
+                GSUPPLICANT_INTERFACE_PROPERTY_VALID,
+                gsupplicant_scan_planner_interface_valid_changed, self);
+        priv->iface_handler_id[INTERFACE_BSSS_CHANGED] =
+            gsupplicant_interface_add_handler(iface,
+                GSUPPLICANT_INTERFACE_PROPERTY_BSSS,
+                gsupplicant_scan_planner_interface_bsss_changed, self);
+        priv->iface_handler_id[INTERFACE_SCANNING_CHANGED] =
+            gsupplicant_interface_add_handler(iface,
+                GSUPPLICANT_INTERFACE_PROPERTY_SCANNING,
+                gsupplicant_scan_planner_interface_scanning_changed, self);
+        gsupplicant_scan_planner_sync_bsss(self);
+        return self;
+    }
+    return NULL;
+}
+
+GSupplicantScanPlanner*
+gsupplicant_scan_planner_ref(
+    GSupplicantScanPlanner* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        g_object_ref(GSUPPLICANT_SCAN_PLANNER(self));
+        return self;
+    } else {
+        return NULL;
+    }
+}
+
+void
+gsupplicant_scan_planner_unref(
+    GSupplicantScanPlanner* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        g_object_unref(GSUPPLICANT_SCAN_PLANNER(self));
+    }
+}
+
+void
+gsupplicant_scan_planner_set_policy(
+    GSupplicantScanPlanner* self,
+    const GSupplicantScanPlannerPolicy* policy) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        self->priv->policy = policy ? *policy :
+            gsupplicant_scan_planner_default;
+    }
+}
+
+const GSupplicantScanPlannerPolicy*
+gsupplicant_scan_planner_get_policy(
+    GSupplicantScanPlanner* self) /* Since 1.0.31 */
+{
+    return G_LIKELY(self) ? &self->priv->policy : NULL;
+}
+
+const GSupplicantScanPlannerStats*
+gsupplicant_scan_planner_get_stats(
+    GSupplicantScanPlanner* self) /* Since 1.0.31 */
+{
+    return G_LIKELY(self) ? &self->priv->stats : NULL;
+}
+
+gboolean
+gsupplicant_scan_planner_scan(
+    GSupplicantScanPlanner* self,
+    GSupplicantScanPlannerFunc fn,
+    void* data) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && !self->busy && self->iface->valid) {
+        GSupplicantScanPlannerPriv* priv = self->priv;
+        const guint max_partial = priv->policy.max_partial;
+
+        self->busy = TRUE;
+        priv->fn = fn;
+        priv->fn_data = data;
+        if (priv->policy.timeout) {
+            priv->timeout = g_timeout_source_new(priv->policy.timeout);
+            g_source_set_callback(priv->timeout,
+                gsupplicant_scan_planner_timeout, self, NULL);
+            g_source_attach(priv->timeout,
+                gsupplicant_get_context(self->iface->supplicant));
+        }
+        gsupplicant_scan_planner_start(self, max_partial &&
+            priv->partial_in_row >= max_partial);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+void
+gsupplicant_scan_planner_cancel(
+    GSupplicantScanPlanner* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && self->busy) {
+        GSupplicantScanPlannerPriv* priv = self->priv;
+        priv->fn = NULL;
+        priv->fn_data = NULL;
+        gsupplicant_scan_planner_complete(self, NULL);
+    }
+}
+
+void
+gsupplicant_scan_planner_reset(
+    GSupplicantScanPlanner* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        GSupplicantScanPlannerPriv* priv = self->priv;
+        g_hash_table_remove_all(priv->history);
+        priv->partial_in_row = 0;
+    }
+}
+
+guint
+gsupplicant_scan_planner_channel_count(
+    GSupplicantScanPlanner* self) /* Since 1.0.31 */
+{
+    guint count = 0;
+    if (G_LIKELY(self)) {
+        GArray* plan = gsupplicant_scan_planner_plan(self);
+        count = plan->len;
+        g_array_free(plan, TRUE);
+    }
+    return count;
+}
+
+/*==========================================================================*
+ * Internals
+ *==========================================================================*/
+
+/**
+ * Per instance initializer
+ */
+static
+void
+gsupplicant_scan_planner_init(
+    GSupplicantScanPlanner* self)
+{
+    GSupplicantScanPlannerPriv* priv = G_TYPE_INSTANCE_GET_PRIVATE(self,
+        GSUPPLICANT_SCAN_PLANNER_TYPE, GSupplicantScanPlannerPriv);
+    self->priv = priv;
+    priv->policy = gsupplicant_scan_planner_default;
+    priv->bsss = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+        NULL, gsupplicant_scan_planner_bss_destroy);
+    priv->history = g_hash_table_new_full(g_bytes_hash, g_bytes_equal,
+        (GDestroyNotify)g_bytes_unref,
+        gsupplicant_scan_planner_history_destroy);
+}
+
+/**
+ * Final stage of deinitialization
+ */
+static
+void
+gsupplicant_scan_planner_finalize(
+    GObject* object)
+{
+    GSupplicantScanPlanner* self = GSUPPLICANT_SCAN_PLANNER(object);
+    GSupplicantScanPlannerPriv* priv = self->priv;
+    gsupplicant_scan_planner_clear_scan(self);
+    g_free(priv->freqs);
+    gsupplicant_interface_remove_all_handlers(self->iface,
+        priv->iface_handler_id);
+    gsupplicant_catalog_remove_handler(priv->catalog,
+        priv->catalog_handler_id);
+    gsupplicant_catalog_unref(priv->catalog);
+    g_hash_table_destroy(priv->bsss);
+    g_hash_table_destroy(priv->history);
+    gsupplicant_interface_unref(self->iface);
+    G_OBJECT_CLASS(SUPER_CLASS)->finalize(object);
+}
+
+/**
+ * Per class initializer
+ */
+static
+void
+gsupplicant_scan_planner_class_init(
+    GSupplicantScanPlannerClass* klass)
+{
+    G_OBJECT_CLASS(klass)->finalize = gsupplicant_scan_planner_finalize;
+    G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    g_type_class_add_private(klass, sizeof(GSupplicantScanPlannerPriv));
+    G_GNUC_END_IGNORE_DEPRECATIONS
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
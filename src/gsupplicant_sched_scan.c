@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gsupplicant_sched_scan.h"
+#include "gsupplicant_interface.h"
+#include "gsupplicant_interface_p.h"
+#include "gsupplicant_log.h"
+
+/* Object definition */
+#define SCHED_SCAN_MAX_STEPS    (16)
+#define SCHED_SCAN_MIN_FREQ     (2400)
+#define SCHED_SCAN_MAX_FREQ     (7200)
+
+typedef struct gsupplicant_sched_scan_step {
+    guint interval;
+    guint iterations;
+} GSupplicantSchedScanStep;
+
+struct gsupplicant_sched_scan_plan {
+    GArray* steps;          /* GSupplicantSchedScanStep */
+    GArray* freqs;          /* guint */
+    gboolean offload;
+    GSupplicantInterface* iface;
+    GSupplicantSchedScanConfig saved;
+};
+
+/*==========================================================================*
+ * Implementation
+ *==========================================================================*/
+
+static
+void
+gsupplicant_sched_scan_config_clear(
+    GSupplicantSchedScanConfig* config)
+{
+    g_free(config->plans);
+    g_free(config->interval);
+    g_free(config->disable_offload);
+    g_free(config->freq_list);
+    memset(config, 0, sizeof(*config));
+}
+
+static
+const GSupplicantSchedScanStep*
+gsupplicant_sched_scan_plan_last_step(
+    const GSupplicantSchedScanPlan* plan)
+{
+    return plan->steps->len ? &g_array_index(plan->steps,
+        GSupplicantSchedScanStep, plan->steps->len - 1) : NULL;
+}
+
+static
+char*
+gsupplicant_sched_scan_plan_freq_list(
+    const GSupplicantSchedScanPlan* plan)
+{
+    GString* buf = g_string_new(NULL);
+    guint i;
+
+    for (i = 0; i < plan->freqs->len; i++) {
+        if (buf->len) g_string_append_c(buf, ' ');
+        g_string_append_printf(buf, "%u", g_array_index(plan->freqs,
+            guint, i));
+    }
+    return g_string_free(buf, FALSE);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+GSupplicantSchedScanPlan*
+gsupplicant_sched_scan_plan_new(
+    void) /* Since 1.0.31 */
+{
+    GSupplicantSchedScanPlan* plan = g_slice_new0(GSupplicantSchedScanPlan);
+
+    plan->steps = g_array_new(FALSE, FALSE, sizeof(GSupplicantSchedScanStep));
+    plan->freqs = g_array_new(FALSE, FALSE, sizeof(guint));
+    plan->offload = TRUE;
+    return plan;
+}
+
+void
+gsupplicant_sched_scan_plan_free(
+    GSupplicantSchedScanPlan* plan) /* Since 1.0.31 */
+{
+    if (G_LIKELY(plan)) {
+        g_array_free(plan->steps, TRUE);
+        g_array_free(plan->freqs, TRUE);
+        gsupplicant_sched_scan_config_clear(&plan->saved);
+        gsupplicant_interface_unref(plan->iface);
+        g_slice_free(GSupplicantSchedScanPlan, plan);
+    }
+}
+
+gboolean
+gsupplicant_sched_scan_plan_add_step(
+    GSupplicantSchedScanPlan* plan,
+    guint interval,
+    guint iterations) /* Since 1.0.31 */
+{
+    if (G_LIKELY(plan) && interval && !gsupplicant_sched_scan_plan_is_valid
+        (plan) && plan->steps->len < SCHED_SCAN_MAX_STEPS) {
+        GSupplicantSchedScanStep step;
+
+        step.interval = interval;
+        step.iterations = iterations;
+        g_array_append_val(plan->steps, step);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+gsupplicant_sched_scan_plan_add_frequency(
+    GSupplicantSchedScanPlan* plan,
+    guint frequency) /* Since 1.0.31 */
+{
+    if (G_LIKELY(plan) && frequency >= SCHED_SCAN_MIN_FREQ &&
+        frequency < SCHED_SCAN_MAX_FREQ) {
+        guint i;
+
+        for (i = 0; i < plan->freqs->len; i++) {
+            if (g_array_index(plan->freqs, guint, i) == frequency) {
+                return TRUE;
+            }
+        }
+        g_array_append_val(plan->freqs, frequency);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+void
+gsupplicant_sched_scan_plan_set_offload(
+    GSupplicantSchedScanPlan* plan,
+    gboolean enable) /* Since 1.0.31 */
+{
+    if (G_LIKELY(plan)) {
+        plan->offload = enable;
+    }
+}
+
+gboolean
+gsupplicant_sched_scan_plan_is_valid(
+    const GSupplicantSchedScanPlan* plan) /* Since 1.0.31 */
+{
+    if (G_LIKELY(plan)) {
+        const GSupplicantSchedScanStep* last =
+            gsupplicant_sched_scan_plan_last_step(plan);
+
+        return last && !last->iterations;
+    }
+    return FALSE;
+}
+
+char*
+gsupplicant_sched_scan_plan_to_string(
+    const GSupplicantSchedScanPlan* plan) /* Since 1.0.31 */
+{
+    if (gsupplicant_sched_scan_plan_is_valid(plan)) {
+        GString* buf = g_string_new(NULL);
+        guint i;
+
+        /* "<interval:iterations> ... <interval>" */
+        for (i = 0; i < plan->steps->len; i++) {
+            const GSupplicantSchedScanStep* step = &g_array_index
+                (plan->steps, GSupplicantSchedScanStep, i);
+
+            if (buf->len) g_string_append_c(buf, ' ');
+            if (step->iterations) {
+                g_string_append_printf(buf, "%u:%u", step->interval,
+                    step->iterations);
+            } else {
+                g_string_append_printf(buf, "%u", step->interval);
+            }
+        }
+        return g_string_free(buf, FALSE);
+    }
+    return NULL;
+}
+
+gboolean
+gsupplicant_sched_scan_plan_apply(
+    GSupplicantSchedScanPlan* plan,
+    GSupplicantInterface* iface) /* Since 1.0.31 */
+{
+    if (gsupplicant_sched_scan_plan_is_valid(plan) &&
+        G_LIKELY(iface) && iface->valid) {
+        GSupplicantSchedScanConfig config;
+        gboolean ok;
+
+        if (plan->iface != iface) {
+            gsupplicant_sched_scan_plan_revert(plan);
+            plan->iface = gsupplicant_interface_ref(iface);
+            gsupplicant_interface_get_sched_scan_config(iface, &plan->saved);
+        }
+
+        /* SchedScanInterval is for drivers which don't support plans */
+        config.plans = gsupplicant_sched_scan_plan_to_string(plan);
+        config.interval = g_strdup_printf("%u",
+            gsupplicant_sched_scan_plan_last_step(plan)->interval);
+        config.disable_offload = g_strdup(plan->offload ? "0" : "1");
+        config.freq_list = plan->freqs->len ?
+            gsupplicant_sched_scan_plan_freq_list(plan) : NULL;
+        GDEBUG("[%s] Sched scan plan: %s", iface->path, config.plans);
+        ok = gsupplicant_interface_set_sched_scan_config(iface, &config);
+        gsupplicant_sched_scan_config_clear(&config);
+        return ok;
+    }
+    return FALSE;
+}
+
+gboolean
+gsupplicant_sched_scan_plan_revert(
+    GSupplicantSchedScanPlan* plan) /* Since 1.0.31 */
+{
+    if (G_LIKELY(plan) && plan->iface) {
+        GSupplicantInterface* iface = plan->iface;
+        GSupplicantSchedScanConfig* saved = &plan->saved;
+        gboolean ok;
+
+        /*
+         * Restore the defaults for whatever wpa_supplicant didn't report,
+         * otherwise the values applied by the plan would stay.
+         */
+        if (!saved->plans) saved->plans = g_strdup("");
+        if (!saved->interval) saved->interval = g_strdup("0");
+        if (!saved->disable_offload) saved->disable_offload = g_strdup("0");
+        if (!saved->freq_list && plan->freqs->len) {
+            saved->freq_list = g_strdup("");
+        }
+        GDEBUG("[%s] Reverting sched scan plan", iface->path);
+        ok = gsupplicant_interface_set_sched_scan_config(iface, saved);
+        gsupplicant_sched_scan_config_clear(saved);
+        gsupplicant_interface_unref(iface);
+        plan->iface = NULL;
+        return ok;
+    }
+    return FALSE;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gsupplicant_snapshot_p.h"
+#include "gsupplicant_util_p.h"
+#include "gsupplicant_log.h"
+
+#define SNAPSHOT_LOCK_BIT (0)
+
+typedef struct gsupplicant_bss_snapshot_priv {
+    GSupplicantBSSSnapshot pub;     /* Must be first */
+    gint ref_count;
+} GSupplicantBSSSnapshotPriv;
+
+typedef struct gsupplicant_interface_snapshot_priv {
+    GSupplicantInterfaceSnapshot pub;   /* Must be first */
+    gint ref_count;
+    char* current_bss;
+    char* current_network;
+    const GSupplicantBSSSnapshot* bss[1];
+} GSupplicantInterfaceSnapshotPriv;
+
+/*==========================================================================*
+ * Internal API
+ *==========================================================================*/
+
+GSupplicantBSSSnapshot*
+gsupplicant_bss_snapshot_new(
+    GSupplicantBSS* bss)
+{
+    GSupplicantBSSSnapshotPriv* priv =
+        g_slice_new0(GSupplicantBSSSnapshotPriv);
+    GSupplicantBSSSnapshot* snapshot = &priv->pub;
+
+    /* Interned strings and GBytes are safe to release on any thread */
+    priv->ref_count = 1;
+    snapshot->path = gsupplicant_intern_ref(bss->path);
+    snapshot->bssid = bss->bssid ? g_bytes_ref(bss->bssid) : NULL;
+    snapshot->ssid = bss->ssid ? g_bytes_ref(bss->ssid) : NULL;
+    snapshot->ssid_str = gsupplicant_intern_ref(bss->ssid_str);
+    snapshot->mode = bss->mode;
+    snapshot->keymgmt = gsupplicant_bss_keymgmt(bss);
+    snapshot->privacy = bss->privacy;
+    snapshot->frequency = bss->frequency;
+    snapshot->maxrate = bss->maxrate;
+    snapshot->signal = bss->signal;
+    return snapshot;
+}
+
+GSupplicantInterfaceSnapshot*
+gsupplicant_interface_snapshot_new(
+    GSupplicantInterface* iface,
+    GHashTable* bss_snapshots,
+    guint serial)
+{
+    const guint n = bss_snapshots ? g_hash_table_size(bss_snapshots) : 0;
+    GSupplicantInterfaceSnapshotPriv* priv = g_malloc0
+        (G_STRUCT_OFFSET(GSupplicantInterfaceSnapshotPriv, bss) +
+            sizeof(priv->bss[0]) * (n + 1));
+    GSupplicantInterfaceSnapshot* snapshot = &priv->pub;
+
+    priv->ref_count = 1;
+    snapshot->path = gsupplicant_intern_ref(iface->path);
+    snapshot->serial = serial;
+    snapshot->valid = iface->valid;
+    snapshot->present = iface->present;
+    snapshot->state = iface->state;
+    snapshot->scanning = iface->scanning;
+    snapshot->current_bss = priv->current_bss = g_strdup(iface->current_bss);
+    snapshot->current_network = priv->current_network =
+        g_strdup(iface->current_network);
+    if (n) {
+        GHashTableIter it;
+        gpointer value;
+        guint i = 0;
+
+        g_hash_table_iter_init(&it, bss_snapshots);
+        while (g_hash_table_iter_next(&it, NULL, &value)) {
+            priv->bss[i++] = gsupplicant_bss_snapshot_ref(value);
+        }
+        if (iface->current_bss) {
+            snapshot->current = g_hash_table_lookup(bss_snapshots,
+                iface->current_bss);
+        }
+    }
+    snapshot->bss_count = n;
+    snapshot->bss = priv->bss;
+    return snapshot;
+}
+
+void
+gsupplicant_snapshot_slot_publish(
+    GSupplicantSnapshotSlot* slot,
+    GSupplicantInterfaceSnapshot* snapshot)
+{
+    GSupplicantInterfaceSnapshot* old;
+
+    g_bit_lock(&slot->lock, SNAPSHOT_LOCK_BIT);
+    old = slot->snapshot;
+    slot->snapshot = snapshot;
+    g_bit_unlock(&slot->lock, SNAPSHOT_LOCK_BIT);
+    gsupplicant_interface_snapshot_unref(old);
+}
+
+const GSupplicantInterfaceSnapshot*
+gsupplicant_snapshot_slot_get(
+    GSupplicantSnapshotSlot* slot)
+{
+    const GSupplicantInterfaceSnapshot* snapshot;
+
+    g_bit_lock(&slot->lock, SNAPSHOT_LOCK_BIT);
+    snapshot = gsupplicant_interface_snapshot_ref(slot->snapshot);
+    g_bit_unlock(&slot->lock, SNAPSHOT_LOCK_BIT);
+    return snapshot;
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+const GSupplicantInterfaceSnapshot*
+gsupplicant_interface_snapshot_ref(
+    const GSupplicantInterfaceSnapshot* snapshot) /* Since 1.0.31 */
+{
+    if (G_LIKELY(snapshot)) {
+        g_atomic_int_inc(&((GSupplicantInterfaceSnapshotPriv*)snapshot)->
+            ref_count);
+    }
+    return snapshot;
+}
+
+void
+gsupplicant_interface_snapshot_unref(
+    const GSupplicantInterfaceSnapshot* snapshot) /* Since 1.0.31 */
+{
+    if (G_LIKELY(snapshot)) {
+        GSupplicantInterfaceSnapshotPriv* priv =
+            (GSupplicantInterfaceSnapshotPriv*)snapshot;
+
+        GASSERT(priv->ref_count > 0);
+        if (g_atomic_int_dec_and_test(&priv->ref_count)) {
+            guint i;
+
+            for (i = 0; i < snapshot->bss_count; i++) {
+                gsupplicant_bss_snapshot_unref(priv->bss[i]);
+            }
+            gsupplicant_intern_unref(snapshot->path);
+            g_free(priv->current_bss);
+            g_free(priv->current_network);
+            g_free(priv);
+        }
+    }
+}
+
+const GSupplicantBSSSnapshot*
+gsupplicant_bss_snapshot_ref(
+    const GSupplicantBSSSnapshot* snapshot) /* Since 1.0.31 */
+{
+    if (G_LIKELY(snapshot)) {
+        g_atomic_int_inc(&((GSupplicantBSSSnapshotPriv*)snapshot)->ref_count);
+    }
+    return snapshot;
+}
+
+void
+gsupplicant_bss_snapshot_unref(
+    const GSupplicantBSSSnapshot* snapshot) /* Since 1.0.31 */
+{
+    if (G_LIKELY(snapshot)) {
+        GSupplicantBSSSnapshotPriv* priv =
+            (GSupplicantBSSSnapshotPriv*)snapshot;
+
+        GASSERT(priv->ref_count > 0);
+        if (g_atomic_int_dec_and_test(&priv->ref_count)) {
+            if (snapshot->bssid) {
+                g_bytes_unref(snapshot->bssid);
+            }
+            if (snapshot->ssid) {
+                g_bytes_unref(snapshot->ssid);
+            }
+            gsupplicant_intern_unref(snapshot->ssid_str);
+            gsupplicant_intern_unref(snapshot->path);
+            g_slice_free(GSupplicantBSSSnapshotPriv, priv);
+        }
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GSUPPLICANT_SNAPSHOT_PRIVATE_H
+#define GSUPPLICANT_SNAPSHOT_PRIVATE_H
+
+#include "gsupplicant_types_p.h"
+#include <gsupplicant_snapshot.h>
+
+/*
+ * The published snapshot. Readers take the bit lock only for as long
+ * as it takes to bump the reference count.
+ */
+typedef struct gsupplicant_snapshot_slot {
+    gint lock;
+    GSupplicantInterfaceSnapshot* snapshot;
+} GSupplicantSnapshotSlot;
+
+GSupplicantBSSSnapshot*
+gsupplicant_bss_snapshot_new(
+    GSupplicantBSS* bss)
+    GSUPPLICANT_INTERNAL;
+
+/* bss_snapshots maps paths to GSupplicantBSSSnapshot */
+GSupplicantInterfaceSnapshot*
+gsupplicant_interface_snapshot_new(
+    GSupplicantInterface* iface,
+    GHashTable* bss_snapshots,
+    guint serial)
+    GSUPPLICANT_INTERNAL;
+
+/* Takes ownership of the snapshot */
+void
+gsupplicant_snapshot_slot_publish(
+    GSupplicantSnapshotSlot* slot,
+    GSupplicantInterfaceSnapshot* snapshot)
+    GSUPPLICANT_INTERNAL;
+
+const GSupplicantInterfaceSnapshot*
+gsupplicant_snapshot_slot_get(
+    GSupplicantSnapshotSlot* slot)
+    GSUPPLICANT_INTERNAL;
+
+#endif /* GSUPPLICANT_SNAPSHOT_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GSUPPLICANT_TRACE_H
+#define GSUPPLICANT_TRACE_H
+
+/*
+ * Static tracepoints (USDT). Compiled in when the library is built with
+ * SDT=1, otherwise they are no-ops. When enabled, each probe is a single
+ * nop instruction until a tracer attaches to it, e.g.
+ *
+ *   perf probe -x libgsupplicant.so sdt_gsupplicant:emit_pending_signals
+ *   bpftrace -e 'usdt:libgsupplicant.so:gsupplicant:call_done { ... }'
+ *
+ * Provider is "gsupplicant". The first argument of most probes is the
+ * object kind ("supplicant", "interface", "bss" or "network"), the
+ * second one is the D-Bus object path:
+ *
+ *   properties_changed       (kind, path, changed, invalidated)
+ *   properties_changed_done  (kind, path)
+ *   emit_pending_signals     (kind, path, pending_signals)
+ *   emit_pending_signals_done(kind, path)
+ *   proxy_new                (kind, path)
+ *   proxy_ready              (kind, path, ok)
+ *   call_start               (kind, path, call)
+ *   call_done                (kind, path, call, cancelled)
+ *   state_changed            (path, old_state, new_state)
+ *
+ * The call pointer identifies the call between call_start and call_done.
+ */
+
+#ifdef HAVE_SDT
+#  include <sys/sdt.h>
+#  define GSUPPLICANT_TRACE_ENABLED 1
+#  define GSUPPLICANT_TRACE2(name,a,b) \
+    STAP_PROBE2(gsupplicant, name, a, b)
+#  define GSUPPLICANT_TRACE3(name,a,b,c) \
+    STAP_PROBE3(gsupplicant, name, a, b, c)
+#  define GSUPPLICANT_TRACE4(name,a,b,c,d) \
+    STAP_PROBE4(gsupplicant, name, a, b, c, d)
+#else
+#  define GSUPPLICANT_TRACE_ENABLED 0
+#  define GSUPPLICANT_TRACE2(name,a,b) ((void)0)
+#  define GSUPPLICANT_TRACE3(name,a,b,c) ((void)0)
+#  define GSUPPLICANT_TRACE4(name,a,b,c,d) ((void)0)
+#endif
+
+#endif /* GSUPPLICANT_TRACE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -34,6 +34,195 @@
 #include "gsupplicant_log.h"
 
 #include <ctype.h>
+#include <stdio.h>
+
+/*
+ * Strings returned by gsupplicant_format_bytes() and friends stay valid
+ * until the end of the current main loop dispatch. They are allocated
+ * from a per-thread arena which gets reset by a single idle callback
+ * per dispatch cycle, rather than freeing each string separately.
+ *
+ * The idle callback must run on the thread which owns the arena. That's
+ * only guaranteed if the thread owns its thread-default context. Other
+ * threads (e.g. the ones not running any main loop) get their strings
+ * from a small per-thread ring instead, where each string stays valid
+ * for the next FORMAT_RING_SIZE - 1 calls.
+ */
+
+#define FORMAT_CHUNK_MIN_SIZE (1024)
+#define FORMAT_CHUNK_MAX_SIZE (0x10000)
+#define FORMAT_RING_SIZE (16)
+
+typedef struct gsupplicant_format_chunk GSupplicantFormatChunk;
+struct gsupplicant_format_chunk {
+    GSupplicantFormatChunk* next;
+    gsize size;
+    gsize used;
+    char data[];
+};
+
+typedef struct gsupplicant_format_arena {
+    GSupplicantFormatChunk* chunks;     /* The current one first */
+    GSource* reset;
+    GMainContext* context;              /* Where reset is attached */
+    char* ring[FORMAT_RING_SIZE];
+    guint ring_pos;
+} GSupplicantFormatArena;
+
+static
+void
+gsupplicant_format_arena_free(
+    gpointer data);
+
+static GPrivate gsupplicant_format_arena_key =
+    G_PRIVATE_INIT(gsupplicant_format_arena_free);
+
+static GSupplicantLogBytesFunc gsupplicant_log_bytes_fn = NULL;
+static void* gsupplicant_log_bytes_data = NULL;
+
+static
+GSupplicantFormatChunk*
+gsupplicant_format_chunk_new(
+    gsize size)
+{
+    GSupplicantFormatChunk* chunk = g_malloc(G_STRUCT_OFFSET
+        (GSupplicantFormatChunk, data) + size);
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
+}
+
+static
+void
+gsupplicant_format_chunks_free(
+    GSupplicantFormatChunk* chunk)
+{
+    while (chunk) {
+        GSupplicantFormatChunk* next = chunk->next;
+        g_free(chunk);
+        chunk = next;
+    }
+}
+
+static
+gboolean
+gsupplicant_format_arena_reset(
+    gpointer data)
+{
+    GSupplicantFormatArena* arena = data;
+    GSupplicantFormatChunk* chunk = arena->chunks;
+
+    g_source_unref(arena->reset);
+    arena->reset = NULL;
+    if (chunk->next) {
+        /* Didn't fit into one chunk, next time allocate a bigger one */
+        gsize total = 0;
+        GSupplicantFormatChunk* ptr;
+        for (ptr = chunk; ptr; ptr = ptr->next) {
+            total += ptr->used;
+        }
+        gsupplicant_format_chunks_free(chunk);
+        arena->chunks = gsupplicant_format_chunk_new(MIN(MAX(total,
+            FORMAT_CHUNK_MIN_SIZE), FORMAT_CHUNK_MAX_SIZE));
+    } else {
+        chunk->used = 0;
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+gsupplicant_format_arena_free(
+    gpointer data)
+{
+    GSupplicantFormatArena* arena = data;
+    guint i;
+
+    if (arena->reset) {
+        g_source_destroy(arena->reset);
+        g_source_unref(arena->reset);
+    }
+    if (arena->context) {
+        g_main_context_unref(arena->context);
+    }
+    for (i = 0; i < FORMAT_RING_SIZE; i++) {
+        g_free(arena->ring[i]);
+    }
+    gsupplicant_format_chunks_free(arena->chunks);
+    g_slice_free(GSupplicantFormatArena, arena);
+}
+
+static
+char*
+gsupplicant_format_alloc(
+    gsize size)
+{
+    GSupplicantFormatArena* arena = g_private_get
+        (&gsupplicant_format_arena_key);
+    GSupplicantFormatChunk* chunk;
+    GMainContext* context;
+    char* ptr;
+
+    if (!arena) {
+        arena = g_slice_new0(GSupplicantFormatArena);
+        g_private_set(&gsupplicant_format_arena_key, arena);
+    }
+
+    context = g_main_context_ref_thread_default();
+    if (!arena->reset) {
+        if (!g_main_context_is_owner(context)) {
+            /* The reset would run on another thread, use the ring */
+            const guint pos = (arena->ring_pos++) % FORMAT_RING_SIZE;
+            g_main_context_unref(context);
+            g_free(arena->ring[pos]);
+            return (arena->ring[pos] = g_malloc(size));
+        }
+        if (arena->context != context) {
+            if (arena->context) {
+                g_main_context_unref(arena->context);
+            }
+            arena->context = g_main_context_ref(context);
+        }
+    }
+    g_main_context_unref(context);
+
+    chunk = arena->chunks;
+    if (!chunk || (chunk->size - chunk->used) < size) {
+        GSupplicantFormatChunk* new_chunk = gsupplicant_format_chunk_new
+            (MAX(size, FORMAT_CHUNK_MIN_SIZE));
+        new_chunk->next = chunk;
+        arena->chunks = chunk = new_chunk;
+    }
+    ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    if (!arena->reset) {
+        /* Runs after the current dispatch on this thread's context */
+        arena->reset = g_idle_source_new();
+        g_source_set_callback(arena->reset, gsupplicant_format_arena_reset,
+            arena, NULL);
+        g_source_attach(arena->reset, arena->context);
+    }
+    return ptr;
+}
+
+static
+const char*
+gsupplicant_format_vprintf(
+    const char* format,
+    va_list va)
+{
+    va_list va2;
+    char* str;
+    int len;
+
+    va_copy(va2, va);
+    len = g_vsnprintf(NULL, 0, format, va2);
+    va_end(va2);
+    str = gsupplicant_format_alloc(len + 1);
+    g_vsnprintf(str, len + 1, format, va);
+    return str;
+}
 
 const char*
 gsupplicant_name_int_find_bit(
@@ -225,41 +414,73 @@ gsupplicant_parse_bits_array(
     return mask;
 }
 
-static
-gboolean
-gsupplicant_idle_cb(
-    gpointer data)
-{
-    return G_SOURCE_REMOVE;
-}
-
 const char*
 gsupplicant_format_bytes(
     GBytes* bytes,
     gboolean append_length)
 {
     if (bytes) {
-        char* str;
+        static const char hex[] = "0123456789abcdef";
         gsize i, size = 0;
         const guint8* data = g_bytes_get_data(bytes, &size);
-        GString* buf = g_string_sized_new(3*size + (append_length ? 8 : 0));
+        /* 3 chars per byte, " (4294967295)" and NULL terminator */
+        char* str = gsupplicant_format_alloc(3*size + 14);
+        char* ptr = str;
         for (i=0; i<size; i++) {
-            if (i > 0) g_string_append_c(buf, ':');
-            g_string_append_printf(buf, "%02x", data[i]);
+            if (i > 0) *ptr++ = ':';
+            *ptr++ = hex[data[i] >> 4];
+            *ptr++ = hex[data[i] & 0x0f];
         }
         if (append_length) {
-            if (size > 0) g_string_append_c(buf, ' ');
-            g_string_append_printf(buf, "(%u)", (guint)size);
+            if (size > 0) *ptr++ = ' ';
+            ptr += sprintf(ptr, "(%u)", (guint)size);
         }
-        str = g_string_free(buf, FALSE);
-        g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, gsupplicant_idle_cb,
-            str, g_free);
+        *ptr = 0;
         return str;
     } else {
         return "(null)";
     }
 }
 
+void
+gsupplicant_log_set_bytes_func(
+    GSupplicantLogBytesFunc fn,
+    void* data)
+{
+    gsupplicant_log_bytes_fn = fn;
+    gsupplicant_log_bytes_data = data;
+}
+
+void
+gsupplicant_log_bytes(
+    const GLogModule* module,
+    int level,
+    GBytes* bytes,
+    gboolean append_length,
+    const char* format,
+    ...)
+{
+    GSupplicantLogBytesFunc fn = gsupplicant_log_bytes_fn;
+    const gboolean enabled = gutil_log_enabled(module, level);
+
+    /* Nothing gets formatted unless someone is going to consume it */
+    if (fn || enabled) {
+        const char* msg;
+        va_list va;
+
+        va_start(va, format);
+        msg = gsupplicant_format_vprintf(format, va);
+        va_end(va);
+        if (fn) {
+            fn(module->name, level, msg, bytes, gsupplicant_log_bytes_data);
+        }
+        if (enabled) {
+            gutil_log(module, level, "%s %s", msg,
+                gsupplicant_format_bytes(bytes, append_length));
+        }
+    }
+}
+
 static
 gboolean
 gsupplicant_cancel_later_cb(
@@ -274,13 +495,61 @@ gsupplicant_cancel_later(
     GCancellable* cancel)
 {
     if (cancel) {
-        return g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
-            gsupplicant_cancel_later_cb, g_object_ref(cancel),
-            g_object_unref);
+        /* Cancel on the context the caller is running on */
+        GSource* source = g_idle_source_new();
+        guint id;
+
+        g_source_set_priority(source, G_PRIORITY_DEFAULT_IDLE);
+        g_source_set_callback(source, gsupplicant_cancel_later_cb,
+            g_object_ref(cancel), g_object_unref);
+        id = g_source_attach(source, g_main_context_get_thread_default());
+        g_source_unref(source);
+        return id;
     }
     return 0;
 }
 
+gboolean
+gsupplicant_proxy_has_owner(
+    gpointer proxy)
+{
+    char* owner = g_dbus_proxy_get_name_owner(G_DBUS_PROXY(proxy));
+    const gboolean has_owner = (owner != NULL);
+
+    g_free(owner);
+    return has_owner;
+}
+
+void
+gsupplicant_block_handlers(
+    gpointer instance,
+    const gulong* ids,
+    guint count)
+{
+    guint i;
+
+    for (i = 0; i < count; i++) {
+        if (ids[i]) {
+            g_signal_handler_block(instance, ids[i]);
+        }
+    }
+}
+
+void
+gsupplicant_unblock_handlers(
+    gpointer instance,
+    const gulong* ids,
+    guint count)
+{
+    guint i;
+
+    for (i = 0; i < count; i++) {
+        if (ids[i]) {
+            g_signal_handler_unblock(instance, ids[i]);
+        }
+    }
+}
+
 const char*
 gsupplicant_check_abs_path(
     const char* path)
@@ -505,6 +774,304 @@ gsupplicant_utf8_from_bytes(
     return NULL;
 }
 
+/*==========================================================================*
+ * Registries
+ *
+ * Objects are bound to the main context which was the thread-default one
+ * when they were created, that's where their D-Bus proxies deliver the
+ * signals and where the callbacks get invoked. Therefore each context has
+ * its own set of instances. The registry itself is shared by all threads
+ * and is protected by a mutex, the objects themselves aren't and must be
+ * used on the thread running their context.
+ *
+ * Registered objects hold a reference to their interned path, which is
+ * used as the key. Therefore the lookup is a pointer comparison, and if
+ * the path isn't interned then there's no such object.
+ *==========================================================================*/
+
+typedef struct gsupplicant_registry_entry {
+    GSupplicantRegistry* registry;
+    GMainContext* context;
+    const char* key;
+} GSupplicantRegistryEntry;
+
+static
+void
+gsupplicant_registry_destroyed(
+    gpointer data,
+    GObject* dead)
+{
+    GSupplicantRegistryEntry* entry = data;
+    GSupplicantRegistry* registry = entry->registry;
+    GHashTable* objects;
+
+    GVERBOSE_("%s", entry->key);
+    g_mutex_lock(&registry->mutex);
+    objects = registry->contexts ?
+        g_hash_table_lookup(registry->contexts, entry->context) : NULL;
+    GASSERT(objects);
+    if (objects) {
+        GASSERT(g_hash_table_lookup(objects, entry->key) == dead);
+        g_hash_table_remove(objects, entry->key);
+        if (g_hash_table_size(objects) == 0) {
+            g_hash_table_remove(registry->contexts, entry->context);
+            if (g_hash_table_size(registry->contexts) == 0) {
+                g_hash_table_unref(registry->contexts);
+                registry->contexts = NULL;
+            }
+        }
+    }
+    g_mutex_unlock(&registry->mutex);
+    g_main_context_unref(entry->context);
+    g_slice_free(GSupplicantRegistryEntry, entry);
+}
+
+gpointer
+gsupplicant_registry_get(
+    GSupplicantRegistry* registry,
+    const char* path)
+{
+    GMainContext* context = g_main_context_get_thread_default();
+    const char* ipath = gsupplicant_intern_find(path);
+    GObject* object = NULL;
+
+    if (!context) {
+        context = g_main_context_default();
+    }
+    g_mutex_lock(&registry->mutex);
+    if (ipath && registry->contexts) {
+        GHashTable* objects = g_hash_table_lookup(registry->contexts, context);
+
+        if (objects) {
+            object = g_hash_table_lookup(objects, ipath);
+            if (object) {
+                g_object_ref(object);
+            }
+        }
+    }
+    g_mutex_unlock(&registry->mutex);
+    return object;
+}
+
+void
+gsupplicant_registry_add(
+    GSupplicantRegistry* registry,
+    const char* ipath,
+    gpointer object)
+{
+    GSupplicantRegistryEntry* entry = g_slice_new(GSupplicantRegistryEntry);
+    GHashTable* objects = NULL;
+
+    /* The key (interned path) is owned by the object */
+    entry->registry = registry;
+    entry->context = g_main_context_ref_thread_default();
+    entry->key = ipath;
+    g_mutex_lock(&registry->mutex);
+    if (registry->contexts) {
+        objects = g_hash_table_lookup(registry->contexts, entry->context);
+    } else {
+        registry->contexts = g_hash_table_new_full(g_direct_hash,
+            g_direct_equal, NULL, (GDestroyNotify) g_hash_table_unref);
+    }
+    if (!objects) {
+        objects = g_hash_table_new(g_direct_hash, g_direct_equal);
+        g_hash_table_insert(registry->contexts, entry->context, objects);
+    }
+    g_hash_table_replace(objects, (gpointer) ipath, object);
+    g_mutex_unlock(&registry->mutex);
+    g_object_weak_ref(G_OBJECT(object), gsupplicant_registry_destroyed, entry);
+}
+
+/*==========================================================================*
+ * Interned strings
+ *
+ * Object paths and SSIDs tend to be repeated in many places (registries,
+ * priv->path, bsss/networks lists, BSSs belonging to the same network).
+ * Interned strings are reference counted and shared, so that the same
+ * string is stored only once and two interned strings are equal if and
+ * only if the pointers are equal.
+ *
+ * The pool is shared by all threads, so it's protected by a mutex. The
+ * reference count is atomic, which allows gsupplicant_intern_ref() to
+ * skip the lock (the caller already holds a reference, so the entry
+ * can't go away underneath it).
+ *==========================================================================*/
+
+typedef struct gsupplicant_intern_entry {
+    gint ref_count;
+    char str[1];
+} GSupInternEntry;
+
+#define INTERN_ENTRY(s) ((GSupInternEntry*)((s) - \
+    G_STRUCT_OFFSET(GSupInternEntry, str)))
+
+/* Interned string => GSupInternEntry */
+static GHashTable* gsupplicant_intern_table = NULL;
+static GMutex gsupplicant_intern_mutex;
+
+const char*
+gsupplicant_intern(
+    const char* str)
+{
+    if (str) {
+        GSupInternEntry* entry;
+
+        g_mutex_lock(&gsupplicant_intern_mutex);
+        entry = gsupplicant_intern_table ?
+            g_hash_table_lookup(gsupplicant_intern_table, str) : NULL;
+        if (entry) {
+            g_atomic_int_inc(&entry->ref_count);
+        } else {
+            const gsize len = strlen(str);
+            entry = g_malloc(G_STRUCT_OFFSET(GSupInternEntry, str) + len + 1);
+            entry->ref_count = 1;
+            memcpy(entry->str, str, len + 1);
+            if (!gsupplicant_intern_table) {
+                gsupplicant_intern_table = g_hash_table_new(g_str_hash,
+                    g_str_equal);
+            }
+            g_hash_table_insert(gsupplicant_intern_table, entry->str, entry);
+        }
+        g_mutex_unlock(&gsupplicant_intern_mutex);
+        return entry->str;
+    }
+    return NULL;
+}
+
+const char*
+gsupplicant_intern_find(
+    const char* str)
+{
+    const char* istr = NULL;
+
+    if (str) {
+        g_mutex_lock(&gsupplicant_intern_mutex);
+        if (gsupplicant_intern_table) {
+            GSupInternEntry* entry =
+                g_hash_table_lookup(gsupplicant_intern_table, str);
+
+            if (entry) {
+                istr = entry->str;
+            }
+        }
+        g_mutex_unlock(&gsupplicant_intern_mutex);
+    }
+    return istr;
+}
+
+const char*
+gsupplicant_intern_ref(
+    const char* istr)
+{
+    if (istr) {
+        g_atomic_int_inc(&INTERN_ENTRY(istr)->ref_count);
+    }
+    return istr;
+}
+
+void
+gsupplicant_intern_unref(
+    const char* istr)
+{
+    if (istr) {
+        GSupInternEntry* entry = INTERN_ENTRY(istr);
+
+        /*
+         * The last reference is dropped under the lock, otherwise
+         * gsupplicant_intern() could pick up the entry between the
+         * decrement and the removal.
+         */
+        g_mutex_lock(&gsupplicant_intern_mutex);
+        GASSERT(entry->ref_count > 0);
+        if (g_atomic_int_dec_and_test(&entry->ref_count)) {
+            GASSERT(g_hash_table_lookup(gsupplicant_intern_table, istr) ==
+                entry);
+            g_hash_table_remove(gsupplicant_intern_table, istr);
+            if (g_hash_table_size(gsupplicant_intern_table) == 0) {
+                g_hash_table_unref(gsupplicant_intern_table);
+                gsupplicant_intern_table = NULL;
+            }
+        } else {
+            entry = NULL;
+        }
+        g_mutex_unlock(&gsupplicant_intern_mutex);
+        g_free(entry);
+    }
+}
+
+GStrV*
+gsupplicant_intern_strv(
+    const GStrV* strv)
+{
+    if (strv) {
+        const guint n = g_strv_length((char**)strv);
+        GStrV* out = g_new(char*, n + 1);
+        guint i;
+        for (i = 0; i < n; i++) {
+            out[i] = (char*)gsupplicant_intern(strv[i]);
+        }
+        out[i] = NULL;
+        return out;
+    }
+    return NULL;
+}
+
+void
+gsupplicant_intern_strv_free(
+    GStrV* strv)
+{
+    if (strv) {
+        GStrV* ptr;
+        for (ptr = strv; *ptr; ptr++) {
+            gsupplicant_intern_unref(*ptr);
+        }
+        g_free(strv);
+    }
+}
+
+int
+gsupplicant_intern_strv_find(
+    const GStrV* strv,
+    const char* istr)
+{
+    if (strv && istr) {
+        int i;
+        for (i = 0; strv[i]; i++) {
+            if (strv[i] == istr) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+GStrV*
+gsupplicant_intern_strv_add(
+    GStrV* strv,
+    const char* istr)
+{
+    const guint n = strv ? g_strv_length(strv) : 0;
+    strv = g_renew(char*, strv, n + 2);
+    strv[n] = (char*)gsupplicant_intern_ref(istr);
+    strv[n + 1] = NULL;
+    return strv;
+}
+
+GStrV*
+gsupplicant_intern_strv_remove_at(
+    GStrV* strv,
+    int pos)
+{
+    if (strv && pos >= 0) {
+        const int n = g_strv_length(strv);
+        if (pos < n) {
+            gsupplicant_intern_unref(strv[pos]);
+            memmove(strv + pos, strv + pos + 1, sizeof(char*) * (n - pos));
+        }
+    }
+    return strv;
+}
+
 /*
  * Local Variables:
  * mode: C
@@ -42,6 +42,15 @@ typedef struct gsupplicant_name_int_pair {
     guint value;
 } GSupNameIntPair;
 
+/*
+ * Weak references to the objects, keyed by path, separately for each
+ * main context. Static zero-initialized instances are ready to use.
+ */
+typedef struct gsupplicant_registry {
+    GMutex mutex;
+    GHashTable* contexts;   /* GMainContext* => (path => GObject*) */
+} GSupplicantRegistry;
+
 typedef
 void
 (*GSupplicantDictStrFunc)(
@@ -119,6 +128,7 @@ gsupplicant_name_int_concat(
     gsize count)
     GSUPPLICANT_INTERNAL;
 
+/* The result stays valid until the end of the current dispatch */
 const char*
 gsupplicant_format_bytes(
     GBytes* bytes,
@@ -130,6 +140,26 @@ gsupplicant_cancel_later(
     GCancellable* cancel)
     GSUPPLICANT_INTERNAL;
 
+gboolean
+gsupplicant_proxy_has_owner(
+    gpointer proxy) /* GDBusProxy */
+    GSUPPLICANT_INTERNAL;
+
+/* Zero ids are skipped */
+void
+gsupplicant_block_handlers(
+    gpointer instance,
+    const gulong* ids,
+    guint count)
+    GSUPPLICANT_INTERNAL;
+
+void
+gsupplicant_unblock_handlers(
+    gpointer instance,
+    const gulong* ids,
+    guint count)
+    GSUPPLICANT_INTERNAL;
+
 const char*
 gsupplicant_check_abs_path(
     const char* path)
@@ -214,6 +244,73 @@ gsupplicant_variant_data_as_bytes(
     GVariant* value)
     GSUPPLICANT_INTERNAL;
 
+/* Interned strings */
+
+/* Returns a new reference to the instance bound to the current context */
+gpointer
+gsupplicant_registry_get(
+    GSupplicantRegistry* registry,
+    const char* path)
+    GSUPPLICANT_INTERNAL;
+
+void
+gsupplicant_registry_add(
+    GSupplicantRegistry* registry,
+    const char* ipath,
+    gpointer object)
+    GSUPPLICANT_INTERNAL;
+
+const char*
+gsupplicant_intern(
+    const char* str)
+    GSUPPLICANT_INTERNAL;
+
+const char*
+gsupplicant_intern_find(
+    const char* str)
+    GSUPPLICANT_INTERNAL;
+
+const char*
+gsupplicant_intern_ref(
+    const char* istr)
+    GSUPPLICANT_INTERNAL;
+
+void
+gsupplicant_intern_unref(
+    const char* istr)
+    GSUPPLICANT_INTERNAL;
+
+GStrV*
+gsupplicant_intern_strv(
+    const GStrV* strv)
+    GSUPPLICANT_INTERNAL;
+
+void
+gsupplicant_intern_strv_free(
+    GStrV* strv)
+    GSUPPLICANT_INTERNAL;
+
+int
+gsupplicant_intern_strv_find(
+    const GStrV* strv,
+    const char* istr)
+    GSUPPLICANT_INTERNAL;
+
+GStrV*
+gsupplicant_intern_strv_add(
+    GStrV* strv,
+    const char* istr)
+    GSUPPLICANT_INTERNAL;
+
+GStrV*
+gsupplicant_intern_strv_remove_at(
+    GStrV* strv,
+    int pos)
+    GSUPPLICANT_INTERNAL;
+
+#define gsupplicant_intern_strv_contains(strv, istr) \
+    (gsupplicant_intern_strv_find(strv, istr) >= 0)
+
 #endif /* GSUPPLICANT_UTIL_PRIVATE_H */
 
 /*
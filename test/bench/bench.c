@@ -0,0 +1,484 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * End-to-end benchmarks against the mock supplicant. See test_bench.h
+ * for the output format. The mock runs in the same process, so CPU time
+ * and allocation counts include the mock side of the traffic (but not
+ * the bus daemon).
+ */
+
+#include "test_supplicant_mock.h"
+#include "test_alloc.h"
+#include "test_bench.h"
+
+#include "gsupplicant.h"
+#include "gsupplicant_interface.h"
+#include "gsupplicant_bss.h"
+#include "gsupplicant_network.h"
+
+#include <gutil_log.h>
+#include <gutil_strv.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_TIMEOUT_MS    (30000)
+
+typedef struct bench_opt {
+    guint bsss;
+    guint networks;
+    guint samples;
+    guint duration_ms;
+    guint batch;
+} BenchOpt;
+
+typedef gboolean (*BenchCondFunc)(void* data);
+
+static
+gboolean
+bench_wakeup(
+    gpointer data)
+{
+    gboolean* expired = data;
+    *expired = TRUE;
+    return G_SOURCE_REMOVE;
+}
+
+/* Runs the main loop until the condition is met */
+static
+void
+bench_wait(
+    BenchCondFunc cond,
+    void* data)
+{
+    gboolean expired = FALSE;
+    const guint id = g_timeout_add(BENCH_TIMEOUT_MS, bench_wakeup, &expired);
+    while (!cond(data) && !expired) {
+        g_main_context_iteration(NULL, TRUE);
+    }
+    if (expired) {
+        GERR("Timeout");
+        exit(1);
+    }
+    g_source_remove(id);
+}
+
+static
+int
+bench_compare_gint64(
+    const void* p1,
+    const void* p2)
+{
+    const gint64 v1 = *(const gint64*)p1;
+    const gint64 v2 = *(const gint64*)p2;
+    return (v1 < v2) ? -1 : (v1 > v2) ? 1 : 0;
+}
+
+static
+void
+bench_report_percentiles(
+    const char* bench,
+    gint64* samples_us,
+    guint n)
+{
+    if (n) {
+        qsort(samples_us, n, sizeof(samples_us[0]), bench_compare_gint64);
+        test_bench_report(bench, "p50", samples_us[n/2]/1000.0, "ms", n);
+        test_bench_report(bench, "p90", samples_us[n*9/10]/1000.0, "ms", n);
+        test_bench_report(bench, "p99", samples_us[n*99/100]/1000.0, "ms", n);
+        test_bench_report(bench, "max", samples_us[n-1]/1000.0, "ms", n);
+    }
+}
+
+typedef struct bench_mem {
+    gsize rss;
+    gsize heap;
+    TestAllocStats alloc;
+} BenchMem;
+
+static
+void
+bench_mem_snapshot(
+    BenchMem* mem)
+{
+    mem->rss = test_alloc_rss();
+    mem->heap = test_alloc_heap();
+    test_alloc_get_stats(&mem->alloc);
+}
+
+static
+void
+bench_mem_report(
+    const char* bench,
+    const BenchMem* before,
+    const BenchMem* after,
+    guint n)
+{
+    if (n) {
+        test_bench_report(bench, "rss_per_object",
+            ((double)after->rss - (double)before->rss) / n, "bytes", n);
+        test_bench_report(bench, "heap_per_object",
+            ((double)after->heap - (double)before->heap) / n, "bytes", n);
+        if (test_alloc_supported()) {
+            test_bench_report(bench, "allocs_per_object",
+                (double)(after->alloc.allocs - before->alloc.allocs) / n,
+                "allocs", n);
+        }
+    }
+}
+
+/*==========================================================================*
+ * Conditions
+ *==========================================================================*/
+
+static
+gboolean
+bench_supplicant_valid(
+    void* supplicant)
+{
+    return ((GSupplicant*)supplicant)->valid;
+}
+
+static
+gboolean
+bench_interface_valid(
+    void* iface)
+{
+    return ((GSupplicantInterface*)iface)->valid;
+}
+
+static
+gboolean
+bench_bss_valid(
+    void* bss)
+{
+    return ((GSupplicantBSS*)bss)->valid;
+}
+
+static
+gboolean
+bench_all_bss_valid(
+    void* array)
+{
+    GPtrArray* bsss = array;
+    guint i;
+    for (i = 0; i < bsss->len; i++) {
+        if (!bench_bss_valid(bsss->pdata[i])) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static
+gboolean
+bench_all_networks_valid(
+    void* array)
+{
+    GPtrArray* networks = array;
+    guint i;
+    for (i = 0; i < networks->len; i++) {
+        if (!((GSupplicantNetwork*)networks->pdata[i])->valid) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+typedef struct bench_contains {
+    GSupplicantInterface* iface;
+    const char* path;
+} BenchContains;
+
+static
+gboolean
+bench_interface_has_bss(
+    void* data)
+{
+    BenchContains* contains = data;
+    return gutil_strv_contains(contains->iface->bsss, contains->path);
+}
+
+typedef struct bench_counter {
+    guint count;
+    guint target;
+} BenchCounter;
+
+static
+gboolean
+bench_counter_reached(
+    void* data)
+{
+    BenchCounter* counter = data;
+    return counter->count >= counter->target;
+}
+
+static
+void
+bench_count_event(
+    GSupplicantBSS* bss,
+    void* data)
+{
+    ((BenchCounter*)data)->count++;
+}
+
+/*==========================================================================*
+ * Benchmarks
+ *==========================================================================*/
+
+static
+GSupplicantInterface*
+bench_interface(
+    TestSupplicantMock* mock,
+    const BenchOpt* opt)
+{
+    GSupplicantInterface* iface;
+    const gint64 start = g_get_monotonic_time();
+
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    bench_wait(bench_interface_valid, iface);
+    test_bench_report("interface_valid", "time", (g_get_monotonic_time() -
+        start) / 1000.0, "ms", opt->bsss);
+    return iface;
+}
+
+static
+GPtrArray*
+bench_bss_objects(
+    GSupplicantInterface* iface)
+{
+    GPtrArray* bsss = g_ptr_array_new_with_free_func((GDestroyNotify)
+        gsupplicant_bss_unref);
+    const gint64 start = g_get_monotonic_time();
+    const guint n = gutil_strv_length(iface->bsss);
+    BenchMem before, after;
+    guint i;
+
+    bench_mem_snapshot(&before);
+    for (i = 0; i < n; i++) {
+        g_ptr_array_add(bsss, gsupplicant_bss_new(iface->bsss[i]));
+    }
+    bench_wait(bench_all_bss_valid, bsss);
+    bench_mem_snapshot(&after);
+    test_bench_report("bss_all_valid", "time",
+        (g_get_monotonic_time() - start) / 1000.0, "ms", n);
+    bench_mem_report("bss_memory", &before, &after, n);
+    return bsss;
+}
+
+static
+void
+bench_network_objects(
+    GSupplicantInterface* iface)
+{
+    GPtrArray* networks = g_ptr_array_new_with_free_func((GDestroyNotify)
+        gsupplicant_network_unref);
+    const guint n = gutil_strv_length(iface->networks);
+    BenchMem before, after;
+    guint i;
+
+    bench_mem_snapshot(&before);
+    for (i = 0; i < n; i++) {
+        g_ptr_array_add(networks, gsupplicant_network_new(iface->networks[i]));
+    }
+    bench_wait(bench_all_networks_valid, networks);
+    bench_mem_snapshot(&after);
+    bench_mem_report("network_memory", &before, &after, n);
+    g_ptr_array_free(networks, TRUE);
+}
+
+static
+void
+bench_bss_added(
+    TestSupplicantMock* mock,
+    GSupplicantInterface* iface,
+    const BenchOpt* opt)
+{
+    gint64* samples = g_new(gint64, opt->samples);
+    guint i;
+
+    for (i = 0; i < opt->samples; i++) {
+        const gint64 start = g_get_monotonic_time();
+        BenchContains contains;
+        GSupplicantBSS* bss;
+
+        contains.iface = iface;
+        contains.path = test_supplicant_mock_add_bss(mock, 0);
+        bench_wait(bench_interface_has_bss, &contains);
+        bss = gsupplicant_bss_new(contains.path);
+        bench_wait(bench_bss_valid, bss);
+        samples[i] = g_get_monotonic_time() - start;
+        gsupplicant_bss_unref(bss);
+        test_supplicant_mock_remove_bss(mock, contains.path);
+    }
+    bench_report_percentiles("bss_added_to_valid", samples, opt->samples);
+    g_free(samples);
+}
+
+static
+void
+bench_events(
+    TestSupplicantMock* mock,
+    GPtrArray* bsss,
+    const BenchOpt* opt)
+{
+    const gint64 start = g_get_monotonic_time();
+    const gint64 cpu_start = test_bench_cpu_ns();
+    const gint64 deadline = start + (gint64)opt->duration_ms * 1000;
+    const guint batch = MIN(opt->batch, bsss->len);
+    gulong* ids = g_new(gulong, bsss->len);
+    BenchCounter counter;
+    BenchMem before, after;
+    guint i, pos = 0;
+    gint16 signal = -40;
+    gint64 cpu;
+
+    memset(&counter, 0, sizeof(counter));
+    for (i = 0; i < bsss->len; i++) {
+        ids[i] = gsupplicant_bss_add_handler(bsss->pdata[i],
+            GSUPPLICANT_BSS_PROPERTY_SIGNAL, bench_count_event, &counter);
+    }
+    bench_mem_snapshot(&before);
+    while (batch && g_get_monotonic_time() < deadline) {
+        signal = (signal <= -90) ? -40 : (signal - 1);
+        for (i = 0; i < batch; i++) {
+            GSupplicantBSS* bss = bsss->pdata[(pos++) % bsss->len];
+            test_supplicant_mock_set_bss_signal(mock, bss->path, signal);
+        }
+        counter.target += batch;
+        bench_wait(bench_counter_reached, &counter);
+    }
+    cpu = test_bench_cpu_ns() - cpu_start;
+    bench_mem_snapshot(&after);
+    for (i = 0; i < bsss->len; i++) {
+        gsupplicant_bss_remove_handler(bsss->pdata[i], ids[i]);
+    }
+    g_free(ids);
+    if (cpu > 0) {
+        test_bench_report("properties_changed", "events_per_cpu_second",
+            counter.count * 1e9 / cpu, "events/s", counter.count);
+    }
+    if (counter.count && test_alloc_supported()) {
+        test_bench_report("properties_changed", "allocs_per_event",
+            (double)(after.alloc.allocs - before.alloc.allocs) /
+            counter.count, "allocs", counter.count);
+    }
+}
+
+/*==========================================================================*
+ * Main
+ *==========================================================================*/
+
+int main(int argc, char* argv[])
+{
+    BenchOpt opt;
+    gboolean verbose = FALSE;
+    GOptionEntry entries[] = {
+        { "bsss", 'b', 0, G_OPTION_ARG_INT, &opt.bsss,
+          "Number of BSSs [100]", "N" },
+        { "networks", 'n', 0, G_OPTION_ARG_INT, &opt.networks,
+          "Number of networks [20]", "N" },
+        { "samples", 's', 0, G_OPTION_ARG_INT, &opt.samples,
+          "Number of latency samples [200]", "N" },
+        { "duration", 't', 0, G_OPTION_ARG_INT, &opt.duration_ms,
+          "Duration of the throughput test [2000]", "MS" },
+        { "batch", 'B', 0, G_OPTION_ARG_INT, &opt.batch,
+          "Updates per throughput round [20]", "N" },
+        { "verbose", 'v', 0, G_OPTION_ARG_NONE, &verbose,
+          "Enable verbose log", NULL },
+        { NULL }
+    };
+    GOptionContext* options;
+    GError* error = NULL;
+    int ret = 1;
+
+    memset(&opt, 0, sizeof(opt));
+    opt.bsss = 100;
+    opt.networks = 20;
+    opt.samples = 200;
+    opt.duration_ms = 2000;
+    opt.batch = 20;
+
+    options = g_option_context_new(NULL);
+    g_option_context_add_main_entries(options, entries, NULL);
+    if (g_option_context_parse(options, &argc, &argv, &error)) {
+        TestSupplicantMockConfig config;
+        TestSupplicantMock* mock;
+        GSupplicant* supplicant;
+        GSupplicantInterface* iface;
+        GPtrArray* bsss;
+        gint64 start;
+
+        gutil_log_timestamp = FALSE;
+        gutil_log_default.level = verbose ? GLOG_LEVEL_VERBOSE :
+            GLOG_LEVEL_ERR;
+
+        memset(&config, 0, sizeof(config));
+        config.interfaces = 1;
+        config.bsss = opt.bsss;
+        config.networks = opt.networks;
+        mock = test_supplicant_mock_new(&config);
+
+        start = g_get_monotonic_time();
+        supplicant = gsupplicant_new();
+        bench_wait(bench_supplicant_valid, supplicant);
+        test_bench_report("supplicant_valid", "time", (g_get_monotonic_time() -
+            start) / 1000.0, "ms", 1);
+
+        iface = bench_interface(mock, &opt);
+        bsss = bench_bss_objects(iface);
+        bench_network_objects(iface);
+        bench_bss_added(mock, iface, &opt);
+        bench_events(mock, bsss, &opt);
+
+        g_ptr_array_free(bsss, TRUE);
+        gsupplicant_interface_unref(iface);
+        gsupplicant_unref(supplicant);
+        test_supplicant_mock_free(mock);
+        test_supplicant_mock_shutdown();
+        ret = 0;
+    } else {
+        fprintf(stderr, "%s\n", GERRMSG(error));
+        g_error_free(error);
+    }
+    g_option_context_free(options);
+    return ret;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Microbenchmarks for the util layer. Each case runs the function on
+ * representative input and reports ns/op and allocs/op, see test_bench.h
+ * for the output format. Allocation counts are only available on glibc.
+ */
+
+#include "test_alloc.h"
+#include "test_bench.h"
+
+#include "gsupplicant_p.h"
+#include "gsupplicant_util_p.h"
+
+#include <gutil_log.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_DEFAULT_ITERATIONS (100000)
+
+/* Same as the EAP method table in gsupplicant.c */
+static const GSupNameIntPair bench_eap_methods [] = {
+    { "MD5",            GSUPPLICANT_EAP_METHOD_MD5 },
+    { "TLS",            GSUPPLICANT_EAP_METHOD_TLS },
+    { "MSCHAPV2",       GSUPPLICANT_EAP_METHOD_MSCHAPV2 },
+    { "PEAP",           GSUPPLICANT_EAP_METHOD_PEAP },
+    { "TTLS",           GSUPPLICANT_EAP_METHOD_TTLS },
+    { "GTC",            GSUPPLICANT_EAP_METHOD_GTC },
+    { "OTP",            GSUPPLICANT_EAP_METHOD_OTP },
+    { "SIM",            GSUPPLICANT_EAP_METHOD_SIM },
+    { "LEAP",           GSUPPLICANT_EAP_METHOD_LEAP },
+    { "PSK",            GSUPPLICANT_EAP_METHOD_PSK },
+    { "AKA",            GSUPPLICANT_EAP_METHOD_AKA },
+    { "FAST",           GSUPPLICANT_EAP_METHOD_FAST },
+    { "PAX",            GSUPPLICANT_EAP_METHOD_PAX },
+    { "SAKE",           GSUPPLICANT_EAP_METHOD_SAKE },
+    { "GPSK",           GSUPPLICANT_EAP_METHOD_GPSK },
+    { "WSC",            GSUPPLICANT_EAP_METHOD_WSC },
+    { "IKEV2",          GSUPPLICANT_EAP_METHOD_IKEV2 },
+    { "TNC",            GSUPPLICANT_EAP_METHOD_TNC },
+    { "PWD",            GSUPPLICANT_EAP_METHOD_PWD }
+};
+
+/* EapMethods capability as reported by a typical wpa_supplicant build */
+static const char* bench_eap_caps [] = {
+    "MD5", "TLS", "MSCHAPV2", "PEAP", "TTLS", "GTC", "OTP", "SIM",
+    "LEAP", "PSK", "AKA", "AKA'", "FAST", "PAX", "SAKE", "GPSK", "WSC",
+    "IKEV2", "TNC", "PWD", NULL
+};
+
+/* KeyMgmt capability */
+static const char* bench_keymgmt_caps [] = {
+    "none", "ieee8021x", "wpa-eap", "wpa-ft-eap", "wpa-eap-sha256",
+    "wpa-psk", "wpa-ft-psk", "wpa-psk-sha256", "wps", "sae", "ft-sae",
+    NULL
+};
+
+typedef struct bench_data {
+    GVariant* eap_caps;
+    GVariant* keymgmt_caps;
+    GVariant* rsn;
+    GBytes* ssid;
+    GBytes* ies;
+    guint count;
+    guint mask;
+} BenchData;
+
+static
+GVariant*
+bench_strv_variant(
+    const char* const* strv)
+{
+    return g_variant_ref_sink(g_variant_new_strv(strv, -1));
+}
+
+static
+GVariant*
+bench_rsn_variant(
+    void)
+{
+    static const char* keymgmt[] = { "wpa-psk", "sae", NULL };
+    static const char* pairwise[] = { "ccmp", NULL };
+    GVariantBuilder builder;
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_add(&builder, "{sv}", "KeyMgmt",
+        g_variant_new_strv(keymgmt, -1));
+    g_variant_builder_add(&builder, "{sv}", "Pairwise",
+        g_variant_new_strv(pairwise, -1));
+    g_variant_builder_add(&builder, "{sv}", "Group",
+        g_variant_new_string("ccmp"));
+    g_variant_builder_add(&builder, "{sv}", "MgmtGroup",
+        g_variant_new_string("aes128cmac"));
+    return g_variant_ref_sink(g_variant_builder_end(&builder));
+}
+
+static
+GBytes*
+bench_ssid_bytes(
+    void)
+{
+    /* 32 bytes, with invalid UTF-8 sequences in the middle */
+    static const guint8 ssid[32] = {
+        'G', 'u', 'e', 's', 't', ' ', 0xc3, 0xa4, 0xff, 0xfe, 'W', 'i',
+        'F', 'i', ' ', 0xe2, 0x82, ' ', '5', 'G', 0x80, 0xbf, '-', 'a',
+        'b', 'c', 'd', 'e', 0xc0, 0xaf, '!', '!'
+    };
+    return g_bytes_new_static(ssid, sizeof(ssid));
+}
+
+static
+GBytes*
+bench_ies_bytes(
+    void)
+{
+    guint8* ies = g_malloc(300);
+    guint i;
+
+    for (i = 0; i < 300; i++) {
+        ies[i] = (guint8)(i * 37 + 11);
+    }
+    return g_bytes_new_take(ies, 300);
+}
+
+static
+void
+bench_flush_idle(
+    void)
+{
+    /* Let gsupplicant_format_bytes() free its buffers */
+    while (g_main_context_iteration(NULL, FALSE));
+}
+
+/*==========================================================================*
+ * Cases
+ *==========================================================================*/
+
+static
+void
+bench_parse_bits_array_eap(
+    void* data)
+{
+    BenchData* bench = data;
+
+    bench->mask ^= gsupplicant_parse_bits_array(0, "EapMethods",
+        bench->eap_caps, bench_eap_methods, G_N_ELEMENTS(bench_eap_methods));
+}
+
+static
+void
+bench_parse_keymgmt_list(
+    void* data)
+{
+    BenchData* bench = data;
+
+    bench->mask ^= gsupplicant_parse_keymgmt_list("KeyMgmt",
+        bench->keymgmt_caps);
+}
+
+static
+void
+bench_name_int_find_name(
+    void* data)
+{
+    BenchData* bench = data;
+
+    /* Last entry, worst case for the linear search */
+    bench->mask ^= gsupplicant_name_int_find_name("PWD", bench_eap_methods,
+        G_N_ELEMENTS(bench_eap_methods))->value;
+}
+
+static
+void
+bench_name_int_find_name_i(
+    void* data)
+{
+    BenchData* bench = data;
+
+    bench->mask ^= gsupplicant_name_int_find_name_i("pwd", bench_eap_methods,
+        G_N_ELEMENTS(bench_eap_methods))->value;
+}
+
+static
+void
+bench_name_int_find_bit(
+    void* data)
+{
+    BenchData* bench = data;
+    guint mask = GSUPPLICANT_EAP_METHOD_MD5 | GSUPPLICANT_EAP_METHOD_PEAP |
+        GSUPPLICANT_EAP_METHOD_PWD;
+    guint bit;
+
+    /* The way capabilities are enumerated, one bit at a time */
+    while (gsupplicant_name_int_find_bit(mask, &bit, bench_eap_methods,
+        G_N_ELEMENTS(bench_eap_methods))) {
+        bench->mask ^= bit;
+        mask &= ~bit;
+    }
+}
+
+static
+void
+bench_name_int_concat(
+    void* data)
+{
+    BenchData* bench = data;
+
+    g_free(gsupplicant_name_int_concat(GSUPPLICANT_EAP_METHOD_PEAP |
+        GSUPPLICANT_EAP_METHOD_TTLS | GSUPPLICANT_EAP_METHOD_TLS, ' ',
+        bench_eap_methods, G_N_ELEMENTS(bench_eap_methods)));
+    bench->count++;
+}
+
+static
+void
+bench_dict_parse_rsn_cb(
+    const char* name,
+    GVariant* value,
+    void* data)
+{
+    BenchData* bench = data;
+
+    if (!g_strcmp0(name, "KeyMgmt")) {
+        bench->mask ^= gsupplicant_parse_keymgmt_list(name, value);
+    } else if (!g_strcmp0(name, "Pairwise")) {
+        bench->mask ^= gsupplicant_parse_cipher_list(name, value);
+    } else {
+        bench->mask ^= gsupplicant_parse_cipher_value(name, value);
+    }
+}
+
+static
+void
+bench_dict_parse_rsn(
+    void* data)
+{
+    BenchData* bench = data;
+
+    bench->count += gsupplicant_dict_parse(bench->rsn,
+        bench_dict_parse_rsn_cb, bench);
+}
+
+static
+void
+bench_utf8_from_bytes(
+    void* data)
+{
+    BenchData* bench = data;
+
+    g_free(gsupplicant_utf8_from_bytes(bench->ssid));
+    bench->count++;
+}
+
+static
+void
+bench_format_bytes_ssid(
+    void* data)
+{
+    BenchData* bench = data;
+
+    bench->count += strlen(gsupplicant_format_bytes(bench->ssid, TRUE));
+    if (!(bench->count & 0xff)) bench_flush_idle();
+}
+
+static
+void
+bench_format_bytes_ies(
+    void* data)
+{
+    BenchData* bench = data;
+
+    bench->count += strlen(gsupplicant_format_bytes(bench->ies, FALSE));
+    bench_flush_idle();
+}
+
+/*==========================================================================*
+ * Main
+ *==========================================================================*/
+
+int main(int argc, char* argv[])
+{
+    gint iterations = BENCH_DEFAULT_ITERATIONS;
+    gboolean verbose = FALSE;
+    GError* error = NULL;
+    GOptionContext* options;
+    GOptionEntry entries[] = {
+        { "iterations", 'n', 0, G_OPTION_ARG_INT, &iterations,
+          "Iterations per case [100000]", "N" },
+        { "verbose", 'v', 0, G_OPTION_ARG_NONE, &verbose,
+          "Enable verbose log (slows things down)", NULL },
+        { NULL }
+    };
+    int ret = 1;
+
+    options = g_option_context_new("- util layer microbenchmarks");
+    g_option_context_add_main_entries(options, entries, NULL);
+    if (g_option_context_parse(options, &argc, &argv, &error) &&
+        iterations > 0) {
+        BenchData bench;
+        const guint n = iterations;
+
+        gutil_log_timestamp = FALSE;
+        gutil_log_default.level = verbose ? GLOG_LEVEL_VERBOSE :
+            GLOG_LEVEL_NONE;
+        memset(&bench, 0, sizeof(bench));
+        bench.eap_caps = bench_strv_variant(bench_eap_caps);
+        bench.keymgmt_caps = bench_strv_variant(bench_keymgmt_caps);
+        bench.rsn = bench_rsn_variant();
+        bench.ssid = bench_ssid_bytes();
+        bench.ies = bench_ies_bytes();
+
+        test_bench_run("parse_bits_array_eap", bench_parse_bits_array_eap,
+            &bench, n);
+        test_bench_run("parse_keymgmt_list", bench_parse_keymgmt_list,
+            &bench, n);
+        test_bench_run("name_int_find_name", bench_name_int_find_name,
+            &bench, n);
+        test_bench_run("name_int_find_name_i", bench_name_int_find_name_i,
+            &bench, n);
+        test_bench_run("name_int_find_bit", bench_name_int_find_bit,
+            &bench, n);
+        test_bench_run("name_int_concat", bench_name_int_concat,
+            &bench, n);
+        test_bench_run("dict_parse_rsn", bench_dict_parse_rsn,
+            &bench, n);
+        test_bench_run("utf8_from_bytes_ssid", bench_utf8_from_bytes,
+            &bench, n);
+        test_bench_run("format_bytes_ssid", bench_format_bytes_ssid,
+            &bench, n);
+        test_bench_run("format_bytes_ies", bench_format_bytes_ies,
+            &bench, n);
+        bench_flush_idle();
+
+        /* Keep the compiler from optimizing the results away */
+        GDEBUG("%u %u", bench.count, bench.mask);
+        g_variant_unref(bench.eap_caps);
+        g_variant_unref(bench.keymgmt_caps);
+        g_variant_unref(bench.rsn);
+        g_bytes_unref(bench.ssid);
+        g_bytes_unref(bench.ies);
+        ret = 0;
+    } else {
+        fprintf(stderr, "%s\n", error ? GERRMSG(error) :
+            "Invalid number of iterations");
+        if (error) g_error_free(error);
+    }
+    g_option_context_free(options);
+    return ret;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
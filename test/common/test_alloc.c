@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "test_alloc.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#ifdef __GLIBC__
+#  include <malloc.h>
+#  define TEST_ALLOC_INTERPOSE 1
+#else
+#  define TEST_ALLOC_INTERPOSE 0
+#endif
+
+#if TEST_ALLOC_INTERPOSE
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t n, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+static guint64 test_alloc_count = 0;
+static guint64 test_alloc_free_count = 0;
+static guint64 test_alloc_bytes = 0;
+
+#define TEST_ALLOC_INC(var,n) __atomic_add_fetch(&(var), n, __ATOMIC_RELAXED)
+
+void*
+malloc(
+    size_t size)
+{
+    TEST_ALLOC_INC(test_alloc_count, 1);
+    TEST_ALLOC_INC(test_alloc_bytes, size);
+    return __libc_malloc(size);
+}
+
+void*
+calloc(
+    size_t n,
+    size_t size)
+{
+    TEST_ALLOC_INC(test_alloc_count, 1);
+    TEST_ALLOC_INC(test_alloc_bytes, n * size);
+    return __libc_calloc(n, size);
+}
+
+void*
+realloc(
+    void* ptr,
+    size_t size)
+{
+    TEST_ALLOC_INC(test_alloc_count, 1);
+    TEST_ALLOC_INC(test_alloc_bytes, size);
+    if (ptr) {
+        TEST_ALLOC_INC(test_alloc_free_count, 1);
+    }
+    return __libc_realloc(ptr, size);
+}
+
+void
+free(
+    void* ptr)
+{
+    if (ptr) {
+        TEST_ALLOC_INC(test_alloc_free_count, 1);
+        __libc_free(ptr);
+    }
+}
+
+#endif /* TEST_ALLOC_INTERPOSE */
+
+gboolean
+test_alloc_supported(
+    void)
+{
+    return TEST_ALLOC_INTERPOSE;
+}
+
+void
+test_alloc_get_stats(
+    TestAllocStats* stats)
+{
+#if TEST_ALLOC_INTERPOSE
+    stats->allocs = __atomic_load_n(&test_alloc_count, __ATOMIC_RELAXED);
+    stats->frees = __atomic_load_n(&test_alloc_free_count, __ATOMIC_RELAXED);
+    stats->bytes = __atomic_load_n(&test_alloc_bytes, __ATOMIC_RELAXED);
+#else
+    memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+gsize
+test_alloc_rss(
+    void)
+{
+    gsize rss = 0;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (f) {
+        unsigned long size, resident;
+        if (fscanf(f, "%lu %lu", &size, &resident) == 2) {
+            rss = (gsize)resident * sysconf(_SC_PAGESIZE);
+        }
+        fclose(f);
+    }
+    return rss;
+}
+
+gsize
+test_alloc_heap(
+    void)
+{
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2,33)
+    return mallinfo2().uordblks;
+#elif defined(__GLIBC__)
+    return (unsigned int)mallinfo().uordblks;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
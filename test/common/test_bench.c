@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "test_bench.h"
+#include "test_alloc.h"
+
+#include <stdio.h>
+#include <time.h>
+
+void
+test_bench_report(
+    const char* bench,
+    const char* metric,
+    double value,
+    const char* unit,
+    guint n)
+{
+    printf("{\"bench\":\"%s\",\"metric\":\"%s\",\"value\":%.3f,"
+        "\"unit\":\"%s\",\"n\":%u}\n", bench, metric, value, unit, n);
+    fflush(stdout);
+}
+
+gint64
+test_bench_cpu_ns(
+    void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (gint64)ts.tv_sec * G_GINT64_CONSTANT(1000000000) + ts.tv_nsec;
+}
+
+void
+test_bench_run(
+    const char* bench,
+    TestBenchFunc fn,
+    void* data,
+    guint iterations)
+{
+    TestAllocStats before, after;
+    gint64 start, elapsed;
+    guint i;
+
+    /* Warm up */
+    for (i = 0; i < MIN(iterations, 100); i++) {
+        fn(data);
+    }
+    test_alloc_get_stats(&before);
+    start = test_bench_cpu_ns();
+    for (i = 0; i < iterations; i++) {
+        fn(data);
+    }
+    elapsed = test_bench_cpu_ns() - start;
+    test_alloc_get_stats(&after);
+    if (iterations) {
+        test_bench_report(bench, "time", (double)elapsed / iterations,
+            "ns/op", iterations);
+        if (test_alloc_supported()) {
+            test_bench_report(bench, "allocs", (double)(after.allocs -
+                before.allocs) / iterations, "allocs/op", iterations);
+        }
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
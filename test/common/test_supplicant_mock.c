@@ -0,0 +1,1664 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "test_supplicant_mock.h"
+
+#include <gutil_log.h>
+#include <gutil_misc.h>
+
+#include <gio/gio.h>
+
+#ifndef TEST_SPEC_DIR
+#  define TEST_SPEC_DIR "../../spec"
+#endif
+
+#define MOCK_SERVICE            "fi.w1.wpa_supplicant1"
+#define MOCK_PATH               "/fi/w1/wpa_supplicant1"
+#define MOCK_ERROR_PREFIX       "fi.w1.wpa_supplicant1."
+
+#define MOCK_IFACE_ROOT         "fi.w1.wpa_supplicant1"
+#define MOCK_IFACE_INTERFACE    "fi.w1.wpa_supplicant1.Interface"
+#define MOCK_IFACE_WPS          "fi.w1.wpa_supplicant1.Interface.WPS"
+#define MOCK_IFACE_BSS          "fi.w1.wpa_supplicant1.BSS"
+#define MOCK_IFACE_NETWORK      "fi.w1.wpa_supplicant1.Network"
+
+#define DBUS_PROPERTIES_INTERFACE "org.freedesktop.DBus.Properties"
+#define DBUS_PROPERTIES_CHANGED "PropertiesChanged"
+
+typedef enum test_mock_spec {
+    MOCK_SPEC_ROOT,
+    MOCK_SPEC_INTERFACE,
+    MOCK_SPEC_WPS,
+    MOCK_SPEC_BSS,
+    MOCK_SPEC_NETWORK,
+    MOCK_SPEC_COUNT
+} MOCK_SPEC;
+
+static const char* test_mock_spec_names[] = {
+    MOCK_IFACE_ROOT,
+    MOCK_IFACE_INTERFACE,
+    MOCK_IFACE_WPS,
+    MOCK_IFACE_BSS,
+    MOCK_IFACE_NETWORK
+};
+
+G_STATIC_ASSERT(G_N_ELEMENTS(test_mock_spec_names) == MOCK_SPEC_COUNT);
+
+typedef struct test_mock_object {
+    TestSupplicantMock* mock;
+    gpointer owner;
+    char* path;
+    GDBusInterfaceInfo* info;
+    GHashTable* props;          /* Property name => GVariant */
+    GPtrArray* changed;         /* Names of changed properties */
+    guint reg_id;
+} TestMockObject;
+
+typedef struct test_mock_interface {
+    TestSupplicantMock* mock;
+    TestMockObject* obj;
+    TestMockObject* wps;
+    char* ifname;
+    GPtrArray* bsss;            /* TestMockObject */
+    GPtrArray* networks;        /* TestMockObject */
+    GPtrArray* scans;           /* Arguments of the Scan calls (a{sv}) */
+    guint next_bss_id;
+    guint next_network_id;
+    guint scan_id;
+    guint roam_id;
+    char* roam_bss;             /* Path of the roam target */
+} TestMockInterface;
+
+typedef struct test_mock_method {
+    guint delay_ms;
+    gboolean delay_set;
+    char* error;
+} TestMockMethod;
+
+typedef struct test_mock_call {
+    TestSupplicantMock* mock;
+    TestMockObject* obj;
+    GDBusMethodInvocation* invocation;
+    guint timeout_id;
+} TestMockCall;
+
+struct test_supplicant_mock {
+    TestSupplicantMockConfig config;
+    GDBusConnection* conn;
+    GDBusNodeInfo* spec[MOCK_SPEC_COUNT];
+    TestMockObject* root;
+    GPtrArray* ifaces;          /* TestMockInterface */
+    GHashTable* bsss;           /* Path => TestMockObject */
+    GHashTable* methods;        /* Name => TestMockMethod */
+    GSList* calls;              /* Delayed calls */
+    GRand* rand;
+    guint default_delay_ms;
+    guint next_iface_id;
+    guint next_bssid;
+    guint churn_id;
+    guint update_id;
+    guint update_pos;
+    guint64 signals;
+    guint64 method_calls;
+};
+
+static GTestDBus* test_mock_bus = NULL;
+
+static
+void
+test_mock_method_call(
+    GDBusConnection* connection,
+    const char* sender,
+    const char* path,
+    const char* iface,
+    const char* method,
+    GVariant* params,
+    GDBusMethodInvocation* invocation,
+    gpointer user_data);
+
+static
+GVariant*
+test_mock_get_property(
+    GDBusConnection* connection,
+    const char* sender,
+    const char* path,
+    const char* iface,
+    const char* name,
+    GError** error,
+    gpointer user_data);
+
+static
+gboolean
+test_mock_set_property(
+    GDBusConnection* connection,
+    const char* sender,
+    const char* path,
+    const char* iface,
+    const char* name,
+    GVariant* value,
+    GError** error,
+    gpointer user_data);
+
+static const GDBusInterfaceVTable test_mock_vtable = {
+    test_mock_method_call,
+    test_mock_get_property,
+    test_mock_set_property
+};
+
+/*==========================================================================*
+ * Objects
+ *==========================================================================*/
+
+static
+GVariant*
+test_mock_default_value(
+    const char* signature)
+{
+    const GVariantType* type = G_VARIANT_TYPE(signature);
+    if (g_variant_type_is_array(type)) {
+        return g_variant_new_array(g_variant_type_element(type), NULL, 0);
+    }
+    switch (signature[0]) {
+    case 'b': return g_variant_new_boolean(FALSE);
+    case 'y': return g_variant_new_byte(0);
+    case 'n': return g_variant_new_int16(0);
+    case 'q': return g_variant_new_uint16(0);
+    case 'i': return g_variant_new_int32(0);
+    case 'u': return g_variant_new_uint32(0);
+    case 'x': return g_variant_new_int64(0);
+    case 't': return g_variant_new_uint64(0);
+    case 'd': return g_variant_new_double(0);
+    case 's': return g_variant_new_string("");
+    case 'o': return g_variant_new_object_path("/");
+    case 'v': return g_variant_new_variant(g_variant_new_string(""));
+    }
+    GWARN("Unsupported signature %s", signature);
+    return NULL;
+}
+
+static
+GVariant*
+test_mock_bytes_value(
+    const void* data,
+    gsize size)
+{
+    return g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, data, size, 1);
+}
+
+static
+void
+test_mock_emit(
+    TestSupplicantMock* mock,
+    const char* path,
+    const char* iface,
+    const char* name,
+    GVariant* args)
+{
+    g_dbus_connection_emit_signal(mock->conn, NULL, path, iface, name,
+        args, NULL);
+    mock->signals++;
+}
+
+static
+TestMockObject*
+test_mock_object_new(
+    TestSupplicantMock* mock,
+    MOCK_SPEC spec,
+    const char* path,
+    gpointer owner)
+{
+    TestMockObject* obj = g_slice_new0(TestMockObject);
+    GDBusInterfaceInfo* info = g_dbus_node_info_lookup_interface
+        (mock->spec[spec], test_mock_spec_names[spec]);
+    GDBusPropertyInfo** prop;
+    GError* error = NULL;
+
+    obj->mock = mock;
+    obj->owner = owner;
+    obj->path = g_strdup(path);
+    obj->info = info;
+    obj->changed = g_ptr_array_new();
+    obj->props = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+        (GDestroyNotify)g_variant_unref);
+    for (prop = info->properties; prop && *prop; prop++) {
+        GVariant* value = test_mock_default_value((*prop)->signature);
+        if (value) {
+            g_hash_table_insert(obj->props, (*prop)->name,
+                g_variant_ref_sink(value));
+        }
+    }
+    obj->reg_id = g_dbus_connection_register_object(mock->conn, path, info,
+        &test_mock_vtable, obj, NULL, &error);
+    if (!obj->reg_id) {
+        GERR("%s", GERRMSG(error));
+        g_error_free(error);
+    }
+    return obj;
+}
+
+static
+void
+test_mock_object_free(
+    TestMockObject* obj)
+{
+    TestSupplicantMock* mock = obj->mock;
+    GSList* l = mock->calls;
+
+    /* Fail the calls which are still pending */
+    while (l) {
+        TestMockCall* call = l->data;
+        l = l->next;
+        if (call->obj == obj) {
+            mock->calls = g_slist_remove(mock->calls, call);
+            g_source_remove(call->timeout_id);
+            g_dbus_method_invocation_return_dbus_error(call->invocation,
+                "org.freedesktop.DBus.Error.UnknownObject", obj->path);
+            g_slice_free(TestMockCall, call);
+        }
+    }
+    if (obj->reg_id) {
+        g_dbus_connection_unregister_object(mock->conn, obj->reg_id);
+    }
+    g_hash_table_destroy(obj->props);
+    g_ptr_array_free(obj->changed, TRUE);
+    g_free(obj->path);
+    g_slice_free(TestMockObject, obj);
+}
+
+static
+GVariant*
+test_mock_object_get(
+    TestMockObject* obj,
+    const char* name)
+{
+    return g_hash_table_lookup(obj->props, name);
+}
+
+/* Changes are emitted by test_mock_object_emit_changed() */
+static
+void
+test_mock_object_set(
+    TestMockObject* obj,
+    const char* name,
+    GVariant* value)
+{
+    GDBusPropertyInfo* prop = g_dbus_interface_info_lookup_property
+        (obj->info, name);
+    guint i;
+
+    g_assert(prop);
+    g_assert(g_variant_is_of_type(value, G_VARIANT_TYPE(prop->signature)));
+    g_hash_table_insert(obj->props, prop->name, g_variant_ref_sink(value));
+    for (i = 0; i < obj->changed->len; i++) {
+        if (obj->changed->pdata[i] == prop->name) {
+            return;
+        }
+    }
+    g_ptr_array_add(obj->changed, prop->name);
+}
+
+static
+GVariant*
+test_mock_object_dict(
+    TestMockObject* obj,
+    GPtrArray* names)
+{
+    GVariantBuilder builder;
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+    if (names) {
+        guint i;
+        for (i = 0; i < names->len; i++) {
+            const char* name = names->pdata[i];
+            g_variant_builder_add(&builder, "{sv}", name,
+                test_mock_object_get(obj, name));
+        }
+    } else {
+        GHashTableIter it;
+        gpointer key, value;
+        g_hash_table_iter_init(&it, obj->props);
+        while (g_hash_table_iter_next(&it, &key, &value)) {
+            g_variant_builder_add(&builder, "{sv}", key, value);
+        }
+    }
+    return g_variant_builder_end(&builder);
+}
+
+static
+void
+test_mock_object_emit_changed(
+    TestMockObject* obj)
+{
+    if (obj->changed->len) {
+        TestSupplicantMock* mock = obj->mock;
+        GVariant* dict = g_variant_ref_sink(test_mock_object_dict(obj,
+            obj->changed));
+        test_mock_emit(mock, obj->path, DBUS_PROPERTIES_INTERFACE,
+            DBUS_PROPERTIES_CHANGED, g_variant_new("(s@a{sv}@as)",
+            obj->info->name, dict, g_variant_new_strv(NULL, 0)));
+        if (mock->config.legacy_signals) {
+            test_mock_emit(mock, obj->path, obj->info->name,
+                DBUS_PROPERTIES_CHANGED, g_variant_new("(@a{sv})", dict));
+        }
+        g_variant_unref(dict);
+        g_ptr_array_set_size(obj->changed, 0);
+    }
+}
+
+static
+GVariant*
+test_mock_paths_value(
+    GPtrArray* objs)
+{
+    GVariantBuilder builder;
+    guint i;
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_OBJECT_PATH_ARRAY);
+    for (i = 0; i < objs->len; i++) {
+        const TestMockObject* obj = objs->pdata[i];
+        g_variant_builder_add(&builder, "o", obj->path);
+    }
+    return g_variant_builder_end(&builder);
+}
+
+static
+int
+test_mock_find_path(
+    GPtrArray* objs,
+    const char* path)
+{
+    guint i;
+    for (i = 0; i < objs->len; i++) {
+        const TestMockObject* obj = objs->pdata[i];
+        if (!g_strcmp0(obj->path, path)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static
+TestMockObject*
+test_mock_find_object(
+    TestSupplicantMock* mock,
+    const char* path,
+    const char* name)
+{
+    TestMockObject* obj = g_hash_table_lookup(mock->bsss, path);
+    guint i;
+
+    if (obj) {
+        return obj;
+    } else if (!g_strcmp0(mock->root->path, path)) {
+        return mock->root;
+    }
+    for (i = 0; i < mock->ifaces->len; i++) {
+        TestMockInterface* iface = mock->ifaces->pdata[i];
+        if (!g_strcmp0(iface->obj->path, path)) {
+            /* The WPS object sits at the same path */
+            return g_dbus_interface_info_lookup_property(iface->obj->info,
+                name) ? iface->obj : iface->wps;
+        } else {
+            const int pos = test_mock_find_path(iface->networks, path);
+            if (pos >= 0) {
+                return iface->networks->pdata[pos];
+            }
+        }
+    }
+    return NULL;
+}
+
+/*==========================================================================*
+ * BSSs and networks
+ *==========================================================================*/
+
+static
+TestMockObject*
+test_mock_bss_new(
+    TestMockInterface* iface)
+{
+    TestSupplicantMock* mock = iface->mock;
+    const guint id = iface->next_bss_id++;
+    const guint bssid_id = mock->next_bssid++;
+    char* path = g_strdup_printf("%s/BSSs/%u", iface->obj->path, id);
+    TestMockObject* obj = test_mock_object_new(mock, MOCK_SPEC_BSS,
+        path, iface);
+    char* ssid = g_strdup_printf("mock-%u", id);
+    static const guint32 rates[] = { 54000000, 24000000, 11000000 };
+    const char* keymgmt[] = { "wpa-psk", NULL };
+    const char* pairwise[] = { "ccmp", NULL };
+    guint8 bssid[6];
+    GVariantBuilder rsn;
+
+    bssid[0] = 0x02;
+    bssid[1] = 0x00;
+    bssid[2] = (guint8)(bssid_id >> 24);
+    bssid[3] = (guint8)(bssid_id >> 16);
+    bssid[4] = (guint8)(bssid_id >> 8);
+    bssid[5] = (guint8)bssid_id;
+
+    g_variant_builder_init(&rsn, G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_add(&rsn, "{sv}", "KeyMgmt",
+        g_variant_new_strv(keymgmt, -1));
+    g_variant_builder_add(&rsn, "{sv}", "Pairwise",
+        g_variant_new_strv(pairwise, -1));
+    g_variant_builder_add(&rsn, "{sv}", "Group",
+        g_variant_new_string("ccmp"));
+
+    test_mock_object_set(obj, "SSID", test_mock_bytes_value(ssid,
+        strlen(ssid)));
+    test_mock_object_set(obj, "BSSID", test_mock_bytes_value(bssid,
+        sizeof(bssid)));
+    test_mock_object_set(obj, "Privacy", g_variant_new_boolean(TRUE));
+    test_mock_object_set(obj, "Mode", g_variant_new_string("infrastructure"));
+    test_mock_object_set(obj, "Signal", g_variant_new_int16(-30 -
+        g_rand_int_range(mock->rand, 0, 60)));
+    test_mock_object_set(obj, "Frequency", g_variant_new_uint16((id & 1) ?
+        (5180 + 20 * (id % 8)) : (2412 + 5 * (id % 13))));
+    test_mock_object_set(obj, "Rates", g_variant_new_fixed_array
+        (G_VARIANT_TYPE_UINT32, rates, G_N_ELEMENTS(rates), sizeof(guint32)));
+    test_mock_object_set(obj, "RSN", g_variant_builder_end(&rsn));
+    test_mock_object_set(obj, "Age", g_variant_new_uint32(0));
+    g_ptr_array_set_size(obj->changed, 0);
+
+    g_hash_table_insert(mock->bsss, obj->path, obj);
+    g_free(ssid);
+    g_free(path);
+    return obj;
+}
+
+static
+const char*
+test_mock_interface_add_bss(
+    TestMockInterface* iface)
+{
+    TestSupplicantMock* mock = iface->mock;
+    TestMockObject* bss = test_mock_bss_new(iface);
+    g_ptr_array_add(iface->bsss, bss);
+    test_mock_emit(mock, iface->obj->path, MOCK_IFACE_INTERFACE, "BSSAdded",
+        g_variant_new("(o@a{sv})", bss->path, test_mock_object_dict(bss,
+        NULL)));
+    test_mock_object_set(iface->obj, "BSSs",
+        test_mock_paths_value(iface->bsss));
+    test_mock_object_emit_changed(iface->obj);
+    return bss->path;
+}
+
+static
+void
+test_mock_interface_remove_bss_at(
+    TestMockInterface* iface,
+    guint pos)
+{
+    TestSupplicantMock* mock = iface->mock;
+    TestMockObject* bss = iface->bsss->pdata[pos];
+    char* path = g_strdup(bss->path);
+    g_ptr_array_remove_index(iface->bsss, pos);
+    g_hash_table_remove(mock->bsss, bss->path);
+    test_mock_object_free(bss);
+    test_mock_emit(mock, iface->obj->path, MOCK_IFACE_INTERFACE, "BSSRemoved",
+        g_variant_new("(o)", path));
+    test_mock_object_set(iface->obj, "BSSs",
+        test_mock_paths_value(iface->bsss));
+    test_mock_object_emit_changed(iface->obj);
+    g_free(path);
+}
+
+/* wpa_supplicant reports network properties as strings */
+static
+GVariant*
+test_mock_network_properties(
+    GVariant* args)
+{
+    GVariantBuilder builder;
+    GVariantIter it;
+    const char* key;
+    GVariant* value;
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+    g_variant_iter_init(&it, args);
+    while (g_variant_iter_next(&it, "{&sv}", &key, &value)) {
+        char* str = NULL;
+        if (g_variant_is_of_type(value, G_VARIANT_TYPE_STRING)) {
+            const char* s = g_variant_get_string(value, NULL);
+            if (!strcmp(key, "ssid") || !strcmp(key, "psk") ||
+                !strcmp(key, "identity") || !strcmp(key, "password")) {
+                str = g_strconcat("\"", s, "\"", NULL);
+            } else {
+                str = g_strdup(s);
+            }
+        } else if (g_variant_is_of_type(value, G_VARIANT_TYPE_BYTESTRING)) {
+            gsize size = 0;
+            const guint8* data = g_variant_get_fixed_array(value, &size, 1);
+            str = gutil_bin2hex(data, size, FALSE);
+        } else if (g_variant_is_of_type(value, G_VARIANT_TYPE_UINT32)) {
+            str = g_strdup_printf("%u", g_variant_get_uint32(value));
+        } else if (g_variant_is_of_type(value, G_VARIANT_TYPE_INT32)) {
+            str = g_strdup_printf("%d", g_variant_get_int32(value));
+        } else if (g_variant_is_of_type(value, G_VARIANT_TYPE_BOOLEAN)) {
+            str = g_strdup(g_variant_get_boolean(value) ? "1" : "0");
+        }
+        if (str) {
+            g_variant_builder_add(&builder, "{sv}", key,
+                g_variant_new_take_string(str));
+        }
+        g_variant_unref(value);
+    }
+    return g_variant_builder_end(&builder);
+}
+
+static
+TestMockObject*
+test_mock_interface_add_network(
+    TestMockInterface* iface,
+    GVariant* args)
+{
+    TestSupplicantMock* mock = iface->mock;
+    char* path = g_strdup_printf("%s/Networks/%u", iface->obj->path,
+        iface->next_network_id++);
+    TestMockObject* net = test_mock_object_new(mock, MOCK_SPEC_NETWORK,
+        path, iface);
+
+    test_mock_object_set(net, "Properties",
+        test_mock_network_properties(args));
+    test_mock_object_set(net, "Enabled", g_variant_new_boolean(TRUE));
+    g_ptr_array_set_size(net->changed, 0);
+    g_ptr_array_add(iface->networks, net);
+
+    test_mock_emit(mock, iface->obj->path, MOCK_IFACE_INTERFACE,
+        "NetworkAdded", g_variant_new("(o@a{sv})", net->path,
+        test_mock_object_dict(net, NULL)));
+    test_mock_object_set(iface->obj, "Networks",
+        test_mock_paths_value(iface->networks));
+    test_mock_object_emit_changed(iface->obj);
+    g_free(path);
+    return net;
+}
+
+static
+void
+test_mock_interface_remove_network_at(
+    TestMockInterface* iface,
+    guint pos)
+{
+    TestSupplicantMock* mock = iface->mock;
+    TestMockObject* net = iface->networks->pdata[pos];
+    char* path = g_strdup(net->path);
+    GVariant* current = test_mock_object_get(iface->obj, "CurrentNetwork");
+
+    if (!g_strcmp0(g_variant_get_string(current, NULL), path)) {
+        test_mock_object_set(iface->obj, "CurrentNetwork",
+            g_variant_new_object_path("/"));
+    }
+    g_ptr_array_remove_index(iface->networks, pos);
+    test_mock_object_free(net);
+    test_mock_emit(mock, iface->obj->path, MOCK_IFACE_INTERFACE,
+        "NetworkRemoved", g_variant_new("(o)", path));
+    test_mock_object_set(iface->obj, "Networks",
+        test_mock_paths_value(iface->networks));
+    test_mock_object_emit_changed(iface->obj);
+    g_free(path);
+}
+
+static
+GVariant*
+test_mock_default_network(
+    guint id)
+{
+    GVariantBuilder builder;
+    char* ssid = g_strdup_printf("mock-%u", id);
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_add(&builder, "{sv}", "ssid",
+        g_variant_new_take_string(ssid));
+    g_variant_builder_add(&builder, "{sv}", "key_mgmt",
+        g_variant_new_string("WPA-PSK"));
+    g_variant_builder_add(&builder, "{sv}", "psk",
+        g_variant_new_string("password"));
+    g_variant_builder_add(&builder, "{sv}", "priority",
+        g_variant_new_int32(0));
+    return g_variant_builder_end(&builder);
+}
+
+/*==========================================================================*
+ * Interfaces
+ *==========================================================================*/
+
+static
+TestMockInterface*
+test_mock_interface_new(
+    TestSupplicantMock* mock,
+    const char* ifname)
+{
+    TestMockInterface* iface = g_slice_new0(TestMockInterface);
+    char* path = g_strdup_printf(MOCK_PATH "/Interfaces/%u",
+        mock->next_iface_id++);
+    guint i;
+
+    iface->mock = mock;
+    iface->ifname = g_strdup(ifname);
+    iface->bsss = g_ptr_array_new();
+    iface->networks = g_ptr_array_new();
+    iface->scans = g_ptr_array_new_with_free_func((GDestroyNotify)
+        g_variant_unref);
+    iface->obj = test_mock_object_new(mock, MOCK_SPEC_INTERFACE, path, iface);
+    iface->wps = test_mock_object_new(mock, MOCK_SPEC_WPS, path, iface);
+    test_mock_object_set(iface->obj, "Ifname", g_variant_new_string(ifname));
+    test_mock_object_set(iface->obj, "Driver", g_variant_new_string("mock"));
+    test_mock_object_set(iface->obj, "State",
+        g_variant_new_string("disconnected"));
+    test_mock_object_set(iface->obj, "ApScan", g_variant_new_uint32(1));
+    test_mock_object_set(iface->obj, "BSSExpireAge",
+        g_variant_new_uint32(180));
+    test_mock_object_set(iface->obj, "BSSExpireCount",
+        g_variant_new_uint32(2));
+    test_mock_object_set(iface->obj, "ScanInterval",
+        g_variant_new_int32(5));
+    test_mock_object_set(iface->obj, "FilterRssi",
+        g_variant_new_string("-100"));
+    test_mock_object_set(iface->obj, "SchedScanPlans",
+        g_variant_new_string(""));
+    test_mock_object_set(iface->obj, "SchedScanInterval",
+        g_variant_new_string("0"));
+    test_mock_object_set(iface->obj, "DisableScanOffload",
+        g_variant_new_string("0"));
+    test_mock_object_set(iface->obj, "FreqList", g_variant_new_string(""));
+    test_mock_object_set(iface->obj, "Okc", g_variant_new_string("0"));
+    test_mock_object_set(iface->obj, "Pmf", g_variant_new_string("0"));
+    test_mock_object_set(iface->obj, "FastReauth",
+        g_variant_new_boolean(TRUE));
+    test_mock_object_set(iface->obj, "Bgscan", g_variant_new_string(""));
+    g_ptr_array_set_size(iface->obj->changed, 0);
+    for (i = 0; i < mock->config.bsss; i++) {
+        g_ptr_array_add(iface->bsss, test_mock_bss_new(iface));
+    }
+    for (i = 0; i < mock->config.networks; i++) {
+        GVariant* args = g_variant_ref_sink(test_mock_default_network(i));
+        test_mock_interface_add_network(iface, args);
+        g_variant_unref(args);
+    }
+    test_mock_object_set(iface->obj, "BSSs",
+        test_mock_paths_value(iface->bsss));
+    g_ptr_array_set_size(iface->obj->changed, 0);
+    g_free(path);
+    return iface;
+}
+
+static
+void
+test_mock_interface_free(
+    TestMockInterface* iface)
+{
+    TestSupplicantMock* mock = iface->mock;
+    guint i;
+
+    if (iface->scan_id) {
+        g_source_remove(iface->scan_id);
+    }
+    if (iface->roam_id) {
+        g_source_remove(iface->roam_id);
+    }
+    g_free(iface->roam_bss);
+    for (i = 0; i < iface->bsss->len; i++) {
+        TestMockObject* bss = iface->bsss->pdata[i];
+        g_hash_table_remove(mock->bsss, bss->path);
+        test_mock_object_free(bss);
+    }
+    for (i = 0; i < iface->networks->len; i++) {
+        test_mock_object_free(iface->networks->pdata[i]);
+    }
+    g_ptr_array_free(iface->bsss, TRUE);
+    g_ptr_array_free(iface->networks, TRUE);
+    g_ptr_array_free(iface->scans, TRUE);
+    test_mock_object_free(iface->wps);
+    test_mock_object_free(iface->obj);
+    g_free(iface->ifname);
+    g_slice_free(TestMockInterface, iface);
+}
+
+static
+int
+test_mock_find_interface(
+    TestSupplicantMock* mock,
+    const char* path,
+    const char* ifname)
+{
+    guint i;
+    for (i = 0; i < mock->ifaces->len; i++) {
+        TestMockInterface* iface = mock->ifaces->pdata[i];
+        if ((path && !strcmp(iface->obj->path, path)) ||
+            (ifname && !strcmp(iface->ifname, ifname))) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static
+void
+test_mock_update_interfaces(
+    TestSupplicantMock* mock)
+{
+    GVariantBuilder builder;
+    guint i;
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_OBJECT_PATH_ARRAY);
+    for (i = 0; i < mock->ifaces->len; i++) {
+        TestMockInterface* iface = mock->ifaces->pdata[i];
+        g_variant_builder_add(&builder, "o", iface->obj->path);
+    }
+    test_mock_object_set(mock->root, "Interfaces",
+        g_variant_builder_end(&builder));
+    test_mock_object_emit_changed(mock->root);
+}
+
+static
+TestMockInterface*
+test_mock_add_interface(
+    TestSupplicantMock* mock,
+    const char* ifname)
+{
+    TestMockInterface* iface = test_mock_interface_new(mock, ifname);
+    g_ptr_array_add(mock->ifaces, iface);
+    test_mock_emit(mock, MOCK_PATH, MOCK_IFACE_ROOT, "InterfaceAdded",
+        g_variant_new("(o@a{sv})", iface->obj->path,
+        test_mock_object_dict(iface->obj, NULL)));
+    test_mock_update_interfaces(mock);
+    return iface;
+}
+
+static
+void
+test_mock_remove_interface_at(
+    TestSupplicantMock* mock,
+    guint pos)
+{
+    TestMockInterface* iface = mock->ifaces->pdata[pos];
+    char* path = g_strdup(iface->obj->path);
+    g_ptr_array_remove_index(mock->ifaces, pos);
+    test_mock_interface_free(iface);
+    test_mock_emit(mock, MOCK_PATH, MOCK_IFACE_ROOT, "InterfaceRemoved",
+        g_variant_new("(o)", path));
+    test_mock_update_interfaces(mock);
+    g_free(path);
+}
+
+static
+gboolean
+test_mock_scan_done(
+    gpointer data)
+{
+    TestMockInterface* iface = data;
+    iface->scan_id = 0;
+    test_mock_object_set(iface->obj, "Scanning", g_variant_new_boolean(FALSE));
+    test_mock_object_emit_changed(iface->obj);
+    test_mock_emit(iface->mock, iface->obj->path, MOCK_IFACE_INTERFACE,
+        "ScanDone", g_variant_new("(b)", TRUE));
+    return G_SOURCE_REMOVE;
+}
+
+static
+gboolean
+test_mock_roam_done(
+    gpointer data)
+{
+    TestMockInterface* iface = data;
+    iface->roam_id = 0;
+    test_mock_object_set(iface->obj, "CurrentBSS",
+        g_variant_new_object_path(iface->roam_bss));
+    test_mock_object_set(iface->obj, "State",
+        g_variant_new_string("completed"));
+    test_mock_object_emit_changed(iface->obj);
+    g_free(iface->roam_bss);
+    iface->roam_bss = NULL;
+    return G_SOURCE_REMOVE;
+}
+
+static
+TestMockObject*
+test_mock_interface_find_bssid(
+    TestMockInterface* iface,
+    const char* addr)
+{
+    guint i;
+    for (i = 0; i < iface->bsss->len; i++) {
+        TestMockObject* bss = iface->bsss->pdata[i];
+        GVariant* var = test_mock_object_get(bss, "BSSID");
+        gsize size = 0;
+        const guint8* b = g_variant_get_fixed_array(var, &size, 1);
+        if (size == 6) {
+            char* str = g_strdup_printf("%02x:%02x:%02x:%02x:%02x:%02x",
+                b[0], b[1], b[2], b[3], b[4], b[5]);
+            const gboolean match = !g_ascii_strcasecmp(str, addr);
+            g_free(str);
+            if (match) {
+                return bss;
+            }
+        }
+    }
+    return NULL;
+}
+
+/*==========================================================================*
+ * Methods
+ *==========================================================================*/
+
+static
+void
+test_mock_return_error(
+    GDBusMethodInvocation* invocation,
+    const char* name,
+    const char* message)
+{
+    char* error = g_strconcat(MOCK_ERROR_PREFIX, name, NULL);
+    g_dbus_method_invocation_return_dbus_error(invocation, error, message);
+    g_free(error);
+}
+
+/* Returns default values for all output arguments */
+static
+void
+test_mock_return_default(
+    GDBusMethodInvocation* invocation)
+{
+    const GDBusMethodInfo* method =
+        g_dbus_method_invocation_get_method_info(invocation);
+    GDBusArgInfo** arg = method->out_args;
+    if (arg && *arg) {
+        GVariantBuilder builder;
+        g_variant_builder_init(&builder, G_VARIANT_TYPE_TUPLE);
+        for (; *arg; arg++) {
+            g_variant_builder_add_value(&builder,
+                test_mock_default_value((*arg)->signature));
+        }
+        g_dbus_method_invocation_return_value(invocation,
+            g_variant_builder_end(&builder));
+    } else {
+        g_dbus_method_invocation_return_value(invocation, NULL);
+    }
+}
+
+static
+void
+test_mock_root_call(
+    TestSupplicantMock* mock,
+    const char* method,
+    GVariant* params,
+    GDBusMethodInvocation* invocation)
+{
+    if (!strcmp(method, "CreateInterface")) {
+        GVariant* args = g_variant_get_child_value(params, 0);
+        const char* ifname = NULL;
+        g_variant_lookup(args, "Ifname", "&s", &ifname);
+        if (!ifname) {
+            test_mock_return_error(invocation, "InvalidArgs", "No Ifname");
+        } else if (test_mock_find_interface(mock, NULL, ifname) >= 0) {
+            test_mock_return_error(invocation, "InterfaceExists", ifname);
+        } else {
+            TestMockInterface* iface = test_mock_add_interface(mock, ifname);
+            g_dbus_method_invocation_return_value(invocation,
+                g_variant_new("(o)", iface->obj->path));
+        }
+        g_variant_unref(args);
+    } else if (!strcmp(method, "GetInterface")) {
+        const char* ifname = NULL;
+        int pos;
+        g_variant_get(params, "(&s)", &ifname);
+        pos = test_mock_find_interface(mock, NULL, ifname);
+        if (pos >= 0) {
+            TestMockInterface* iface = mock->ifaces->pdata[pos];
+            g_dbus_method_invocation_return_value(invocation,
+                g_variant_new("(o)", iface->obj->path));
+        } else {
+            test_mock_return_error(invocation, "InterfaceUnknown", ifname);
+        }
+    } else if (!strcmp(method, "RemoveInterface")) {
+        const char* path = NULL;
+        int pos;
+        g_variant_get(params, "(&o)", &path);
+        pos = test_mock_find_interface(mock, path, NULL);
+        if (pos >= 0) {
+            test_mock_remove_interface_at(mock, pos);
+            g_dbus_method_invocation_return_value(invocation, NULL);
+        } else {
+            test_mock_return_error(invocation, "InterfaceUnknown", path);
+        }
+    } else {
+        test_mock_return_default(invocation);
+    }
+}
+
+static
+void
+test_mock_interface_call(
+    TestMockInterface* iface,
+    const char* method,
+    GVariant* params,
+    GDBusMethodInvocation* invocation)
+{
+    TestSupplicantMock* mock = iface->mock;
+    TestMockObject* obj = iface->obj;
+    if (!strcmp(method, "Scan")) {
+        g_ptr_array_add(iface->scans, g_variant_get_child_value(params, 0));
+        if (iface->scan_id) {
+            test_mock_return_error(invocation, "Interface.ScanError",
+                "Scan request rejected");
+        } else {
+            test_mock_object_set(obj, "Scanning", g_variant_new_boolean(TRUE));
+            test_mock_object_emit_changed(obj);
+            iface->scan_id = mock->config.scan_ms ?
+                g_timeout_add(mock->config.scan_ms, test_mock_scan_done,
+                    iface) : g_idle_add(test_mock_scan_done, iface);
+            g_dbus_method_invocation_return_value(invocation, NULL);
+        }
+    } else if (!strcmp(method, "AddNetwork")) {
+        GVariant* args = g_variant_get_child_value(params, 0);
+        TestMockObject* net = test_mock_interface_add_network(iface, args);
+        g_dbus_method_invocation_return_value(invocation,
+            g_variant_new("(o)", net->path));
+        g_variant_unref(args);
+    } else if (!strcmp(method, "RemoveNetwork") ||
+        !strcmp(method, "SelectNetwork")) {
+        const char* path = NULL;
+        int pos;
+        g_variant_get(params, "(&o)", &path);
+        pos = test_mock_find_path(iface->networks, path);
+        if (pos < 0) {
+            test_mock_return_error(invocation, "NetworkUnknown", path);
+        } else if (method[0] == 'R') {
+            test_mock_interface_remove_network_at(iface, pos);
+            g_dbus_method_invocation_return_value(invocation, NULL);
+        } else {
+            test_mock_object_set(obj, "CurrentNetwork",
+                g_variant_new_object_path(path));
+            test_mock_object_set(obj, "State",
+                g_variant_new_string("completed"));
+            test_mock_object_emit_changed(obj);
+            test_mock_emit(mock, obj->path, MOCK_IFACE_INTERFACE,
+                "NetworkSelected", g_variant_new("(o)", path));
+            g_dbus_method_invocation_return_value(invocation, NULL);
+        }
+    } else if (!strcmp(method, "RemoveAllNetworks")) {
+        while (iface->networks->len) {
+            test_mock_interface_remove_network_at(iface,
+                iface->networks->len - 1);
+        }
+        g_dbus_method_invocation_return_value(invocation, NULL);
+    } else if (!strcmp(method, "Disconnect")) {
+        test_mock_object_set(obj, "State",
+            g_variant_new_string("disconnected"));
+        test_mock_object_set(obj, "CurrentNetwork",
+            g_variant_new_object_path("/"));
+        test_mock_object_set(obj, "CurrentBSS",
+            g_variant_new_object_path("/"));
+        test_mock_object_emit_changed(obj);
+        g_dbus_method_invocation_return_value(invocation, NULL);
+    } else if (!strcmp(method, "SignalPoll")) {
+        GVariant* path = test_mock_object_get(obj, "CurrentBSS");
+        TestMockObject* bss = path ? g_hash_table_lookup(mock->bsss,
+            g_variant_get_string(path, NULL)) : NULL;
+        GVariantBuilder builder;
+
+        /* RSSI of the current BSS */
+        g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+        if (bss) {
+            g_variant_builder_add(&builder, "{sv}", "rssi",
+                g_variant_new_int32(g_variant_get_int16
+                    (test_mock_object_get(bss, "Signal"))));
+            g_variant_builder_add(&builder, "{sv}", "linkspeed",
+                g_variant_new_int32(54));
+        }
+        g_dbus_method_invocation_return_value(invocation,
+            g_variant_new("(v)", g_variant_builder_end(&builder)));
+    } else if (!strcmp(method, "Roam")) {
+        const char* addr = NULL;
+        TestMockObject* bss;
+        g_variant_get(params, "(&s)", &addr);
+        bss = test_mock_interface_find_bssid(iface, addr);
+        if (!bss) {
+            test_mock_return_error(invocation, "InvalidArgs", addr);
+        } else if (iface->roam_id) {
+            test_mock_return_error(invocation, "UnknownError", "Busy");
+        } else {
+            /* Reassociation takes roam_ms */
+            test_mock_object_set(obj, "State",
+                g_variant_new_string("associating"));
+            test_mock_object_emit_changed(obj);
+            iface->roam_bss = g_strdup(bss->path);
+            iface->roam_id = mock->config.roam_ms ?
+                g_timeout_add(mock->config.roam_ms, test_mock_roam_done,
+                    iface) : g_idle_add(test_mock_roam_done, iface);
+            g_dbus_method_invocation_return_value(invocation, NULL);
+        }
+    } else if (!strcmp(method, "FlushBSS")) {
+        guint age = 0;
+        guint i = iface->bsss->len;
+
+        /* Zero age flushes everything, like wpa_supplicant does */
+        g_variant_get(params, "(u)", &age);
+        while (i > 0) {
+            TestMockObject* bss = iface->bsss->pdata[--i];
+
+            if (!age || g_variant_get_uint32(test_mock_object_get(bss,
+                "Age")) > age) {
+                test_mock_interface_remove_bss_at(iface, i);
+            }
+        }
+        g_dbus_method_invocation_return_value(invocation, NULL);
+    } else {
+        test_mock_return_default(invocation);
+    }
+}
+
+static
+void
+test_mock_complete_call(
+    TestMockObject* obj,
+    GDBusMethodInvocation* invocation)
+{
+    TestSupplicantMock* mock = obj->mock;
+    const char* method = g_dbus_method_invocation_get_method_name(invocation);
+    const char* iface = g_dbus_method_invocation_get_interface_name
+        (invocation);
+    GVariant* params = g_dbus_method_invocation_get_parameters(invocation);
+    const TestMockMethod* conf = g_hash_table_lookup(mock->methods, method);
+
+    if (conf && conf->error) {
+        g_dbus_method_invocation_return_dbus_error(invocation, conf->error,
+            "Injected failure");
+    } else if (!strcmp(iface, MOCK_IFACE_ROOT)) {
+        test_mock_root_call(mock, method, params, invocation);
+    } else if (!strcmp(iface, MOCK_IFACE_INTERFACE)) {
+        test_mock_interface_call(obj->owner, method, params, invocation);
+    } else {
+        test_mock_return_default(invocation);
+    }
+}
+
+static
+gboolean
+test_mock_delayed_call(
+    gpointer data)
+{
+    TestMockCall* call = data;
+    TestSupplicantMock* mock = call->mock;
+    mock->calls = g_slist_remove(mock->calls, call);
+    test_mock_complete_call(call->obj, call->invocation);
+    g_slice_free(TestMockCall, call);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+test_mock_method_call(
+    GDBusConnection* connection,
+    const char* sender,
+    const char* path,
+    const char* iface,
+    const char* method,
+    GVariant* params,
+    GDBusMethodInvocation* invocation,
+    gpointer user_data)
+{
+    TestMockObject* obj = user_data;
+    TestSupplicantMock* mock = obj->mock;
+    const TestMockMethod* conf = g_hash_table_lookup(mock->methods, method);
+    const guint delay = (conf && conf->delay_set) ? conf->delay_ms :
+        mock->default_delay_ms;
+
+    mock->method_calls++;
+    if (delay) {
+        TestMockCall* call = g_slice_new0(TestMockCall);
+        call->mock = mock;
+        call->obj = obj;
+        call->invocation = invocation;
+        call->timeout_id = g_timeout_add(delay, test_mock_delayed_call, call);
+        mock->calls = g_slist_append(mock->calls, call);
+    } else {
+        test_mock_complete_call(obj, invocation);
+    }
+}
+
+static
+GVariant*
+test_mock_get_property(
+    GDBusConnection* connection,
+    const char* sender,
+    const char* path,
+    const char* iface,
+    const char* name,
+    GError** error,
+    gpointer user_data)
+{
+    TestMockObject* obj = user_data;
+    GVariant* value = test_mock_object_get(obj, name);
+    if (value) {
+        return g_variant_ref(value);
+    } else {
+        g_set_error(error, G_DBUS_ERROR, G_DBUS_ERROR_INVALID_ARGS,
+            "Unknown property %s", name);
+        return NULL;
+    }
+}
+
+static
+gboolean
+test_mock_set_property(
+    GDBusConnection* connection,
+    const char* sender,
+    const char* path,
+    const char* iface,
+    const char* name,
+    GVariant* value,
+    GError** error,
+    gpointer user_data)
+{
+    TestMockObject* obj = user_data;
+    test_mock_object_set(obj, name, value);
+    test_mock_object_emit_changed(obj);
+    return TRUE;
+}
+
+static
+TestMockMethod*
+test_mock_method(
+    TestSupplicantMock* mock,
+    const char* name)
+{
+    TestMockMethod* method = g_hash_table_lookup(mock->methods, name);
+    if (!method) {
+        method = g_slice_new0(TestMockMethod);
+        g_hash_table_insert(mock->methods, g_strdup(name), method);
+    }
+    return method;
+}
+
+static
+void
+test_mock_method_free(
+    gpointer data)
+{
+    TestMockMethod* method = data;
+    g_free(method->error);
+    g_slice_free(TestMockMethod, method);
+}
+
+/*==========================================================================*
+ * Load generators
+ *==========================================================================*/
+
+static
+gboolean
+test_mock_churn(
+    gpointer data)
+{
+    TestSupplicantMock* mock = data;
+    guint i, k;
+    for (i = 0; i < mock->ifaces->len; i++) {
+        TestMockInterface* iface = mock->ifaces->pdata[i];
+        for (k = 0; k < mock->config.churn_count; k++) {
+            if (iface->bsss->len) {
+                test_mock_interface_remove_bss_at(iface, 0);
+            }
+            test_mock_interface_add_bss(iface);
+        }
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static
+gboolean
+test_mock_update(
+    gpointer data)
+{
+    TestSupplicantMock* mock = data;
+    const guint n = g_hash_table_size(mock->bsss);
+    if (n) {
+        GPtrArray* all = g_ptr_array_sized_new(n);
+        GHashTableIter it;
+        gpointer value;
+        guint k;
+
+        /* Hashtable order is stable as long as it's not modified */
+        g_hash_table_iter_init(&it, mock->bsss);
+        while (g_hash_table_iter_next(&it, NULL, &value)) {
+            g_ptr_array_add(all, value);
+        }
+        for (k = 0; k < mock->config.update_count; k++) {
+            TestMockObject* bss = all->pdata[(mock->update_pos++) % n];
+            GVariant* age = test_mock_object_get(bss, "Age");
+            test_mock_object_set(bss, "Signal", g_variant_new_int16(-30 -
+                g_rand_int_range(mock->rand, 0, 60)));
+            if (age) {
+                test_mock_object_set(bss, "Age", g_variant_new_uint32
+                    (g_variant_get_uint32(age) + 1));
+            }
+            test_mock_object_emit_changed(bss);
+        }
+        g_ptr_array_free(all, TRUE);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+TestSupplicantMock*
+test_supplicant_mock_new(
+    const TestSupplicantMockConfig* config)
+{
+    TestSupplicantMock* mock = g_new0(TestSupplicantMock, 1);
+    const char* address;
+    GError* error = NULL;
+    guint i;
+
+    if (config) {
+        mock->config = *config;
+    } else {
+        mock->config.interfaces = 1;
+    }
+
+    /* Load the interface descriptions */
+    for (i = 0; i < MOCK_SPEC_COUNT; i++) {
+        char* fname = g_strconcat(TEST_SPEC_DIR "/",
+            test_mock_spec_names[i], ".xml", NULL);
+        char* xml = NULL;
+        g_assert(g_file_get_contents(fname, &xml, NULL, NULL));
+        mock->spec[i] = g_dbus_node_info_new_for_xml(xml, &error);
+        g_assert_no_error(error);
+        g_free(xml);
+        g_free(fname);
+    }
+
+    /* Start (or reuse) the private bus */
+    if (!test_mock_bus) {
+        test_mock_bus = g_test_dbus_new(G_TEST_DBUS_NONE);
+        g_test_dbus_up(test_mock_bus);
+        g_setenv("DBUS_SYSTEM_BUS_ADDRESS",
+            g_test_dbus_get_bus_address(test_mock_bus), TRUE);
+    }
+    address = g_test_dbus_get_bus_address(test_mock_bus);
+    mock->conn = g_dbus_connection_new_for_address_sync(address,
+        G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+        G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION, NULL, NULL, &error);
+    g_assert_no_error(error);
+
+    mock->rand = g_rand_new_with_seed(mock->config.seed ?
+        mock->config.seed : 1234);
+    mock->ifaces = g_ptr_array_new();
+    mock->bsss = g_hash_table_new(g_str_hash, g_str_equal);
+    mock->methods = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+        test_mock_method_free);
+    mock->root = test_mock_object_new(mock, MOCK_SPEC_ROOT, MOCK_PATH, mock);
+    test_mock_object_set(mock->root, "DebugLevel",
+        g_variant_new_string("info"));
+    for (i = 0; i < mock->config.interfaces; i++) {
+        char* ifname = g_strdup_printf("wlan%u", i);
+        g_ptr_array_add(mock->ifaces, test_mock_interface_new(mock, ifname));
+        g_free(ifname);
+    }
+    test_mock_update_interfaces(mock);
+
+    /* Everything is in place, claim the name */
+    test_supplicant_mock_claim_name(mock);
+
+    if (mock->config.churn_ms) {
+        mock->churn_id = g_timeout_add(mock->config.churn_ms,
+            test_mock_churn, mock);
+    }
+    if (mock->config.update_ms) {
+        mock->update_id = g_timeout_add(mock->config.update_ms,
+            test_mock_update, mock);
+    }
+    return mock;
+}
+
+void
+test_supplicant_mock_free(
+    TestSupplicantMock* mock)
+{
+    if (mock) {
+        guint i;
+        if (mock->churn_id) {
+            g_source_remove(mock->churn_id);
+        }
+        if (mock->update_id) {
+            g_source_remove(mock->update_id);
+        }
+        for (i = 0; i < mock->ifaces->len; i++) {
+            test_mock_interface_free(mock->ifaces->pdata[i]);
+        }
+        test_mock_object_free(mock->root);
+        GASSERT(!mock->calls);
+        g_ptr_array_free(mock->ifaces, TRUE);
+        g_hash_table_destroy(mock->bsss);
+        g_hash_table_destroy(mock->methods);
+        g_rand_free(mock->rand);
+
+        /* Closing the connection releases the name */
+        g_dbus_connection_close_sync(mock->conn, NULL, NULL);
+        g_object_unref(mock->conn);
+        for (i = 0; i < MOCK_SPEC_COUNT; i++) {
+            g_dbus_node_info_unref(mock->spec[i]);
+        }
+        g_free(mock);
+    }
+}
+
+void
+test_supplicant_mock_shutdown(
+    void)
+{
+    if (test_mock_bus) {
+        g_test_dbus_down(test_mock_bus);
+        g_object_unref(test_mock_bus);
+        test_mock_bus = NULL;
+    }
+}
+
+static
+void
+test_mock_name_call(
+    TestSupplicantMock* mock,
+    const char* method,
+    GVariant* args)
+{
+    GError* error = NULL;
+    GVariant* reply = g_dbus_connection_call_sync(mock->conn,
+        "org.freedesktop.DBus", "/org/freedesktop/DBus",
+        "org.freedesktop.DBus", method, args, G_VARIANT_TYPE("(u)"),
+        G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
+
+    g_assert_no_error(error);
+    g_variant_unref(reply);
+}
+
+void
+test_supplicant_mock_claim_name(
+    TestSupplicantMock* mock)
+{
+    test_mock_name_call(mock, "RequestName",
+        g_variant_new("(su)", MOCK_SERVICE, 0x4 /* DO_NOT_QUEUE */));
+}
+
+void
+test_supplicant_mock_drop_name(
+    TestSupplicantMock* mock)
+{
+    test_mock_name_call(mock, "ReleaseName",
+        g_variant_new("(s)", MOCK_SERVICE));
+}
+
+guint
+test_supplicant_mock_interface_count(
+    TestSupplicantMock* mock)
+{
+    return mock->ifaces->len;
+}
+
+const char*
+test_supplicant_mock_interface_path(
+    TestSupplicantMock* mock,
+    guint i)
+{
+    if (i < mock->ifaces->len) {
+        TestMockInterface* iface = mock->ifaces->pdata[i];
+        return iface->obj->path;
+    }
+    return NULL;
+}
+
+gboolean
+test_supplicant_mock_remove_interface(
+    TestSupplicantMock* mock,
+    guint i)
+{
+    if (i < mock->ifaces->len) {
+        test_mock_remove_interface_at(mock, i);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+guint
+test_supplicant_mock_bss_count(
+    TestSupplicantMock* mock,
+    guint i)
+{
+    if (i < mock->ifaces->len) {
+        TestMockInterface* iface = mock->ifaces->pdata[i];
+        return iface->bsss->len;
+    }
+    return 0;
+}
+
+guint
+test_supplicant_mock_scan_count(
+    TestSupplicantMock* mock,
+    guint i)
+{
+    return (i < mock->ifaces->len) ? ((TestMockInterface*)
+        mock->ifaces->pdata[i])->scans->len : 0;
+}
+
+GVariant*
+test_supplicant_mock_scan_args(
+    TestSupplicantMock* mock,
+    guint i,
+    guint scan)
+{
+    if (i < mock->ifaces->len) {
+        TestMockInterface* iface = mock->ifaces->pdata[i];
+
+        if (scan < iface->scans->len) {
+            return iface->scans->pdata[scan];
+        }
+    }
+    return NULL;
+}
+
+const char*
+test_supplicant_mock_add_bss(
+    TestSupplicantMock* mock,
+    guint i)
+{
+    return (i < mock->ifaces->len) ?
+        test_mock_interface_add_bss(mock->ifaces->pdata[i]) : NULL;
+}
+
+gboolean
+test_supplicant_mock_remove_bss(
+    TestSupplicantMock* mock,
+    const char* path)
+{
+    TestMockObject* bss = g_hash_table_lookup(mock->bsss, path);
+    if (bss) {
+        TestMockInterface* iface = bss->owner;
+        test_mock_interface_remove_bss_at(iface,
+            test_mock_find_path(iface->bsss, path));
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+test_supplicant_mock_scan_done(
+    TestSupplicantMock* mock,
+    guint i)
+{
+    if (i < mock->ifaces->len) {
+        TestMockInterface* iface = mock->ifaces->pdata[i];
+        test_mock_emit(mock, iface->obj->path, MOCK_IFACE_INTERFACE,
+            "ScanDone", g_variant_new("(b)", TRUE));
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+test_supplicant_mock_station(
+    TestSupplicantMock* mock,
+    guint i,
+    const char* address,
+    gboolean authorized)
+{
+    if (i < mock->ifaces->len) {
+        TestMockInterface* iface = mock->ifaces->pdata[i];
+        test_mock_emit(mock, iface->obj->path, MOCK_IFACE_INTERFACE,
+            authorized ? "StaAuthorized" : "StaDeauthorized",
+            g_variant_new("(s)", address));
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+test_supplicant_mock_set_bss_ssid(
+    TestSupplicantMock* mock,
+    const char* path,
+    const char* ssid)
+{
+    TestMockObject* bss = g_hash_table_lookup(mock->bsss, path);
+    if (bss) {
+        test_mock_object_set(bss, "SSID", test_mock_bytes_value(ssid,
+            strlen(ssid)));
+        test_mock_object_emit_changed(bss);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+test_supplicant_mock_associate(
+    TestSupplicantMock* mock,
+    const char* path)
+{
+    TestMockObject* bss = g_hash_table_lookup(mock->bsss, path);
+    if (bss) {
+        TestMockInterface* iface = bss->owner;
+        test_mock_object_set(iface->obj, "CurrentBSS",
+            g_variant_new_object_path(path));
+        test_mock_object_set(iface->obj, "State",
+            g_variant_new_string("completed"));
+        test_mock_object_emit_changed(iface->obj);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+test_supplicant_mock_set_bss_signal(
+    TestSupplicantMock* mock,
+    const char* path,
+    gint16 signal)
+{
+    TestMockObject* bss = g_hash_table_lookup(mock->bsss, path);
+    if (bss) {
+        test_mock_object_set(bss, "Signal", g_variant_new_int16(signal));
+        test_mock_object_emit_changed(bss);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+GVariant*
+test_supplicant_mock_get_property(
+    TestSupplicantMock* mock,
+    const char* path,
+    const char* name)
+{
+    TestMockObject* obj = test_mock_find_object(mock, path, name);
+    return obj ? test_mock_object_get(obj, name) : NULL;
+}
+
+gboolean
+test_supplicant_mock_set_property(
+    TestSupplicantMock* mock,
+    const char* path,
+    const char* name,
+    GVariant* value)
+{
+    TestMockObject* obj = test_mock_find_object(mock, path, name);
+    if (obj) {
+        test_mock_object_set(obj, name, value);
+        test_mock_object_emit_changed(obj);
+        return TRUE;
+    }
+    g_variant_unref(g_variant_ref_sink(value));
+    return FALSE;
+}
+
+void
+test_supplicant_mock_set_method_delay(
+    TestSupplicantMock* mock,
+    const char* name,
+    guint ms)
+{
+    if (name) {
+        TestMockMethod* method = test_mock_method(mock, name);
+        method->delay_ms = ms;
+        method->delay_set = TRUE;
+    } else {
+        mock->default_delay_ms = ms;
+    }
+}
+
+void
+test_supplicant_mock_set_method_error(
+    TestSupplicantMock* mock,
+    const char* name,
+    const char* error)
+{
+    if (name) {
+        TestMockMethod* method = test_mock_method(mock, name);
+        g_free(method->error);
+        method->error = g_strdup(error);
+    }
+}
+
+guint64
+test_supplicant_mock_signal_count(
+    TestSupplicantMock* mock)
+{
+    return mock->signals;
+}
+
+guint64
+test_supplicant_mock_call_count(
+    TestSupplicantMock* mock)
+{
+    return mock->method_calls;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
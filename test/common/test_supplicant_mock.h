@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TEST_SUPPLICANT_MOCK_H
+#define TEST_SUPPLICANT_MOCK_H
+
+#include <gutil_types.h>
+
+/*
+ * Mock wpa_supplicant service. Implements the interfaces described by the
+ * XML files in spec/ on a private bus, which also becomes the system bus for
+ * the rest of the process (DBUS_SYSTEM_BUS_ADDRESS is pointed to it).
+ * The bus is started by the first mock and is shared by all subsequent
+ * ones, there should be only one mock alive at any time though.
+ */
+
+typedef struct test_supplicant_mock TestSupplicantMock;
+
+typedef struct test_supplicant_mock_config {
+    guint interfaces;       /* Number of interfaces created at startup */
+    guint bsss;             /* BSSs per interface */
+    guint networks;         /* Networks per interface */
+    guint churn_ms;         /* BSS replacement period, 0 to disable */
+    guint churn_count;      /* BSSs replaced per interface per period */
+    guint update_ms;        /* BSS Signal update period, 0 to disable */
+    guint update_count;     /* BSSs updated per period (round robin) */
+    guint scan_ms;          /* Scan duration */
+    guint roam_ms;          /* Time spent associating by Roam() */
+    guint32 seed;           /* Random seed, 0 for default */
+    gboolean legacy_signals; /* Emit wpa_supplicant's own PropertiesChanged
+                              * in addition to the standard one */
+} TestSupplicantMockConfig;
+
+/* NULL config means one interface without BSSs and networks */
+TestSupplicantMock*
+test_supplicant_mock_new(
+    const TestSupplicantMockConfig* config);
+
+void
+test_supplicant_mock_free(
+    TestSupplicantMock* mock);
+
+/* Stops the shared bus, to be called before exit */
+void
+test_supplicant_mock_shutdown(
+    void);
+
+/*
+ * Releases and re-acquires the service name, like wpa_supplicant does
+ * when it's restarted. The objects stay in place, the changes made in
+ * between don't reach the clients.
+ */
+void
+test_supplicant_mock_drop_name(
+    TestSupplicantMock* mock);
+
+void
+test_supplicant_mock_claim_name(
+    TestSupplicantMock* mock);
+
+guint
+test_supplicant_mock_interface_count(
+    TestSupplicantMock* mock);
+
+const char*
+test_supplicant_mock_interface_path(
+    TestSupplicantMock* mock,
+    guint iface);
+
+gboolean
+test_supplicant_mock_remove_interface(
+    TestSupplicantMock* mock,
+    guint iface);
+
+guint
+test_supplicant_mock_bss_count(
+    TestSupplicantMock* mock,
+    guint iface);
+
+/* Number of Scan calls received by the interface */
+guint
+test_supplicant_mock_scan_count(
+    TestSupplicantMock* mock,
+    guint iface);
+
+/* Returns the a{sv} argument of the given Scan call (not a reference) */
+GVariant*
+test_supplicant_mock_scan_args(
+    TestSupplicantMock* mock,
+    guint iface,
+    guint scan);
+
+/* Returns the path of the new BSS */
+const char*
+test_supplicant_mock_add_bss(
+    TestSupplicantMock* mock,
+    guint iface);
+
+gboolean
+test_supplicant_mock_remove_bss(
+    TestSupplicantMock* mock,
+    const char* path);
+
+/* Emits ScanDone without a scan request, like a scheduled scan would */
+gboolean
+test_supplicant_mock_scan_done(
+    TestSupplicantMock* mock,
+    guint iface);
+
+/* Emits StaAuthorized or StaDeauthorized */
+gboolean
+test_supplicant_mock_station(
+    TestSupplicantMock* mock,
+    guint iface,
+    const char* address,
+    gboolean authorized);
+
+gboolean
+test_supplicant_mock_set_bss_ssid(
+    TestSupplicantMock* mock,
+    const char* path,
+    const char* ssid);
+
+/* Moves the interface to COMPLETED state with the specified BSS */
+gboolean
+test_supplicant_mock_associate(
+    TestSupplicantMock* mock,
+    const char* path);
+
+gboolean
+test_supplicant_mock_set_bss_signal(
+    TestSupplicantMock* mock,
+    const char* path,
+    gint16 signal);
+
+/* Returns a borrowed reference, NULL if there's no such property */
+GVariant*
+test_supplicant_mock_get_property(
+    TestSupplicantMock* mock,
+    const char* path,
+    const char* name);
+
+/* Consumes the floating reference and emits PropertiesChanged */
+gboolean
+test_supplicant_mock_set_property(
+    TestSupplicantMock* mock,
+    const char* path,
+    const char* name,
+    GVariant* value);
+
+/* NULL method name applies to all methods without explicit setting */
+void
+test_supplicant_mock_set_method_delay(
+    TestSupplicantMock* mock,
+    const char* method,
+    guint ms);
+
+/* Makes the method fail with the specified D-Bus error, NULL to clear */
+void
+test_supplicant_mock_set_method_error(
+    TestSupplicantMock* mock,
+    const char* method,
+    const char* error);
+
+/* Number of signals emitted and method calls received */
+guint64
+test_supplicant_mock_signal_count(
+    TestSupplicantMock* mock);
+
+guint64
+test_supplicant_mock_call_count(
+    TestSupplicantMock* mock);
+
+#endif /* TEST_SUPPLICANT_MOCK_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
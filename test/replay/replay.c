@@ -0,0 +1,718 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Replays a journal recorded with gsupplicant_journal_start() on a
+ * private bus. The replay service answers the calls made by the library
+ * with the recorded replies and emits the recorded signals, either at
+ * the recorded pace or as fast as possible. On the client side, the
+ * usual objects (GSupplicant, interfaces, BSSs and networks) are created
+ * and updated as they would be by a real client, and CPU time, memory
+ * and allocations are reported (see test_bench.h for the format).
+ *
+ * Each recorded call is a barrier - the signals recorded after it are
+ * not emitted until the library has made the same call, so that the
+ * proxies are in place by the time the signals arrive. The library
+ * may not repeat every call exactly though, so the barrier gives up
+ * after REPLAY_BARRIER_TIMEOUT_MS.
+ */
+
+#include "test_alloc.h"
+#include "test_bench.h"
+
+#include "gsupplicant.h"
+#include "gsupplicant_interface.h"
+#include "gsupplicant_bss.h"
+#include "gsupplicant_network.h"
+#include "gsupplicant_journal_p.h"
+#include "gsupplicant_dbus.h"
+
+#include <gutil_log.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define REPLAY_BARRIER_TIMEOUT_MS (1000)
+#define REPLAY_SETTLE_MS (200)
+
+typedef struct replay {
+    GPtrArray* records;
+    GHashTable* replies;    /* Call key => GQueue of recorded replies */
+    GHashTable* credits;    /* Call key => number of unmatched calls */
+    GMainLoop* loop;
+    GDBusConnection* conn;
+    gboolean fast;
+    guint pos;
+    gint64 base;            /* Monotonic time of the first record */
+    gint64 barrier_start;
+    guint timer_id;
+    guint settle_id;
+    guint64 calls;
+    guint64 unknown_calls;
+    guint64 signals;
+    guint64 skipped;
+} Replay;
+
+typedef
+gpointer
+(*ReplayNewFunc)(
+    const char* path);
+
+typedef struct replay_call {
+    Replay* replay;
+    GDBusMessage* message;
+} ReplayCall;
+
+typedef struct replay_client {
+    GSupplicant* supplicant;
+    gulong supplicant_id;
+    GHashTable* ifaces;
+} ReplayClient;
+
+typedef struct replay_iface {
+    GSupplicantInterface* iface;
+    gulong handler_id[2];
+    GHashTable* bsss;
+    GHashTable* networks;
+} ReplayIface;
+
+static void replay_advance(Replay* replay);
+
+/*==========================================================================*
+ * Service side
+ *==========================================================================*/
+
+static
+char*
+replay_call_key(
+    GDBusMessage* message)
+{
+    GVariant* body = g_dbus_message_get_body(message);
+    char* args = body ? g_variant_print(body, FALSE) : NULL;
+    const char* iface = g_dbus_message_get_interface(message);
+    char* key = g_strconcat(g_dbus_message_get_path(message), "\n",
+        iface ? iface : "", "\n", g_dbus_message_get_member(message), "\n",
+        args ? args : "", NULL);
+
+    g_free(args);
+    return key;
+}
+
+static
+void
+replay_queue_free(
+    gpointer data)
+{
+    g_queue_free_full(data, g_object_unref);
+}
+
+static
+void
+replay_index(
+    Replay* replay)
+{
+    GHashTable* pending = g_hash_table_new_full(g_direct_hash,
+        g_direct_equal, NULL, g_free);
+    guint i;
+
+    for (i = 0; i < replay->records->len; i++) {
+        const GSupplicantJournalRecord* record = replay->records->pdata[i];
+        GDBusMessage* message = record->message;
+        gpointer serial;
+        char* key;
+
+        switch (record->type) {
+        case GSUPPLICANT_JOURNAL_RECORD_CALL:
+            serial = GUINT_TO_POINTER(g_dbus_message_get_serial(message));
+            g_hash_table_replace(pending, serial, replay_call_key(message));
+            break;
+        case GSUPPLICANT_JOURNAL_RECORD_REPLY:
+            serial = GUINT_TO_POINTER(g_dbus_message_get_reply_serial
+                (message));
+            key = g_hash_table_lookup(pending, serial);
+            if (key) {
+                GQueue* queue = g_hash_table_lookup(replay->replies, key);
+
+                if (!queue) {
+                    queue = g_queue_new();
+                    g_hash_table_insert(replay->replies, g_strdup(key),
+                        queue);
+                }
+                g_queue_push_tail(queue, g_object_ref(message));
+                g_hash_table_remove(pending, serial);
+            }
+            break;
+        case GSUPPLICANT_JOURNAL_RECORD_SIGNAL:
+            break;
+        }
+    }
+    g_hash_table_destroy(pending);
+}
+
+static
+GDBusMessage*
+replay_reply_new(
+    GDBusMessage* call,
+    GDBusMessage* recorded)
+{
+    if (g_dbus_message_get_message_type(recorded) ==
+        G_DBUS_MESSAGE_TYPE_ERROR) {
+        GVariant* body = g_dbus_message_get_body(recorded);
+        const char* text = "";
+
+        if (body && g_variant_n_children(body) > 0 &&
+            g_variant_is_of_type(body, G_VARIANT_TYPE("(s)"))) {
+            g_variant_get(body, "(&s)", &text);
+        }
+        return g_dbus_message_new_method_error_literal(call,
+            g_dbus_message_get_error_name(recorded), text);
+    } else {
+        GDBusMessage* reply = g_dbus_message_new_method_reply(call);
+
+        g_dbus_message_set_body(reply, g_dbus_message_get_body(recorded));
+        return reply;
+    }
+}
+
+static
+gboolean
+replay_settled(
+    gpointer data)
+{
+    Replay* replay = data;
+
+    replay->settle_id = 0;
+    g_main_loop_quit(replay->loop);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+replay_settle(
+    Replay* replay)
+{
+    if (replay->pos >= replay->records->len) {
+        /* Wait until the library stops making calls */
+        if (replay->settle_id) {
+            g_source_remove(replay->settle_id);
+        }
+        replay->settle_id = g_timeout_add(REPLAY_SETTLE_MS,
+            replay_settled, replay);
+    }
+}
+
+/* Invoked on the main thread */
+static
+gboolean
+replay_serve(
+    gpointer data)
+{
+    ReplayCall* call = data;
+    Replay* replay = call->replay;
+    GDBusMessage* message = call->message;
+    char* key = replay_call_key(message);
+    GQueue* queue = g_hash_table_lookup(replay->replies, key);
+    GDBusMessage* reply;
+
+    if (queue && !g_queue_is_empty(queue)) {
+        /* The last reply is reused for repeated calls */
+        if (g_queue_get_length(queue) > 1) {
+            GDBusMessage* recorded = g_queue_pop_head(queue);
+
+            reply = replay_reply_new(message, recorded);
+            g_object_unref(recorded);
+        } else {
+            reply = replay_reply_new(message, g_queue_peek_head(queue));
+        }
+    } else {
+        reply = g_dbus_message_new_method_error_literal(message,
+            "org.freedesktop.DBus.Error.UnknownMethod",
+            "Not in the journal");
+        replay->unknown_calls++;
+    }
+    g_dbus_connection_send_message(replay->conn, reply,
+        G_DBUS_SEND_MESSAGE_FLAGS_NONE, NULL, NULL);
+    g_object_unref(reply);
+    replay->calls++;
+
+    /* Give the barrier credit for this call */
+    g_hash_table_insert(replay->credits, key, GUINT_TO_POINTER
+        (GPOINTER_TO_UINT(g_hash_table_lookup(replay->credits, key)) + 1));
+    replay_advance(replay);
+    replay_settle(replay);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+replay_call_free(
+    gpointer data)
+{
+    ReplayCall* call = data;
+
+    g_object_unref(call->message);
+    g_slice_free(ReplayCall, call);
+}
+
+/* Invoked on GDBus worker thread */
+static
+GDBusMessage*
+replay_filter(
+    GDBusConnection* conn,
+    GDBusMessage* message,
+    gboolean incoming,
+    gpointer data)
+{
+    if (incoming && g_dbus_message_get_message_type(message) ==
+        G_DBUS_MESSAGE_TYPE_METHOD_CALL) {
+        ReplayCall* call = g_slice_new(ReplayCall);
+
+        call->replay = data;
+        call->message = message;
+        g_main_context_invoke_full(NULL, G_PRIORITY_DEFAULT, replay_serve,
+            call, replay_call_free);
+        return NULL;
+    }
+    return message;
+}
+
+static
+void
+replay_emit(
+    Replay* replay,
+    GDBusMessage* recorded)
+{
+    GDBusMessage* signal = g_dbus_message_new_signal
+        (g_dbus_message_get_path(recorded),
+         g_dbus_message_get_interface(recorded),
+         g_dbus_message_get_member(recorded));
+
+    g_dbus_message_set_body(signal, g_dbus_message_get_body(recorded));
+    g_dbus_connection_send_message(replay->conn, signal,
+        G_DBUS_SEND_MESSAGE_FLAGS_NONE, NULL, NULL);
+    g_object_unref(signal);
+    replay->signals++;
+}
+
+static
+gboolean
+replay_timer(
+    gpointer data)
+{
+    Replay* replay = data;
+
+    replay->timer_id = 0;
+    replay_advance(replay);
+    replay_settle(replay);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+replay_schedule(
+    Replay* replay,
+    gint64 due)
+{
+    const gint64 now = g_get_monotonic_time();
+
+    if (replay->timer_id) {
+        g_source_remove(replay->timer_id);
+    }
+    replay->timer_id = g_timeout_add(due > now ? (guint)
+        ((due - now + 999) / 1000) : 0, replay_timer, replay);
+}
+
+static
+void
+replay_advance(
+    Replay* replay)
+{
+    const gint64 t0 = replay->records->len ? ((GSupplicantJournalRecord*)
+        replay->records->pdata[0])->time : 0;
+
+    while (replay->pos < replay->records->len) {
+        const GSupplicantJournalRecord* record =
+            replay->records->pdata[replay->pos];
+        const gint64 now = g_get_monotonic_time();
+
+        if (!replay->base) {
+            replay->base = now;
+        }
+        if (record->type == GSUPPLICANT_JOURNAL_RECORD_CALL) {
+            char* key = replay_call_key(record->message);
+            const guint credit = GPOINTER_TO_UINT(g_hash_table_lookup
+                (replay->credits, key));
+
+            if (credit) {
+                g_hash_table_insert(replay->credits, key,
+                    GUINT_TO_POINTER(credit - 1));
+                if (!replay->fast) {
+                    /* Don't try to catch up after waiting */
+                    replay->base = MAX(replay->base,
+                        now - (record->time - t0));
+                }
+            } else if (!replay->barrier_start) {
+                replay->barrier_start = now;
+                replay_schedule(replay, now +
+                    REPLAY_BARRIER_TIMEOUT_MS * 1000);
+                g_free(key);
+                return;
+            } else if (now - replay->barrier_start <
+                REPLAY_BARRIER_TIMEOUT_MS * 1000) {
+                g_free(key);
+                return;
+            } else {
+                replay->skipped++;
+                g_free(key);
+            }
+            replay->barrier_start = 0;
+        } else if (record->type == GSUPPLICANT_JOURNAL_RECORD_SIGNAL) {
+            const gint64 due = replay->base + (record->time - t0);
+
+            if (!replay->fast && due > now) {
+                replay_schedule(replay, due);
+                return;
+            }
+            replay_emit(replay, record->message);
+        }
+        replay->pos++;
+    }
+}
+
+/*==========================================================================*
+ * Client side
+ *==========================================================================*/
+
+static
+void
+replay_sync(
+    GHashTable* objects,
+    const GStrV* paths,
+    ReplayNewFunc create)
+{
+    GHashTable* current = g_hash_table_new(g_str_hash, g_str_equal);
+    GHashTableIter it;
+    gpointer key;
+
+    if (paths) {
+        const GStrV* ptr;
+
+        for (ptr = paths; *ptr; ptr++) {
+            g_hash_table_add(current, (gpointer)*ptr);
+            if (!g_hash_table_contains(objects, *ptr)) {
+                g_hash_table_insert(objects, g_strdup(*ptr), create(*ptr));
+            }
+        }
+    }
+    g_hash_table_iter_init(&it, objects);
+    while (g_hash_table_iter_next(&it, &key, NULL)) {
+        if (!g_hash_table_contains(current, key)) {
+            g_hash_table_iter_remove(&it);
+        }
+    }
+    g_hash_table_destroy(current);
+}
+
+static
+void
+replay_bsss_changed(
+    GSupplicantInterface* iface,
+    void* data)
+{
+    ReplayIface* ri = data;
+
+    replay_sync(ri->bsss, iface->bsss, (ReplayNewFunc)gsupplicant_bss_new);
+}
+
+static
+void
+replay_networks_changed(
+    GSupplicantInterface* iface,
+    void* data)
+{
+    ReplayIface* ri = data;
+
+    replay_sync(ri->networks, iface->networks,
+        (ReplayNewFunc)gsupplicant_network_new);
+}
+
+static
+gpointer
+replay_iface_new(
+    const char* path)
+{
+    ReplayIface* ri = g_slice_new0(ReplayIface);
+
+    ri->iface = gsupplicant_interface_new(path);
+    ri->bsss = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+        (GDestroyNotify)gsupplicant_bss_unref);
+    ri->networks = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+        (GDestroyNotify)gsupplicant_network_unref);
+    ri->handler_id[0] = gsupplicant_interface_add_handler(ri->iface,
+        GSUPPLICANT_INTERFACE_PROPERTY_BSSS, replay_bsss_changed, ri);
+    ri->handler_id[1] = gsupplicant_interface_add_handler(ri->iface,
+        GSUPPLICANT_INTERFACE_PROPERTY_NETWORKS, replay_networks_changed, ri);
+    replay_bsss_changed(ri->iface, ri);
+    replay_networks_changed(ri->iface, ri);
+    return ri;
+}
+
+static
+void
+replay_iface_free(
+    gpointer data)
+{
+    ReplayIface* ri = data;
+
+    gsupplicant_interface_remove_handlers(ri->iface, ri->handler_id,
+        G_N_ELEMENTS(ri->handler_id));
+    g_hash_table_destroy(ri->bsss);
+    g_hash_table_destroy(ri->networks);
+    gsupplicant_interface_unref(ri->iface);
+    g_slice_free(ReplayIface, ri);
+}
+
+static
+void
+replay_interfaces_changed(
+    GSupplicant* supplicant,
+    void* data)
+{
+    ReplayClient* client = data;
+
+    replay_sync(client->ifaces, supplicant->interfaces, replay_iface_new);
+}
+
+static
+void
+replay_client_init(
+    ReplayClient* client)
+{
+    client->supplicant = gsupplicant_new();
+    client->ifaces = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+        replay_iface_free);
+    client->supplicant_id = gsupplicant_add_handler(client->supplicant,
+        GSUPPLICANT_PROPERTY_INTERFACES, replay_interfaces_changed, client);
+}
+
+static
+void
+replay_client_deinit(
+    ReplayClient* client)
+{
+    g_hash_table_destroy(client->ifaces);
+    gsupplicant_remove_handler(client->supplicant, client->supplicant_id);
+    gsupplicant_unref(client->supplicant);
+}
+
+static
+guint
+replay_client_count(
+    ReplayClient* client,
+    gboolean bsss)
+{
+    GHashTableIter it;
+    gpointer value;
+    guint n = 0;
+
+    g_hash_table_iter_init(&it, client->ifaces);
+    while (g_hash_table_iter_next(&it, NULL, &value)) {
+        ReplayIface* ri = value;
+
+        n += g_hash_table_size(bsss ? ri->bsss : ri->networks);
+    }
+    return n;
+}
+
+/*==========================================================================*
+ * Main
+ *==========================================================================*/
+
+static
+void
+replay_run(
+    GPtrArray* records,
+    gboolean fast)
+{
+    GTestDBus* bus = g_test_dbus_new(G_TEST_DBUS_NONE);
+    GError* error = NULL;
+    ReplayClient client;
+    Replay replay;
+    TestAllocStats before, after;
+    gsize rss_before, rss_after;
+    gint64 start, cpu;
+    GVariant* ret;
+    double wall;
+
+    /* The library talks to the system bus */
+    g_test_dbus_up(bus);
+    g_setenv("DBUS_SYSTEM_BUS_ADDRESS", g_test_dbus_get_bus_address(bus),
+        TRUE);
+    g_unsetenv("GSUPPLICANT_JOURNAL");
+
+    memset(&replay, 0, sizeof(replay));
+    replay.records = records;
+    replay.fast = fast;
+    replay.loop = g_main_loop_new(NULL, FALSE);
+    replay.replies = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+        replay_queue_free);
+    replay.credits = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+        NULL);
+    replay_index(&replay);
+    replay.conn = g_dbus_connection_new_for_address_sync
+        (g_test_dbus_get_bus_address(bus),
+        G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+        G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION, NULL, NULL, &error);
+    g_assert_no_error(error);
+    g_dbus_connection_add_filter(replay.conn, replay_filter, &replay, NULL);
+    ret = g_dbus_connection_call_sync(replay.conn, "org.freedesktop.DBus",
+        "/org/freedesktop/DBus", "org.freedesktop.DBus", "RequestName",
+        g_variant_new("(su)", GSUPPLICANT_SERVICE, 0x4 /* DO_NOT_QUEUE */),
+        G_VARIANT_TYPE("(u)"), G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
+    g_assert_no_error(error);
+    g_variant_unref(ret);
+
+    rss_before = test_alloc_rss();
+    test_alloc_get_stats(&before);
+    start = g_get_monotonic_time();
+    cpu = test_bench_cpu_ns();
+
+    replay_client_init(&client);
+    replay_advance(&replay);
+    replay_settle(&replay);
+    g_main_loop_run(replay.loop);
+
+    cpu = test_bench_cpu_ns() - cpu;
+    wall = (g_get_monotonic_time() - start) / 1000.0;
+    test_alloc_get_stats(&after);
+    rss_after = test_alloc_rss();
+
+    test_bench_report("replay", "wall", wall, "ms", records->len);
+    test_bench_report("replay", "cpu", cpu / 1000000.0, "ms", records->len);
+    if (cpu > 0) {
+        test_bench_report("replay", "events_per_cpu_second",
+            (double)(replay.signals + replay.calls) * 1000000000.0 / cpu,
+            "events/s", records->len);
+    }
+    test_bench_report("replay", "signals", replay.signals, "count",
+        records->len);
+    test_bench_report("replay", "calls", replay.calls, "count",
+        records->len);
+    test_bench_report("replay", "unknown_calls", replay.unknown_calls,
+        "count", records->len);
+    test_bench_report("replay", "skipped_calls", replay.skipped, "count",
+        records->len);
+    test_bench_report("replay", "bss_objects",
+        replay_client_count(&client, TRUE), "count", records->len);
+    test_bench_report("replay", "network_objects",
+        replay_client_count(&client, FALSE), "count", records->len);
+    test_bench_report("replay", "rss_growth", (double)rss_after -
+        (double)rss_before, "bytes", records->len);
+    if (test_alloc_supported()) {
+        test_bench_report("replay", "allocs", after.allocs - before.allocs,
+            "count", records->len);
+        test_bench_report("replay", "alloc_bytes", after.bytes - before.bytes,
+            "bytes", records->len);
+    }
+
+    replay_client_deinit(&client);
+    replay.pos = records->len;
+    if (replay.timer_id) {
+        g_source_remove(replay.timer_id);
+    }
+    if (replay.settle_id) {
+        g_source_remove(replay.settle_id);
+    }
+    g_dbus_connection_close_sync(replay.conn, NULL, NULL);
+    g_object_unref(replay.conn);
+    /* Let the pending calls go */
+    while (g_main_context_iteration(NULL, FALSE));
+    g_hash_table_destroy(replay.replies);
+    g_hash_table_destroy(replay.credits);
+    g_main_loop_unref(replay.loop);
+    g_test_dbus_down(bus);
+    g_object_unref(bus);
+}
+
+int main(int argc, char* argv[])
+{
+    gboolean fast = FALSE;
+    gboolean verbose = FALSE;
+    GOptionEntry entries[] = {
+        { "fast", 'f', 0, G_OPTION_ARG_NONE, &fast,
+          "Replay as fast as possible", NULL },
+        { "verbose", 'v', 0, G_OPTION_ARG_NONE, &verbose,
+          "Enable verbose log", NULL },
+        { NULL }
+    };
+    GOptionContext* options;
+    GError* error = NULL;
+    int ret = 1;
+
+    options = g_option_context_new("JOURNAL");
+    g_option_context_add_main_entries(options, entries, NULL);
+    if (g_option_context_parse(options, &argc, &argv, &error)) {
+        if (argc == 2) {
+            GPtrArray* records;
+
+            gutil_log_timestamp = FALSE;
+            gutil_log_default.level = verbose ? GLOG_LEVEL_VERBOSE :
+                GLOG_LEVEL_ERR;
+            records = gsupplicant_journal_load(argv[1], &error);
+            if (records) {
+                replay_run(records, fast);
+                g_ptr_array_free(records, TRUE);
+                ret = 0;
+            } else {
+                fprintf(stderr, "%s\n", GERRMSG(error));
+                g_error_free(error);
+            }
+        } else {
+            char* help = g_option_context_get_help(options, TRUE, NULL);
+
+            fprintf(stderr, "%s", help);
+            g_free(help);
+        }
+    } else {
+        fprintf(stderr, "%s\n", GERRMSG(error));
+        g_error_free(error);
+    }
+    g_option_context_free(options);
+    return ret;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,3121 @@
+/*
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived from
+ *      this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "test_common.h"
+#include "test_supplicant_mock.h"
+
+#include "gsupplicant.h"
+#include "gsupplicant_interface.h"
+#include "gsupplicant_bss.h"
+#include "gsupplicant_catalog.h"
+#include "gsupplicant_embed.h"
+#include "gsupplicant_error.h"
+#include "gsupplicant_link_predictor.h"
+#include "gsupplicant_network.h"
+#include "gsupplicant_roam_profile.h"
+#include "gsupplicant_scan_planner.h"
+#include "gsupplicant_sched_scan.h"
+#include "gsupplicant_snapshot.h"
+#include "gsupplicant_journal_p.h"
+
+#include <gutil_log.h>
+#include <gutil_strv.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TEST_PREFIX "/gsupplicant/"
+#define TEST_TIMEOUT_SEC (10)
+
+static TestOpt test_opt;
+
+typedef struct test_wait {
+    GMainLoop* loop;
+    guint timeout_id;
+} TestWait;
+
+static
+gboolean
+test_timeout(
+    gpointer data)
+{
+    g_assert_not_reached();
+    return G_SOURCE_REMOVE;
+}
+
+static
+guint
+test_timeout_start(
+    void)
+{
+    return (test_opt.flags & TEST_FLAG_DEBUG) ? 0 :
+        g_timeout_add_seconds(TEST_TIMEOUT_SEC, test_timeout, NULL);
+}
+
+static
+void
+test_timeout_stop(
+    guint id)
+{
+    if (id) {
+        g_source_remove(id);
+    }
+}
+
+/* Spins the default context while the condition holds, up to the timeout */
+#define TEST_WAIT_WHILE(cond) G_STMT_START { \
+    const guint test_timeout_id = test_timeout_start(); \
+    while (cond) { \
+        g_main_context_iteration(NULL, TRUE); \
+    } \
+    test_timeout_stop(test_timeout_id); \
+} G_STMT_END
+
+static
+void
+test_wait_init(
+    TestWait* wait)
+{
+    wait->loop = g_main_loop_new(NULL, TRUE);
+    wait->timeout_id = test_timeout_start();
+}
+
+static
+void
+test_wait_run(
+    TestWait* wait)
+{
+    g_main_loop_run(wait->loop);
+    test_timeout_stop(wait->timeout_id);
+    wait->timeout_id = 0;
+    g_main_loop_unref(wait->loop);
+    wait->loop = NULL;
+}
+
+static
+void
+test_quit_when_valid(
+    GSupplicant* supplicant,
+    void* loop)
+{
+    if (supplicant->valid) {
+        g_main_loop_quit(loop);
+    }
+}
+
+static
+void
+test_iface_quit_when_valid(
+    GSupplicantInterface* iface,
+    void* loop)
+{
+    if (iface->valid) {
+        g_main_loop_quit(loop);
+    }
+}
+
+static
+void
+test_iface_quit(
+    GSupplicantInterface* iface,
+    void* loop)
+{
+    g_main_loop_quit(loop);
+}
+
+static
+void
+test_bss_quit(
+    GSupplicantBSS* bss,
+    void* loop)
+{
+    g_main_loop_quit(loop);
+}
+
+/* String property of a mock object, NULL if there's no such property */
+static
+const char*
+test_mock_string(
+    TestSupplicantMock* mock,
+    const char* path,
+    const char* name)
+{
+    GVariant* value = test_supplicant_mock_get_property(mock, path, name);
+
+    return value ? g_variant_get_string(value, NULL) : NULL;
+}
+
+static
+void
+test_iface_wait_valid(
+    GSupplicantInterface* iface)
+{
+    if (!iface->valid) {
+        TestWait wait;
+        gulong id;
+        test_wait_init(&wait);
+        id = gsupplicant_interface_add_handler(iface,
+            GSUPPLICANT_INTERFACE_PROPERTY_VALID,
+            test_iface_quit_when_valid, wait.loop);
+        test_wait_run(&wait);
+        gsupplicant_interface_remove_handler(iface, id);
+    }
+    g_assert(iface->valid);
+}
+
+/*==========================================================================*
+ * supplicant
+ *==========================================================================*/
+
+static
+void
+test_gsupplicant_supplicant_changed(
+    GSupplicant* supplicant,
+    GSUPPLICANT_PROPERTY property,
+    void* data)
+{
+    g_array_append_val((GArray*)data, property);
+}
+
+static
+void
+test_gsupplicant_supplicant_iface_changed(
+    GSupplicantInterface* iface,
+    GSUPPLICANT_INTERFACE_PROPERTY property,
+    void* data)
+{
+    g_array_append_val((GArray*)data, property);
+}
+
+static
+void
+test_gsupplicant_supplicant_bss_changed(
+    GSupplicantBSS* bss,
+    GSUPPLICANT_BSS_PROPERTY property,
+    void* data)
+{
+    g_array_append_val((GArray*)data, property);
+}
+
+static
+void
+test_gsupplicant_supplicant_network_changed(
+    GSupplicantNetwork* network,
+    GSUPPLICANT_NETWORK_PROPERTY property,
+    void* data)
+{
+    g_array_append_val((GArray*)data, property);
+}
+
+static
+void
+test_gsupplicant_supplicant(
+    void)
+{
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    GSupplicant* supplicant;
+    GSupplicantInterface* iface;
+    GSupplicantInterface* iface2;
+    GSupplicantBSS* bss;
+    GSupplicantBSS* bss2;
+    GSupplicantNetwork* network;
+    GSupplicantNetwork* network2;
+    GArray* changes;
+    GArray* iface_changes;
+    GArray* bss_changes;
+    GArray* network_changes;
+    gulong id, iface_id, bss_id, network_id;
+
+    memset(&config, 0, sizeof(config));
+    config.interfaces = 3;
+    config.bsss = 1;
+    config.networks = 1;
+    mock = test_supplicant_mock_new(&config);
+    supplicant = gsupplicant_new();
+    if (!supplicant->valid) {
+        TestWait wait;
+        gulong id;
+        test_wait_init(&wait);
+        id = gsupplicant_add_handler(supplicant, GSUPPLICANT_PROPERTY_VALID,
+            test_quit_when_valid, wait.loop);
+        test_wait_run(&wait);
+        gsupplicant_remove_handler(supplicant, id);
+    }
+    g_assert(supplicant->valid);
+    g_assert(gutil_strv_length(supplicant->interfaces) == 3);
+    g_assert(gutil_strv_contains(supplicant->interfaces,
+        test_supplicant_mock_interface_path(mock, 0)));
+
+    /* Resync doesn't change anything while wpa_supplicant is there */
+    gsupplicant_set_resync_timeout(NULL, 1000);
+    gsupplicant_set_resync_timeout(supplicant, 1000);
+    g_assert(supplicant->valid);
+
+    /* Objects which are supposed to survive the restart */
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    test_iface_wait_valid(iface);
+    bss = gsupplicant_bss_new(iface->bsss[0]);
+    network = gsupplicant_network_new(iface->networks[0]);
+    TEST_WAIT_WHILE(!bss->valid || !network->valid);
+    g_assert_cmpuint(iface->ap_scan, ==, 1);
+    g_assert_cmpint(bss->signal, !=, -33);
+    g_assert(network->enabled);
+
+    /* Restart with one interface less, only that change gets signalled */
+    changes = g_array_new(FALSE, FALSE, sizeof(GSUPPLICANT_PROPERTY));
+    iface_changes = g_array_new(FALSE, FALSE,
+        sizeof(GSUPPLICANT_INTERFACE_PROPERTY));
+    bss_changes = g_array_new(FALSE, FALSE, sizeof(GSUPPLICANT_BSS_PROPERTY));
+    network_changes = g_array_new(FALSE, FALSE,
+        sizeof(GSUPPLICANT_NETWORK_PROPERTY));
+    id = gsupplicant_add_property_changed_handler(supplicant,
+        GSUPPLICANT_PROPERTY_ANY, test_gsupplicant_supplicant_changed,
+        changes);
+    iface_id = gsupplicant_interface_add_property_changed_handler(iface,
+        GSUPPLICANT_INTERFACE_PROPERTY_ANY,
+        test_gsupplicant_supplicant_iface_changed, iface_changes);
+    bss_id = gsupplicant_bss_add_property_changed_handler(bss,
+        GSUPPLICANT_BSS_PROPERTY_ANY,
+        test_gsupplicant_supplicant_bss_changed, bss_changes);
+    network_id = gsupplicant_network_add_property_changed_handler(network,
+        GSUPPLICANT_NETWORK_PROPERTY_ANY,
+        test_gsupplicant_supplicant_network_changed, network_changes);
+    test_supplicant_mock_drop_name(mock);
+    g_assert(test_supplicant_mock_remove_interface(mock, 2));
+
+    /* One property of each object changes while wpa_supplicant is away */
+    g_assert(test_supplicant_mock_set_property(mock, iface->path,
+        "ApScan", g_variant_new_uint32(2)));
+    g_assert(test_supplicant_mock_set_bss_signal(mock, bss->path, -33));
+    g_assert(test_supplicant_mock_set_property(mock, network->path,
+        "Enabled", g_variant_new_boolean(FALSE)));
+    test_supplicant_mock_claim_name(mock);
+    TEST_WAIT_WHILE(gutil_strv_length(supplicant->interfaces) != 2 ||
+        iface->ap_scan != 2 || bss->signal != -33 || network->enabled);
+    while (g_main_context_iteration(NULL, FALSE));
+    g_assert(supplicant->valid);
+    g_assert_cmpuint(changes->len, ==, 1);
+    g_assert_cmpint(g_array_index(changes, GSUPPLICANT_PROPERTY, 0), ==,
+        GSUPPLICANT_PROPERTY_INTERFACES);
+    g_assert(gutil_strv_contains(supplicant->interfaces,
+        test_supplicant_mock_interface_path(mock, 1)));
+
+    /* Same objects, still valid, and nothing but the actual changes */
+    iface2 = gsupplicant_interface_new(iface->path);
+    bss2 = gsupplicant_bss_new(bss->path);
+    network2 = gsupplicant_network_new(network->path);
+    g_assert(iface2 == iface);
+    g_assert(bss2 == bss);
+    g_assert(network2 == network);
+    gsupplicant_interface_unref(iface2);
+    gsupplicant_bss_unref(bss2);
+    gsupplicant_network_unref(network2);
+    g_assert(iface->valid);
+    g_assert(iface->present);
+    g_assert(bss->valid);
+    g_assert(bss->present);
+    g_assert(network->valid);
+    g_assert(network->present);
+    g_assert_cmpuint(iface_changes->len, ==, 1);
+    g_assert_cmpint(g_array_index(iface_changes,
+        GSUPPLICANT_INTERFACE_PROPERTY, 0), ==,
+        GSUPPLICANT_INTERFACE_PROPERTY_AP_SCAN);
+    g_assert_cmpuint(bss_changes->len, ==, 1);
+    g_assert_cmpint(g_array_index(bss_changes, GSUPPLICANT_BSS_PROPERTY,
+        0), ==, GSUPPLICANT_BSS_PROPERTY_SIGNAL);
+    g_assert_cmpuint(network_changes->len, ==, 1);
+    g_assert_cmpint(g_array_index(network_changes,
+        GSUPPLICANT_NETWORK_PROPERTY, 0), ==,
+        GSUPPLICANT_NETWORK_PROPERTY_ENABLED);
+
+    gsupplicant_remove_handler(supplicant, id);
+    gsupplicant_interface_remove_handler(iface, iface_id);
+    gsupplicant_bss_remove_handler(bss, bss_id);
+    gsupplicant_network_remove_handler(network, network_id);
+    g_array_free(changes, TRUE);
+    g_array_free(iface_changes, TRUE);
+    g_array_free(bss_changes, TRUE);
+    g_array_free(network_changes, TRUE);
+    gsupplicant_network_unref(network);
+    gsupplicant_bss_unref(bss);
+    gsupplicant_interface_unref(iface);
+    gsupplicant_set_resync_timeout(supplicant, 0);
+    gsupplicant_unref(supplicant);
+    test_supplicant_mock_free(mock);
+}
+
+/*==========================================================================*
+ * bss
+ *==========================================================================*/
+
+static
+void
+test_gsupplicant_bss(
+    void)
+{
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface;
+    TestWait wait;
+    gulong id;
+    const char* path;
+
+    memset(&config, 0, sizeof(config));
+    config.interfaces = 1;
+    config.bsss = 5;
+    mock = test_supplicant_mock_new(&config);
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    test_iface_wait_valid(iface);
+    g_assert(gutil_strv_length(iface->bsss) == 5);
+
+    /* Add one more */
+    test_wait_init(&wait);
+    id = gsupplicant_interface_add_handler(iface,
+        GSUPPLICANT_INTERFACE_PROPERTY_BSSS, test_iface_quit, wait.loop);
+    path = test_supplicant_mock_add_bss(mock, 0);
+    test_wait_run(&wait);
+    g_assert(gutil_strv_length(iface->bsss) == 6);
+    g_assert(gutil_strv_contains(iface->bsss, path));
+
+    /* And remove it */
+    test_wait_init(&wait);
+    gsupplicant_interface_remove_handler(iface, id);
+    id = gsupplicant_interface_add_handler(iface,
+        GSUPPLICANT_INTERFACE_PROPERTY_BSSS, test_iface_quit, wait.loop);
+    g_assert(test_supplicant_mock_remove_bss(mock, path));
+    test_wait_run(&wait);
+    g_assert(gutil_strv_length(iface->bsss) == 5);
+
+    gsupplicant_interface_remove_handler(iface, id);
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+}
+
+/*==========================================================================*
+ * bss_data
+ *==========================================================================*/
+
+static
+void
+test_gsupplicant_bss_data(
+    void)
+{
+    static const char long_ssid[] = "0123456789abcdef0123456789abcdefX";
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface;
+    GSupplicantBSS* bss;
+    const guint8* data;
+    const char* path;
+    gsize size = 1;
+
+    g_assert(!gsupplicant_bss_bssid_data(NULL, &size));
+    g_assert(!size);
+    g_assert(!gsupplicant_bss_ssid_data(NULL, NULL));
+
+    mock = test_supplicant_mock_new(NULL);
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    test_iface_wait_valid(iface);
+    path = test_supplicant_mock_add_bss(mock, 0);
+    bss = gsupplicant_bss_new(path);
+    TEST_WAIT_WHILE(!bss->valid);
+
+    /* Inline copies match the GBytes */
+    data = gsupplicant_bss_bssid_data(bss, &size);
+    g_assert(data);
+    g_assert_cmpuint(size, ==, 6);
+    g_assert(!memcmp(data, g_bytes_get_data(bss->bssid, NULL), size));
+    g_assert(gsupplicant_bss_bssid_data(bss, NULL) == data);
+    data = gsupplicant_bss_ssid_data(bss, &size);
+    g_assert_cmpuint(size, ==, g_bytes_get_size(bss->ssid));
+    g_assert(!memcmp(data, g_bytes_get_data(bss->ssid, NULL), size));
+    g_assert_cmpstr(bss->ssid_str, ==, "mock-0");
+
+    /* Maximum length SSID */
+    g_assert(test_supplicant_mock_set_bss_ssid(mock, path, "0123456789"
+        "abcdef0123456789abcdef"));
+    TEST_WAIT_WHILE(g_bytes_get_size(bss->ssid) != 32);
+    data = gsupplicant_bss_ssid_data(bss, &size);
+    g_assert_cmpuint(size, ==, 32);
+    g_assert(!memcmp(data, long_ssid, size));
+    g_assert_cmpuint(strlen(bss->ssid_str), ==, 32);
+
+    /* 33 bytes is too long and gets rejected, the SSID stays */
+    g_assert(test_supplicant_mock_set_bss_ssid(mock, path, long_ssid));
+    g_assert(test_supplicant_mock_set_bss_signal(mock, path, -11));
+    TEST_WAIT_WHILE(bss->signal != -11);
+    g_assert(bss->ssid);
+    g_assert_cmpuint(g_bytes_get_size(bss->ssid), ==, 32);
+    g_assert(gsupplicant_bss_ssid_data(bss, &size));
+    g_assert_cmpuint(size, ==, 32);
+
+    /* Same for BSSID */
+    g_assert(test_supplicant_mock_set_property(mock, path, "BSSID",
+        g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, long_ssid, 7, 1)));
+    g_assert(test_supplicant_mock_set_bss_signal(mock, path, -12));
+    TEST_WAIT_WHILE(bss->signal != -12);
+    g_assert(gsupplicant_bss_bssid_data(bss, &size));
+    g_assert_cmpuint(size, ==, 6);
+    g_assert(gsupplicant_interface_find_bss(iface, bss->bssid) == bss);
+
+    gsupplicant_bss_unref(bss);
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+}
+
+/*==========================================================================*
+ * bss_index
+ *==========================================================================*/
+
+static
+gboolean
+test_gsupplicant_bss_index_contains(
+    GSupplicantInterface* iface,
+    GSupplicantBSS* bss,
+    guint frequency)
+{
+    const GPtrArray* list = gsupplicant_interface_find_bsss_on_frequency
+        (iface, frequency);
+    guint i;
+
+    for (i = 0; list && i < list->len; i++) {
+        if (list->pdata[i] == bss) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static
+void
+test_gsupplicant_bss_index(
+    void)
+{
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface;
+    GSupplicantBSS* bss[3];
+    GBytes* bssid;
+    guint i, freq;
+
+    g_assert(!gsupplicant_interface_find_bss(NULL, NULL));
+    g_assert(!gsupplicant_interface_find_bsss_on_frequency(NULL, 2412));
+
+    memset(&config, 0, sizeof(config));
+    config.interfaces = 1;
+    config.bsss = G_N_ELEMENTS(bss);
+    mock = test_supplicant_mock_new(&config);
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    test_iface_wait_valid(iface);
+    g_assert(!gsupplicant_interface_find_bss(iface, NULL));
+    g_assert(!gsupplicant_interface_find_bsss_on_frequency(iface, 0));
+
+    /* Nothing is indexed until BSS objects get created */
+    g_assert(!gsupplicant_interface_find_bsss_on_frequency(iface, 2412));
+    for (i = 0; i < G_N_ELEMENTS(bss); i++) {
+        bss[i] = gsupplicant_bss_new(iface->bsss[i]);
+        TEST_WAIT_WHILE(!bss[i]->valid);
+        g_assert(bss[i]->bssid);
+        g_assert(bss[i]->frequency);
+    }
+    for (i = 0; i < G_N_ELEMENTS(bss); i++) {
+        g_assert(gsupplicant_interface_find_bss(iface, bss[i]->bssid) ==
+            bss[i]);
+        g_assert(test_gsupplicant_bss_index_contains(iface, bss[i],
+            bss[i]->frequency));
+    }
+
+    /* Put the first two on the same channel */
+    freq = bss[1]->frequency;
+    g_assert(test_supplicant_mock_set_property(mock, bss[0]->path,
+        "Frequency", g_variant_new_uint16(freq)));
+    TEST_WAIT_WHILE(bss[0]->frequency != freq);
+    g_assert_cmpuint(gsupplicant_interface_find_bsss_on_frequency(iface,
+        freq)->len, ==, 2);
+    g_assert(test_gsupplicant_bss_index_contains(iface, bss[0], freq));
+    g_assert(test_gsupplicant_bss_index_contains(iface, bss[1], freq));
+
+    /* And move the first one away */
+    g_assert(test_supplicant_mock_set_property(mock, bss[0]->path,
+        "Frequency", g_variant_new_uint16(5825)));
+    TEST_WAIT_WHILE(bss[0]->frequency != 5825);
+    g_assert(!test_gsupplicant_bss_index_contains(iface, bss[0], freq));
+    g_assert(test_gsupplicant_bss_index_contains(iface, bss[0], 5825));
+    g_assert_cmpuint(gsupplicant_interface_find_bsss_on_frequency(iface,
+        freq)->len, ==, 1);
+
+    /* Changing BSSID re-indexes the BSS */
+    bssid = g_bytes_ref(bss[2]->bssid);
+    g_assert(test_supplicant_mock_set_property(mock, bss[2]->path, "BSSID",
+        g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE,
+        "\x02\xff\xff\xff\xff\xff", 6, 1)));
+    TEST_WAIT_WHILE(g_bytes_equal(bss[2]->bssid, bssid));
+    g_assert(!gsupplicant_interface_find_bss(iface, bssid));
+    g_assert(gsupplicant_interface_find_bss(iface, bss[2]->bssid) == bss[2]);
+    g_bytes_unref(bssid);
+
+    /* Destroyed BSS disappears from both tables */
+    bssid = g_bytes_ref(bss[0]->bssid);
+    gsupplicant_bss_unref(bss[0]);
+    g_assert(!gsupplicant_interface_find_bss(iface, bssid));
+    g_assert(!gsupplicant_interface_find_bsss_on_frequency(iface, 5825));
+    g_assert(gsupplicant_interface_find_bss(iface, bss[1]->bssid) == bss[1]);
+    g_bytes_unref(bssid);
+
+    for (i = 1; i < G_N_ELEMENTS(bss); i++) {
+        gsupplicant_bss_unref(bss[i]);
+    }
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+}
+
+/*==========================================================================*
+ * bss_expiry
+ *==========================================================================*/
+
+static
+void
+test_gsupplicant_bss_expiry(
+    void)
+{
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface;
+    GSupplicantBSS* bss;
+    GSupplicantBSSExpiry expiry;
+    TestWait wait;
+    char* path;
+    gint64 now;
+    gulong id;
+
+    memset(&expiry, 0, sizeof(expiry));
+    g_assert(!gsupplicant_interface_set_bss_expire_age(NULL, 10));
+    g_assert(!gsupplicant_interface_set_bss_expire_count(NULL, 2));
+    g_assert(!gsupplicant_interface_set_bss_expiry(NULL, &expiry));
+
+    memset(&config, 0, sizeof(config));
+    config.interfaces = 1;
+    config.bsss = 2;
+    mock = test_supplicant_mock_new(&config);
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    g_assert(!gsupplicant_interface_set_bss_expiry(iface, &expiry));
+    test_iface_wait_valid(iface);
+
+    /* Age is converted into the last seen time */
+    now = g_get_monotonic_time();
+    bss = gsupplicant_bss_new(iface->bsss[0]);
+    if (!bss->valid) {
+        test_wait_init(&wait);
+        id = gsupplicant_bss_add_handler(bss, GSUPPLICANT_BSS_PROPERTY_VALID,
+            test_bss_quit, wait.loop);
+        test_wait_run(&wait);
+        gsupplicant_bss_remove_handler(bss, id);
+    }
+    g_assert(!bss->age);
+    g_assert(bss->last_seen >= now);
+    g_assert(bss->last_seen <= g_get_monotonic_time());
+
+    g_assert(gsupplicant_interface_set_bss_expire_age(iface, 30));
+    g_assert(gsupplicant_interface_set_bss_expire_count(iface, 2));
+
+    /* Flushing requires max_age */
+    expiry.flush_interval = 1;
+    g_assert(!gsupplicant_interface_set_bss_expiry(iface, &expiry));
+
+    /* The first BSS hasn't been seen for a while */
+    test_wait_init(&wait);
+    id = gsupplicant_bss_add_handler(bss, GSUPPLICANT_BSS_PROPERTY_AGE,
+        test_bss_quit, wait.loop);
+    g_assert(test_supplicant_mock_set_property(mock, bss->path, "Age",
+        g_variant_new_uint32(300)));
+    test_wait_run(&wait);
+    gsupplicant_bss_remove_handler(bss, id);
+    g_assert_cmpuint(bss->age, ==, 300);
+    g_assert(bss->last_seen <= g_get_monotonic_time() -
+        300 * G_TIME_SPAN_SECOND);
+
+    /* Only that one gets flushed, the fresh one survives */
+    path = g_strdup(iface->bsss[1]);
+    expiry.max_age = 180;
+    expiry.max_count = 1;
+    test_wait_init(&wait);
+    id = gsupplicant_interface_add_handler(iface,
+        GSUPPLICANT_INTERFACE_PROPERTY_BSSS, test_iface_quit, wait.loop);
+    g_assert(gsupplicant_interface_set_bss_expiry(iface, &expiry));
+    test_wait_run(&wait);
+    gsupplicant_interface_remove_handler(iface, id);
+    g_assert_cmpuint(gutil_strv_length(iface->bsss), ==, 1);
+    g_assert_cmpstr(iface->bsss[0], ==, path);
+    g_assert_cmpuint(test_supplicant_mock_bss_count(mock, 0), ==, 1);
+    g_free(path);
+
+    g_assert(gsupplicant_interface_set_bss_expiry(iface, NULL));
+    gsupplicant_bss_unref(bss);
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+}
+
+/*==========================================================================*
+ * bss_roam
+ *==========================================================================*/
+
+typedef struct test_bss_roam {
+    gboolean done;
+    gboolean error;
+    gint64 gap;
+} TestBSSRoam;
+
+static
+void
+test_gsupplicant_bss_roam_done(
+    GSupplicantBSS* bss,
+    GCancellable* cancel,
+    const GError* error,
+    gint64 gap,
+    void* data)
+{
+    TestBSSRoam* roam = data;
+    roam->done = TRUE;
+    roam->error = (error != NULL);
+    roam->gap = gap;
+}
+
+static
+void
+test_gsupplicant_bss_roam(
+    void)
+{
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface;
+    GSupplicantBSS* bss[3];
+    GCancellable* cancel;
+    TestBSSRoam roam;
+    guint i;
+
+    g_assert(!gsupplicant_bss_roam(NULL, NULL, NULL));
+    g_assert(!gsupplicant_interface_roam(NULL, "02:00:00:00:00:00", NULL,
+        NULL));
+
+    memset(&config, 0, sizeof(config));
+    config.interfaces = 1;
+    config.bsss = G_N_ELEMENTS(bss);
+    config.roam_ms = 50;
+    mock = test_supplicant_mock_new(&config);
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    test_iface_wait_valid(iface);
+    g_assert(!gsupplicant_interface_roam(iface, NULL, NULL, NULL));
+
+    /* The first two BSSs belong to the same ESS */
+    g_assert(test_supplicant_mock_set_bss_ssid(mock, iface->bsss[1],
+        "mock-0"));
+    for (i = 0; i < G_N_ELEMENTS(bss); i++) {
+        bss[i] = gsupplicant_bss_new(iface->bsss[i]);
+        TEST_WAIT_WHILE(!bss[i]->valid);
+    }
+    TEST_WAIT_WHILE(!g_bytes_equal(bss[0]->ssid, bss[1]->ssid));
+
+    /* Not associated yet */
+    g_assert(!gsupplicant_bss_roam(bss[1], NULL, NULL));
+    g_assert(test_supplicant_mock_associate(mock, bss[0]->path));
+    TEST_WAIT_WHILE(iface->state != GSUPPLICANT_INTERFACE_STATE_COMPLETED ||
+        g_strcmp0(iface->current_bss, bss[0]->path));
+
+    /* Already there and different SSID */
+    g_assert(!gsupplicant_bss_roam(bss[0], NULL, NULL));
+    g_assert(!gsupplicant_bss_roam(bss[2], NULL, NULL));
+
+    /* Roam to the second one */
+    memset(&roam, 0, sizeof(roam));
+    g_assert(gsupplicant_bss_roam(bss[1], test_gsupplicant_bss_roam_done,
+        &roam));
+    TEST_WAIT_WHILE(!roam.done);
+    g_assert(!roam.error);
+    g_assert(roam.gap >= config.roam_ms * 1000 / 2);
+    g_assert_cmpstr(iface->current_bss, ==, bss[1]->path);
+
+    /* Cancel the roam back, the supplicant completes it anyway */
+    memset(&roam, 0, sizeof(roam));
+    cancel = gsupplicant_bss_roam(bss[0], test_gsupplicant_bss_roam_done,
+        &roam);
+    g_assert(cancel);
+    g_cancellable_cancel(cancel);
+    TEST_WAIT_WHILE(g_strcmp0(iface->current_bss, bss[0]->path));
+    g_assert(!roam.done);
+
+    /* Roam() failure */
+    test_supplicant_mock_set_method_error(mock, "Roam",
+        "fi.w1.wpa_supplicant1.UnknownError");
+    g_assert(gsupplicant_bss_roam(bss[1], test_gsupplicant_bss_roam_done,
+        &roam));
+    TEST_WAIT_WHILE(!roam.done);
+    g_assert(roam.error);
+    g_assert(!roam.gap);
+
+    for (i = 0; i < G_N_ELEMENTS(bss); i++) {
+        gsupplicant_bss_unref(bss[i]);
+    }
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+}
+
+/*==========================================================================*
+ * network_properties
+ *==========================================================================*/
+
+static
+GVariant*
+test_gsupplicant_network_dict(
+    const char* ssid,
+    const char* priority)
+{
+    GVariantBuilder builder;
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_add(&builder, "{sv}", "ssid",
+        g_variant_new_string(ssid));
+    if (priority) {
+        g_variant_builder_add(&builder, "{sv}", "priority",
+            g_variant_new_string(priority));
+    }
+    return g_variant_builder_end(&builder);
+}
+
+static
+void
+test_gsupplicant_network_count(
+    GSupplicantNetwork* network,
+    void* count)
+{
+    (*(guint*)count)++;
+}
+
+static
+void
+test_gsupplicant_network_properties(
+    void)
+{
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface;
+    GSupplicantNetwork* network;
+    const GSupplicantNetworkKeyValue* kv;
+    guint count = 0, changes = 0;
+    gulong id;
+
+    memset(&config, 0, sizeof(config));
+    config.interfaces = 1;
+    config.networks = 1;
+    mock = test_supplicant_mock_new(&config);
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    test_iface_wait_valid(iface);
+    network = gsupplicant_network_new(iface->networks[0]);
+    TEST_WAIT_WHILE(!network->valid);
+    g_assert(network->properties);
+    g_assert_cmpstr(g_hash_table_lookup(network->properties, "ssid"), ==,
+        "\"mock-0\"");
+    g_assert_cmpstr(gsupplicant_network_property(network, "priority"), ==,
+        "0");
+    id = gsupplicant_network_add_handler(network,
+        GSUPPLICANT_NETWORK_PROPERTY_PROPERTIES,
+        test_gsupplicant_network_count, &changes);
+
+    /* First change */
+    g_assert(test_supplicant_mock_set_property(mock, network->path,
+        "Properties", test_gsupplicant_network_dict("\"one\"", "1")));
+    TEST_WAIT_WHILE(changes < 1);
+    g_assert_cmpuint(g_hash_table_size(network->properties), ==, 2);
+    g_assert_cmpstr(g_hash_table_lookup(network->properties, "ssid"), ==,
+        "\"one\"");
+    g_assert_cmpstr(g_hash_table_lookup(network->properties, "priority"),
+        ==, "1");
+    kv = gsupplicant_network_properties(network, &count);
+    g_assert_cmpuint(count, ==, 2);
+    g_assert_cmpstr(kv[0].key, ==, "priority");
+    g_assert_cmpstr(kv[0].value, ==, "1");
+    g_assert_cmpstr(kv[1].key, ==, "ssid");
+    g_assert_cmpstr(kv[1].value, ==, "\"one\"");
+
+    /* Second one replaces the dictionary again */
+    g_assert(test_supplicant_mock_set_property(mock, network->path,
+        "Properties", test_gsupplicant_network_dict("\"two\"", NULL)));
+    TEST_WAIT_WHILE(changes < 2);
+    g_assert_cmpuint(g_hash_table_size(network->properties), ==, 1);
+    g_assert_cmpstr(g_hash_table_lookup(network->properties, "ssid"), ==,
+        "\"two\"");
+    g_assert(!g_hash_table_lookup(network->properties, "priority"));
+    kv = gsupplicant_network_properties(network, &count);
+    g_assert_cmpuint(count, ==, 1);
+    g_assert_cmpstr(kv[0].value, ==, "\"two\"");
+    g_assert(!gsupplicant_network_property(network, "priority"));
+
+    /* Something else changes, the view stays intact */
+    g_assert(test_supplicant_mock_set_property(mock, network->path,
+        "Enabled", g_variant_new_boolean(FALSE)));
+    TEST_WAIT_WHILE(network->enabled);
+    g_assert_cmpuint(changes, ==, 2);
+    g_assert(gsupplicant_network_properties(network, NULL) == kv);
+    g_assert_cmpstr(gsupplicant_network_property(network, "ssid"), ==,
+        "\"two\"");
+
+    gsupplicant_network_remove_handler(network, id);
+    gsupplicant_network_unref(network);
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+}
+
+/*==========================================================================*
+ * network_properties_keys
+ *==========================================================================*/
+
+typedef struct test_network_keys {
+    GString* keys;
+    guint changes;
+    guint priority;
+    guint psk;
+} TestNetworkKeys;
+
+static
+void
+test_gsupplicant_network_key_any(
+    GSupplicantNetwork* network,
+    const char* key,
+    void* data)
+{
+    TestNetworkKeys* test = data;
+
+    if (test->keys->len) {
+        g_string_append_c(test->keys, ',');
+    }
+    g_string_append(test->keys, key);
+}
+
+static
+void
+test_gsupplicant_network_key_count(
+    GSupplicantNetwork* network,
+    const char* key,
+    void* count)
+{
+    (*(guint*)count)++;
+}
+
+static
+void
+test_gsupplicant_network_keys_changed(
+    GSupplicantNetwork* network,
+    void* data)
+{
+    TestNetworkKeys* test = data;
+
+    test->changes++;
+}
+
+/* Copies the current dictionary, with up to two keys set or removed */
+static
+GVariant*
+test_gsupplicant_network_dict_set2(
+    GSupplicantNetwork* network,
+    const char* key1,
+    const char* value1, /* NULL to remove */
+    const char* key2,   /* Optional */
+    const char* value2)
+{
+    GVariantBuilder builder;
+    const GSupplicantNetworkKeyValue* kv;
+    guint i, count = 0;
+
+    kv = gsupplicant_network_properties(network, &count);
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+    for (i = 0; i < count; i++) {
+        if (g_strcmp0(kv[i].key, key1) && g_strcmp0(kv[i].key, key2)) {
+            g_variant_builder_add(&builder, "{sv}", kv[i].key,
+                g_variant_new_string(kv[i].value));
+        }
+    }
+    if (value1) {
+        g_variant_builder_add(&builder, "{sv}", key1,
+            g_variant_new_string(value1));
+    }
+    if (key2 && value2) {
+        g_variant_builder_add(&builder, "{sv}", key2,
+            g_variant_new_string(value2));
+    }
+    return g_variant_builder_end(&builder);
+}
+
+static
+GVariant*
+test_gsupplicant_network_dict_set(
+    GSupplicantNetwork* network,
+    const char* key,
+    const char* value)
+{
+    return test_gsupplicant_network_dict_set2(network, key, value,
+        NULL, NULL);
+}
+
+static
+void
+test_gsupplicant_network_properties_keys(
+    void)
+{
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface;
+    GSupplicantNetwork* network;
+    TestNetworkKeys test;
+    gulong id[4];
+
+    memset(&config, 0, sizeof(config));
+    memset(&test, 0, sizeof(test));
+    config.interfaces = 1;
+    config.networks = 1;
+    test.keys = g_string_new(NULL);
+    mock = test_supplicant_mock_new(&config);
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    test_iface_wait_valid(iface);
+    network = gsupplicant_network_new(iface->networks[0]);
+    TEST_WAIT_WHILE(!network->valid);
+    g_assert_cmpstr(gsupplicant_network_property(network, "psk"), ==,
+        "\"password\"");
+    id[0] = gsupplicant_network_add_properties_key_handler(network, NULL,
+        test_gsupplicant_network_key_any, &test);
+    id[1] = gsupplicant_network_add_properties_key_handler(network,
+        "priority", test_gsupplicant_network_key_count, &test.priority);
+    id[2] = gsupplicant_network_add_properties_key_handler(network,
+        "psk", test_gsupplicant_network_key_count, &test.psk);
+    id[3] = gsupplicant_network_add_handler(network,
+        GSUPPLICANT_NETWORK_PROPERTY_PROPERTIES,
+        test_gsupplicant_network_keys_changed, &test);
+    g_assert(id[0] && id[1] && id[2] && id[3]);
+
+    /* Modified key */
+    g_assert(test_supplicant_mock_set_property(mock, network->path,
+        "Properties", test_gsupplicant_network_dict_set(network,
+        "priority", "5")));
+    TEST_WAIT_WHILE(test.changes < 1);
+    g_assert_cmpstr(test.keys->str, ==, "priority");
+    g_assert_cmpuint(test.priority, ==, 1);
+    g_assert_cmpuint(test.psk, ==, 0);
+    g_assert_cmpstr(gsupplicant_network_property(network, "priority"), ==,
+        "5");
+
+    /* Added key */
+    g_string_truncate(test.keys, 0);
+    g_assert(test_supplicant_mock_set_property(mock, network->path,
+        "Properties", test_gsupplicant_network_dict_set(network,
+        "bgscan", "\"simple\"")));
+    TEST_WAIT_WHILE(test.changes < 2);
+    g_assert_cmpstr(test.keys->str, ==, "bgscan");
+    g_assert_cmpuint(test.priority, ==, 1);
+    g_assert_cmpuint(test.psk, ==, 0);
+    g_assert_cmpstr(gsupplicant_network_property(network, "bgscan"), ==,
+        "\"simple\"");
+
+    /* Removed key */
+    g_string_truncate(test.keys, 0);
+    g_assert(test_supplicant_mock_set_property(mock, network->path,
+        "Properties", test_gsupplicant_network_dict_set(network,
+        "psk", NULL)));
+    TEST_WAIT_WHILE(test.changes < 3);
+    g_assert_cmpstr(test.keys->str, ==, "psk");
+    g_assert_cmpuint(test.priority, ==, 1);
+    g_assert_cmpuint(test.psk, ==, 1);
+    g_assert(!gsupplicant_network_property(network, "psk"));
+
+    /*
+     * Identical dictionary (a new variant though). The mock emits
+     * PropertiesChanged anyway but nothing is reported. The change
+     * following it is the only one that shows up.
+     */
+    g_string_truncate(test.keys, 0);
+    g_assert(test_supplicant_mock_set_property(mock, network->path,
+        "Properties", test_gsupplicant_network_dict_set(network,
+        "psk", NULL)));
+    g_assert(test_supplicant_mock_set_property(mock, network->path,
+        "Properties", test_gsupplicant_network_dict_set(network,
+        "bgscan", NULL)));
+    TEST_WAIT_WHILE(test.changes < 4);
+    g_assert_cmpstr(test.keys->str, ==, "bgscan");
+    g_assert_cmpuint(test.changes, ==, 4);
+    g_assert_cmpuint(test.priority, ==, 1);
+    g_assert_cmpuint(test.psk, ==, 1);
+
+    /* Two keys in one update, the rest stays quiet */
+    g_string_truncate(test.keys, 0);
+    g_assert(test_supplicant_mock_set_property(mock, network->path,
+        "Properties", test_gsupplicant_network_dict_set2(network,
+        "priority", "8", "psk", "\"secret\"")));
+    TEST_WAIT_WHILE(test.changes < 5);
+    g_assert_cmpstr(test.keys->str, ==, "priority,psk");
+    g_assert_cmpuint(test.changes, ==, 5);
+    g_assert_cmpuint(test.priority, ==, 2);
+    g_assert_cmpuint(test.psk, ==, 2);
+    g_assert_cmpstr(gsupplicant_network_property(network, "psk"), ==,
+        "\"secret\"");
+
+    gsupplicant_network_remove_all_handlers(network, id);
+    gsupplicant_network_unref(network);
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+    g_string_free(test.keys, TRUE);
+}
+
+/*==========================================================================*
+ * catalog
+ *==========================================================================*/
+
+static
+void
+test_gsupplicant_catalog_changed(
+    GSupplicantCatalog* catalog,
+    void* count)
+{
+    (*(guint*)count)++;
+}
+
+static
+gboolean
+test_gsupplicant_catalog_ready(
+    GSupplicantCatalog* catalog,
+    GSupplicantInterface* iface)
+{
+    const GStrV* ptr;
+    for (ptr = iface->networks; ptr && *ptr; ptr++) {
+        const GSupplicantCatalogEntry* entry =
+            gsupplicant_catalog_get(catalog, *ptr);
+        if (!entry || !entry->ssid) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static
+void
+test_gsupplicant_catalog(
+    void)
+{
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface;
+    GSupplicantCatalog* catalog;
+    const GSupplicantCatalogEntry* e0;
+    const GSupplicantCatalogEntry* e1;
+    const GPtrArray* list;
+    GBytes* ssid0 = g_bytes_new_static("mock-0", 6);
+    GBytes* ssid1 = g_bytes_new_static("mock-1", 6);
+    GVariantBuilder builder;
+    char* path0;
+    guint changes = 0;
+    gulong id;
+
+    g_assert(!gsupplicant_catalog_new(NULL));
+    g_assert(!gsupplicant_catalog_ref(NULL));
+    gsupplicant_catalog_unref(NULL);
+    g_assert(!gsupplicant_catalog_add_changed_handler(NULL, NULL, NULL));
+    gsupplicant_catalog_remove_handler(NULL, 0);
+    g_assert(!gsupplicant_catalog_get(NULL, NULL));
+    g_assert(!gsupplicant_catalog_find_ssid(NULL, ssid0));
+    g_assert(!gsupplicant_catalog_find_keymgmt(NULL,
+        GSUPPLICANT_KEYMGMT_WPA_PSK));
+    g_assert(!gsupplicant_catalog_lookup(NULL, ssid0,
+        GSUPPLICANT_KEYMGMT_WPA_PSK));
+
+    memset(&config, 0, sizeof(config));
+    config.interfaces = 1;
+    config.networks = 2;
+    mock = test_supplicant_mock_new(&config);
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    test_iface_wait_valid(iface);
+    g_assert_cmpuint(gutil_strv_length(iface->networks), ==, 2);
+
+    catalog = gsupplicant_catalog_new(iface);
+    g_assert(gsupplicant_catalog_ref(catalog) == catalog);
+    gsupplicant_catalog_unref(catalog);
+    g_assert(!gsupplicant_catalog_add_changed_handler(catalog, NULL, NULL));
+    id = gsupplicant_catalog_add_changed_handler(catalog,
+        test_gsupplicant_catalog_changed, &changes);
+    TEST_WAIT_WHILE(!test_gsupplicant_catalog_ready(catalog, iface));
+    g_assert_cmpuint(catalog->count, ==, 2);
+    g_assert(!gsupplicant_catalog_get(catalog, "/none"));
+
+    /* Lookups */
+    path0 = g_strdup(iface->networks[0]);
+    e0 = gsupplicant_catalog_get(catalog, iface->networks[0]);
+    e1 = gsupplicant_catalog_get(catalog, iface->networks[1]);
+    g_assert(e0);
+    g_assert(e1);
+    g_assert_cmpstr(e0->path, ==, path0);
+    g_assert(e0->network);
+    g_assert(g_bytes_equal(e0->ssid, ssid0));
+    g_assert(g_bytes_equal(e1->ssid, ssid1));
+    g_assert_cmpuint(e0->keymgmt, ==, GSUPPLICANT_KEYMGMT_WPA_PSK);
+    g_assert(!e0->priority);
+    g_assert(!e0->disabled);
+    list = gsupplicant_catalog_find_ssid(catalog, ssid0);
+    g_assert(list);
+    g_assert_cmpuint(list->len, ==, 1);
+    g_assert(list->pdata[0] == e0);
+    list = gsupplicant_catalog_find_keymgmt(catalog,
+        GSUPPLICANT_KEYMGMT_WPA_PSK);
+    g_assert(list);
+    g_assert_cmpuint(list->len, ==, 2);
+    g_assert(!gsupplicant_catalog_find_keymgmt(catalog,
+        GSUPPLICANT_KEYMGMT_WPA_EAP));
+    g_assert(!gsupplicant_catalog_find_keymgmt(catalog,
+        GSUPPLICANT_KEYMGMT_WPA_PSK | GSUPPLICANT_KEYMGMT_WPA_EAP));
+    g_assert(gsupplicant_catalog_lookup(catalog, ssid1,
+        GSUPPLICANT_KEYMGMT_WPA_PSK | GSUPPLICANT_KEYMGMT_WPA_EAP) == e1);
+    g_assert(!gsupplicant_catalog_lookup(catalog, ssid1,
+        GSUPPLICANT_KEYMGMT_WPA_EAP));
+
+    /* Update re-indexes the entry */
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_add(&builder, "{sv}", "ssid",
+        g_variant_new_string("\"mock-1\""));
+    g_variant_builder_add(&builder, "{sv}", "key_mgmt",
+        g_variant_new_string("WPA-EAP"));
+    g_variant_builder_add(&builder, "{sv}", "eap",
+        g_variant_new_string("PEAP"));
+    g_variant_builder_add(&builder, "{sv}", "priority",
+        g_variant_new_string("5"));
+    g_variant_builder_add(&builder, "{sv}", "disabled",
+        g_variant_new_string("1"));
+    changes = 0;
+    g_assert(test_supplicant_mock_set_property(mock, path0, "Properties",
+        g_variant_builder_end(&builder)));
+    TEST_WAIT_WHILE(!changes);
+    g_assert(gsupplicant_catalog_get(catalog, path0) == e0);
+    g_assert(g_bytes_equal(e0->ssid, ssid1));
+    g_assert_cmpuint(e0->keymgmt, ==, GSUPPLICANT_KEYMGMT_WPA_EAP);
+    g_assert_cmpuint(e0->eap, ==, GSUPPLICANT_EAP_METHOD_PEAP);
+    g_assert_cmpint(e0->priority, ==, 5);
+    g_assert(e0->disabled);
+    g_assert(!gsupplicant_catalog_find_ssid(catalog, ssid0));
+    list = gsupplicant_catalog_find_ssid(catalog, ssid1);
+    g_assert(list);
+    g_assert_cmpuint(list->len, ==, 2);
+    list = gsupplicant_catalog_find_keymgmt(catalog,
+        GSUPPLICANT_KEYMGMT_WPA_PSK);
+    g_assert_cmpuint(list->len, ==, 1);
+    g_assert(list->pdata[0] == e1);
+    list = gsupplicant_catalog_find_keymgmt(catalog,
+        GSUPPLICANT_KEYMGMT_WPA_EAP);
+    g_assert_cmpuint(list->len, ==, 1);
+    g_assert(list->pdata[0] == e0);
+    g_assert(gsupplicant_catalog_lookup(catalog, ssid1,
+        GSUPPLICANT_KEYMGMT_WPA_EAP) == e0);
+    g_assert(gsupplicant_catalog_lookup(catalog, ssid1,
+        GSUPPLICANT_KEYMGMT_WPA_PSK) == e1);
+
+    /* Removal drops the entry from all indices */
+    changes = 0;
+    g_assert(gsupplicant_interface_remove_network(iface, path0, NULL, NULL));
+    TEST_WAIT_WHILE(catalog->count != 1);
+    g_assert(changes);
+    g_assert(!gsupplicant_catalog_get(catalog, path0));
+    g_assert(!gsupplicant_catalog_find_keymgmt(catalog,
+        GSUPPLICANT_KEYMGMT_WPA_EAP));
+    list = gsupplicant_catalog_find_ssid(catalog, ssid1);
+    g_assert_cmpuint(list->len, ==, 1);
+    g_assert(list->pdata[0] == e1);
+
+    gsupplicant_catalog_remove_handler(catalog, id);
+    gsupplicant_catalog_unref(catalog);
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+    g_bytes_unref(ssid0);
+    g_bytes_unref(ssid1);
+    g_free(path0);
+}
+
+/*==========================================================================*
+ * stations
+ *==========================================================================*/
+
+typedef struct test_stations {
+    guint added;
+    guint removed;
+    guint changed;
+    char* last;
+} TestStations;
+
+static
+void
+test_gsupplicant_stations_added(
+    GSupplicantInterface* iface,
+    const GSupplicantStation* sta,
+    void* data)
+{
+    TestStations* test = data;
+    g_assert(gsupplicant_interface_find_station(iface, sta->address) == sta);
+    g_assert(sta->connected);
+    g_assert(sta->connected_real);
+    g_free(test->last);
+    test->last = g_strdup(sta->address);
+    test->added++;
+}
+
+static
+void
+test_gsupplicant_stations_removed(
+    GSupplicantInterface* iface,
+    const GSupplicantStation* sta,
+    void* data)
+{
+    TestStations* test = data;
+    g_assert(!gsupplicant_interface_find_station(iface, sta->address));
+    g_free(test->last);
+    test->last = g_strdup(sta->address);
+    test->removed++;
+}
+
+static
+void
+test_gsupplicant_stations_changed(
+    GSupplicantInterface* iface,
+    void* data)
+{
+    ((TestStations*)data)->changed++;
+}
+
+static
+void
+test_gsupplicant_stations(
+    void)
+{
+    static const char* mac[] = {
+        "02:00:00:00:00:01",
+        "02:00:00:00:00:02",
+        "02:00:00:00:00:03"
+    };
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface;
+    const GSupplicantStation* sta;
+    TestStations test;
+    gulong id[3];
+    guint i;
+
+    g_assert(!gsupplicant_interface_find_station(NULL, mac[0]));
+    g_assert(!gsupplicant_interface_add_station_added_handler(NULL, NULL,
+        NULL));
+    g_assert(!gsupplicant_interface_add_station_removed_handler(NULL, NULL,
+        NULL));
+
+    mock = test_supplicant_mock_new(NULL);
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    test_iface_wait_valid(iface);
+    g_assert(!iface->stations);
+    g_assert(!gsupplicant_interface_find_station(iface, NULL));
+    g_assert(!gsupplicant_interface_find_station(iface, mac[0]));
+    g_assert(!gsupplicant_interface_add_station_added_handler(iface, NULL,
+        NULL));
+
+    memset(&test, 0, sizeof(test));
+    id[0] = gsupplicant_interface_add_station_added_handler(iface,
+        test_gsupplicant_stations_added, &test);
+    id[1] = gsupplicant_interface_add_station_removed_handler(iface,
+        test_gsupplicant_stations_removed, &test);
+    id[2] = gsupplicant_interface_add_handler(iface,
+        GSUPPLICANT_INTERFACE_PROPERTY_STATIONS,
+        test_gsupplicant_stations_changed, &test);
+
+    /* Duplicates are ignored */
+    for (i = 0; i < G_N_ELEMENTS(mac); i++) {
+        g_assert(test_supplicant_mock_station(mock, 0, mac[i], TRUE));
+    }
+    g_assert(test_supplicant_mock_station(mock, 0, mac[0], TRUE));
+    TEST_WAIT_WHILE(test.added < G_N_ELEMENTS(mac));
+    g_assert_cmpstr(test.last, ==, mac[2]);
+    g_assert_cmpuint(test.changed, ==, test.added);
+    g_assert_cmpuint(gutil_strv_length(iface->stations), ==, 3);
+    g_assert_cmpstr(iface->stations[0], ==, mac[0]);
+    g_assert_cmpstr(iface->stations[1], ==, mac[1]);
+    g_assert_cmpstr(iface->stations[2], ==, mac[2]);
+    sta = gsupplicant_interface_find_station(iface, mac[2]);
+    g_assert(sta);
+
+    /* Removing one doesn't affect the others */
+    g_assert(test_supplicant_mock_station(mock, 0, mac[0], FALSE));
+    g_assert(test_supplicant_mock_station(mock, 0, mac[0], FALSE));
+    TEST_WAIT_WHILE(!test.removed);
+    g_assert_cmpstr(test.last, ==, mac[0]);
+    g_assert(gsupplicant_interface_find_station(iface, mac[2]) == sta);
+    g_assert_cmpstr(sta->address, ==, mac[2]);
+    g_assert_cmpuint(gutil_strv_length(iface->stations), ==, 2);
+    g_assert_cmpstr(iface->stations[0], ==, mac[1]);
+    g_assert_cmpstr(iface->stations[1], ==, mac[2]);
+
+    /* The order is preserved */
+    g_assert(test_supplicant_mock_station(mock, 0, mac[0], TRUE));
+    TEST_WAIT_WHILE(test.added < G_N_ELEMENTS(mac) + 1);
+    g_assert_cmpuint(gutil_strv_length(iface->stations), ==, 3);
+    g_assert_cmpstr(iface->stations[2], ==, mac[0]);
+    g_assert(test_supplicant_mock_station(mock, 0, mac[2], FALSE));
+    TEST_WAIT_WHILE(test.removed < 2);
+    g_assert_cmpuint(gutil_strv_length(iface->stations), ==, 2);
+    g_assert_cmpstr(iface->stations[0], ==, mac[1]);
+    g_assert_cmpstr(iface->stations[1], ==, mac[0]);
+
+    /* And the rest */
+    g_assert(test_supplicant_mock_station(mock, 0, mac[1], FALSE));
+    TEST_WAIT_WHILE(test.removed < 3);
+    g_assert_cmpuint(gutil_strv_length(iface->stations), ==, 1);
+    g_assert_cmpstr(iface->stations[0], ==, mac[0]);
+    g_assert(test_supplicant_mock_station(mock, 0, mac[0], FALSE));
+    TEST_WAIT_WHILE(test.removed < 4);
+    g_assert(!iface->stations);
+    g_assert_cmpuint(test.changed, ==, test.added + test.removed);
+
+    /* Station table survives until the interface is gone */
+    g_assert(test_supplicant_mock_station(mock, 0, mac[0], TRUE));
+    TEST_WAIT_WHILE(test.added < G_N_ELEMENTS(mac) + 2);
+    g_assert_cmpuint(gutil_strv_length(iface->stations), ==, 1);
+
+    gsupplicant_interface_remove_all_handlers(iface, id);
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+    g_free(test.last);
+}
+
+/*==========================================================================*
+ * filter
+ *==========================================================================*/
+
+/* Waits until the mock receives the value */
+static
+void
+test_gsupplicant_filter_wait_mock(
+    TestSupplicantMock* mock,
+    GSupplicantInterface* iface,
+    const char* rssi)
+{
+    TEST_WAIT_WHILE(g_strcmp0(test_mock_string(mock, iface->path,
+        "FilterRssi"), rssi));
+}
+
+static
+void
+test_gsupplicant_filter(
+    void)
+{
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface;
+    GSupplicantFilterPolicy policy;
+
+    g_assert(!gsupplicant_interface_set_filter_ssids(NULL, TRUE));
+    g_assert(!gsupplicant_interface_set_filter_rssi(NULL, -80));
+    g_assert(!gsupplicant_interface_set_bss_max_count(NULL, 10));
+    g_assert(!gsupplicant_interface_set_filter_policy(NULL, NULL));
+    g_assert(!gsupplicant_interface_get_filter_rssi(NULL));
+
+    memset(&config, 0, sizeof(config));
+    config.interfaces = 1;
+    config.bsss = 3;
+    mock = test_supplicant_mock_new(&config);
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    test_iface_wait_valid(iface);
+
+    /* The initial value comes from wpa_supplicant */
+    g_assert_cmpint(gsupplicant_interface_get_filter_rssi(iface), ==, -100);
+
+    g_assert(gsupplicant_interface_set_filter_ssids(iface, FALSE));
+    g_assert(!gsupplicant_interface_set_bss_max_count(iface, 0));
+    g_assert(gsupplicant_interface_set_bss_max_count(iface, 50));
+    g_assert(gsupplicant_interface_set_filter_rssi(iface, -80));
+    g_assert(gsupplicant_interface_get_filter_rssi(iface) == -80);
+    test_gsupplicant_filter_wait_mock(mock, iface, "-80");
+
+    /* And follows the changes made by someone else */
+    g_assert(test_supplicant_mock_set_property(mock, iface->path,
+        "FilterRssi", g_variant_new_string("-95")));
+    TEST_WAIT_WHILE(gsupplicant_interface_get_filter_rssi(iface) != -95);
+
+    /* Invalid policies */
+    memset(&policy, 0, sizeof(policy));
+    g_assert(!gsupplicant_interface_set_filter_policy(iface, &policy));
+    policy.step = 5;
+    policy.min_rssi = -70;
+    policy.max_rssi = -90;
+    g_assert(!gsupplicant_interface_set_filter_policy(iface, &policy));
+
+    /* Setting the policy clamps the current threshold */
+    policy.min_rssi = -90;
+    policy.max_rssi = -70;
+    policy.dense_count = 1;
+    g_assert(gsupplicant_interface_set_filter_policy(iface, &policy));
+    g_assert(gsupplicant_interface_get_filter_rssi(iface) == -90);
+    test_gsupplicant_filter_wait_mock(mock, iface, "-90");
+
+    /* Three BSSs is a dense environment */
+    g_assert(gsupplicant_interface_scan(iface, NULL, NULL, NULL));
+    TEST_WAIT_WHILE(gsupplicant_interface_get_filter_rssi(iface) == -90);
+    g_assert(gsupplicant_interface_get_filter_rssi(iface) == -85);
+    test_gsupplicant_filter_wait_mock(mock, iface, "-85");
+
+    g_assert(gsupplicant_interface_set_filter_policy(iface, NULL));
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+}
+
+/*==========================================================================*
+ * scan_error
+ *==========================================================================*/
+
+static
+void
+test_gsupplicant_scan_error_done(
+    GSupplicantInterface* iface,
+    GCancellable* cancel,
+    const GError* error,
+    void* loop)
+{
+    g_assert(error);
+    g_main_loop_quit(loop);
+}
+
+static
+void
+test_gsupplicant_scan_error(
+    void)
+{
+    TestSupplicantMock* mock = test_supplicant_mock_new(NULL);
+    GSupplicantInterface* iface = gsupplicant_interface_new
+        (test_supplicant_mock_interface_path(mock, 0));
+    TestWait wait;
+
+    test_iface_wait_valid(iface);
+    test_supplicant_mock_set_method_delay(mock, "Scan", 10);
+    test_supplicant_mock_set_method_error(mock, "Scan",
+        "fi.w1.wpa_supplicant1.Interface.ScanError");
+    test_wait_init(&wait);
+    g_assert(gsupplicant_interface_scan(iface, NULL,
+        test_gsupplicant_scan_error_done, wait.loop));
+    test_wait_run(&wait);
+    g_assert(test_supplicant_mock_call_count(mock) > 0);
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+}
+
+/*==========================================================================*
+ * directed_scan
+ *==========================================================================*/
+
+static
+void
+test_gsupplicant_directed_scan_done(
+    GSupplicantInterface* iface,
+    GCancellable* cancel,
+    const GError* error,
+    void* loop)
+{
+    g_assert(!error);
+    g_main_loop_quit(loop);
+}
+
+static
+void
+test_gsupplicant_directed_scan_failed(
+    GSupplicantInterface* iface,
+    GCancellable* cancel,
+    const GError* error,
+    void* count)
+{
+    g_assert(error);
+    (*(guint*)count)++;
+}
+
+/* Returns the comma-separated list of SSIDs of the given Scan call */
+static
+char*
+test_gsupplicant_directed_scan_ssids(
+    TestSupplicantMock* mock,
+    guint scan)
+{
+    GVariant* args = test_supplicant_mock_scan_args(mock, 0, scan);
+    GVariant* list = g_variant_lookup_value(args, "SSIDs",
+        G_VARIANT_TYPE("aay"));
+    GString* buf = g_string_new(NULL);
+    gsize i, n;
+
+    g_assert(list);
+    n = g_variant_n_children(list);
+    for (i = 0; i < n; i++) {
+        GVariant* ssid = g_variant_get_child_value(list, i);
+        gsize len = 0;
+        const char* data = g_variant_get_fixed_array(ssid, &len, 1);
+
+        if (buf->len) {
+            g_string_append_c(buf, ',');
+        }
+        g_string_append_len(buf, data, len);
+        g_variant_unref(ssid);
+    }
+    g_variant_unref(list);
+    return g_string_free(buf, FALSE);
+}
+
+static
+void
+test_gsupplicant_directed_scan_check(
+    TestSupplicantMock* mock,
+    guint first,
+    const char* const* expected)
+{
+    guint i;
+
+    g_assert_cmpuint(test_supplicant_mock_scan_count(mock, 0), ==,
+        first + g_strv_length((char**)expected));
+    for (i = 0; expected[i]; i++) {
+        char* ssids = test_gsupplicant_directed_scan_ssids(mock, first + i);
+
+        g_assert_cmpstr(ssids, ==, expected[i]);
+        g_free(ssids);
+    }
+}
+
+static
+void
+test_gsupplicant_directed_scan(
+    void)
+{
+    static const char* names[] = { "one", "two", "three", "four", "five" };
+    static const int priority[] = { 0, 3, 1, 3, 2 };
+    static const char* one_by_one[] = {
+        "two", "four", "five", "three", "one", NULL
+    };
+    static const char* by_two[] = { "two,four", "five,three", "one", NULL };
+    TestSupplicantMock* mock = test_supplicant_mock_new(NULL);
+    GSupplicantInterface* iface = gsupplicant_interface_new
+        (test_supplicant_mock_interface_path(mock, 0));
+    GSupplicantDirectedScanSSID ssids[G_N_ELEMENTS(names)];
+    GSupplicantDirectedScanSSID none[2];
+    GVariantBuilder caps;
+    GCancellable* cancel;
+    TestWait wait;
+    guint first, failed = 0;
+    guint i;
+
+    G_STATIC_ASSERT(G_N_ELEMENTS(priority) == G_N_ELEMENTS(names));
+    for (i = 0; i < G_N_ELEMENTS(ssids); i++) {
+        ssids[i].ssid = g_bytes_new_static(names[i], strlen(names[i]));
+        ssids[i].priority = priority[i];
+    }
+
+    test_iface_wait_valid(iface);
+    g_assert(!gsupplicant_interface_directed_scan(NULL, NULL, ssids,
+        G_N_ELEMENTS(ssids), NULL, NULL));
+    g_assert(!gsupplicant_interface_directed_scan(iface, NULL, NULL, 0,
+        NULL, NULL));
+
+    /* Nothing to scan for (the callback would crash) */
+    memset(none, 0, sizeof(none));
+    g_assert(!gsupplicant_interface_directed_scan(iface, NULL, none,
+        G_N_ELEMENTS(none), test_gsupplicant_directed_scan_done, NULL));
+    g_assert(!test_supplicant_mock_scan_count(mock, 0));
+
+    /* The mock doesn't report MaxScanSSID, one SSID per scan then */
+    test_wait_init(&wait);
+    g_assert(gsupplicant_interface_directed_scan(iface, NULL, ssids,
+        G_N_ELEMENTS(ssids), test_gsupplicant_directed_scan_done,
+        wait.loop));
+    test_wait_run(&wait);
+    test_gsupplicant_directed_scan_check(mock, 0, one_by_one);
+
+    /* Two at a time, still in the order of priority */
+    g_variant_builder_init(&caps, G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_add(&caps, "{sv}", "MaxScanSSID",
+        g_variant_new_int32(2));
+    g_assert(test_supplicant_mock_set_property(mock, iface->path,
+        "Capabilities", g_variant_builder_end(&caps)));
+    TEST_WAIT_WHILE(iface->caps.max_scan_ssid != 2);
+    first = test_supplicant_mock_scan_count(mock, 0);
+    test_wait_init(&wait);
+    g_assert(gsupplicant_interface_directed_scan(iface, NULL, ssids,
+        G_N_ELEMENTS(ssids), test_gsupplicant_directed_scan_done,
+        wait.loop));
+    test_wait_run(&wait);
+    test_gsupplicant_directed_scan_check(mock, first, by_two);
+
+    /* Cancel doesn't invoke the callback */
+    first = test_supplicant_mock_scan_count(mock, 0);
+    cancel = gsupplicant_interface_directed_scan(iface, NULL, ssids,
+        G_N_ELEMENTS(ssids), test_gsupplicant_directed_scan_done, NULL);
+    g_assert(cancel);
+    g_cancellable_cancel(cancel);
+    TEST_WAIT_WHILE(test_supplicant_mock_scan_count(mock, 0) == first);
+
+    /*
+     * wpa_supplicant goes away while it's holding the Scan call. The
+     * scan fails and is freed, the late reply must not reach it.
+     */
+    test_supplicant_mock_set_method_delay(mock, "Scan", 100);
+    first = test_supplicant_mock_scan_count(mock, 0);
+    g_assert(gsupplicant_interface_directed_scan(iface, NULL, ssids,
+        G_N_ELEMENTS(ssids), test_gsupplicant_directed_scan_failed,
+        &failed));
+    test_supplicant_mock_drop_name(mock);
+    TEST_WAIT_WHILE(!failed);
+    g_assert(!iface->valid);
+    TEST_WAIT_WHILE(test_supplicant_mock_scan_count(mock, 0) == first);
+
+    /* The reply arrives before anything the mock sends afterwards */
+    test_supplicant_mock_set_method_delay(mock, "Scan", 0);
+    test_supplicant_mock_claim_name(mock);
+    test_iface_wait_valid(iface);
+    g_assert_cmpuint(failed, ==, 1);
+
+    for (i = 0; i < G_N_ELEMENTS(ssids); i++) {
+        g_bytes_unref(ssids[i].ssid);
+    }
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+}
+
+/*==========================================================================*
+ * scan_policy
+ *==========================================================================*/
+
+typedef struct test_scan_policy_data {
+    GMainLoop* loop;
+    guint ok;
+    guint failed;
+    guint expected;
+} TestScanPolicyData;
+
+static
+void
+test_gsupplicant_scan_policy_done(
+    GSupplicantInterface* iface,
+    GCancellable* cancel,
+    const GError* error,
+    void* data)
+{
+    TestScanPolicyData* test = data;
+
+    if (error) {
+        g_assert(gsupplicant_is_error(error, GSUPPLICANT_ERROR_SCAN_ERROR));
+        test->failed++;
+    } else {
+        test->ok++;
+    }
+    if (test->ok + test->failed == test->expected) {
+        g_main_loop_quit(test->loop);
+    }
+}
+
+static
+void
+test_gsupplicant_scan_policy(
+    void)
+{
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface[2];
+    GSupplicantScanPolicy policy;
+    TestScanPolicyData test;
+    TestWait wait;
+    guint64 calls;
+    guint i;
+
+    gsupplicant_set_scan_policy(NULL, NULL);
+    memset(&config, 0, sizeof(config));
+    config.interfaces = G_N_ELEMENTS(iface);
+    mock = test_supplicant_mock_new(&config);
+    for (i = 0; i < G_N_ELEMENTS(iface); i++) {
+        iface[i] = gsupplicant_interface_new
+            (test_supplicant_mock_interface_path(mock, i));
+        test_iface_wait_valid(iface[i]);
+    }
+
+    /* One scan at a time, identical requests are merged */
+    memset(&policy, 0, sizeof(policy));
+    policy.flags = GSUPPLICANT_SCAN_POLICY_MERGE;
+    policy.max_active = 1;
+    policy.stagger_ms = 10;
+    gsupplicant_set_scan_policy(iface[0]->supplicant, &policy);
+
+    memset(&test, 0, sizeof(test));
+    test_wait_init(&wait);
+    test.loop = wait.loop;
+    test.expected = 3;
+    calls = test_supplicant_mock_call_count(mock);
+    g_assert(gsupplicant_interface_scan(iface[0], NULL,
+        test_gsupplicant_scan_policy_done, &test));
+    g_assert(gsupplicant_interface_scan(iface[1], NULL,
+        test_gsupplicant_scan_policy_done, &test));
+    g_assert(gsupplicant_interface_scan(iface[1], NULL,
+        test_gsupplicant_scan_policy_done, &test));
+    test_wait_run(&wait);
+    g_assert(test.ok == 3);
+    g_assert(test_supplicant_mock_call_count(mock) - calls == 2);
+
+    /* Wait for the scans to finish */
+    TEST_WAIT_WHILE(!gsupplicant_interface_get_scan_times(iface[0])->scans ||
+        !gsupplicant_interface_get_scan_times(iface[1])->scans);
+    g_assert(!gsupplicant_interface_get_scan_times(NULL));
+
+    /* Rejected requests are retried */
+    policy.retry_count = 2;
+    policy.retry_delay_ms = 1;
+    gsupplicant_set_scan_policy(iface[0]->supplicant, &policy);
+    test_supplicant_mock_set_method_error(mock, "Scan",
+        "fi.w1.wpa_supplicant1.Interface.ScanError");
+    memset(&test, 0, sizeof(test));
+    test_wait_init(&wait);
+    test.loop = wait.loop;
+    test.expected = 1;
+    calls = test_supplicant_mock_call_count(mock);
+    g_assert(gsupplicant_interface_scan(iface[0], NULL,
+        test_gsupplicant_scan_policy_done, &test));
+    test_wait_run(&wait);
+    g_assert(test.failed == 1);
+    g_assert(test_supplicant_mock_call_count(mock) - calls == 3);
+
+    gsupplicant_set_scan_policy(iface[0]->supplicant, NULL);
+    for (i = 0; i < G_N_ELEMENTS(iface); i++) {
+        gsupplicant_interface_unref(iface[i]);
+    }
+    test_supplicant_mock_free(mock);
+}
+
+/*==========================================================================*
+ * sched_scan
+ *==========================================================================*/
+
+/* Waits until the mock receives all four values */
+static
+void
+test_gsupplicant_sched_scan_wait_mock(
+    TestSupplicantMock* mock,
+    GSupplicantInterface* iface,
+    const char* plans,
+    const char* interval,
+    const char* disable_offload,
+    const char* freq_list)
+{
+    static const char* names[] = {
+        "SchedScanPlans", "SchedScanInterval",
+        "DisableScanOffload", "FreqList"
+    };
+    const char* values[G_N_ELEMENTS(names)];
+    guint i;
+
+    values[0] = plans;
+    values[1] = interval;
+    values[2] = disable_offload;
+    values[3] = freq_list;
+    for (i = 0; i < G_N_ELEMENTS(names); i++) {
+        TEST_WAIT_WHILE(g_strcmp0(test_mock_string(mock, iface->path,
+            names[i]), values[i]));
+    }
+}
+
+/*
+ * Runs a host scan. The Scan reply follows the PropertiesChanged signals
+ * for all the properties which have been set before the call, so it also
+ * brings our cached properties up to date.
+ */
+static
+void
+test_gsupplicant_host_scan(
+    GSupplicantInterface* iface)
+{
+    const GSupplicantScanSourceStats* stats =
+        gsupplicant_interface_get_scan_source_stats(iface);
+    const guint host_scans = stats->host_scans;
+
+    g_assert(gsupplicant_interface_scan(iface, NULL, NULL, NULL));
+    TEST_WAIT_WHILE(stats->host_scans == host_scans);
+}
+
+/* Emits ScanDone nobody has requested, waits until it's counted */
+static
+void
+test_gsupplicant_sched_scan_done(
+    TestSupplicantMock* mock,
+    const GSupplicantScanSourceStats* stats)
+{
+    const guint total = stats->host_scans + stats->offloaded_scans +
+        stats->other_scans;
+
+    g_assert(test_supplicant_mock_scan_done(mock, 0));
+    TEST_WAIT_WHILE(stats->host_scans + stats->offloaded_scans +
+        stats->other_scans == total);
+}
+
+static
+void
+test_gsupplicant_sched_scan(
+    void)
+{
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface;
+    GSupplicantSchedScanPlan* plan;
+    const GSupplicantScanSourceStats* stats;
+    TestWait wait;
+    char* str;
+    gulong id;
+
+    gsupplicant_sched_scan_plan_free(NULL);
+    g_assert(!gsupplicant_sched_scan_plan_add_step(NULL, 10, 0));
+    g_assert(!gsupplicant_sched_scan_plan_add_frequency(NULL, 2412));
+    g_assert(!gsupplicant_sched_scan_plan_is_valid(NULL));
+    g_assert(!gsupplicant_sched_scan_plan_to_string(NULL));
+    g_assert(!gsupplicant_sched_scan_plan_apply(NULL, NULL));
+    g_assert(!gsupplicant_sched_scan_plan_revert(NULL));
+    gsupplicant_sched_scan_plan_set_offload(NULL, FALSE);
+    g_assert(!gsupplicant_interface_set_sched_scan_interval(NULL, 10));
+    g_assert(!gsupplicant_interface_set_sched_scan_plans(NULL, NULL));
+    g_assert(!gsupplicant_interface_set_scan_offload(NULL, TRUE));
+    g_assert(!gsupplicant_interface_get_scan_source_stats(NULL));
+
+    /* Build the plan */
+    plan = gsupplicant_sched_scan_plan_new();
+    g_assert(!gsupplicant_sched_scan_plan_is_valid(plan));
+    g_assert(!gsupplicant_sched_scan_plan_to_string(plan));
+    g_assert(!gsupplicant_sched_scan_plan_add_step(plan, 0, 1));
+    g_assert(gsupplicant_sched_scan_plan_add_step(plan, 10, 3));
+    g_assert(!gsupplicant_sched_scan_plan_is_valid(plan));
+    g_assert(gsupplicant_sched_scan_plan_add_step(plan, 60, 0));
+    g_assert(gsupplicant_sched_scan_plan_is_valid(plan));
+    g_assert(!gsupplicant_sched_scan_plan_add_step(plan, 300, 0));
+    g_assert(!gsupplicant_sched_scan_plan_add_frequency(plan, 0));
+    g_assert(gsupplicant_sched_scan_plan_add_frequency(plan, 2412));
+    g_assert(gsupplicant_sched_scan_plan_add_frequency(plan, 2412));
+    g_assert(gsupplicant_sched_scan_plan_add_frequency(plan, 5180));
+    str = gsupplicant_sched_scan_plan_to_string(plan);
+    g_assert_cmpstr(str, ==, "10:3 60");
+    g_free(str);
+
+    memset(&config, 0, sizeof(config));
+    config.interfaces = 1;
+    mock = test_supplicant_mock_new(&config);
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    g_assert(!gsupplicant_sched_scan_plan_apply(plan, iface));
+    test_iface_wait_valid(iface);
+
+    stats = gsupplicant_interface_get_scan_source_stats(iface);
+    test_gsupplicant_sched_scan_wait_mock(mock, iface, "", "0", "0", "");
+
+    /* Nothing is scheduled, neither host nor offloaded scan */
+    test_gsupplicant_sched_scan_done(mock, stats);
+    g_assert_cmpuint(stats->other_scans, ==, 1);
+    g_assert(!stats->offloaded_scans);
+    g_assert(!stats->host_scans);
+
+    /* Host scan */
+    g_assert(gsupplicant_interface_set_sched_scan_interval(iface, 30));
+    g_assert(!gsupplicant_interface_set_sched_scan_interval(iface, 0));
+    g_assert(gsupplicant_interface_set_sched_scan_plans(iface, NULL));
+    g_assert(gsupplicant_interface_set_scan_offload(iface, TRUE));
+    test_gsupplicant_sched_scan_wait_mock(mock, iface, "", "30", "0", "");
+    test_gsupplicant_host_scan(iface);
+    g_assert_cmpuint(stats->host_scans, ==, 1);
+    g_assert(!stats->offloaded_scans);
+
+    /* Apply and revert */
+    gsupplicant_sched_scan_plan_set_offload(plan, FALSE);
+    g_assert(gsupplicant_sched_scan_plan_apply(plan, iface));
+    test_gsupplicant_sched_scan_wait_mock(mock, iface, "10:3 60", "60", "1",
+        "2412 5180");
+    g_assert(gsupplicant_sched_scan_plan_apply(plan, iface));
+    g_assert(gsupplicant_sched_scan_plan_revert(plan));
+    test_gsupplicant_sched_scan_wait_mock(mock, iface, "", "30", "0", "");
+    g_assert(!gsupplicant_sched_scan_plan_revert(plan));
+
+    /* The plan stays applied after it's freed */
+    gsupplicant_sched_scan_plan_set_offload(plan, TRUE);
+    g_assert(gsupplicant_sched_scan_plan_apply(plan, iface));
+    gsupplicant_sched_scan_plan_free(plan);
+    test_gsupplicant_sched_scan_wait_mock(mock, iface, "10:3 60", "60", "0",
+        "2412 5180");
+    test_gsupplicant_host_scan(iface);
+    g_assert_cmpuint(stats->host_scans, ==, 2);
+
+    /* Results of a scan which nobody has requested */
+    test_wait_init(&wait);
+    id = gsupplicant_interface_add_handler(iface,
+        GSUPPLICANT_INTERFACE_PROPERTY_BSSS, test_iface_quit, wait.loop);
+    test_supplicant_mock_add_bss(mock, 0);
+    test_wait_run(&wait);
+    gsupplicant_interface_remove_handler(iface, id);
+    test_gsupplicant_sched_scan_done(mock, stats);
+    g_assert_cmpuint(stats->offloaded_scans, ==, 1);
+    g_assert_cmpuint(stats->offloaded_results, ==, 1);
+    g_assert_cmpuint(stats->host_scans, ==, 2);
+
+    /* Failed scan request doesn't turn the next scan into a host scan */
+    test_supplicant_mock_set_method_error(mock, "Scan",
+        "fi.w1.wpa_supplicant1.Interface.ScanError");
+    test_wait_init(&wait);
+    g_assert(gsupplicant_interface_scan(iface, NULL,
+        test_gsupplicant_scan_error_done, wait.loop));
+    test_wait_run(&wait);
+    test_gsupplicant_sched_scan_done(mock, stats);
+    g_assert_cmpuint(stats->offloaded_scans, ==, 2);
+    g_assert_cmpuint(stats->host_scans, ==, 2);
+
+    /* Offload disabled */
+    test_supplicant_mock_set_method_error(mock, "Scan", NULL);
+    g_assert(gsupplicant_interface_set_scan_offload(iface, FALSE));
+    test_gsupplicant_host_scan(iface);
+    test_gsupplicant_sched_scan_done(mock, stats);
+    g_assert_cmpuint(stats->other_scans, ==, 2);
+    g_assert_cmpuint(stats->offloaded_scans, ==, 2);
+    g_assert_cmpuint(stats->host_scans, ==, 3);
+
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+}
+
+/*==========================================================================*
+ * roam_profile
+ *==========================================================================*/
+
+typedef struct test_roam_profile_data {
+    GMainLoop* loop;
+    char* path;
+    char* from;
+    char* to;
+} TestRoamProfileData;
+
+static
+void
+test_gsupplicant_roam_profile_roamed(
+    GSupplicantRoamProfile* profile,
+    const GSupplicantRoamEvent* event,
+    void* data)
+{
+    TestRoamProfileData* test = data;
+
+    g_assert(!test->from);
+    g_assert(!test->to);
+    g_assert(!event->gap);
+    test->from = g_strdup(event->from);
+    test->to = g_strdup(event->to);
+    g_main_loop_quit(test->loop);
+}
+
+static
+void
+test_gsupplicant_roam_profile_network_added(
+    GSupplicantInterface* iface,
+    GCancellable* cancel,
+    const GError* error,
+    const char* path,
+    void* data)
+{
+    TestRoamProfileData* test = data;
+
+    g_assert(!error);
+    g_assert(path);
+    test->path = g_strdup(path);
+    g_main_loop_quit(test->loop);
+}
+
+/* Returns key_mgmt which has been passed to AddNetwork */
+static
+char*
+test_gsupplicant_roam_profile_key_mgmt(
+    TestSupplicantMock* mock,
+    GSupplicantInterface* iface,
+    const GSupplicantNetworkParams* np)
+{
+    TestRoamProfileData test;
+    const char* key_mgmt = NULL;
+    GVariant* props;
+
+    memset(&test, 0, sizeof(test));
+    test.loop = g_main_loop_new(NULL, TRUE);
+    g_assert(gsupplicant_interface_add_network(iface, np, 0,
+        test_gsupplicant_roam_profile_network_added, &test));
+    g_main_loop_run(test.loop);
+    g_main_loop_unref(test.loop);
+
+    props = test_supplicant_mock_get_property(mock, test.path, "Properties");
+    g_assert(props);
+    g_assert(g_variant_lookup(props, "key_mgmt", "&s", &key_mgmt));
+    g_free(test.path);
+    return g_strdup(key_mgmt);
+}
+
+/* Waits until the mock receives the values */
+static
+void
+test_gsupplicant_roam_profile_wait_mock(
+    TestSupplicantMock* mock,
+    GSupplicantInterface* iface,
+    const char* pmf,
+    const char* bgscan)
+{
+    TEST_WAIT_WHILE(g_strcmp0(test_mock_string(mock, iface->path, "Pmf"),
+        pmf) || g_strcmp0(test_mock_string(mock, iface->path, "Bgscan"),
+        bgscan));
+}
+
+static
+void
+test_gsupplicant_roam_profile(
+    void)
+{
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface;
+    GSupplicantRoamProfile* profile;
+    GSupplicantRoamProfileConfig roam;
+    GSupplicantNetworkParams np;
+    const GSupplicantRoamStats* stats;
+    TestRoamProfileData test;
+    char* key_mgmt;
+    char* bss[2];
+    gulong id;
+    const GSUPPLICANT_ROAM_FEATURE all = GSUPPLICANT_ROAM_OKC |
+        GSUPPLICANT_ROAM_FT | GSUPPLICANT_ROAM_FAST_REAUTH |
+        GSUPPLICANT_ROAM_PMF | GSUPPLICANT_ROAM_BGSCAN;
+
+    memset(&roam, 0, sizeof(roam));
+    roam.features = all;
+    roam.pmf = GSUPPLICANT_MFP_OPTIONAL;
+    roam.bgscan = "simple:30:-65:300";
+
+    g_assert(!gsupplicant_roam_profile_new(NULL));
+    g_assert(!gsupplicant_roam_profile_ref(NULL));
+    gsupplicant_roam_profile_unref(NULL);
+    g_assert(!gsupplicant_roam_profile_check(NULL, &roam, NULL));
+    g_assert(!gsupplicant_roam_profile_apply(NULL, &roam));
+    gsupplicant_roam_profile_network_params(NULL, &np);
+    g_assert(!gsupplicant_roam_profile_get_stats(NULL));
+    g_assert(!gsupplicant_roam_profile_add_roam_handler(NULL, NULL, NULL));
+    gsupplicant_roam_profile_remove_handler(NULL, 0);
+    g_assert(!gsupplicant_interface_set_okc(NULL, TRUE));
+    g_assert(!gsupplicant_interface_set_pmf(NULL, GSUPPLICANT_MFP_NONE));
+    g_assert(!gsupplicant_interface_set_fast_reauth(NULL, TRUE));
+    g_assert(!gsupplicant_interface_set_bgscan(NULL, NULL));
+
+    memset(&config, 0, sizeof(config));
+    config.interfaces = 1;
+    config.bsss = G_N_ELEMENTS(bss);
+    mock = test_supplicant_mock_new(&config);
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    profile = gsupplicant_roam_profile_new(iface);
+    g_assert(gsupplicant_roam_profile_ref(profile) == profile);
+    gsupplicant_roam_profile_unref(profile);
+    g_assert(!gsupplicant_roam_profile_add_roam_handler(profile, NULL,
+        NULL));
+    gsupplicant_roam_profile_remove_handler(profile, 0);
+
+    /* Nothing works until the interface is valid */
+    g_assert(!gsupplicant_roam_profile_check(profile, NULL, NULL));
+    g_assert(gsupplicant_roam_profile_check(profile, &roam, NULL) == all);
+    g_assert(!gsupplicant_roam_profile_apply(profile, &roam));
+    test_iface_wait_valid(iface);
+
+    /* The mock doesn't advertise any capabilities */
+    g_assert(gsupplicant_roam_profile_check(profile, &roam, NULL) ==
+        (all & ~GSUPPLICANT_ROAM_BGSCAN));
+    roam.bgscan = NULL;
+    g_assert(gsupplicant_roam_profile_check(profile, &roam, NULL) == all);
+    roam.bgscan = "simple:30:-65:300";
+
+    g_assert(gsupplicant_interface_set_okc(iface, TRUE));
+    g_assert(gsupplicant_interface_set_fast_reauth(iface, FALSE));
+    g_assert(gsupplicant_interface_set_pmf(iface, GSUPPLICANT_MFP_REQUIRED));
+    g_assert(!gsupplicant_interface_set_pmf(iface,
+        (GSUPPLICANT_MFP_OPTIONS)(GSUPPLICANT_MFP_REQUIRED + 1)));
+    g_assert(gsupplicant_interface_set_bgscan(iface, NULL));
+    test_gsupplicant_roam_profile_wait_mock(mock, iface, "2", "");
+    test_gsupplicant_host_scan(iface);
+
+    /* Nothing is added to the network parameters before apply */
+    memset(&np, 0, sizeof(np));
+    np.ssid = g_bytes_new_static("mock-0", 6);
+    np.security = GSUPPLICANT_SECURITY_PSK;
+    gsupplicant_roam_profile_network_params(profile, NULL);
+    gsupplicant_roam_profile_network_params(profile, &np);
+    g_assert(!np.flags);
+    g_assert(!np.keymgmt);
+    g_assert(!np.bgscan);
+
+    /* FT key management bits alone don't enable FT */
+    np.keymgmt = GSUPPLICANT_KEYMGMT_WPA_FT_PSK | GSUPPLICANT_KEYMGMT_FT_SAE;
+    key_mgmt = test_gsupplicant_roam_profile_key_mgmt(mock, iface, &np);
+    g_assert_cmpstr(key_mgmt, ==, "SAE WPA-PSK WPA-PSK-SHA256");
+    g_free(key_mgmt);
+
+    /* OKC and fast re-authentication are not requested, left alone */
+    roam.features = GSUPPLICANT_ROAM_FT | GSUPPLICANT_ROAM_PMF |
+        GSUPPLICANT_ROAM_BGSCAN;
+    g_assert(gsupplicant_roam_profile_apply(profile, &roam));
+    test_gsupplicant_roam_profile_wait_mock(mock, iface, "1", roam.bgscan);
+    g_assert_cmpstr(test_mock_string(mock, iface->path, "Okc"), ==, "1");
+    g_assert(!g_variant_get_boolean(test_supplicant_mock_get_property
+        (mock, iface->path, "FastReauth")));
+
+    np.keymgmt = 0;
+    gsupplicant_roam_profile_network_params(profile, &np);
+    g_assert(np.flags & GSUPPLICANT_NETWORK_PARAM_FT);
+    g_assert(np.keymgmt & GSUPPLICANT_KEYMGMT_WPA_FT_PSK);
+    g_assert(!(np.keymgmt & GSUPPLICANT_KEYMGMT_WPA_FT_EAP));
+    g_assert_cmpstr(np.bgscan, ==, roam.bgscan);
+    key_mgmt = test_gsupplicant_roam_profile_key_mgmt(mock, iface, &np);
+    g_assert_cmpstr(key_mgmt, ==, "SAE WPA-PSK WPA-PSK-SHA256 "
+        "FT-PSK FT-SAE");
+    g_free(key_mgmt);
+    g_bytes_unref(np.ssid);
+
+    /* Caller's bgscan is left alone */
+    memset(&np, 0, sizeof(np));
+    np.security = GSUPPLICANT_SECURITY_EAP;
+    np.bgscan = "learn";
+    gsupplicant_roam_profile_network_params(profile, &np);
+    g_assert(np.keymgmt == GSUPPLICANT_KEYMGMT_WPA_FT_EAP);
+    g_assert_cmpstr(np.bgscan, ==, "learn");
+
+    /* Dropped features get their original values back */
+    roam.features = GSUPPLICANT_ROAM_FT;
+    g_assert(gsupplicant_roam_profile_apply(profile, &roam));
+    test_gsupplicant_roam_profile_wait_mock(mock, iface, "2", "");
+
+    /* No roaming yet */
+    stats = gsupplicant_roam_profile_get_stats(profile);
+    g_assert(stats);
+    g_assert(!stats->roams);
+    g_assert(!stats->max_gap);
+
+    /* Association followed by a roam */
+    memset(&test, 0, sizeof(test));
+    test.loop = g_main_loop_new(NULL, TRUE);
+    id = gsupplicant_roam_profile_add_roam_handler(profile,
+        test_gsupplicant_roam_profile_roamed, &test);
+    g_assert(id);
+    bss[0] = g_strdup(iface->bsss[0]);
+    bss[1] = g_strdup(iface->bsss[1]);
+    g_assert(test_supplicant_mock_associate(mock, bss[0]));
+    TEST_WAIT_WHILE(g_strcmp0(iface->current_bss, bss[0]));
+    g_assert(!stats->roams);
+    g_assert(test_supplicant_mock_associate(mock, bss[1]));
+    g_main_loop_run(test.loop);
+    g_assert_cmpstr(test.from, ==, bss[0]);
+    g_assert_cmpstr(test.to, ==, bss[1]);
+    g_assert_cmpuint(stats->roams, ==, 1);
+    gsupplicant_roam_profile_remove_handler(profile, id);
+    g_main_loop_unref(test.loop);
+    g_free(test.from);
+    g_free(test.to);
+    g_free(bss[0]);
+    g_free(bss[1]);
+
+    gsupplicant_roam_profile_unref(profile);
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+}
+
+/*==========================================================================*
+ * link_predictor
+ *==========================================================================*/
+
+static
+void
+test_gsupplicant_link_predictor_count(
+    GSupplicantLinkPredictor* predictor,
+    void* data)
+{
+    (*((guint*)data))++;
+}
+
+static
+void
+test_gsupplicant_link_predictor_signal(
+    TestSupplicantMock* mock,
+    GSupplicantLinkPredictor* predictor,
+    GSupplicantBSS* bss,
+    gint16 signal)
+{
+    const GSupplicantLinkPredictorStats* stats =
+        gsupplicant_link_predictor_get_stats(predictor);
+    const guint samples = stats->samples;
+
+    g_assert(test_supplicant_mock_set_bss_signal(mock, bss->path, signal));
+    TEST_WAIT_WHILE(stats->samples == samples);
+    g_assert_cmpint(bss->signal, ==, signal);
+}
+
+static
+void
+test_gsupplicant_link_predictor(
+    void)
+{
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface;
+    GSupplicantLinkPredictor* predictor;
+    GSupplicantLinkPredictorPolicy policy;
+    const GSupplicantLinkPredictorStats* stats;
+    GSupplicantBSS* bss[2];
+    guint samples, changes = 0;
+    gulong id;
+    gint rssi;
+    guint i;
+
+    g_assert(!gsupplicant_link_predictor_new(NULL));
+    g_assert(!gsupplicant_link_predictor_ref(NULL));
+    gsupplicant_link_predictor_unref(NULL);
+    gsupplicant_link_predictor_set_policy(NULL, NULL);
+    g_assert(!gsupplicant_link_predictor_get_policy(NULL));
+    g_assert(!gsupplicant_link_predictor_get_stats(NULL));
+    g_assert(!gsupplicant_link_predictor_predict(NULL, NULL));
+    g_assert(!gsupplicant_link_predictor_add_at_risk_handler(NULL, NULL,
+        NULL));
+    gsupplicant_link_predictor_remove_handler(NULL, 0);
+
+    memset(&config, 0, sizeof(config));
+    config.interfaces = 1;
+    config.bsss = G_N_ELEMENTS(bss);
+    mock = test_supplicant_mock_new(&config);
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    predictor = gsupplicant_link_predictor_new(iface);
+    g_assert(gsupplicant_link_predictor_ref(predictor) == predictor);
+    gsupplicant_link_predictor_unref(predictor);
+    g_assert(!gsupplicant_link_predictor_add_at_risk_handler(predictor,
+        NULL, NULL));
+    gsupplicant_link_predictor_remove_handler(predictor, 0);
+    id = gsupplicant_link_predictor_add_at_risk_handler(predictor,
+        test_gsupplicant_link_predictor_count, &changes);
+    g_assert(id);
+
+    /* Only Signal updates for now */
+    policy = *gsupplicant_link_predictor_get_policy(predictor);
+    policy.poll_interval = 0;
+    policy.rssi_threshold = -70;
+    policy.min_scan_interval = 0;
+    gsupplicant_link_predictor_set_policy(predictor, &policy);
+    stats = gsupplicant_link_predictor_get_stats(predictor);
+    test_iface_wait_valid(iface);
+
+    /* Both BSSs belong to the same ESS */
+    g_assert(test_supplicant_mock_set_bss_ssid(mock, iface->bsss[1],
+        "mock-0"));
+    for (i = 0; i < G_N_ELEMENTS(bss); i++) {
+        bss[i] = gsupplicant_bss_new(iface->bsss[i]);
+        TEST_WAIT_WHILE(!bss[i]->valid);
+    }
+    TEST_WAIT_WHILE(!g_bytes_equal(bss[0]->ssid, bss[1]->ssid));
+    g_assert(bss[0]->frequency != bss[1]->frequency);
+
+    /* Nothing happens until we are connected */
+    test_supplicant_mock_set_bss_signal(mock, bss[0]->path, -40);
+    g_assert(test_supplicant_mock_associate(mock, bss[0]->path));
+    TEST_WAIT_WHILE(iface->state != GSUPPLICANT_INTERFACE_STATE_COMPLETED);
+    g_assert(!gsupplicant_link_predictor_predict(predictor, &rssi));
+    g_assert(!predictor->at_risk);
+
+    /* Signal is dropping fast */
+    test_gsupplicant_link_predictor_signal(mock, predictor, bss[0], -50);
+    test_gsupplicant_link_predictor_signal(mock, predictor, bss[0], -55);
+    g_assert(!predictor->at_risk);
+    test_gsupplicant_link_predictor_signal(mock, predictor, bss[0], -60);
+    g_assert(gsupplicant_link_predictor_predict(predictor, &rssi));
+    g_assert_cmpint(rssi, <, policy.rssi_threshold);
+    g_assert(predictor->at_risk);
+    g_assert_cmpuint(changes, ==, 1);
+    g_assert_cmpuint(stats->predictions, ==, 1);
+
+    /* The ESS channels are pre-scanned */
+    g_assert_cmpuint(stats->scans, ==, 1);
+    g_assert_cmpuint(stats->channels, ==, 2);
+
+    /* And recovering */
+    test_gsupplicant_link_predictor_signal(mock, predictor, bss[0], -30);
+    test_gsupplicant_link_predictor_signal(mock, predictor, bss[0], -20);
+    test_gsupplicant_link_predictor_signal(mock, predictor, bss[0], -10);
+    g_assert(!predictor->at_risk);
+    g_assert_cmpuint(changes, ==, 2);
+
+    /* Signal poll provides samples too */
+    samples = stats->samples;
+    policy.poll_interval = 10;
+    gsupplicant_link_predictor_set_policy(predictor, &policy);
+    TEST_WAIT_WHILE(stats->samples < samples + 2);
+    policy.poll_interval = 0;
+    gsupplicant_link_predictor_set_policy(predictor, &policy);
+
+    /* Predicted drop */
+    test_gsupplicant_link_predictor_signal(mock, predictor, bss[0], -60);
+    test_gsupplicant_link_predictor_signal(mock, predictor, bss[0], -80);
+    test_gsupplicant_link_predictor_signal(mock, predictor, bss[0], -95);
+    g_assert(predictor->at_risk);
+    g_assert(gsupplicant_interface_disconnect(iface, NULL, NULL));
+    TEST_WAIT_WHILE(predictor->at_risk);
+    g_assert_cmpuint(stats->drops, ==, 1);
+    g_assert_cmpuint(stats->predicted_drops, ==, 1);
+
+    /* Default policy */
+    gsupplicant_link_predictor_set_policy(predictor, NULL);
+    g_assert_cmpint(gsupplicant_link_predictor_get_policy(predictor)->
+        rssi_threshold, !=, policy.rssi_threshold);
+
+    gsupplicant_link_predictor_remove_handler(predictor, id);
+    gsupplicant_link_predictor_unref(predictor);
+    for (i = 0; i < G_N_ELEMENTS(bss); i++) {
+        gsupplicant_bss_unref(bss[i]);
+    }
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+}
+
+/*==========================================================================*
+ * snapshot
+ *==========================================================================*/
+
+static
+const GSupplicantBSSSnapshot*
+test_snapshot_find_bss(
+    const GSupplicantInterfaceSnapshot* snapshot,
+    const char* path)
+{
+    guint i;
+
+    for (i = 0; i < snapshot->bss_count; i++) {
+        if (!g_strcmp0(snapshot->bss[i]->path, path)) {
+            return snapshot->bss[i];
+        }
+    }
+    return NULL;
+}
+
+static
+const GSupplicantInterfaceSnapshot*
+test_snapshot_wait(
+    GSupplicantInterface* iface,
+    guint serial)
+{
+    const GSupplicantInterfaceSnapshot* snapshot =
+        gsupplicant_interface_get_snapshot(iface);
+    const guint timeout_id = test_timeout_start();
+
+    /* Rebuilds are coalesced in an idle callback */
+    while (snapshot->serial == serial) {
+        gsupplicant_interface_snapshot_unref(snapshot);
+        g_main_context_iteration(NULL, TRUE);
+        snapshot = gsupplicant_interface_get_snapshot(iface);
+    }
+    test_timeout_stop(timeout_id);
+    return snapshot;
+}
+
+static
+gpointer
+test_gsupplicant_snapshot_thread(
+    gpointer iface)
+{
+    const GSupplicantInterfaceSnapshot* snapshot =
+        gsupplicant_interface_get_snapshot(iface);
+    const guint count = snapshot->bss_count;
+
+    gsupplicant_interface_snapshot_unref(snapshot);
+    return GUINT_TO_POINTER(count);
+}
+
+static
+void
+test_gsupplicant_snapshot(
+    void)
+{
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface;
+    GSupplicantBSS* bss[3];
+    const GSupplicantInterfaceSnapshot* snap1;
+    const GSupplicantInterfaceSnapshot* snap2;
+    const GSupplicantBSSSnapshot* bss1;
+    const GSupplicantBSSSnapshot* bss2;
+    GThread* thread;
+    TestWait wait;
+    gulong id;
+    guint serial;
+    guint i;
+
+    memset(&config, 0, sizeof(config));
+    config.interfaces = 1;
+    config.bsss = G_N_ELEMENTS(bss);
+    mock = test_supplicant_mock_new(&config);
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    g_assert(!gsupplicant_interface_get_snapshot(NULL));
+    gsupplicant_interface_snapshot_unref(NULL);
+    gsupplicant_bss_snapshot_unref(NULL);
+    g_assert(!gsupplicant_bss_snapshot_ref(NULL));
+
+    /* There's always something published */
+    snap1 = gsupplicant_interface_get_snapshot(iface);
+    g_assert(snap1);
+    g_assert(!snap1->bss_count);
+    serial = snap1->serial;
+    gsupplicant_interface_snapshot_unref(snap1);
+    test_iface_wait_valid(iface);
+    snap1 = test_snapshot_wait(iface, serial);
+    g_assert(snap1->valid);
+    g_assert(snap1->state == iface->state);
+    g_assert(!g_strcmp0(snap1->path, iface->path));
+    g_assert(!snap1->bss_count);
+    serial = snap1->serial;
+    gsupplicant_interface_snapshot_unref(snap1);
+
+    /* Only the BSSs which have objects get there */
+    g_assert(gutil_strv_length(iface->bsss) == G_N_ELEMENTS(bss));
+    for (i = 0; i < G_N_ELEMENTS(bss); i++) {
+        bss[i] = gsupplicant_bss_new(iface->bsss[i]);
+        if (!bss[i]->valid) {
+            test_wait_init(&wait);
+            id = gsupplicant_bss_add_handler(bss[i],
+                GSUPPLICANT_BSS_PROPERTY_VALID, test_bss_quit, wait.loop);
+            test_wait_run(&wait);
+            gsupplicant_bss_remove_handler(bss[i], id);
+        }
+        g_assert(bss[i]->valid);
+    }
+    snap1 = test_snapshot_wait(iface, serial);
+    while (snap1->bss_count < G_N_ELEMENTS(bss)) {
+        serial = snap1->serial;
+        gsupplicant_interface_snapshot_unref(snap1);
+        snap1 = test_snapshot_wait(iface, serial);
+    }
+    g_assert(snap1->bss_count == G_N_ELEMENTS(bss));
+    bss1 = test_snapshot_find_bss(snap1, bss[0]->path);
+    g_assert(bss1);
+    g_assert(bss1->signal == bss[0]->signal);
+    g_assert(bss1->frequency == bss[0]->frequency);
+    g_assert(g_bytes_equal(bss1->bssid, bss[0]->bssid));
+
+    /* Readable on another thread */
+    thread = g_thread_new("snapshot", test_gsupplicant_snapshot_thread,
+        iface);
+    g_assert_cmpuint(GPOINTER_TO_UINT(g_thread_join(thread)), ==,
+        G_N_ELEMENTS(bss));
+
+    /* Change the signal of one BSS, the others are shared */
+    test_wait_init(&wait);
+    id = gsupplicant_bss_add_handler(bss[0], GSUPPLICANT_BSS_PROPERTY_SIGNAL,
+        test_bss_quit, wait.loop);
+    g_assert(test_supplicant_mock_set_bss_signal(mock, bss[0]->path,
+        bss[0]->signal - 10));
+    test_wait_run(&wait);
+    gsupplicant_bss_remove_handler(bss[0], id);
+    snap2 = test_snapshot_wait(iface, snap1->serial);
+    g_assert(snap2 != snap1);
+    g_assert(snap2->serial > snap1->serial);
+    g_assert(snap2->bss_count == G_N_ELEMENTS(bss));
+    bss2 = test_snapshot_find_bss(snap2, bss[0]->path);
+    g_assert(bss2 != bss1);
+    g_assert(bss2->signal == bss[0]->signal);
+    g_assert(bss1->signal == bss[0]->signal + 10);
+    g_assert(test_snapshot_find_bss(snap2, bss[1]->path) ==
+        test_snapshot_find_bss(snap1, bss[1]->path));
+
+    /* Old snapshot stays intact after the BSS objects are gone */
+    bss1 = gsupplicant_bss_snapshot_ref(bss1);
+    gsupplicant_interface_snapshot_unref(snap2);
+    for (i = 0; i < G_N_ELEMENTS(bss); i++) {
+        gsupplicant_bss_unref(bss[i]);
+    }
+    serial = snap2->serial;
+    gsupplicant_interface_snapshot_unref(snap2);
+
+    /* Removing all of them results in a single rebuild */
+    snap2 = test_snapshot_wait(iface, serial);
+    g_assert_cmpuint(snap2->serial, ==, serial + 1);
+    g_assert(!snap2->bss_count);
+    g_assert(snap1->bss_count == G_N_ELEMENTS(bss));
+    gsupplicant_interface_snapshot_unref(snap1);
+    gsupplicant_interface_snapshot_unref(snap2);
+    g_assert(bss1->path);
+    gsupplicant_bss_snapshot_unref(bss1);
+
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+}
+
+/*==========================================================================*
+ * embed
+ *==========================================================================*/
+
+static
+void
+test_gsupplicant_embed(
+    void)
+{
+    TestSupplicantMock* mock = test_supplicant_mock_new(NULL);
+    GSupplicantEmbed* embed = gsupplicant_embed_new(NULL);
+    GSupplicantInterface* iface;
+    const gint64 deadline = g_get_monotonic_time() +
+        TEST_TIMEOUT_SEC * G_USEC_PER_SEC;
+
+    g_assert(embed);
+    g_assert(gsupplicant_embed_context(embed) == g_main_context_default());
+    g_assert(!gsupplicant_embed_context(NULL));
+    g_assert(gsupplicant_embed_prepare(NULL, NULL, NULL) == -1);
+    g_assert(!gsupplicant_embed_dispatch(NULL));
+    gsupplicant_embed_free(NULL);
+
+    /* Drive everything (including the mock) without GMainLoop */
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    while (!iface->valid) {
+        const GPollFD* fds;
+        guint n;
+        GPollFD* copy;
+        int timeout = gsupplicant_embed_prepare(embed, &fds, &n);
+
+        g_assert(g_get_monotonic_time() < deadline);
+        g_assert(n > 0);
+        copy = g_new(GPollFD, n);
+        memcpy(copy, fds, sizeof(fds[0]) * n);
+        g_poll(copy, n, timeout < 0 ? 100 : MIN(timeout, 100));
+        g_free(copy);
+        gsupplicant_embed_dispatch(embed);
+    }
+
+    /* Dispatch without prepare */
+    gsupplicant_embed_dispatch(embed);
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+    gsupplicant_embed_free(embed);
+}
+
+/*==========================================================================*
+ * scan_planner
+ *==========================================================================*/
+
+typedef struct test_scan_planner_result {
+    GMainLoop* loop;
+    GError* error;
+    gboolean full;
+    guint count;
+} TestScanPlannerResult;
+
+static
+void
+test_gsupplicant_scan_planner_done(
+    GSupplicantScanPlanner* planner,
+    const GError* error,
+    gboolean full,
+    void* data)
+{
+    TestScanPlannerResult* result = data;
+
+    g_assert(!result->error);
+    result->error = error ? g_error_copy(error) : NULL;
+    result->full = full;
+    result->count++;
+    g_main_loop_quit(result->loop);
+}
+
+static
+void
+test_gsupplicant_scan_planner_seen(
+    TestSupplicantMock* mock,
+    const char* path)
+{
+    GSupplicantBSS* bss = gsupplicant_bss_new(path);
+
+    g_assert(test_supplicant_mock_set_bss_signal(mock, path,
+        bss->signal - 1));
+    gsupplicant_bss_unref(bss);
+}
+
+static
+void
+test_gsupplicant_scan_planner_run(
+    GSupplicantScanPlanner* planner,
+    TestScanPlannerResult* result,
+    TestSupplicantMock* mock,
+    const char* hit)
+{
+    TestWait wait;
+
+    test_wait_init(&wait);
+    memset(result, 0, sizeof(*result));
+    result->loop = wait.loop;
+    g_assert(gsupplicant_scan_planner_scan(planner,
+        test_gsupplicant_scan_planner_done, result));
+    g_assert(planner->busy);
+    g_assert(!gsupplicant_scan_planner_scan(planner, NULL, NULL));
+    if (hit) {
+        /* A saved network shows up while scanning */
+        test_gsupplicant_scan_planner_seen(mock, hit);
+    }
+    test_wait_run(&wait);
+    g_assert(!planner->busy);
+    g_assert_cmpuint(result->count, ==, 1);
+}
+
+static
+void
+test_gsupplicant_scan_planner(
+    void)
+{
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface;
+    GSupplicantScanPlanner* planner;
+    GSupplicantScanPlannerPolicy policy;
+    const GSupplicantScanPlannerStats* stats;
+    TestScanPlannerResult result;
+    char* hit;
+    char* miss;
+
+    g_assert(!gsupplicant_scan_planner_new(NULL));
+    g_assert(!gsupplicant_scan_planner_ref(NULL));
+    g_assert(!gsupplicant_scan_planner_get_policy(NULL));
+    g_assert(!gsupplicant_scan_planner_get_stats(NULL));
+    g_assert(!gsupplicant_scan_planner_scan(NULL, NULL, NULL));
+    g_assert(!gsupplicant_scan_planner_channel_count(NULL));
+    gsupplicant_scan_planner_set_policy(NULL, NULL);
+    gsupplicant_scan_planner_cancel(NULL);
+    gsupplicant_scan_planner_reset(NULL);
+    gsupplicant_scan_planner_unref(NULL);
+
+    /* BSSs 0 and 1 belong to the saved networks and sit on 2 channels */
+    memset(&config, 0, sizeof(config));
+    config.interfaces = 1;
+    config.bsss = 3;
+    config.networks = 2;
+    config.scan_ms = 20;
+    mock = test_supplicant_mock_new(&config);
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    planner = gsupplicant_scan_planner_new(iface);
+    test_iface_wait_valid(iface);
+    TEST_WAIT_WHILE(gsupplicant_scan_planner_channel_count(planner) < 2);
+    hit = g_strdup(iface->bsss[0]);
+    miss = g_strdup(iface->bsss[1]);
+
+    memset(&policy, 0, sizeof(policy));
+    policy.type = GSUPPLICANT_SCAN_TYPE_ACTIVE;
+    policy.max_channels = 4;
+    policy.max_partial = 2;
+    gsupplicant_scan_planner_set_policy(planner, &policy);
+    g_assert(gsupplicant_scan_planner_get_policy(planner)->max_channels == 4);
+    stats = gsupplicant_scan_planner_get_stats(planner);
+
+    /* Without the history it has to be a full scan. It's made slow
+     * so that the partial ones are guaranteed to save some time. */
+    gsupplicant_scan_planner_reset(planner);
+    g_assert(!gsupplicant_scan_planner_channel_count(planner));
+    test_supplicant_mock_set_method_delay(mock, "Scan", 200);
+    test_gsupplicant_scan_planner_run(planner, &result, mock, NULL);
+    g_assert(!result.error);
+    g_assert(result.full);
+    g_assert_cmpuint(stats->full_scans, ==, 1);
+    g_assert(!stats->partial_scans);
+    g_assert(stats->full_time >= 200000);
+    test_supplicant_mock_set_method_delay(mock, "Scan", 0);
+
+    /* Learn one channel. Nothing shows up there, hence the fallback */
+    test_gsupplicant_scan_planner_seen(mock, hit);
+    TEST_WAIT_WHILE(!gsupplicant_scan_planner_channel_count(planner));
+    g_assert_cmpuint(gsupplicant_scan_planner_channel_count(planner), ==, 1);
+    test_gsupplicant_scan_planner_run(planner, &result, mock, NULL);
+    g_assert(!result.error);
+    g_assert(result.full);
+    g_assert_cmpuint(stats->partial_scans, ==, 1);
+    g_assert_cmpuint(stats->fallbacks, ==, 1);
+    g_assert_cmpuint(stats->channels, ==, 1);
+    g_assert_cmpuint(stats->full_scans, ==, 2);
+    g_assert(!stats->time_saved);
+
+    /* Saved network seen off the planned channels isn't a hit */
+    test_gsupplicant_scan_planner_run(planner, &result, mock, miss);
+    g_assert(!result.error);
+    g_assert(result.full);
+    g_assert_cmpuint(stats->partial_scans, ==, 2);
+    g_assert_cmpuint(stats->fallbacks, ==, 2);
+    g_assert_cmpuint(stats->channels, ==, 2);
+    g_assert_cmpuint(stats->full_scans, ==, 3);
+
+    /* Partial scans which find something are faster than full ones */
+    test_gsupplicant_scan_planner_run(planner, &result, mock, hit);
+    g_assert(!result.error);
+    g_assert(!result.full);
+    g_assert_cmpuint(stats->partial_scans, ==, 3);
+    g_assert_cmpuint(stats->fallbacks, ==, 2);
+    g_assert_cmpuint(stats->full_scans, ==, 3);
+    g_assert(stats->time_saved > 0);
+    test_gsupplicant_scan_planner_run(planner, &result, mock, hit);
+    g_assert(!result.full);
+    g_assert_cmpuint(stats->partial_scans, ==, 4);
+
+    /* Two partial scans in a row, the next one is full regardless */
+    g_assert(gsupplicant_scan_planner_channel_count(planner));
+    test_gsupplicant_scan_planner_run(planner, &result, mock, hit);
+    g_assert(!result.error);
+    g_assert(result.full);
+    g_assert_cmpuint(stats->partial_scans, ==, 4);
+    g_assert_cmpuint(stats->full_scans, ==, 4);
+
+    /* And then a partial one again */
+    test_gsupplicant_scan_planner_run(planner, &result, mock, hit);
+    g_assert(!result.full);
+    g_assert_cmpuint(stats->partial_scans, ==, 5);
+
+    /* The whole pass times out */
+    policy.timeout = 50;
+    gsupplicant_scan_planner_set_policy(planner, &policy);
+    test_supplicant_mock_set_method_delay(mock, "Scan", 500);
+    test_gsupplicant_scan_planner_run(planner, &result, mock, NULL);
+    g_assert_error(result.error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT);
+    g_clear_error(&result.error);
+
+    /* Let the delayed call complete */
+    TEST_WAIT_WHILE(!iface->scanning);
+    TEST_WAIT_WHILE(iface->scanning);
+
+    /* Cancel doesn't invoke the callback */
+    memset(&result, 0, sizeof(result));
+    g_assert(gsupplicant_scan_planner_scan(planner,
+        test_gsupplicant_scan_planner_done, &result));
+    gsupplicant_scan_planner_cancel(planner);
+    g_assert(!planner->busy);
+    g_assert(!result.count);
+    TEST_WAIT_WHILE(!iface->scanning);
+    TEST_WAIT_WHILE(iface->scanning);
+
+    gsupplicant_scan_planner_set_policy(planner, NULL);
+    g_assert_cmpuint(gsupplicant_scan_planner_get_policy(planner)->timeout,
+        ==, 30000);
+    gsupplicant_scan_planner_unref(planner);
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+    g_free(hit);
+    g_free(miss);
+}
+
+/*==========================================================================*
+ * journal
+ *==========================================================================*/
+
+static
+void
+test_gsupplicant_journal_network_added(
+    GSupplicantInterface* iface,
+    GCancellable* cancel,
+    const GError* error,
+    const char* path,
+    void* loop)
+{
+    g_assert(!error);
+    g_assert(path);
+    g_main_loop_quit(loop);
+}
+
+static
+void
+test_gsupplicant_journal(
+    void)
+{
+    static const char passphrase[] = "journal-secret";
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    GSupplicantInterface* iface;
+    GSupplicantNetworkParams np;
+    GPtrArray* records;
+    GError* error = NULL;
+    TestWait wait;
+    struct stat st;
+    char* file = NULL;
+    guint i, counts[GSUPPLICANT_JOURNAL_RECORD_SIGNAL + 1];
+    gboolean add_network = FALSE;
+    gint64 last = 0;
+    gulong id;
+    int fd;
+
+    fd = g_file_open_tmp("test-journal-XXXXXX", &file, &error);
+    g_assert_no_error(error);
+    close(fd);
+
+    memset(&config, 0, sizeof(config));
+    config.interfaces = 1;
+    config.bsss = 2;
+    mock = test_supplicant_mock_new(&config);
+
+    /* Existing file doesn't get overwritten */
+    g_assert(!gsupplicant_journal_start(file, &error));
+    g_assert(error);
+    g_clear_error(&error);
+    unlink(file);
+
+    g_assert(gsupplicant_journal_start(file, &error));
+    g_assert_no_error(error);
+    g_assert(!stat(file, &st));
+    g_assert_cmpuint(st.st_mode & 0777, ==, 0600);
+    iface = gsupplicant_interface_new(test_supplicant_mock_interface_path
+        (mock, 0));
+    test_iface_wait_valid(iface);
+
+    /* The passphrase must not end up in the journal */
+    memset(&np, 0, sizeof(np));
+    np.ssid = g_bytes_new_static("journal", 7);
+    np.security = GSUPPLICANT_SECURITY_PSK;
+    np.passphrase = passphrase;
+    test_wait_init(&wait);
+    g_assert(gsupplicant_interface_add_network(iface, &np, 0,
+        test_gsupplicant_journal_network_added, wait.loop));
+    test_wait_run(&wait);
+    g_bytes_unref(np.ssid);
+
+    /* Generate a signal */
+    test_wait_init(&wait);
+    id = gsupplicant_interface_add_handler(iface,
+        GSUPPLICANT_INTERFACE_PROPERTY_BSSS, test_iface_quit, wait.loop);
+    test_supplicant_mock_add_bss(mock, 0);
+    test_wait_run(&wait);
+    gsupplicant_journal_stop();
+    gsupplicant_interface_remove_handler(iface, id);
+    gsupplicant_interface_unref(iface);
+    test_supplicant_mock_free(mock);
+
+    records = gsupplicant_journal_load(file, &error);
+    g_assert_no_error(error);
+    g_assert(records);
+    memset(counts, 0, sizeof(counts));
+    for (i = 0; i < records->len; i++) {
+        const GSupplicantJournalRecord* record = records->pdata[i];
+        g_assert(record->type >= GSUPPLICANT_JOURNAL_RECORD_CALL);
+        g_assert(record->type <= GSUPPLICANT_JOURNAL_RECORD_SIGNAL);
+        g_assert(record->time >= last);
+        last = record->time;
+        counts[record->type]++;
+        if (record->type == GSUPPLICANT_JOURNAL_RECORD_CALL &&
+            !g_strcmp0(g_dbus_message_get_member(record->message),
+            "AddNetwork")) {
+            char* args = g_variant_print(g_dbus_message_get_body
+                (record->message), FALSE);
+            g_assert(!strstr(args, passphrase));
+            g_assert(strstr(args, "<redacted>"));
+            add_network = TRUE;
+            g_free(args);
+        }
+    }
+    g_assert(add_network);
+    g_assert(counts[GSUPPLICANT_JOURNAL_RECORD_CALL]);
+    g_assert(counts[GSUPPLICANT_JOURNAL_RECORD_REPLY]);
+    g_assert(counts[GSUPPLICANT_JOURNAL_RECORD_SIGNAL]);
+    g_ptr_array_free(records, TRUE);
+
+    /* Not a journal */
+    g_assert(g_file_set_contents(file, "garbage", -1, NULL));
+    g_assert(!gsupplicant_journal_load(file, &error));
+    g_assert(error);
+    g_clear_error(&error);
+
+    unlink(file);
+    g_free(file);
+}
+
+/*==========================================================================*
+ * worker
+ *==========================================================================*/
+
+typedef struct test_worker {
+    const char* path;
+    GSupplicantInterface* main_iface;
+    GMainLoop* main_loop;
+    GMainLoop* loop;
+    GThread* thread;
+} TestWorker;
+
+static
+void
+test_gsupplicant_worker_valid(
+    GSupplicantInterface* iface,
+    void* data)
+{
+    TestWorker* worker = data;
+
+    g_assert(g_thread_self() == worker->thread);
+    if (iface->valid) {
+        g_main_loop_quit(worker->loop);
+    }
+}
+
+static
+gboolean
+test_gsupplicant_worker_done(
+    gpointer data)
+{
+    TestWorker* worker = data;
+
+    g_main_loop_quit(worker->main_loop);
+    return G_SOURCE_REMOVE;
+}
+
+static
+gpointer
+test_gsupplicant_worker_thread(
+    gpointer data)
+{
+    TestWorker* worker = data;
+    GMainContext* context = g_main_context_new();
+    GSupplicantInterface* iface;
+    GSupplicantInterface* iface2;
+    gulong id;
+
+    worker->thread = g_thread_self();
+    worker->loop = g_main_loop_new(context, FALSE);
+    g_main_context_push_thread_default(context);
+    iface = gsupplicant_interface_new(worker->path);
+    g_assert(iface != worker->main_iface);
+    iface2 = gsupplicant_interface_new(worker->path);
+    g_assert(iface2 == iface);
+    gsupplicant_interface_unref(iface2);
+    g_assert(gsupplicant_get_context(iface->supplicant) == context);
+    id = gsupplicant_interface_add_handler(iface,
+        GSUPPLICANT_INTERFACE_PROPERTY_VALID,
+        test_gsupplicant_worker_valid, worker);
+    if (!iface->valid) {
+        g_main_loop_run(worker->loop);
+    }
+    g_assert(iface->valid);
+    g_assert(!g_strcmp0(iface->path, worker->path));
+    gsupplicant_interface_remove_handler(iface, id);
+    gsupplicant_interface_unref(iface);
+    g_main_context_pop_thread_default(context);
+    g_main_loop_unref(worker->loop);
+    g_main_context_unref(context);
+    g_main_context_invoke(NULL, test_gsupplicant_worker_done, worker);
+    return NULL;
+}
+
+static
+void
+test_gsupplicant_worker(
+    void)
+{
+    TestSupplicantMockConfig config;
+    TestSupplicantMock* mock;
+    TestWorker worker;
+    TestWait wait;
+    GThread* thread;
+
+    memset(&config, 0, sizeof(config));
+    config.interfaces = 1;
+    config.bsss = 2;
+    mock = test_supplicant_mock_new(&config);
+
+    memset(&worker, 0, sizeof(worker));
+    worker.path = test_supplicant_mock_interface_path(mock, 0);
+    worker.main_iface = gsupplicant_interface_new(worker.path);
+    test_iface_wait_valid(worker.main_iface);
+    g_assert(!gsupplicant_get_context(NULL));
+    g_assert(gsupplicant_get_context(worker.main_iface->supplicant) ==
+        g_main_context_default());
+
+    /* The mock keeps running on the main thread */
+    test_wait_init(&wait);
+    worker.main_loop = wait.loop;
+    thread = g_thread_new("worker", test_gsupplicant_worker_thread, &worker);
+    test_wait_run(&wait);
+    g_thread_join(thread);
+
+    g_assert(worker.main_iface->valid);
+    gsupplicant_interface_unref(worker.main_iface);
+    test_supplicant_mock_free(mock);
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+int main(int argc, char* argv[])
+{
+    int ret;
+    G_GNUC_BEGIN_IGNORE_DEPRECATIONS;
+    g_type_init();
+    G_GNUC_END_IGNORE_DEPRECATIONS;
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_PREFIX "supplicant", test_gsupplicant_supplicant);
+    g_test_add_func(TEST_PREFIX "bss", test_gsupplicant_bss);
+    g_test_add_func(TEST_PREFIX "bss_data", test_gsupplicant_bss_data);
+    g_test_add_func(TEST_PREFIX "bss_index", test_gsupplicant_bss_index);
+    g_test_add_func(TEST_PREFIX "bss_expiry", test_gsupplicant_bss_expiry);
+    g_test_add_func(TEST_PREFIX "bss_roam", test_gsupplicant_bss_roam);
+    g_test_add_func(TEST_PREFIX "network_properties",
+        test_gsupplicant_network_properties);
+    g_test_add_func(TEST_PREFIX "network_properties_keys",
+        test_gsupplicant_network_properties_keys);
+    g_test_add_func(TEST_PREFIX "catalog", test_gsupplicant_catalog);
+    g_test_add_func(TEST_PREFIX "stations", test_gsupplicant_stations);
+    g_test_add_func(TEST_PREFIX "filter", test_gsupplicant_filter);
+    g_test_add_func(TEST_PREFIX "scan_error", test_gsupplicant_scan_error);
+    g_test_add_func(TEST_PREFIX "directed_scan",
+        test_gsupplicant_directed_scan);
+    g_test_add_func(TEST_PREFIX "scan_policy", test_gsupplicant_scan_policy);
+    g_test_add_func(TEST_PREFIX "sched_scan", test_gsupplicant_sched_scan);
+    g_test_add_func(TEST_PREFIX "roam_profile",
+        test_gsupplicant_roam_profile);
+    g_test_add_func(TEST_PREFIX "link_predictor",
+        test_gsupplicant_link_predictor);
+    g_test_add_func(TEST_PREFIX "snapshot", test_gsupplicant_snapshot);
+    g_test_add_func(TEST_PREFIX "embed", test_gsupplicant_embed);
+    g_test_add_func(TEST_PREFIX "scan_planner", test_gsupplicant_scan_planner);
+    g_test_add_func(TEST_PREFIX "journal", test_gsupplicant_journal);
+    g_test_add_func(TEST_PREFIX "worker", test_gsupplicant_worker);
+    test_init(&test_opt, argc, argv);
+    ret = g_test_run();
+    test_supplicant_mock_shutdown();
+    return ret;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
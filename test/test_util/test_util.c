@@ -33,6 +33,8 @@
 #include "test_common.h"
 
 #include "gsupplicant_util_p.h"
+#include "gsupplicant_log.h"
+#include "gsupplicant_trace.h"
 
 #include <gutil_log.h>
 #include <glib/gstdio.h>
@@ -295,6 +297,165 @@ test_util_format_bytes(
     g_main_loop_unref(loop);
 }
 
+/*==========================================================================*
+ * format_arena
+ *==========================================================================*/
+
+static
+void
+test_util_format_arena(
+    void)
+{
+    guint8 data[1000];
+    GBytes* bytes;
+    GMainLoop* loop;
+    const char* str[3];
+    guint i, k;
+
+    for (i = 0; i < sizeof(data); i++) {
+        data[i] = (guint8)i;
+    }
+    bytes = g_bytes_new_static(data, sizeof(data));
+
+    /* Twice, to exercise both the initial and the grown chunk */
+    for (k = 0; k < 2; k++) {
+        /* Arena is only used by the thread which owns the context */
+        g_assert(g_main_context_acquire(NULL));
+        /* These don't fit into one chunk */
+        for (i = 0; i < G_N_ELEMENTS(str); i++) {
+            str[i] = gsupplicant_format_bytes(bytes, TRUE);
+        }
+        /* All of them are still valid */
+        for (i = 0; i < G_N_ELEMENTS(str); i++) {
+            g_assert_cmpuint(strlen(str[i]), == ,3*sizeof(data) - 1 + 7);
+            g_assert(g_str_has_prefix(str[i], "00:01:02:03"));
+            g_assert(g_str_has_suffix(str[i], "e6:e7 (1000)"));
+        }
+        g_main_context_release(NULL);
+
+        /* The arena is reset by idle callback */
+        loop = g_main_loop_new(NULL, TRUE);
+        g_idle_add(test_loop_quit, loop);
+        g_main_loop_run(loop);
+        g_main_loop_unref(loop);
+    }
+    g_bytes_unref(bytes);
+}
+
+/*==========================================================================*
+ * format_thread
+ *==========================================================================*/
+
+static
+gpointer
+test_util_format_thread_proc(
+    gpointer data)
+{
+    GBytes* bytes = data;
+    const char* str = gsupplicant_format_bytes(bytes, FALSE);
+    const char* str2;
+
+    /* Nothing resets these strings behind our back */
+    g_assert_cmpstr(str, ==, "01:02:03");
+    g_assert(g_main_context_acquire(NULL));
+    while (g_main_context_iteration(NULL, FALSE));
+    g_main_context_release(NULL);
+    str2 = gsupplicant_format_bytes(bytes, TRUE);
+    g_assert_cmpstr(str, ==, "01:02:03");
+    g_assert_cmpstr(str2, ==, "01:02:03 (3)");
+    return NULL;
+}
+
+static
+void
+test_util_format_thread(
+    void)
+{
+    static const guint8 data[] = { 0x01, 0x02, 0x03 };
+    GBytes* bytes = g_bytes_new_static(data, sizeof(data));
+    GThread* thread = g_thread_new("test", test_util_format_thread_proc,
+        bytes);
+
+    g_thread_join(thread);
+    g_bytes_unref(bytes);
+}
+
+/*==========================================================================*
+ * log_bytes
+ *==========================================================================*/
+
+typedef struct test_log_bytes {
+    int count;
+    int level;
+    char* message;
+    GBytes* bytes;
+} TestLogBytes;
+
+static
+void
+test_util_log_bytes_func(
+    const char* module,
+    int level,
+    const char* message,
+    GBytes* bytes,
+    void* data)
+{
+    TestLogBytes* test = data;
+
+    g_assert_cmpstr(module, == ,GSUPPLICANT_LOG_MODULE.name);
+    test->count++;
+    test->level = level;
+    g_free(test->message);
+    test->message = g_strdup(message);
+    test->bytes = bytes;
+}
+
+static
+void
+test_util_log_bytes(
+    void)
+{
+    static const guint8 data[] = { 0x01, 0x02, 0x03 };
+    GBytes* bytes = g_bytes_new_static(data, sizeof(data));
+    const int level = GSUPPLICANT_LOG_MODULE.level;
+    TestLogBytes test;
+    GMainLoop* loop;
+
+    memset(&test, 0, sizeof(test));
+
+    /* No sink and logging is off - nothing happens */
+    GSUPPLICANT_LOG_MODULE.level = GLOG_LEVEL_NONE;
+    gsupplicant_log_bytes(&GSUPPLICANT_LOG_MODULE, GLOG_LEVEL_VERBOSE,
+        bytes, FALSE, "test");
+
+    /* The sink receives the raw bytes regardless of the log level */
+    gsupplicant_log_set_bytes_func(test_util_log_bytes_func, &test);
+    gsupplicant_log_bytes(&GSUPPLICANT_LOG_MODULE, GLOG_LEVEL_VERBOSE,
+        bytes, FALSE, "test %d", 1);
+    g_assert_cmpint(test.count, == ,1);
+    g_assert_cmpint(test.level, == ,GLOG_LEVEL_VERBOSE);
+    g_assert_cmpstr(test.message, == ,"test 1");
+    g_assert(test.bytes == bytes);
+
+    /* And so does the log */
+    GSUPPLICANT_LOG_MODULE.level = GLOG_LEVEL_VERBOSE;
+    gsupplicant_log_bytes(&GSUPPLICANT_LOG_MODULE, GLOG_LEVEL_DEBUG,
+        NULL, TRUE, "test %d", 2);
+    g_assert_cmpint(test.count, == ,2);
+    g_assert_cmpstr(test.message, == ,"test 2");
+    g_assert(!test.bytes);
+
+    gsupplicant_log_set_bytes_func(NULL, NULL);
+    GSUPPLICANT_LOG_MODULE.level = level;
+    g_free(test.message);
+    g_bytes_unref(bytes);
+
+    loop = g_main_loop_new(NULL, TRUE);
+    g_idle_add(test_loop_quit, loop);
+    g_main_loop_run(loop);
+    g_main_loop_unref(loop);
+}
+
 /*==========================================================================*
  * cancel_later
  *==========================================================================*/
@@ -591,6 +752,95 @@ test_util_utf8_from_bytes1(
     g_bytes_unref(bytes);
 }
 
+/*==========================================================================*
+ * intern
+ *==========================================================================*/
+
+static
+void
+test_util_intern(
+    void)
+{
+    char* foo2 = g_strdup("foo");
+    const char* foo = gsupplicant_intern("foo");
+    const char* bar = gsupplicant_intern("bar");
+    static const char* in[] = { "foo", "bar", "foo", NULL };
+    GStrV* strv;
+
+    g_assert(!gsupplicant_intern(NULL));
+    g_assert(!gsupplicant_intern_ref(NULL));
+    gsupplicant_intern_unref(NULL);
+    g_assert(!gsupplicant_intern_find(NULL));
+    g_assert(!gsupplicant_intern_find("xxx"));
+
+    /* Same string => same pointer */
+    g_assert(foo != foo2);
+    g_assert(!g_strcmp0(foo, foo2));
+    g_assert(gsupplicant_intern(foo2) == foo);
+    g_assert(gsupplicant_intern_find(foo2) == foo);
+    g_assert(gsupplicant_intern_ref(foo) == foo);
+    g_assert(foo != bar);
+    gsupplicant_intern_unref(foo);
+    gsupplicant_intern_unref(foo);
+    g_assert(gsupplicant_intern_find("foo") == foo);
+
+    /* Lists of interned strings */
+    g_assert(!gsupplicant_intern_strv(NULL));
+    gsupplicant_intern_strv_free(NULL);
+    g_assert(gsupplicant_intern_strv_find(NULL, foo) < 0);
+    g_assert(gsupplicant_intern_strv_remove_at(NULL, 0) == NULL);
+    strv = gsupplicant_intern_strv((const GStrV*)in);
+    g_assert(g_strv_length(strv) == 3);
+    g_assert(strv[0] == foo);
+    g_assert(strv[1] == bar);
+    g_assert(strv[2] == foo);
+    g_assert(gsupplicant_intern_strv_find(strv, foo) == 0);
+    g_assert(gsupplicant_intern_strv_find(strv, bar) == 1);
+    g_assert(gsupplicant_intern_strv_find(strv, foo2) < 0);
+    g_assert(gsupplicant_intern_strv_find(strv, NULL) < 0);
+    strv = gsupplicant_intern_strv_remove_at(strv, 0);
+    strv = gsupplicant_intern_strv_remove_at(strv, 5);
+    strv = gsupplicant_intern_strv_remove_at(strv, -1);
+    g_assert(g_strv_length(strv) == 2);
+    g_assert(gsupplicant_intern_strv_contains(strv, foo));
+    g_assert(gsupplicant_intern_strv_contains(strv, bar));
+    strv = gsupplicant_intern_strv_remove_at(strv, 1);
+    g_assert(!gsupplicant_intern_strv_contains(strv, foo));
+    strv = gsupplicant_intern_strv_add(strv, foo);
+    g_assert(gsupplicant_intern_strv_find(strv, foo) == 1);
+    gsupplicant_intern_strv_free(strv);
+    gsupplicant_intern_strv_free(gsupplicant_intern_strv_add(NULL, foo));
+
+    /* The last reference releases the string */
+    gsupplicant_intern_unref(bar);
+    gsupplicant_intern_unref(foo);
+    g_assert(!gsupplicant_intern_find("foo"));
+    g_assert(!gsupplicant_intern_find("bar"));
+    g_free(foo2);
+}
+
+/*==========================================================================*
+ * trace
+ *==========================================================================*/
+
+static
+void
+test_util_trace(
+    void)
+{
+    /* Probes are compiled in with SDT=1, otherwise they are no-ops */
+#ifdef HAVE_SDT
+    g_assert(GSUPPLICANT_TRACE_ENABLED);
+#else
+    g_assert(!GSUPPLICANT_TRACE_ENABLED);
+#endif
+    GSUPPLICANT_TRACE2(test_trace2, "supplicant", "/fi/w1/wpa_supplicant1");
+    GSUPPLICANT_TRACE3(test_trace3, "interface", "/fi/w1/wpa_supplicant1/0",
+        0x05);
+    GSUPPLICANT_TRACE4(test_trace4, "bss", "/fi/w1/wpa_supplicant1/0/BSSs/0",
+        &test_opt, TRUE);
+}
+
 /*==========================================================================*
  * Common
  *==========================================================================*/
@@ -606,11 +856,16 @@ int main(int argc, char* argv[])
     g_test_add_func(TEST_PREFIX "parse_bits_array", test_util_parse_bits_array);
     g_test_add_func(TEST_PREFIX "parse_bit_value", test_util_parse_bit_value);
     g_test_add_func(TEST_PREFIX "format_bytes", test_util_format_bytes);
+    g_test_add_func(TEST_PREFIX "format_arena", test_util_format_arena);
+    g_test_add_func(TEST_PREFIX "format_thread", test_util_format_thread);
+    g_test_add_func(TEST_PREFIX "log_bytes", test_util_log_bytes);
     g_test_add_func(TEST_PREFIX "cancel_later", test_util_cancel_later);
     g_test_add_func(TEST_PREFIX "abs_path", test_util_abs_path);
     g_test_add_func(TEST_PREFIX "blob_or_abs_path", test_util_blob_or_abs_path);
     g_test_add_func(TEST_PREFIX "dict_parse", test_util_dict_parse);
     g_test_add_func(TEST_PREFIX "utf8_from_bytes", test_util_utf8_from_bytes);
+    g_test_add_func(TEST_PREFIX "intern", test_util_intern);
+    g_test_add_func(TEST_PREFIX "trace", test_util_trace);
     for (i = 0; i < G_N_ELEMENTS(test_util_utf8_data); i++) {
         const TestUTF8Data* test = test_util_utf8_data + i;
         g_test_add_data_func(test->name, test, test_util_utf8_from_bytes1);